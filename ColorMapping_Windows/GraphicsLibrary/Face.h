@@ -23,6 +23,8 @@
 #ifndef FACE_H
 #define FACE_H
 
+#include <string>
+#include <cstdint>
 #include "Vertex.h"
 
 namespace sgpu {
@@ -34,6 +36,28 @@ struct TriangleFace {
     unsigned int indices[TRIANGLE_EDGE_COUNT];
 };
 
+/* Material index of a sub-mesh without a material. */
+const std::uint32_t SUBMESH_NO_MATERIAL = 0xFFFFFFFFu;
+
+/*
+ * Contiguous range of faces of a Mesh that belong to the same Obj object,
+ * group, and material. All sub-meshes of a Mesh share its vertex and index
+ * buffers. The range references the vertices [minIndex, maxIndex] (see
+ * glDrawRangeElements).
+ */
+struct SubMesh {
+    std::string name;
+    std::string material;
+
+    std::uint32_t faceOffset;
+    std::uint32_t faceCount;
+    std::uint32_t minIndex;
+    std::uint32_t maxIndex;
+
+    /* Index of the material within its Mesh (see Mesh::getMaterial). */
+    std::uint32_t materialIndex;
+};
+
 }
 
 #endif
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MESH_NORMALS_H
+#define MESH_NORMALS_H
+
+#include <vector>
+#include <Mathematics.h>
+#include "Vertex.h"
+#include "Face.h"
+
+namespace sgpu {
+
+/* Weight of a face in the computed normals of its vertices. */
+enum MeshNormalWeighting {
+    MESH_NORMAL_UNIFORM,    /* Every adjacent face counts the same. */
+    MESH_NORMAL_AREA,       /* Faces are weighted by their area. */
+    MESH_NORMAL_ANGLE       /* Faces are weighted by their angle at the vertex. */
+};
+
+/*
+ * Calculates smooth vertex normals of an indexed triangle list. Each vertex
+ * receives the weighted sum of the normals of its faces, normalized; vertices
+ * without faces (and those whose faces are degenerate) receive a zero normal.
+ * Angle weighting does not depend on how the faces around a vertex are
+ * triangulated. Faces are processed four at a time and the vertices are split
+ * between the threads, so the result does not depend on the thread count.
+ *
+ * @param indices - Three vertex indices per triangle.
+ * @param vertices - The positions of the vertices.
+ * @param normals - Receives one normal per vertex.
+ * @param weighting - The weight of each face in the normals of its vertices.
+ *
+ * @return Returns false if there are no vertices or no faces.
+ */
+bool CalculateNormals(const std::vector<unsigned int>& indices, const std::vector<Vector3f>& vertices, std::vector<Vector3f>& normals, MeshNormalWeighting weighting = MESH_NORMAL_UNIFORM);
+
+/*
+ * Calculates the tangents of the vertices from their positions, normals, and
+ * texture-coords (http://www.terathon.com/code/tangent.html). The tangent is
+ * orthogonalized against the normal and its w component holds the handedness
+ * of the tangent frame. Faces with degenerate texture-coords are ignored.
+ *
+ * @return Returns false if there are no vertices or no faces.
+ */
+bool CalculateTangents(std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces);
+
+}
+
+#endif
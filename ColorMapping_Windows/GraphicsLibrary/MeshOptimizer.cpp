@@ -0,0 +1,424 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "MeshOptimizer.h"
+#include <iostream>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+
+namespace sgpu {
+
+/* Parameters of the vertex scores of OptimizeVertexCache (see Forsyth). */
+static const float VERTEX_CACHE_DECAY_POWER = 1.5f;
+static const float VERTEX_CACHE_LAST_FACE_SCORE = 0.75f;
+static const float VERTEX_CACHE_VALENCE_SCALE = 2.0f;
+static const float VERTEX_CACHE_VALENCE_POWER = 0.5f;
+
+/* Number of remaining face counts whose valence score is tabulated. */
+static const std::size_t VERTEX_CACHE_VALENCE_COUNT = 64u;
+
+/* Marks a vertex that has no local index, or the lack of a next face. */
+static const std::uint32_t OPTIMIZER_NONE = 0xFFFFFFFFu;
+
+/*
+ * FIFO post-transform vertex cache. A vertex is cached if fewer than size
+ * misses happened since it was last transformed; the stamps are never
+ * cleared, so a reset only advances the time past every cached vertex.
+ */
+struct Optimizer_Cache {
+    Optimizer_Cache(std::size_t vertexCount, unsigned int size) : stamps(vertexCount, 0u), time(size + 1u), size(size) {}
+
+    void reset() {
+        this->time += this->size + 1u;
+    }
+
+    /* Returns the number of vertices of the face that had to be transformed. */
+    unsigned int add(const TriangleFace& face) {
+        unsigned int misses = 0u;
+        for ( unsigned int k = 0; k < TRIANGLE_EDGE_COUNT; k++ ) {
+            std::uint32_t& stamp = this->stamps[face.indices[k]];
+            if ( this->time - stamp <= this->size ) continue;
+            stamp = this->time++;
+            misses++;
+        }
+        return misses;
+    }
+
+    std::vector<std::uint32_t> stamps;
+    std::uint32_t time;
+    unsigned int size;
+};
+
+/* Returns the number of vertices a range of faces transforms from an empty cache. */
+std::size_t Optimizer_CountMisses(const TriangleFace* faces, std::size_t faceCount, Optimizer_Cache& cache) {
+    std::size_t misses = 0u;
+    cache.reset();
+    for ( std::size_t f = 0; f < faceCount; f++ ) misses += cache.add(faces[f]);
+    return misses;
+}
+
+/* Returns false if a face of the range references a vertex >= vertexCount. */
+bool Optimizer_ValidateFaces(const TriangleFace* faces, std::size_t faceCount, std::size_t vertexCount) {
+    for ( std::size_t f = 0; f < faceCount; f++ ) {
+        for ( unsigned int k = 0; k < TRIANGLE_EDGE_COUNT; k++ ) {
+            if ( faces[f].indices[k] < vertexCount ) continue;
+            std::cerr << "[MeshOptimizer] Error: Face " << f << " references vertex " << faces[f].indices[k] << " of " << vertexCount << "." << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+VertexCacheStatistics AnalyzeVertexCache(const TriangleFace* faces, std::size_t faceCount, std::size_t vertexCount, unsigned int cacheSize) {
+    VertexCacheStatistics statistics = { 0.0f, 0.0f };
+    if ( faceCount == 0 || cacheSize == 0 || !Optimizer_ValidateFaces(faces, faceCount, vertexCount) ) return statistics;
+
+    Optimizer_Cache cache(vertexCount, cacheSize);
+    std::size_t misses = Optimizer_CountMisses(faces, faceCount, cache);
+
+    std::size_t referencedCount = vertexCount - std::count(cache.stamps.begin(), cache.stamps.end(), 0u);
+    statistics.acmr = static_cast<float>(misses) / static_cast<float>(faceCount);
+    statistics.atvr = static_cast<float>(misses) / static_cast<float>(referencedCount);
+    return statistics;
+}
+
+/* Vertex scores of OptimizeVertexCache by cache position and remaining faces. */
+struct Optimizer_ScoreTable {
+    Optimizer_ScoreTable() {
+        //----------------------------------------------------------------------
+        // The vertices of the last face score the same so that the next face
+        // does not depend on the order in which they were added.
+        //----------------------------------------------------------------------
+        for ( unsigned int i = 0; i < TRIANGLE_EDGE_COUNT; i++ ) this->cache[i] = VERTEX_CACHE_LAST_FACE_SCORE;
+        for ( unsigned int i = TRIANGLE_EDGE_COUNT; i < VERTEX_CACHE_OPTIMIZATION_SIZE; i++ ) {
+            float scale = 1.0f - static_cast<float>(i - TRIANGLE_EDGE_COUNT) / static_cast<float>(VERTEX_CACHE_OPTIMIZATION_SIZE - TRIANGLE_EDGE_COUNT);
+            this->cache[i] = std::pow(scale, VERTEX_CACHE_DECAY_POWER);
+        }
+
+        this->valence[0] = 0.0f;
+        for ( std::size_t i = 1; i < VERTEX_CACHE_VALENCE_COUNT; i++ )
+            this->valence[i] = VERTEX_CACHE_VALENCE_SCALE * std::pow(static_cast<float>(i), -VERTEX_CACHE_VALENCE_POWER);
+    }
+
+    /* Score of a vertex at a cache position (or OPTIMIZER_NONE) with faces left. */
+    float score(std::uint32_t position, std::uint32_t faceCount) const {
+        if ( faceCount == 0u ) return -1.0f;
+        float cacheScore = (position < VERTEX_CACHE_OPTIMIZATION_SIZE) ? this->cache[position] : 0.0f;
+        return cacheScore + this->valence[std::min<std::size_t>(faceCount, VERTEX_CACHE_VALENCE_COUNT - 1u)];
+    }
+
+    float cache[VERTEX_CACHE_OPTIMIZATION_SIZE];
+    float valence[VERTEX_CACHE_VALENCE_COUNT];
+};
+
+/*
+ * OptimizeVertexCache of a validated range of faces. localIndices holds
+ * OPTIMIZER_NONE for every vertex and is restored before returning; like the
+ * FIFO cache the orders are compared with, it can be shared by the ranges of
+ * a mesh.
+ */
+void Optimizer_VertexCache(TriangleFace* faces, std::size_t faceCount, std::vector<std::uint32_t>& localIndices, Optimizer_Cache& fifo) {
+    static const Optimizer_ScoreTable scores;
+    if ( faceCount < 2u ) return;
+
+    //--------------------------------------------------------------------------
+    // Renumber the vertices of the range and build the list of the faces of
+    // each vertex. The first liveCounts[v] faces of a list are not drawn yet.
+    //--------------------------------------------------------------------------
+    std::size_t cornerCount = faceCount * TRIANGLE_EDGE_COUNT;
+    std::vector<std::uint32_t> corners(cornerCount);
+    std::vector<std::uint32_t> globalIndices;
+    for ( std::size_t c = 0; c < cornerCount; c++ ) {
+        std::uint32_t& local = localIndices[faces[c / TRIANGLE_EDGE_COUNT].indices[c % TRIANGLE_EDGE_COUNT]];
+        if ( local == OPTIMIZER_NONE ) {
+            local = static_cast<std::uint32_t>(globalIndices.size());
+            globalIndices.push_back(faces[c / TRIANGLE_EDGE_COUNT].indices[c % TRIANGLE_EDGE_COUNT]);
+        }
+        corners[c] = local;
+    }
+
+    std::size_t vertexCount = globalIndices.size();
+    std::vector<std::uint32_t> liveCounts(vertexCount, 0u);
+    for ( std::size_t c = 0; c < cornerCount; c++ ) liveCounts[corners[c]]++;
+
+    std::vector<std::uint32_t> offsets(vertexCount + 1u, 0u);
+    for ( std::size_t v = 0; v < vertexCount; v++ ) offsets[v + 1] = offsets[v] + liveCounts[v];
+
+    std::vector<std::uint32_t> adjacency(cornerCount);
+    std::vector<std::uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+    for ( std::size_t c = 0; c < cornerCount; c++ ) adjacency[cursors[corners[c]]++] = static_cast<std::uint32_t>(c / TRIANGLE_EDGE_COUNT);
+
+    std::vector<float> vertexScores(vertexCount);
+    for ( std::size_t v = 0; v < vertexCount; v++ ) vertexScores[v] = scores.score(OPTIMIZER_NONE, liveCounts[v]);
+
+    std::vector<float> faceScores(faceCount, 0.0f);
+    for ( std::size_t c = 0; c < cornerCount; c++ ) faceScores[c / TRIANGLE_EDGE_COUNT] += vertexScores[corners[c]];
+
+    //--------------------------------------------------------------------------
+    // Draw the best face among the faces of the cached vertices. If none is
+    // left the next face in the original order that is not drawn yet is used.
+    //--------------------------------------------------------------------------
+    std::vector<TriangleFace> sortedFaces(faceCount);
+    std::vector<std::uint8_t> drawn(faceCount, 0u);
+    std::uint32_t cache[VERTEX_CACHE_OPTIMIZATION_SIZE + TRIANGLE_EDGE_COUNT];
+    std::uint32_t nextCache[VERTEX_CACHE_OPTIMIZATION_SIZE + TRIANGLE_EDGE_COUNT];
+    std::size_t cacheCount = 0u;
+    std::size_t nextFace = 0u;
+    std::uint32_t best = static_cast<std::uint32_t>(std::max_element(faceScores.begin(), faceScores.end()) - faceScores.begin());
+    for ( std::size_t i = 0; i < faceCount; i++ ) {
+        if ( best == OPTIMIZER_NONE ) {
+            while ( drawn[nextFace] ) nextFace++;
+            best = static_cast<std::uint32_t>(nextFace);
+        }
+
+        const std::uint32_t* face = corners.data() + best * TRIANGLE_EDGE_COUNT;
+        sortedFaces[i] = faces[best];
+        drawn[best] = 1u;
+
+        std::size_t nextCount = 0u;
+        for ( unsigned int k = 0; k < TRIANGLE_EDGE_COUNT; k++ ) nextCache[nextCount++] = face[k];
+        for ( std::size_t j = 0; j < cacheCount; j++ ) {
+            nextCache[nextCount] = cache[j];
+            nextCount += (cache[j] != face[A] && cache[j] != face[B] && cache[j] != face[C]) ? 1u : 0u;
+        }
+
+        for ( unsigned int k = 0; k < TRIANGLE_EDGE_COUNT; k++ ) {
+            std::uint32_t* live = adjacency.data() + offsets[face[k]];
+            std::uint32_t& liveCount = liveCounts[face[k]];
+            std::swap(*std::find(live, live + liveCount, best), live[liveCount - 1u]);
+            liveCount--;
+        }
+
+        //----------------------------------------------------------------------
+        // Rescore the vertices whose cache position changed (including those
+        // pushed out of the cache) and their remaining faces. The best face is
+        // picked as the scores are updated; a face with two changed vertices
+        // may be compared before its second update.
+        //----------------------------------------------------------------------
+        best = OPTIMIZER_NONE;
+        float bestScore = 0.0f;
+        for ( std::size_t j = 0; j < nextCount; j++ ) {
+            std::uint32_t v = nextCache[j];
+            float score = scores.score(static_cast<std::uint32_t>(j), liveCounts[v]);
+            float delta = score - vertexScores[v];
+            vertexScores[v] = score;
+
+            const std::uint32_t* live = adjacency.data() + offsets[v];
+            for ( std::uint32_t a = 0; a < liveCounts[v]; a++ ) {
+                float faceScore = faceScores[live[a]] + delta;
+                faceScores[live[a]] = faceScore;
+                best = (faceScore > bestScore) ? live[a] : best;
+                bestScore = std::max(faceScore, bestScore);
+            }
+        }
+
+        cacheCount = std::min<std::size_t>(nextCount, VERTEX_CACHE_OPTIMIZATION_SIZE);
+        std::copy(nextCache, nextCache + cacheCount, cache);
+    }
+
+    for ( std::size_t v = 0; v < vertexCount; v++ ) localIndices[globalIndices[v]] = OPTIMIZER_NONE;
+
+    //--------------------------------------------------------------------------
+    // Faces that are already well ordered (ex. by an exporter) are kept if the
+    // new order would transform more vertices.
+    //--------------------------------------------------------------------------
+    if ( Optimizer_CountMisses(sortedFaces.data(), faceCount, fifo) < Optimizer_CountMisses(faces, faceCount, fifo) )
+        std::copy(sortedFaces.begin(), sortedFaces.end(), faces);
+}
+
+bool OptimizeVertexCache(std::vector<TriangleFace>& faces, std::size_t faceOffset, std::size_t faceCount, std::size_t vertexCount) {
+    if ( faceOffset + faceCount > faces.size() ) {
+        std::cerr << "[MeshOptimizer:optimizeVertexCache] Error: Face range exceeds the face array." << std::endl;
+        return false;
+    }
+
+    if ( !Optimizer_ValidateFaces(faces.data() + faceOffset, faceCount, vertexCount) ) return false;
+
+    std::vector<std::uint32_t> localIndices(vertexCount, OPTIMIZER_NONE);
+    Optimizer_Cache cache(vertexCount, VERTEX_CACHE_ANALYSIS_SIZE);
+    Optimizer_VertexCache(faces.data() + faceOffset, faceCount, localIndices, cache);
+    return true;
+}
+
+/*
+ * Splits a validated range of faces at the faces whose three vertices miss the
+ * cache, and splits each of those clusters again wherever the faces since the
+ * last split cost at most threshold times the misses per face of the cluster.
+ */
+void Optimizer_Clusters(const TriangleFace* faces, std::size_t faceCount, float threshold, Optimizer_Cache& cache, std::vector<std::size_t>& clusters) {
+    std::vector<std::size_t> hardClusters(1u, 0u);
+    cache.reset();
+    for ( std::size_t f = 0; f < faceCount; f++ ) {
+        if ( cache.add(faces[f]) == TRIANGLE_EDGE_COUNT && f != 0u ) hardClusters.push_back(f);
+    }
+    hardClusters.push_back(faceCount);
+
+    clusters.clear();
+    for ( std::size_t h = 0; h + 1 < hardClusters.size(); h++ ) {
+        std::size_t begin = hardClusters[h];
+        std::size_t end = hardClusters[h + 1];
+        std::size_t misses = Optimizer_CountMisses(faces + begin, end - begin, cache);
+        float limit = threshold * static_cast<float>(misses) / static_cast<float>(end - begin);
+        std::size_t start = begin;
+        std::size_t clusterMisses = 0u;
+        clusters.push_back(begin);
+        cache.reset();
+        for ( std::size_t f = begin; f + 1 < end; f++ ) {
+            clusterMisses += cache.add(faces[f]);
+            if ( static_cast<float>(clusterMisses) > limit * static_cast<float>(f + 1 - start) ) continue;
+            clusters.push_back(f + 1);
+            start = f + 1;
+            clusterMisses = 0u;
+            cache.reset();
+        }
+    }
+    clusters.push_back(faceCount);
+}
+
+/*
+ * OptimizeOverdraw of a validated range of faces. The cache only provides
+ * the stamps of the vertices, so it can be shared by the ranges of a mesh.
+ */
+void Optimizer_Overdraw(TriangleFace* faces, std::size_t faceCount, const std::vector<Vertex>& vertices, float threshold, Optimizer_Cache& cache) {
+    if ( faceCount < 2u ) return;
+
+    std::size_t misses = Optimizer_CountMisses(faces, faceCount, cache);
+    std::vector<std::size_t> clusters;
+    Optimizer_Clusters(faces, faceCount, threshold, cache, clusters);
+    std::size_t clusterCount = clusters.size() - 1u;
+    if ( clusterCount < 2u ) return;
+
+    //--------------------------------------------------------------------------
+    // Area weighted centroid and normal of each cluster and of the range. A
+    // cluster is drawn earlier the further it faces away from the centroid.
+    //--------------------------------------------------------------------------
+    std::vector<float> clusterData(clusterCount * 7u, 0.0f);
+    float meshCentroid[3] = { 0.0f, 0.0f, 0.0f };
+    float meshArea = 0.0f;
+    for ( std::size_t i = 0; i < clusterCount; i++ ) {
+        float* data = clusterData.data() + i * 7u;
+        for ( std::size_t f = clusters[i]; f < clusters[i + 1]; f++ ) {
+            const Vector3f& p0 = vertices[faces[f].indices[A]].position;
+            const Vector3f& p1 = vertices[faces[f].indices[B]].position;
+            const Vector3f& p2 = vertices[faces[f].indices[C]].position;
+            float u[3] = { p1.x() - p0.x(), p1.y() - p0.y(), p1.z() - p0.z() };
+            float v[3] = { p2.x() - p0.x(), p2.y() - p0.y(), p2.z() - p0.z() };
+            float normal[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+            float area = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            for ( unsigned int k = 0; k < 3; k++ ) {
+                float centroid = (p0[k] + p1[k] + p2[k]) / 3.0f;
+                data[k] += centroid * area;
+                data[3 + k] += normal[k];
+                meshCentroid[k] += centroid * area;
+            }
+            data[6] += area;
+            meshArea += area;
+        }
+    }
+
+    std::vector<float> keys(clusterCount, 0.0f);
+    for ( std::size_t i = 0; i < clusterCount; i++ ) {
+        const float* data = clusterData.data() + i * 7u;
+        float normalLength = std::sqrt(data[3] * data[3] + data[4] * data[4] + data[5] * data[5]);
+        if ( data[6] <= 0.0f || meshArea <= 0.0f || normalLength <= 0.0f ) continue;
+        for ( unsigned int k = 0; k < 3; k++ )
+            keys[i] += (data[k] / data[6] - meshCentroid[k] / meshArea) * data[3 + k] / normalLength;
+    }
+
+    std::vector<std::size_t> order(clusterCount);
+    for ( std::size_t i = 0; i < clusterCount; i++ ) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&keys](std::size_t a, std::size_t b) { return keys[a] > keys[b]; });
+
+    std::vector<TriangleFace> sortedFaces;
+    sortedFaces.reserve(faceCount);
+    for ( std::size_t i = 0; i < clusterCount; i++ )
+        sortedFaces.insert(sortedFaces.end(), faces + clusters[order[i]], faces + clusters[order[i] + 1]);
+
+    //--------------------------------------------------------------------------
+    // Each cluster starts with a cold cache once the clusters are reordered,
+    // so the cache order is kept if the new order misses more than threshold
+    // times as often.
+    //--------------------------------------------------------------------------
+    if ( static_cast<float>(Optimizer_CountMisses(sortedFaces.data(), faceCount, cache)) > threshold * static_cast<float>(misses) ) return;
+    std::copy(sortedFaces.begin(), sortedFaces.end(), faces);
+}
+
+bool OptimizeOverdraw(std::vector<TriangleFace>& faces, std::size_t faceOffset, std::size_t faceCount, const std::vector<Vertex>& vertices, float threshold) {
+    if ( faceOffset + faceCount > faces.size() ) {
+        std::cerr << "[MeshOptimizer:optimizeOverdraw] Error: Face range exceeds the face array." << std::endl;
+        return false;
+    }
+
+    if ( !Optimizer_ValidateFaces(faces.data() + faceOffset, faceCount, vertices.size()) ) return false;
+
+    Optimizer_Cache cache(vertices.size(), VERTEX_CACHE_ANALYSIS_SIZE);
+    Optimizer_Overdraw(faces.data() + faceOffset, faceCount, vertices, threshold, cache);
+    return true;
+}
+
+bool OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces) {
+    if ( !Optimizer_ValidateFaces(faces.data(), faces.size(), vertices.size()) ) return false;
+
+    std::vector<std::uint32_t> remap(vertices.size(), OPTIMIZER_NONE);
+    std::uint32_t vertexCount = 0u;
+    for ( std::size_t f = 0; f < faces.size(); f++ ) {
+        for ( unsigned int k = 0; k < TRIANGLE_EDGE_COUNT; k++ ) {
+            std::uint32_t& index = remap[faces[f].indices[k]];
+            if ( index == OPTIMIZER_NONE ) index = vertexCount++;
+            faces[f].indices[k] = index;
+        }
+    }
+
+    std::vector<Vertex> sortedVertices(vertices.size());
+    for ( std::size_t v = 0; v < vertices.size(); v++ ) {
+        if ( remap[v] == OPTIMIZER_NONE ) remap[v] = vertexCount++;
+        sortedVertices[remap[v]] = vertices[v];
+    }
+
+    vertices.swap(sortedVertices);
+    return true;
+}
+
+bool OptimizeMesh(std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces, const std::vector<SubMesh>& subMeshes, MeshOptimizationStatistics* statistics) {
+    if ( !Optimizer_ValidateFaces(faces.data(), faces.size(), vertices.size()) ) return false;
+    if ( statistics != nullptr ) statistics->original = AnalyzeVertexCache(faces.data(), faces.size(), vertices.size());
+
+    std::vector<std::uint32_t> localIndices(vertices.size(), OPTIMIZER_NONE);
+    Optimizer_Cache cache(vertices.size(), VERTEX_CACHE_ANALYSIS_SIZE);
+    for ( std::size_t i = 0; i < subMeshes.size(); i++ ) {
+        const SubMesh& subMesh = subMeshes[i];
+        if ( static_cast<std::size_t>(subMesh.faceOffset) + subMesh.faceCount > faces.size() ) {
+            std::cerr << "[MeshOptimizer:optimizeMesh] Error: Sub-mesh exceeds the face array." << std::endl;
+            return false;
+        }
+
+        Optimizer_VertexCache(faces.data() + subMesh.faceOffset, subMesh.faceCount, localIndices, cache);
+        Optimizer_Overdraw(faces.data() + subMesh.faceOffset, subMesh.faceCount, vertices, OVERDRAW_DEFAULT_THRESHOLD, cache);
+    }
+
+    if ( !OptimizeVertexFetch(vertices, faces) ) return false;
+    if ( statistics != nullptr ) statistics->optimized = AnalyzeVertexCache(faces.data(), faces.size(), vertices.size());
+    return true;
+}
+
+}
@@ -27,6 +27,7 @@
 #include <memory>
 #include <vector>
 #include <map>
+#include <cstdint>
 #include <Mathematics.h>
 
 namespace sgpu {
@@ -36,18 +37,106 @@ struct ObjMesh;
 /* *.obj Supported geometry face types */
 enum ObjFaceType { TRIANGLE, QUAD, POLYGON };
 
+/*
+ * *.obj Loading strategies. OBJ_LOAD_STREAM reads the file line-by-line
+ * through std::istream. OBJ_LOAD_MAPPED maps the file into memory and
+ * tokenizes it in place (std::from_chars, no per-line strings or streams),
+ * producing the same meshes considerably faster. OBJ_LOAD_PARALLEL splits
+ * the mapped file into newline aligned chunks that are parsed on separate
+ * threads and merged in file order (files below 1 MB per thread are parsed
+ * as OBJ_LOAD_MAPPED). The mapped readers also resolve relative (negative)
+ * face indices.
+ */
+enum ObjLoadMode { OBJ_LOAD_STREAM, OBJ_LOAD_MAPPED, OBJ_LOAD_PARALLEL };
+
 /*
  * Simple mesh loader. This function allows a single *.obj file to
  * be read with the first mesh automatically extracted from the file.
  */
 bool LoadObjMesh(const std::string& filename, std::shared_ptr<ObjMesh>& mesh);
 
+/*
+ * Receives the records of an Obj file in file order while it is parsed by
+ * ParseObjFile, without an ObjFile or ObjMesh being built. Face indices are
+ * 0-based and file-global (relative indices are already resolved) and a node
+ * without a texture-coord or normal index passes index 0. Returning false
+ * from a callback stops the parsing process.
+ */
+class ObjVisitor {
+public:
+    virtual ~ObjVisitor() {}
+
+    /* v, vn, and vt records. */
+    virtual bool onVertex(const Vector3f& /*position*/) { return true; }
+    virtual bool onNormal(const Vector3f& /*normal*/) { return true; }
+    virtual bool onTexcoord(const Vector3f& /*textureCoord*/) { return true; }
+
+    /* f records, each index array contains one index per node of the face. */
+    virtual bool onFace(const std::uint32_t* /*vertexIndices*/, const std::uint32_t* /*textureIndices*/, const std::uint32_t* /*normalIndices*/, std::size_t /*nodeCount*/) { return true; }
+
+    /* g and o records (the name is empty if none was provided). */
+    virtual bool onGroup(const std::string& /*name*/) { return true; }
+    virtual bool onObject(const std::string& /*name*/) { return true; }
+
+    /* usemtl and mtllib records (one call per library). */
+    virtual bool onMaterial(const std::string& /*name*/) { return true; }
+    virtual bool onMaterialLibrary(const std::string& /*name*/) { return true; }
+};
+
+/*
+ * Parses an Obj file and passes its records to the provided visitor.
+ *
+ * @param filename - The name of the Obj file to be read (include .obj).
+ * @param visitor - The visitor that receives the records of the file.
+ *
+ * @return If the file could be read (or the visitor stopped the parsing
+ * process) then this function will return true; otherwise it will return
+ * false.
+ */
+bool ParseObjFile(const std::string& filename, ObjVisitor& visitor);
+
+/*
+ * Material of an Obj material library (*.mtl). Only the diffuse, specular,
+ * and shininess properties (Kd, Ks, Ns) and their texture maps (map_Kd,
+ * map_Bump, map_Ks) are read. The texture map filenames are resolved against
+ * the directory of the material library.
+ */
+struct ObjMaterial {
+    ObjMaterial();
+
+    std::string name;
+    Vector3f diffuse;
+    Vector3f specular;
+    float shininess;
+
+    std::string diffuseMap;
+    std::string normalMap;
+    std::string specularMap;
+};
+
+/*
+ * Reads the materials of an Obj material library (*.mtl) and appends them to
+ * the provided material array.
+ *
+ * @param filename - The name of the material library (include .mtl).
+ * @param materials - The materials read from the library.
+ *
+ * @return If the library is read successfully then this function will return
+ * true; otherwise it will return false.
+ */
+bool LoadObjMaterialLibrary(const std::string& filename, std::vector<ObjMaterial>& materials);
+
+/*
+ * Face of an ObjMesh. The indices of a face are not stored with the face, the
+ * face refers to the nodes [offset, offset + count) of the vertex, texture-
+ * coord, and normal index streams of its mesh. Faces are fixed-size and need
+ * no allocations of their own.
+ */
 struct Obj_Face {
     ObjFaceType type;
 
-    std::vector<std::size_t> vertexIndices;
-    std::vector<std::size_t> textureIndices;
-    std::vector<std::size_t> normalIndices;
+    std::uint32_t offset;
+    std::uint32_t count;
 
     std::size_t smoothingGroupIndex;
     std::size_t groupIndex;
@@ -65,6 +154,16 @@ struct ObjMesh {
     std::vector<Vector3f> normals;
     std::vector<Vector3f> textureCoordinates;
 
+    /*
+     * Index streams that store the nodes of every face in order. A node
+     * without a texture-coord or normal stores index 0. If every face of the
+     * mesh is a triangle, then the streams contain exactly 3 nodes per face
+     * and can be used directly as triangle index arrays.
+     */
+    std::vector<std::uint32_t> vertexIndices;
+    std::vector<std::uint32_t> textureIndices;
+    std::vector<std::uint32_t> normalIndices;
+
     std::vector<Obj_Face> faces;
 };
 
@@ -74,9 +173,10 @@ typedef std::vector<std::string> StringArray;
 
 /* 
  * This class provides an Obj file definition into a set of meshes. Obj material 
- * libraries are supported as external references. The implementation of this
- * Wavefront Obj reader is focused on the readability and clearness of the 
- * presented code and does not provide a highly optimized Obj reader. This 
+ * libraries are supported as external references. The stream based 
+ * implementation of this Wavefront Obj reader (OBJ_LOAD_STREAM) is focused on
+ * the readability and clearness of the presented code, the default mapped
+ * reader (OBJ_LOAD_MAPPED) parses the same records in place for speed. This 
  * implementation utilizes the definition of an Wavefront Obj file below:
  *
  * # Obj Comment
@@ -112,11 +212,12 @@ public:
      * Loads a set of Obj mesh definitions from an Obj file.
      * 
      * @param filename - The name of the Obj file to be read (include .obj).
+     * @param mode - The strategy used to read the file (see ObjLoadMode).
      *
      * @return If the file is successfully loaded from the provided file then
      * this function will return true; otherwise it will return false.
      */
-    bool load(const std::string& filename);
+    bool load(const std::string& filename, ObjLoadMode mode = OBJ_LOAD_MAPPED);
 
     /*
      * Saves this definition of set of ObjMeshes as an Obj file.
@@ -257,6 +358,11 @@ public:
     /* Returns the list of external material libraries */
     const StringArray& getMaterialLibraries() const;
 
+protected:
+    bool loadStream(const std::string& filename);
+    bool loadMapped(const std::string& filename);
+    bool loadParallel(const std::string& filename);
+
 protected:
     /* Stores the individual meshes within this Obj file. */
     MeshArray meshes;
@@ -15,8 +15,13 @@ const int WINDOW_WIDTH = 600;
 const int WINDOW_HEIGHT = 400;
 GLint g_glutWindowIdentifier;
 
+/* Quads per side of the base plane, and target edge length after tessellation (pixels) */
+const unsigned int PLANE_DIVISIONS = 16u;
+const float TESSELLATION_EDGE_PIXELS = 8.0f;
+
 std::shared_ptr<MouseCameraf> camera = nullptr;
 std::shared_ptr<Mesh> mesh = nullptr;
+float viewportHeight = static_cast<float>(WINDOW_HEIGHT);
 
 void g_init() {
 	glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
@@ -27,13 +32,18 @@ void g_init() {
     camera->setPosition(18.0f, 1.5707f, 1.570f * 0.7f);
 
     mesh = std::make_shared<Mesh>();
-    mesh->load("models/tessealted_plane.obj");
-    mesh->loadShader("shaders/DisplacementMapping.vert", "shaders/DisplacementMapping.frag");
+    //--------------------------------------------------------------------------
+    // A coarse plane is subdivided on the GPU by the tessellation stages, as
+    // finely as its faces cover the screen (see DisplacementMapping.tesc).
+    //--------------------------------------------------------------------------
+    mesh->createPlane(16.0f, 16.0f, PLANE_DIVISIONS, PLANE_DIVISIONS);
+    mesh->loadShader("shaders/DisplacementMapping.vert", "shaders/DisplacementMapping.tesc", "shaders/DisplacementMapping.tese", "shaders/DisplacementMapping.frag");
     mesh->setHeightmapTexture("textures/displacementmap.png");
 }
 
 void g_glutReshapeFunc(int width, int height) {
 	glViewport(0, 0, width, height);
+    viewportHeight = static_cast<float>(height);
     camera->setPerspective(45.0f, (float)width / (float)height, 0.1f, 1000.0f);
 	glutPostRedisplay();
 }
@@ -53,6 +63,8 @@ void g_glutDisplayFunc() {
     mesh->getShader()->uniformMatrix("normalMatrix", normalMatrix);
     mesh->getShader()->uniformVector("lightPosition", Vector3f(0.0f, 12.0f, 0.0f));
     mesh->getShader()->uniform1f("height", 2.0f);
+    mesh->getShader()->uniform1f("viewportHeight", viewportHeight);
+    mesh->getShader()->uniform1f("edgePixels", TESSELLATION_EDGE_PIXELS);
     mesh->endRender();
 
     glutSwapBuffers();
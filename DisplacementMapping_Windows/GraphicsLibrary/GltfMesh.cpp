@@ -0,0 +1,539 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "GltfMesh.h"
+#include <iostream>
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+
+namespace sgpu {
+
+static const std::uint32_t GLB_MAGIC = 0x46546C67u;
+static const std::uint32_t GLB_VERSION = 2u;
+static const std::uint32_t GLB_CHUNK_JSON = 0x4E4F534Au;
+static const std::uint32_t GLB_CHUNK_BIN = 0x004E4942u;
+static const std::size_t GLB_HEADER_SIZE = 12u;
+static const std::size_t GLB_CHUNK_HEADER_SIZE = 8u;
+static const unsigned int GLTF_MODE_TRIANGLES = 4u;
+
+//------------------------------------------------------------------------------
+// Minimal JSON document model, only used for the (small) JSON chunk of a .glb
+// file. Numbers are stored as doubles and objects keep their member order.
+//------------------------------------------------------------------------------
+enum Gltf_JsonType { GLTF_JSON_NULL, GLTF_JSON_BOOL, GLTF_JSON_NUMBER, GLTF_JSON_STRING, GLTF_JSON_ARRAY, GLTF_JSON_OBJECT };
+
+struct Gltf_Json {
+    Gltf_Json() : type(GLTF_JSON_NULL), number(0.0), boolean(false) {}
+
+    /* Returns the member with the provided key (nullptr if not found). */
+    const Gltf_Json* find(const std::string& key) const {
+        if ( this->type != GLTF_JSON_OBJECT ) return nullptr;
+        for ( std::size_t i = 0; i < this->members.size(); i++ )
+            if ( this->members[i].first == key ) return &this->members[i].second;
+        return nullptr;
+    }
+
+    /* Returns the element at the provided index (nullptr if not found). */
+    const Gltf_Json* at(std::size_t index) const {
+        if ( this->type != GLTF_JSON_ARRAY || index >= this->elements.size() ) return nullptr;
+        return &this->elements[index];
+    }
+
+    /* Returns the numeric member with the provided key or the default value. */
+    double getNumber(const std::string& key, double defaultValue) const {
+        const Gltf_Json* value = this->find(key);
+        if ( value == nullptr || value->type != GLTF_JSON_NUMBER ) return defaultValue;
+        return value->number;
+    }
+
+    /* Returns the string member with the provided key or an empty string. */
+    std::string getString(const std::string& key) const {
+        const Gltf_Json* value = this->find(key);
+        if ( value == nullptr || value->type != GLTF_JSON_STRING ) return std::string();
+        return value->string;
+    }
+
+    Gltf_JsonType type;
+    double number;
+    bool boolean;
+    std::string string;
+    std::vector<Gltf_Json> elements;
+    std::vector<std::pair<std::string, Gltf_Json>> members;
+};
+
+inline void Gltf_SkipSpace(const char*& cur, const char* end) {
+    while ( cur < end && (*cur == ' ' || *cur == '\t' || *cur == '\n' || *cur == '\r') ) cur++;
+}
+
+/* Appends the UTF-8 encoding of the provided code point. */
+void Gltf_AppendUtf8(std::string& out, std::uint32_t codePoint) {
+    if ( codePoint < 0x80u ) out.push_back(static_cast<char>(codePoint));
+    else if ( codePoint < 0x800u ) {
+        out.push_back(static_cast<char>(0xC0u | (codePoint >> 6)));
+        out.push_back(static_cast<char>(0x80u | (codePoint & 0x3Fu)));
+    }
+    else {
+        out.push_back(static_cast<char>(0xE0u | (codePoint >> 12)));
+        out.push_back(static_cast<char>(0x80u | ((codePoint >> 6) & 0x3Fu)));
+        out.push_back(static_cast<char>(0x80u | (codePoint & 0x3Fu)));
+    }
+}
+
+bool Parse_Gltf_String(const char*& cur, const char* end, std::string& string) {
+    if ( cur >= end || *cur != '"' ) return false;
+    cur++;
+
+    while ( cur < end && *cur != '"' ) {
+        if ( *cur != '\\' ) {
+            string.push_back(*cur++);
+            continue;
+        }
+
+        if ( ++cur >= end ) return false;
+        char c = *cur++;
+        switch ( c ) {
+            case 'b': string.push_back('\b'); break;
+            case 'f': string.push_back('\f'); break;
+            case 'n': string.push_back('\n'); break;
+            case 'r': string.push_back('\r'); break;
+            case 't': string.push_back('\t'); break;
+            case 'u': {
+                std::uint32_t codePoint = 0u;
+                if ( end - cur < 4 || std::from_chars(cur, cur + 4, codePoint, 16).ptr != cur + 4 ) return false;
+                Gltf_AppendUtf8(string, codePoint);
+                cur += 4;
+                break;
+            }
+            default: string.push_back(c); break;
+        }
+    }
+
+    if ( cur >= end ) return false;
+    cur++;
+    return true;
+}
+
+/* Parses the JSON value starting at cur (recursive descent). */
+bool Parse_Gltf_Json(const char*& cur, const char* end, Gltf_Json& value, unsigned int depth) {
+    static const unsigned int MAX_DEPTH = 64u;
+    if ( depth > MAX_DEPTH ) return false;
+
+    Gltf_SkipSpace(cur, end);
+    if ( cur >= end ) return false;
+
+    if ( *cur == '{' ) {
+        value.type = GLTF_JSON_OBJECT;
+        cur++;
+        Gltf_SkipSpace(cur, end);
+        if ( cur < end && *cur == '}' ) { cur++; return true; }
+
+        while ( cur < end ) {
+            std::pair<std::string, Gltf_Json> member;
+            Gltf_SkipSpace(cur, end);
+            if ( !Parse_Gltf_String(cur, end, member.first) ) return false;
+            Gltf_SkipSpace(cur, end);
+            if ( cur >= end || *cur++ != ':' ) return false;
+            if ( !Parse_Gltf_Json(cur, end, member.second, depth + 1) ) return false;
+            value.members.push_back(std::move(member));
+
+            Gltf_SkipSpace(cur, end);
+            if ( cur < end && *cur == ',' ) { cur++; continue; }
+            if ( cur < end && *cur == '}' ) { cur++; return true; }
+            return false;
+        }
+        return false;
+    }
+
+    if ( *cur == '[' ) {
+        value.type = GLTF_JSON_ARRAY;
+        cur++;
+        Gltf_SkipSpace(cur, end);
+        if ( cur < end && *cur == ']' ) { cur++; return true; }
+
+        while ( cur < end ) {
+            value.elements.push_back(Gltf_Json());
+            if ( !Parse_Gltf_Json(cur, end, value.elements.back(), depth + 1) ) return false;
+
+            Gltf_SkipSpace(cur, end);
+            if ( cur < end && *cur == ',' ) { cur++; continue; }
+            if ( cur < end && *cur == ']' ) { cur++; return true; }
+            return false;
+        }
+        return false;
+    }
+
+    if ( *cur == '"' ) {
+        value.type = GLTF_JSON_STRING;
+        return Parse_Gltf_String(cur, end, value.string);
+    }
+
+    static const std::string JSON_TRUE = "true";
+    static const std::string JSON_FALSE = "false";
+    static const std::string JSON_NULL = "null";
+    std::size_t remaining = static_cast<std::size_t>(end - cur);
+    if ( remaining >= JSON_TRUE.length() && JSON_TRUE.compare(0, JSON_TRUE.length(), cur, JSON_TRUE.length()) == 0 ) {
+        value.type = GLTF_JSON_BOOL;
+        value.boolean = true;
+        cur += JSON_TRUE.length();
+        return true;
+    }
+
+    if ( remaining >= JSON_FALSE.length() && JSON_FALSE.compare(0, JSON_FALSE.length(), cur, JSON_FALSE.length()) == 0 ) {
+        value.type = GLTF_JSON_BOOL;
+        cur += JSON_FALSE.length();
+        return true;
+    }
+
+    if ( remaining >= JSON_NULL.length() && JSON_NULL.compare(0, JSON_NULL.length(), cur, JSON_NULL.length()) == 0 ) {
+        cur += JSON_NULL.length();
+        return true;
+    }
+
+    value.type = GLTF_JSON_NUMBER;
+    std::from_chars_result result = std::from_chars(cur, end, value.number);
+    if ( result.ec != std::errc() ) return false;
+    cur = result.ptr;
+    return true;
+}
+
+/* Returns the number of components of a glTF accessor type (0 if unsupported). */
+unsigned int Gltf_ComponentCount(const std::string& type) {
+    if ( type == "SCALAR" ) return 1u;
+    if ( type == "VEC2" ) return 2u;
+    if ( type == "VEC3" ) return 3u;
+    if ( type == "VEC4" ) return 4u;
+    return 0u;
+}
+
+/* Returns the size in bytes of a glTF component type (0 if unsupported). */
+std::size_t Gltf_ComponentSize(unsigned int componentType) {
+    switch ( componentType ) {
+        case GLTF_BYTE:
+        case GLTF_UNSIGNED_BYTE: return 1u;
+        case GLTF_SHORT:
+        case GLTF_UNSIGNED_SHORT: return 2u;
+        case GLTF_UNSIGNED_INT:
+        case GLTF_FLOAT: return 4u;
+        default: return 0u;
+    }
+}
+
+/* 
+ * Resolves the accessor with the provided index into a view of the binary
+ * chunk. The accessor must lie entirely within its buffer view.
+ */
+bool Resolve_Gltf_Accessor(const Gltf_Json& root, const unsigned char* bin, std::size_t binSize, double index, GltfAccessor& accessor) {
+    const Gltf_Json* accessors = root.find("accessors");
+    const Gltf_Json* bufferViews = root.find("bufferViews");
+    const Gltf_Json* json = (accessors != nullptr && index >= 0.0) ? accessors->at(static_cast<std::size_t>(index)) : nullptr;
+    if ( json == nullptr ) {
+        std::cerr << "[GltfFile:load] Error: Invalid accessor index." << std::endl;
+        return false;
+    }
+
+    if ( json->find("sparse") != nullptr ) {
+        std::cerr << "[GltfFile:load] Error: Sparse accessors are not supported." << std::endl;
+        return false;
+    }
+
+    double viewIndex = json->getNumber("bufferView", -1.0);
+    const Gltf_Json* view = (bufferViews != nullptr && viewIndex >= 0.0) ? bufferViews->at(static_cast<std::size_t>(viewIndex)) : nullptr;
+    if ( view == nullptr || view->getNumber("buffer", 0.0) != 0.0 || bin == nullptr ) {
+        std::cerr << "[GltfFile:load] Error: Accessor does not reference the binary chunk." << std::endl;
+        return false;
+    }
+
+    accessor.componentType = static_cast<unsigned int>(json->getNumber("componentType", 0.0));
+    accessor.componentCount = Gltf_ComponentCount(json->getString("type"));
+    accessor.count = static_cast<std::size_t>(json->getNumber("count", 0.0));
+    const Gltf_Json* normalized = json->find("normalized");
+    accessor.normalized = (normalized != nullptr && normalized->boolean);
+
+    std::size_t elementSize = Gltf_ComponentSize(accessor.componentType) * accessor.componentCount;
+    if ( elementSize == 0u ) {
+        std::cerr << "[GltfFile:load] Error: Unsupported accessor type." << std::endl;
+        return false;
+    }
+
+    std::size_t viewOffset = static_cast<std::size_t>(view->getNumber("byteOffset", 0.0));
+    std::size_t viewLength = static_cast<std::size_t>(view->getNumber("byteLength", 0.0));
+    std::size_t offset = static_cast<std::size_t>(json->getNumber("byteOffset", 0.0));
+    accessor.stride = static_cast<std::size_t>(view->getNumber("byteStride", static_cast<double>(elementSize)));
+
+    if ( viewOffset > binSize || viewLength > binSize - viewOffset || 
+         (accessor.count > 0 && (offset > viewLength || (accessor.count - 1) * accessor.stride + elementSize > viewLength - offset)) ) {
+        std::cerr << "[GltfFile:load] Error: Accessor exceeds its buffer view." << std::endl;
+        return false;
+    }
+
+    accessor.data = bin + viewOffset + offset;
+    return true;
+}
+
+/* Resolves an optional attribute of a primitive, validating its layout. */
+bool Resolve_Gltf_Attribute(const Gltf_Json& root, const unsigned char* bin, std::size_t binSize, const Gltf_Json& attributes, const std::string& name, unsigned int minComponents, unsigned int maxComponents, bool bFloatOnly, GltfAccessor& accessor) {
+    const Gltf_Json* index = attributes.find(name);
+    if ( index == nullptr ) return true;
+    if ( !Resolve_Gltf_Accessor(root, bin, binSize, index->number, accessor) ) return false;
+
+    bool valid = accessor.componentCount >= minComponents && accessor.componentCount <= maxComponents;
+    if ( bFloatOnly ) valid = valid && accessor.componentType == GLTF_FLOAT;
+    else valid = valid && (accessor.componentType == GLTF_FLOAT || accessor.normalized);
+
+    if ( !valid ) {
+        std::cerr << "[GltfFile:load] Error: Unsupported layout of attribute: " << name << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+GltfAccessor::GltfAccessor() {
+    this->data = nullptr;
+    this->count = 0u;
+    this->stride = 0u;
+    this->componentType = GLTF_FLOAT;
+    this->componentCount = 0u;
+    this->normalized = false;
+}
+
+bool GltfAccessor::isValid() const {
+    return this->data != nullptr;
+}
+
+float GltfAccessor::getFloat(std::size_t i, unsigned int c) const {
+    const unsigned char* element = this->data + i * this->stride;
+
+    //--------------------------------------------------------------------------
+    // The binary chunk is only 4-byte aligned, components are read with
+    // memcpy. Normalized integers are mapped to [0, 1] or [-1, 1].
+    //--------------------------------------------------------------------------
+    switch ( this->componentType ) {
+        case GLTF_FLOAT: {
+            float value;
+            std::memcpy(&value, element + c * sizeof(float), sizeof(float));
+            return value;
+        }
+        case GLTF_UNSIGNED_BYTE: {
+            float value = static_cast<float>(element[c]);
+            return this->normalized ? value / 255.0f : value;
+        }
+        case GLTF_BYTE: {
+            float value = static_cast<float>(static_cast<std::int8_t>(element[c]));
+            return this->normalized ? std::max(value / 127.0f, -1.0f) : value;
+        }
+        case GLTF_UNSIGNED_SHORT: {
+            std::uint16_t value;
+            std::memcpy(&value, element + c * sizeof(std::uint16_t), sizeof(std::uint16_t));
+            return this->normalized ? static_cast<float>(value) / 65535.0f : static_cast<float>(value);
+        }
+        case GLTF_SHORT: {
+            std::int16_t value;
+            std::memcpy(&value, element + c * sizeof(std::int16_t), sizeof(std::int16_t));
+            return this->normalized ? std::max(static_cast<float>(value) / 32767.0f, -1.0f) : static_cast<float>(value);
+        }
+        default:
+            return 0.0f;
+    }
+}
+
+std::uint32_t GltfAccessor::getIndex(std::size_t i, unsigned int c) const {
+    const unsigned char* element = this->data + i * this->stride;
+
+    switch ( this->componentType ) {
+        case GLTF_UNSIGNED_BYTE:
+            return element[c];
+        case GLTF_UNSIGNED_SHORT: {
+            std::uint16_t value;
+            std::memcpy(&value, element + c * sizeof(std::uint16_t), sizeof(std::uint16_t));
+            return value;
+        }
+        case GLTF_UNSIGNED_INT: {
+            std::uint32_t value;
+            std::memcpy(&value, element + c * sizeof(std::uint32_t), sizeof(std::uint32_t));
+            return value;
+        }
+        default:
+            return 0u;
+    }
+}
+
+GltfFile::GltfFile() {}
+
+GltfFile::~GltfFile() {
+    this->close();
+}
+
+bool GltfFile::load(const std::string& filename) {
+    this->close();
+
+    if ( !this->file.open(filename) ) {
+        std::cerr << "[GltfFile:load] Error: The file: " << filename << " could not be opened." << std::endl;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // A .glb file consists of a 12 byte header followed by the JSON chunk and
+    // an optional binary (BIN) chunk.
+    //--------------------------------------------------------------------------
+    std::uint32_t header[3] = { 0u, 0u, 0u };
+    if ( this->file.size() >= GLB_HEADER_SIZE ) std::memcpy(header, this->file.data(), GLB_HEADER_SIZE);
+    if ( header[0] != GLB_MAGIC || header[1] != GLB_VERSION || header[2] > this->file.size() ) {
+        std::cerr << "[GltfFile:load] Error: The file: " << filename << " is not a binary glTF 2.0 file." << std::endl;
+        this->close();
+        return false;
+    }
+
+    const char* json = nullptr;
+    std::size_t jsonSize = 0u;
+    const unsigned char* bin = nullptr;
+    std::size_t binSize = 0u;
+
+    std::size_t offset = GLB_HEADER_SIZE;
+    while ( offset + GLB_CHUNK_HEADER_SIZE <= header[2] ) {
+        std::uint32_t chunk[2];
+        std::memcpy(chunk, this->file.data() + offset, GLB_CHUNK_HEADER_SIZE);
+        offset += GLB_CHUNK_HEADER_SIZE;
+        if ( chunk[0] > header[2] - offset ) break;
+
+        if ( chunk[1] == GLB_CHUNK_JSON && json == nullptr ) {
+            json = this->file.data() + offset;
+            jsonSize = chunk[0];
+        }
+        else if ( chunk[1] == GLB_CHUNK_BIN && bin == nullptr ) {
+            bin = reinterpret_cast<const unsigned char*>(this->file.data() + offset);
+            binSize = chunk[0];
+        }
+
+        offset += chunk[0];
+    }
+
+    Gltf_Json root;
+    const char* cur = json;
+    if ( json == nullptr || !Parse_Gltf_Json(cur, json + jsonSize, root, 0u) || root.type != GLTF_JSON_OBJECT ) {
+        std::cerr << "[GltfFile:load] Error: The file: " << filename << " has no valid JSON chunk." << std::endl;
+        this->close();
+        return false;
+    }
+
+    const Gltf_Json* buffers = root.find("buffers");
+    if ( buffers != nullptr && buffers->at(0) != nullptr && buffers->at(0)->find("uri") != nullptr ) {
+        std::cerr << "[GltfFile:load] Error: External glTF buffers are not supported: " << filename << std::endl;
+        this->close();
+        return false;
+    }
+
+    const Gltf_Json* materials = root.find("materials");
+    for ( std::size_t i = 0; materials != nullptr && i < materials->elements.size(); i++ ) {
+        GltfMaterial material;
+        material.name = materials->elements[i].getString("name");
+        if ( material.name.length() == 0 ) material.name = "material" + std::to_string(i);
+        for ( unsigned int c = 0; c < 4u; c++ ) material.baseColor[c] = 1.0f;
+
+        const Gltf_Json* pbr = materials->elements[i].find("pbrMetallicRoughness");
+        const Gltf_Json* factor = (pbr != nullptr) ? pbr->find("baseColorFactor") : nullptr;
+        for ( unsigned int c = 0; factor != nullptr && c < 4u && c < factor->elements.size(); c++ )
+            material.baseColor[c] = static_cast<float>(factor->elements[c].number);
+        this->materials.push_back(material);
+    }
+
+    //--------------------------------------------------------------------------
+    // Collect the triangle primitives of every mesh.
+    //--------------------------------------------------------------------------
+    const Gltf_Json* meshes = root.find("meshes");
+    for ( std::size_t m = 0; meshes != nullptr && m < meshes->elements.size(); m++ ) {
+        const Gltf_Json& mesh = meshes->elements[m];
+        const Gltf_Json* primitives = mesh.find("primitives");
+
+        for ( std::size_t p = 0; primitives != nullptr && p < primitives->elements.size(); p++ ) {
+            const Gltf_Json& json = primitives->elements[p];
+            if ( static_cast<unsigned int>(json.getNumber("mode", GLTF_MODE_TRIANGLES)) != GLTF_MODE_TRIANGLES ) {
+                std::cerr << "[GltfFile:load] Warning: Only triangle primitives are supported. Ignoring primitive." << std::endl;
+                continue;
+            }
+
+            const Gltf_Json* attributes = json.find("attributes");
+            if ( attributes == nullptr || attributes->find("POSITION") == nullptr ) {
+                std::cerr << "[GltfFile:load] Warning: Primitive without positions. Ignoring primitive." << std::endl;
+                continue;
+            }
+
+            GltfPrimitive primitive;
+            primitive.name = mesh.getString("name");
+            double materialIndex = json.getNumber("material", -1.0);
+            if ( materialIndex >= 0.0 && static_cast<std::size_t>(materialIndex) < this->materials.size() )
+                primitive.material = this->materials[static_cast<std::size_t>(materialIndex)].name;
+
+            bool valid = Resolve_Gltf_Attribute(root, bin, binSize, *attributes, "POSITION", 3u, 3u, true, primitive.positions);
+            valid = valid && Resolve_Gltf_Attribute(root, bin, binSize, *attributes, "NORMAL", 3u, 3u, true, primitive.normals);
+            valid = valid && Resolve_Gltf_Attribute(root, bin, binSize, *attributes, "TANGENT", 4u, 4u, true, primitive.tangents);
+            valid = valid && Resolve_Gltf_Attribute(root, bin, binSize, *attributes, "TEXCOORD_0", 2u, 2u, false, primitive.textureCoords);
+            valid = valid && Resolve_Gltf_Attribute(root, bin, binSize, *attributes, "COLOR_0", 3u, 4u, false, primitive.colors);
+
+            const Gltf_Json* indices = json.find("indices");
+            if ( valid && indices != nullptr ) {
+                valid = Resolve_Gltf_Accessor(root, bin, binSize, indices->number, primitive.indices);
+                valid = valid && primitive.indices.componentCount == 1u && primitive.indices.componentType != GLTF_FLOAT &&
+                        primitive.indices.componentType != GLTF_BYTE && primitive.indices.componentType != GLTF_SHORT;
+            }
+
+            //------------------------------------------------------------------
+            // Every vertex attribute must provide one element per position.
+            //------------------------------------------------------------------
+            std::size_t vertexCount = primitive.positions.count;
+            const GltfAccessor* attributeAccessors[] = { &primitive.normals, &primitive.tangents, &primitive.textureCoords, &primitive.colors };
+            for ( std::size_t a = 0; valid && a < 4u; a++ )
+                valid = !attributeAccessors[a]->isValid() || attributeAccessors[a]->count == vertexCount;
+
+            if ( !valid ) {
+                std::cerr << "[GltfFile:load] Error: Invalid primitive in file: " << filename << std::endl;
+                this->close();
+                return false;
+            }
+
+            this->primitives.push_back(primitive);
+        }
+    }
+
+    return true;
+}
+
+void GltfFile::close() {
+    this->primitives.clear();
+    this->materials.clear();
+    this->file.close();
+}
+
+std::size_t GltfFile::getPrimitiveCount() const {
+    return this->primitives.size();
+}
+
+const GltfPrimitive& GltfFile::getPrimitive(std::size_t index) const {
+    return this->primitives[index];
+}
+
+const std::vector<GltfMaterial>& GltfFile::getMaterials() const {
+    return this->materials;
+}
+
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef GLTF_MESH_H
+#define GLTF_MESH_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "MappedFile.h"
+
+namespace sgpu {
+
+/* Component types of glTF accessors (see the glTF 2.0 specification). */
+enum GltfComponentType {
+    GLTF_BYTE = 5120,
+    GLTF_UNSIGNED_BYTE = 5121,
+    GLTF_SHORT = 5122,
+    GLTF_UNSIGNED_SHORT = 5123,
+    GLTF_UNSIGNED_INT = 5125,
+    GLTF_FLOAT = 5126
+};
+
+/*
+ * Accessor of a glTF primitive that points directly into the mapped binary
+ * chunk of its .glb file. Element i starts at data + i * stride and consists
+ * of componentCount components of the provided component type. An accessor
+ * that is not provided by the primitive has a data pointer of nullptr.
+ */
+struct GltfAccessor {
+    GltfAccessor();
+
+    /* Returns true if the primitive provides this accessor. */
+    bool isValid() const;
+
+    /* Reads component c of element i as a float (normalized if required). */
+    float getFloat(std::size_t i, unsigned int c) const;
+
+    /* Reads component c of element i as an unsigned integer. */
+    std::uint32_t getIndex(std::size_t i, unsigned int c) const;
+
+    const unsigned char* data;
+    std::size_t count;
+    std::size_t stride;
+    unsigned int componentType;
+    unsigned int componentCount;
+    bool normalized;
+};
+
+/*
+ * Triangle primitive of a glTF mesh. A primitive without indices draws its
+ * vertices in order.
+ */
+struct GltfPrimitive {
+    std::string name;
+    std::string material;
+
+    GltfAccessor positions;
+    GltfAccessor normals;
+    GltfAccessor tangents;
+    GltfAccessor textureCoords;
+    GltfAccessor colors;
+    GltfAccessor indices;
+};
+
+/* Material of a glTF file (only the base color factor is read). */
+struct GltfMaterial {
+    std::string name;
+    float baseColor[4];
+};
+
+/*
+ * Binary glTF 2.0 (.glb) file. The file is mapped into memory and only its
+ * JSON chunk is parsed; the accessors of the primitives point directly into
+ * the mapped binary chunk, so no vertex data is tokenized or copied until it
+ * is read. Triangle primitives (mode 4) of every mesh are loaded, node
+ * transformations, external buffers, and sparse accessors are not supported.
+ */
+class GltfFile {
+public:
+    GltfFile();
+    ~GltfFile();
+
+    /*
+     * Loads the triangle primitives of a binary glTF file.
+     * 
+     * @param filename - The name of the glTF file to be read (include .glb).
+     *
+     * @return If the file is successfully loaded from the provided file then
+     * this function will return true; otherwise it will return false.
+     */
+    bool load(const std::string& filename);
+
+    /* Releases the mapping of the file and its primitives. */
+    void close();
+
+    /* Returns the number of triangle primitives within this glTF file. */
+    std::size_t getPrimitiveCount() const;
+
+    /* Returns the primitive at the provided index. */
+    const GltfPrimitive& getPrimitive(std::size_t index) const;
+
+    /* Returns the materials of this glTF file. */
+    const std::vector<GltfMaterial>& getMaterials() const;
+
+protected:
+    GltfFile(const GltfFile&) = delete;
+    GltfFile& operator = (const GltfFile&) = delete;
+
+protected:
+    MappedFile file;
+    std::vector<GltfPrimitive> primitives;
+    std::vector<GltfMaterial> materials;
+};
+
+}
+
+#endif
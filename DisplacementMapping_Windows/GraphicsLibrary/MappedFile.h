@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+namespace sgpu {
+
+/*
+ * Read-only view of a file mapped into the address space of this process. The
+ * contents of the file can be read in place through data() without copying
+ * them into an intermediate buffer (std::ifstream, std::string). The mapping
+ * is released when the file is closed or this object is destroyed.
+ */
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    /*
+     * Maps the file with the provided name into memory (read-only).
+     *
+     * @param filename - The name of the file to be mapped.
+     *
+     * @return If the file could be opened and mapped then this function will
+     * return true; otherwise it will return false.
+     */
+    bool open(const std::string& filename);
+
+    /* Releases the mapping of the currently open file (if any). */
+    void close();
+
+    /* Returns true if a file is currently mapped by this object. */
+    bool isOpen() const;
+
+    /* Returns the first byte of the mapped file (nullptr for empty files). */
+    const char* data() const;
+
+    /* Returns the number of bytes in the mapped file. */
+    std::size_t size() const;
+
+protected:
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator = (const MappedFile&) = delete;
+
+protected:
+    const char* view;
+    std::size_t length;
+    bool opened;
+
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fileDescriptor;
+#endif
+};
+
+}
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "TessellationShader.h"
+#include <gl/glew.h>
+
+namespace sgpu {
+
+TessellationShader::TessellationShader() {
+    this->controlId = 0;
+    this->evaluationId = 0;
+}
+
+TessellationShader::~TessellationShader() {
+    glDeleteShader(this->controlId);
+    glDeleteShader(this->evaluationId);
+}
+
+bool TessellationShader::load(const std::string& vertexFilename, const std::string& controlFilename, const std::string& evaluationFilename, const std::string& fragmentFilename) {
+    if ( !this->loadFile(vertexFilename, this->vertSource) ) return false;
+    if ( !this->loadFile(fragmentFilename, this->fragSource) ) return false;
+    if ( !this->loadFile(controlFilename, this->controlSource) ) return false;
+    if ( !this->loadFile(evaluationFilename, this->evaluationSource) ) return false;
+
+    this->vertFilename = vertexFilename;
+    this->fragFilename = fragmentFilename;
+    this->controlFilename = controlFilename;
+    this->evaluationFilename = evaluationFilename;
+
+    this->vertexId = glCreateShader(GL_VERTEX_SHADER);
+    this->fragmentId = glCreateShader(GL_FRAGMENT_SHADER);
+    this->controlId = glCreateShader(GL_TESS_CONTROL_SHADER);
+    this->evaluationId = glCreateShader(GL_TESS_EVALUATION_SHADER);
+
+    const char* vsource_cstr = this->vertSource.c_str();
+    const char* fsource_cstr = this->fragSource.c_str();
+    const char* csource_cstr = this->controlSource.c_str();
+    const char* esource_cstr = this->evaluationSource.c_str();
+
+    glShaderSource(this->vertexId, 1, &vsource_cstr, 0);
+    glShaderSource(this->fragmentId, 1, &fsource_cstr, 0);
+    glShaderSource(this->controlId, 1, &csource_cstr, 0);
+    glShaderSource(this->evaluationId, 1, &esource_cstr, 0);
+    return true;
+}
+
+bool TessellationShader::compile() {
+    glCompileShader(this->vertexId);
+    if ( !this->compileStatus(this->vertexId, this->vertFilename) ) return false;
+
+    glCompileShader(this->fragmentId);
+    if ( !this->compileStatus(this->fragmentId, this->fragFilename) ) return false;
+
+    glCompileShader(this->controlId);
+    if ( !this->compileStatus(this->controlId, this->controlFilename) ) return false;
+
+    glCompileShader(this->evaluationId);
+    if ( !this->compileStatus(this->evaluationId, this->evaluationFilename) ) return false;
+    return true;
+}
+
+bool TessellationShader::link() {
+    this->programId = glCreateProgram();
+    glAttachShader(this->programId, this->vertexId);
+    glAttachShader(this->programId, this->controlId);
+    glAttachShader(this->programId, this->evaluationId);
+    glAttachShader(this->programId, this->fragmentId);
+    glLinkProgram(this->programId);
+    
+    if ( !this->linkStatus(this->programId) ) return false;
+    return true;
+}
+
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "Frustum.h"
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRUSTUM_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace sgpu {
+
+Frustum::Frustum() {
+    //--------------------------------------------------------------------------
+    // A default frustum has planes at infinity, so it contains everything.
+    //--------------------------------------------------------------------------
+    for ( unsigned int i = 0; i < FRUSTUM_PLANE_COUNT; i++ ) {
+        this->planes[i][0] = 0.0f;
+        this->planes[i][1] = 0.0f;
+        this->planes[i][2] = 0.0f;
+        this->planes[i][3] = 1.0f;
+    }
+}
+
+Frustum::Frustum(const Matrix4f& clipMatrix) {
+    this->set(clipMatrix);
+}
+
+Frustum::~Frustum() {}
+
+void Frustum::set(const Matrix4f& clipMatrix) {
+    //--------------------------------------------------------------------------
+    // A point is inside if -w <= x, y, z <= w in clip space, so each plane is
+    // the fourth row of the (OpenGL column-major) matrix plus or minus one of
+    // the other rows: left, right, bottom, top, near, far.
+    //--------------------------------------------------------------------------
+    const float* clip = clipMatrix.constData();
+    for ( unsigned int i = 0; i < FRUSTUM_PLANE_COUNT; i++ ) {
+        float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+        for ( unsigned int k = 0; k < 4; k++ ) this->planes[i][k] = clip[k * 4 + 3] + sign * clip[k * 4 + i / 2];
+
+        float length = std::sqrt(this->planes[i][0] * this->planes[i][0] + this->planes[i][1] * this->planes[i][1] + this->planes[i][2] * this->planes[i][2]);
+        if ( length > 0.0f ) for ( unsigned int k = 0; k < 4; k++ ) this->planes[i][k] /= length;
+    }
+}
+
+bool Frustum::intersectsSphere(const Vector3f& center, float radius) const {
+    for ( unsigned int i = 0; i < FRUSTUM_PLANE_COUNT; i++ ) {
+        const float* plane = this->planes[i];
+        if ( plane[0] * center.x() + plane[1] * center.y() + plane[2] * center.z() + plane[3] < -radius ) return false;
+    }
+
+    return true;
+}
+
+bool Frustum::intersectsBox(const Vector3f& boundsMinimum, const Vector3f& boundsMaximum, unsigned int& planeMask) const {
+    for ( unsigned int i = 0; i < FRUSTUM_PLANE_COUNT; i++ ) {
+        if ( (planeMask & (1u << i)) == 0 ) continue;
+
+        //----------------------------------------------------------------------
+        // The corner furthest along the normal is the last to leave the plane
+        // and the corner furthest against it is the first.
+        //----------------------------------------------------------------------
+        const float* plane = this->planes[i];
+        float furthest = plane[3];
+        float closest = plane[3];
+        for ( unsigned int k = 0; k < 3; k++ ) {
+            furthest += plane[k] * ((plane[k] >= 0.0f) ? boundsMaximum[k] : boundsMinimum[k]);
+            closest += plane[k] * ((plane[k] >= 0.0f) ? boundsMinimum[k] : boundsMaximum[k]);
+        }
+
+        if ( furthest < 0.0f ) return false;
+        if ( closest >= 0.0f ) planeMask &= ~(1u << i);
+    }
+
+    return true;
+}
+
+unsigned int Frustum::intersectSpheres(const float* x, const float* y, const float* z, const float* radius, unsigned int planeMask) const {
+#ifdef FRUSTUM_SSE2
+    __m128 cx = _mm_loadu_ps(x);
+    __m128 cy = _mm_loadu_ps(y);
+    __m128 cz = _mm_loadu_ps(z);
+    __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius));
+    __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for ( unsigned int i = 0; i < FRUSTUM_PLANE_COUNT; i++ ) {
+        if ( (planeMask & (1u << i)) == 0 ) continue;
+
+        const float* plane = this->planes[i];
+        __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(plane[0])), _mm_mul_ps(cy, _mm_set1_ps(plane[1]))), _mm_add_ps(_mm_mul_ps(cz, _mm_set1_ps(plane[2])), _mm_set1_ps(plane[3])));
+        inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+    }
+
+    return static_cast<unsigned int>(_mm_movemask_ps(inside));
+#else
+    unsigned int inside = (1u << FRUSTUM_BATCH_SIZE) - 1u;
+    for ( unsigned int i = 0; i < FRUSTUM_PLANE_COUNT; i++ ) {
+        if ( (planeMask & (1u << i)) == 0 ) continue;
+
+        const float* plane = this->planes[i];
+        for ( unsigned int j = 0; j < FRUSTUM_BATCH_SIZE; j++ ) {
+            if ( plane[0] * x[j] + plane[1] * y[j] + plane[2] * z[j] + plane[3] < -radius[j] ) inside &= ~(1u << j);
+        }
+    }
+
+    return inside;
+#endif
+}
+
+const float* Frustum::getPlane(FrustumPlane plane) const {
+    return this->planes[plane];
+}
+
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <Mathematics.h>
+#include <Matrix4.h>
+
+namespace sgpu {
+
+/* Planes of a Frustum; their normals point into the frustum. */
+enum FrustumPlane {
+    FRUSTUM_LEFT,
+    FRUSTUM_RIGHT,
+    FRUSTUM_BOTTOM,
+    FRUSTUM_TOP,
+    FRUSTUM_NEAR,
+    FRUSTUM_FAR,
+    FRUSTUM_PLANE_COUNT
+};
+
+/* Plane mask of a Frustum test that has to test every plane. */
+const unsigned int FRUSTUM_ALL_PLANES = (1u << FRUSTUM_PLANE_COUNT) - 1u;
+
+/* Number of spheres tested together by Frustum::intersectSpheres. */
+const std::size_t FRUSTUM_BATCH_SIZE = 4u;
+
+/*
+ * View frustum of a clip matrix, as six planes in the space the matrix
+ * transforms from. For the world space frustum of a camera the clip matrix is
+ * camera.getViewMatrix() * camera.getProjectionMatrix() (the matrices of this
+ * library are multiplied in the order they are applied); for the object space
+ * frustum of a mesh it is modelView * projection.
+ *
+ * All tests are conservative: a volume may be reported as intersecting the
+ * frustum although it only intersects the planes outside of it near a corner.
+ */
+class Frustum {
+public:
+    Frustum();
+    Frustum(const Matrix4f& clipMatrix);
+    ~Frustum();
+
+    /* Extracts the planes from the rows of a clip matrix (Gribb-Hartmann). */
+    void set(const Matrix4f& clipMatrix);
+
+    /* Returns true if a sphere is not entirely outside of any plane. */
+    bool intersectsSphere(const Vector3f& center, float radius) const;
+
+    /*
+     * Tests an axis-aligned box against the planes of planeMask (bit i is
+     * plane i). The planes the box is entirely inside of are removed from the
+     * mask, so the children of a hierarchy contained in the box only need to
+     * be tested against the remaining planes.
+     *
+     * @return Returns false if the box is entirely outside of any plane.
+     */
+    bool intersectsBox(const Vector3f& boundsMinimum, const Vector3f& boundsMaximum, unsigned int& planeMask) const;
+
+    /*
+     * Tests FRUSTUM_BATCH_SIZE spheres, given component by component, against
+     * the planes of planeMask (with SSE2 if available).
+     *
+     * @return Returns a mask whose bit i is set if sphere i is not entirely
+     * outside of any of the planes.
+     */
+    unsigned int intersectSpheres(const float* x, const float* y, const float* z, const float* radius, unsigned int planeMask = FRUSTUM_ALL_PLANES) const;
+
+    /* Returns the plane (a, b, c, d) with ax + by + cz + d >= 0 inside. */
+    const float* getPlane(FrustumPlane plane) const;
+
+protected:
+    /* Planes with unit normals, so distances are in units of the space. */
+    float planes[FRUSTUM_PLANE_COUNT][4];
+};
+
+}
+
+#endif
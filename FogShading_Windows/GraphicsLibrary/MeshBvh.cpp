@@ -0,0 +1,663 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "MeshBvh.h"
+#include "ParallelFor.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MESH_BVH_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace sgpu {
+
+/* Number of bins the centroids of a node are sorted into to find a split. */
+static const std::size_t BVH_BIN_COUNT = 16u;
+
+/* Most faces of a leaf that is not worth splitting (see Bvh_FindSplit). */
+static const std::size_t BVH_MAX_LEAF_FACES = 8u;
+
+/* Cost of visiting a node relative to the cost of intersecting a face. */
+static const float BVH_TRAVERSAL_COST = 1.0f;
+
+/* Deepest node of a hierarchy; nodes at this depth become leaves. */
+static const std::size_t BVH_MAX_DEPTH = 64u;
+
+/* Smallest number of faces worth building on several threads. */
+static const std::size_t BVH_MIN_PARALLEL_FACES = 1u << 14;
+
+/* Number of subtrees per thread the top of a hierarchy is split into. */
+static const std::size_t BVH_TASKS_PER_THREAD = 4u;
+
+/* Smallest number of rays worth tracing on several threads. */
+static const std::size_t BVH_MIN_PARALLEL_RAYS = 1u << 10;
+
+/* Smallest magnitude of a ray direction component (avoids infinities). */
+static const float BVH_MIN_DIRECTION = 1.0e-20f;
+
+/* Bounds and centroid of a face being sorted into the hierarchy. */
+struct Bvh_FaceBounds {
+    float minimum[3];
+    float maximum[3];
+    float centroid[3];
+    std::uint32_t face;
+};
+
+/* Axis-aligned box that grows to contain points and other boxes. */
+struct Bvh_Box {
+    void reset() {
+        for ( unsigned int k = 0; k < 3; k++ ) {
+            this->minimum[k] = std::numeric_limits<float>::max();
+            this->maximum[k] = -std::numeric_limits<float>::max();
+        }
+    }
+
+    void grow(const float* minimum, const float* maximum) {
+        for ( unsigned int k = 0; k < 3; k++ ) {
+            this->minimum[k] = std::min(this->minimum[k], minimum[k]);
+            this->maximum[k] = std::max(this->maximum[k], maximum[k]);
+        }
+    }
+
+    float area() const {
+        float dx = this->maximum[0] - this->minimum[0];
+        float dy = this->maximum[1] - this->minimum[1];
+        float dz = this->maximum[2] - this->minimum[2];
+        if ( dx < 0.0f || dy < 0.0f || dz < 0.0f ) return 0.0f;
+        return 2.0f * (dx * dy + dy * dz + dz * dx);
+    }
+
+    float minimum[3];
+    float maximum[3];
+};
+
+/* Subtree of the hierarchy left to a worker thread (see MeshBvh::build). */
+struct Bvh_Task {
+    std::uint32_t begin;
+    std::uint32_t end;
+    std::uint32_t node;
+    std::size_t depth;
+};
+
+/* Faces being sorted into the hierarchy and the nodes being built. */
+struct Bvh_Builder {
+    Bvh_FaceBounds* faces;
+    std::vector<MeshBvhNode>* nodes;
+
+    /* Ranges of at most taskSize faces become tasks if tasks is set. */
+    std::vector<Bvh_Task>* tasks;
+    std::size_t taskSize;
+    std::size_t depth;
+};
+
+/* Returns the number of bins of a node, fewer than BVH_BIN_COUNT for small nodes. */
+inline std::size_t Bvh_BinCount(std::size_t faceCount) {
+    return std::min(BVH_BIN_COUNT, faceCount);
+}
+
+/*
+ * Finds the binned SAH split of the faces [begin, end) of a node. Returns
+ * false if a leaf is cheaper than any split; otherwise axis and bin are set
+ * so the faces whose centroid falls into a lower bin go to the first child.
+ */
+bool Bvh_FindSplit(const Bvh_Builder& builder, std::uint32_t begin, std::uint32_t end, const Bvh_Box& box, const Bvh_Box& centroids, unsigned int& axis, std::size_t& bin) {
+    std::size_t count = end - begin;
+    std::size_t binCount = Bvh_BinCount(count);
+    float bestCost = std::numeric_limits<float>::max();
+
+    //--------------------------------------------------------------------------
+    // The faces are sorted into the bins of all three axes in one pass.
+    //--------------------------------------------------------------------------
+    Bvh_Box bins[3][BVH_BIN_COUNT];
+    std::size_t binCounts[3][BVH_BIN_COUNT];
+    float scales[3];
+    for ( unsigned int k = 0; k < 3; k++ ) {
+        float extent = centroids.maximum[k] - centroids.minimum[k];
+        scales[k] = (extent > 0.0f) ? static_cast<float>(binCount) / extent : 0.0f;
+        for ( std::size_t b = 0; b < binCount; b++ ) {
+            bins[k][b].reset();
+            binCounts[k][b] = 0u;
+        }
+    }
+
+    for ( std::uint32_t i = begin; i < end; i++ ) {
+        const Bvh_FaceBounds& face = builder.faces[i];
+        for ( unsigned int k = 0; k < 3; k++ ) {
+            std::size_t b = std::min(binCount - 1u, static_cast<std::size_t>((face.centroid[k] - centroids.minimum[k]) * scales[k]));
+            bins[k][b].grow(face.minimum, face.maximum);
+            binCounts[k][b]++;
+        }
+    }
+
+    for ( unsigned int k = 0; k < 3; k++ ) {
+        if ( scales[k] == 0.0f ) continue;
+
+        //----------------------------------------------------------------------
+        // Sweeps the bins from the right to get the area and count of every
+        // right side, then from the left to evaluate every split plane.
+        //----------------------------------------------------------------------
+        float rightAreas[BVH_BIN_COUNT];
+        std::size_t rightCounts[BVH_BIN_COUNT];
+        Bvh_Box right;
+        right.reset();
+        std::size_t rightCount = 0u;
+        for ( std::size_t b = binCount - 1u; b > 0; b-- ) {
+            right.grow(bins[k][b].minimum, bins[k][b].maximum);
+            rightCount += binCounts[k][b];
+            rightAreas[b] = right.area();
+            rightCounts[b] = rightCount;
+        }
+
+        Bvh_Box left;
+        left.reset();
+        std::size_t leftCount = 0u;
+        for ( std::size_t b = 1; b < binCount; b++ ) {
+            left.grow(bins[k][b - 1].minimum, bins[k][b - 1].maximum);
+            leftCount += binCounts[k][b - 1];
+            if ( leftCount == 0u || rightCounts[b] == 0u ) continue;
+
+            float cost = static_cast<float>(leftCount) * left.area() + static_cast<float>(rightCounts[b]) * rightAreas[b];
+            if ( cost >= bestCost ) continue;
+            bestCost = cost;
+            axis = k;
+            bin = b;
+        }
+    }
+
+    if ( bestCost == std::numeric_limits<float>::max() ) return false;
+
+    float area = box.area();
+    float splitCost = BVH_TRAVERSAL_COST + ((area > 0.0f) ? bestCost / area : 0.0f);
+    return count > BVH_MAX_LEAF_FACES || splitCost < static_cast<float>(count);
+}
+
+/*
+ * Builds the subtree of the faces [begin, end) below the node at the provided
+ * index. Children are appended to the nodes in pairs, and the faces are
+ * partitioned in place so every leaf references a contiguous range of them.
+ */
+void Bvh_BuildNode(Bvh_Builder& builder, std::uint32_t begin, std::uint32_t end, std::uint32_t nodeIndex, std::size_t depth) {
+    Bvh_Box box, centroids;
+    box.reset();
+    centroids.reset();
+    for ( std::uint32_t i = begin; i < end; i++ ) {
+        const Bvh_FaceBounds& face = builder.faces[i];
+        box.grow(face.minimum, face.maximum);
+        centroids.grow(face.centroid, face.centroid);
+    }
+
+    MeshBvhNode& node = (*builder.nodes)[nodeIndex];
+    for ( unsigned int k = 0; k < 3; k++ ) {
+        node.boundsMinimum[k] = box.minimum[k];
+        node.boundsMaximum[k] = box.maximum[k];
+    }
+
+    builder.depth = std::max(builder.depth, depth);
+    if ( builder.tasks != nullptr && end - begin <= builder.taskSize ) {
+        Bvh_Task task = { begin, end, nodeIndex, depth };
+        builder.tasks->push_back(task);
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    // Faces whose centroids coincide cannot be binned; if there are too many
+    // of them for a leaf they are split in half.
+    //--------------------------------------------------------------------------
+    unsigned int axis = 0u;
+    std::size_t bin = 0u;
+    std::uint32_t middle = begin;
+    if ( depth < BVH_MAX_DEPTH && end - begin > 1u ) {
+        if ( Bvh_FindSplit(builder, begin, end, box, centroids, axis, bin) ) {
+            std::size_t binCount = Bvh_BinCount(end - begin);
+            float scale = static_cast<float>(binCount) / (centroids.maximum[axis] - centroids.minimum[axis]);
+            float minimum = centroids.minimum[axis];
+            middle = static_cast<std::uint32_t>(std::partition(builder.faces + begin, builder.faces + end, [&](const Bvh_FaceBounds& face) {
+                return std::min(binCount - 1u, static_cast<std::size_t>((face.centroid[axis] - minimum) * scale)) < bin;
+            }) - builder.faces);
+        }
+        else if ( end - begin > BVH_MAX_LEAF_FACES ) middle = begin + (end - begin) / 2u;
+    }
+
+    if ( middle == begin || middle == end ) {
+        node.offset = begin;
+        node.count = end - begin;
+        return;
+    }
+
+    std::uint32_t childIndex = static_cast<std::uint32_t>(builder.nodes->size());
+    node.offset = childIndex;
+    node.count = 0u;
+    builder.nodes->resize(builder.nodes->size() + 2u);
+    Bvh_BuildNode(builder, begin, middle, childIndex, depth + 1u);
+    Bvh_BuildNode(builder, middle, end, childIndex + 1u, depth + 1u);
+}
+
+/* Returns 1 / d, keeping the result finite for components close to zero. */
+inline float Bvh_Inverse(float d) {
+    if ( std::fabs(d) < BVH_MIN_DIRECTION ) return (d < 0.0f) ? -1.0f / BVH_MIN_DIRECTION : 1.0f / BVH_MIN_DIRECTION;
+    return 1.0f / d;
+}
+
+/* Returns true if a ray enters the box of a node before closest (at entry). */
+inline bool Bvh_IntersectNode(const MeshBvhNode& node, const float* origin, const float* inverse, float closest, float& entry) {
+    float tmin = 0.0f;
+    float tmax = closest;
+    for ( unsigned int k = 0; k < 3; k++ ) {
+        float t0 = (node.boundsMinimum[k] - origin[k]) * inverse[k];
+        float t1 = (node.boundsMaximum[k] - origin[k]) * inverse[k];
+        tmin = std::max(tmin, std::min(t0, t1));
+        tmax = std::min(tmax, std::max(t0, t1));
+    }
+
+    entry = tmin;
+    return tmin <= tmax;
+}
+
+/* Moller-Trumbore intersection of a ray with a triangle closer than closest. */
+inline bool Bvh_IntersectTriangle(const MeshBvhTriangle& triangle, const float* origin, const float* direction, float closest, float& t, float& u, float& v) {
+    const float* e1 = triangle.edge1;
+    const float* e2 = triangle.edge2;
+    float p[3] = { direction[1] * e2[2] - direction[2] * e2[1], direction[2] * e2[0] - direction[0] * e2[2], direction[0] * e2[1] - direction[1] * e2[0] };
+    float det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+    if ( det == 0.0f ) return false;
+
+    float inverse = 1.0f / det;
+    float s[3] = { origin[0] - triangle.p0[0], origin[1] - triangle.p0[1], origin[2] - triangle.p0[2] };
+    u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inverse;
+    if ( u < 0.0f || u > 1.0f ) return false;
+
+    float q[3] = { s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0] };
+    v = (direction[0] * q[0] + direction[1] * q[1] + direction[2] * q[2]) * inverse;
+    if ( v < 0.0f || u + v > 1.0f ) return false;
+
+    t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inverse;
+    return t >= 0.0f && t < closest;
+}
+
+MeshBvh::MeshBvh() {
+    this->depth = 0u;
+}
+
+bool MeshBvh::build(const Vertex* vertices, std::size_t vertexCount, const TriangleFace* faces, std::size_t faceCount) {
+    this->clear();
+
+    //--------------------------------------------------------------------------
+    // Bounds and centroids of the faces that have an area.
+    //--------------------------------------------------------------------------
+    std::vector<Bvh_FaceBounds> bounds;
+    bounds.reserve(faceCount);
+    for ( std::size_t f = 0; f < faceCount; f++ ) {
+        const TriangleFace& face = faces[f];
+        if ( face[0] >= vertexCount || face[1] >= vertexCount || face[2] >= vertexCount ) {
+            std::cerr << "[MeshBvh:build] Error: Face " << f << " references a missing vertex." << std::endl;
+            return false;
+        }
+
+        const Vector3f& p0 = vertices[face[0]].position;
+        const Vector3f& p1 = vertices[face[1]].position;
+        const Vector3f& p2 = vertices[face[2]].position;
+        if ( Vector3f::Cross(p1 - p0, p2 - p0).length() == 0.0 ) continue;
+
+        Bvh_FaceBounds faceBounds;
+        faceBounds.minimum[0] = std::min(p0.x(), std::min(p1.x(), p2.x()));
+        faceBounds.minimum[1] = std::min(p0.y(), std::min(p1.y(), p2.y()));
+        faceBounds.minimum[2] = std::min(p0.z(), std::min(p1.z(), p2.z()));
+        faceBounds.maximum[0] = std::max(p0.x(), std::max(p1.x(), p2.x()));
+        faceBounds.maximum[1] = std::max(p0.y(), std::max(p1.y(), p2.y()));
+        faceBounds.maximum[2] = std::max(p0.z(), std::max(p1.z(), p2.z()));
+        for ( unsigned int k = 0; k < 3; k++ ) faceBounds.centroid[k] = 0.5f * (faceBounds.minimum[k] + faceBounds.maximum[k]);
+        faceBounds.face = static_cast<std::uint32_t>(f);
+        bounds.push_back(faceBounds);
+    }
+
+    if ( bounds.size() == 0 ) return true;
+
+    //--------------------------------------------------------------------------
+    // The top of the tree is built on this thread until the remaining ranges
+    // are small enough to give each thread several subtrees to build.
+    //--------------------------------------------------------------------------
+    std::size_t threadCount = (bounds.size() >= BVH_MIN_PARALLEL_FACES) ? GetThreadCount() : 1u;
+    std::vector<Bvh_Task> tasks;
+    Bvh_Builder builder;
+    builder.faces = bounds.data();
+    builder.nodes = &this->nodes;
+    builder.tasks = (threadCount > 1u) ? &tasks : nullptr;
+    builder.taskSize = std::max<std::size_t>(1u, bounds.size() / (threadCount * BVH_TASKS_PER_THREAD));
+    builder.depth = 0u;
+    this->nodes.resize(1u);
+    Bvh_BuildNode(builder, 0u, static_cast<std::uint32_t>(bounds.size()), 0u, 0u);
+    this->depth = builder.depth;
+
+    std::vector<std::vector<MeshBvhNode>> subtrees(tasks.size());
+    std::vector<std::size_t> depths(tasks.size(), 0u);
+    ParallelFor(std::min(threadCount, tasks.size()), [&](std::size_t t) {
+        for ( std::size_t i = t; i < tasks.size(); i += std::min(threadCount, tasks.size()) ) {
+            Bvh_Builder subtree = builder;
+            subtree.nodes = &subtrees[i];
+            subtree.tasks = nullptr;
+            subtree.depth = 0u;
+            subtrees[i].resize(1u);
+            Bvh_BuildNode(subtree, tasks[i].begin, tasks[i].end, 0u, tasks[i].depth);
+            depths[i] = subtree.depth;
+        }
+    });
+
+    //--------------------------------------------------------------------------
+    // The root of each subtree replaces the node of its task and the rest of
+    // the subtree is appended, offsetting the indices of its children.
+    //--------------------------------------------------------------------------
+    for ( std::size_t i = 0; i < tasks.size(); i++ ) {
+        std::uint32_t base = static_cast<std::uint32_t>(this->nodes.size()) - 1u;
+        std::vector<MeshBvhNode>& subtree = subtrees[i];
+        for ( std::size_t n = 0; n < subtree.size(); n++ ) {
+            if ( subtree[n].count == 0u ) subtree[n].offset += base;
+        }
+
+        this->nodes[tasks[i].node] = subtree[0];
+        this->nodes.insert(this->nodes.end(), subtree.begin() + 1, subtree.end());
+        this->depth = std::max(this->depth, depths[i]);
+        std::vector<MeshBvhNode>().swap(subtree);
+    }
+
+    //--------------------------------------------------------------------------
+    // Triangles are stored in the order of the leaves that reference them.
+    //--------------------------------------------------------------------------
+    this->triangles.resize(bounds.size());
+    for ( std::size_t i = 0; i < bounds.size(); i++ ) {
+        const TriangleFace& face = faces[bounds[i].face];
+        const Vector3f& p0 = vertices[face[0]].position;
+        Vector3f edge1 = vertices[face[1]].position - p0;
+        Vector3f edge2 = vertices[face[2]].position - p0;
+        MeshBvhTriangle& triangle = this->triangles[i];
+        triangle.p0[0] = p0.x(); triangle.p0[1] = p0.y(); triangle.p0[2] = p0.z();
+        triangle.edge1[0] = edge1.x(); triangle.edge1[1] = edge1.y(); triangle.edge1[2] = edge1.z();
+        triangle.edge2[0] = edge2.x(); triangle.edge2[1] = edge2.y(); triangle.edge2[2] = edge2.z();
+        triangle.face = bounds[i].face;
+    }
+
+    return true;
+}
+
+void MeshBvh::clear() {
+    std::vector<MeshBvhNode>().swap(this->nodes);
+    std::vector<MeshBvhTriangle>().swap(this->triangles);
+    this->depth = 0u;
+}
+
+bool MeshBvh::intersect(const MeshRay& ray, MeshRayHit& hit) const {
+    hit.face = MESH_RAY_NO_HIT;
+    hit.distance = ray.maxDistance;
+    hit.u = 0.0f;
+    hit.v = 0.0f;
+    if ( this->nodes.size() == 0 ) return false;
+
+    float origin[3] = { ray.origin.x(), ray.origin.y(), ray.origin.z() };
+    float direction[3] = { ray.direction.x(), ray.direction.y(), ray.direction.z() };
+    float inverse[3] = { Bvh_Inverse(direction[0]), Bvh_Inverse(direction[1]), Bvh_Inverse(direction[2]) };
+
+    float entry = 0.0f;
+    if ( !Bvh_IntersectNode(this->nodes[0], origin, inverse, hit.distance, entry) ) return false;
+
+    //--------------------------------------------------------------------------
+    // Closer children are visited first; farther children are pushed and
+    // skipped once a hit closer than their entry distance is found.
+    //--------------------------------------------------------------------------
+    std::uint32_t stack[BVH_MAX_DEPTH + 1u];
+    float stackEntries[BVH_MAX_DEPTH + 1u];
+    std::size_t stackSize = 0u;
+    std::uint32_t nodeIndex = 0u;
+    while ( true ) {
+        const MeshBvhNode& node = this->nodes[nodeIndex];
+        if ( node.count != 0u ) {
+            for ( std::uint32_t i = node.offset; i < node.offset + node.count; i++ ) {
+                float t, u, v;
+                if ( !Bvh_IntersectTriangle(this->triangles[i], origin, direction, hit.distance, t, u, v) ) continue;
+                hit.face = this->triangles[i].face;
+                hit.distance = t;
+                hit.u = u;
+                hit.v = v;
+            }
+        }
+        else {
+            float entries[2];
+            bool bHits[2];
+            for ( unsigned int c = 0; c < 2; c++ ) bHits[c] = Bvh_IntersectNode(this->nodes[node.offset + c], origin, inverse, hit.distance, entries[c]);
+            if ( bHits[0] && bHits[1] ) {
+                unsigned int near = (entries[1] < entries[0]) ? 1u : 0u;
+                stack[stackSize] = node.offset + 1u - near;
+                stackEntries[stackSize++] = entries[1u - near];
+                nodeIndex = node.offset + near;
+                continue;
+            }
+
+            if ( bHits[0] || bHits[1] ) {
+                nodeIndex = node.offset + (bHits[0] ? 0u : 1u);
+                continue;
+            }
+        }
+
+        while ( stackSize > 0u && stackEntries[stackSize - 1u] > hit.distance ) stackSize--;
+        if ( stackSize == 0u ) break;
+        nodeIndex = stack[--stackSize];
+    }
+
+    return hit.face != MESH_RAY_NO_HIT;
+}
+
+#ifdef MESH_BVH_SSE2
+/* Returns a where mask is set and b elsewhere. */
+inline __m128 Bvh_Select(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+/* Origins, inverse directions, and closest hits of a packet of rays. */
+struct Bvh_Packet {
+    __m128 origin[3];
+    __m128 direction[3];
+    __m128 inverse[3];
+    __m128 closest;
+    __m128 face;
+    __m128 u;
+    __m128 v;
+};
+
+/* Returns the mask of the rays that enter the box of a node before their closest hit. */
+inline int Bvh_IntersectNode(const MeshBvhNode& node, const Bvh_Packet& packet, __m128& entry) {
+    __m128 tmin = _mm_setzero_ps();
+    __m128 tmax = packet.closest;
+    for ( unsigned int k = 0; k < 3; k++ ) {
+        __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMinimum[k]), packet.origin[k]), packet.inverse[k]);
+        __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.boundsMaximum[k]), packet.origin[k]), packet.inverse[k]);
+        tmin = _mm_max_ps(tmin, _mm_min_ps(t0, t1));
+        tmax = _mm_min_ps(tmax, _mm_max_ps(t0, t1));
+    }
+
+    __m128 mask = _mm_cmple_ps(tmin, tmax);
+    entry = Bvh_Select(mask, tmin, _mm_set1_ps(std::numeric_limits<float>::max()));
+    return _mm_movemask_ps(mask);
+}
+
+/* Returns the smallest lane of a register. */
+inline float Bvh_Minimum(__m128 value) {
+    value = _mm_min_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1)));
+    value = _mm_min_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_cvtss_f32(value);
+}
+
+/* Moller-Trumbore intersection of a packet of rays with a triangle. */
+inline void Bvh_IntersectTriangle(const MeshBvhTriangle& triangle, Bvh_Packet& packet) {
+    __m128 e1x = _mm_set1_ps(triangle.edge1[0]), e1y = _mm_set1_ps(triangle.edge1[1]), e1z = _mm_set1_ps(triangle.edge1[2]);
+    __m128 e2x = _mm_set1_ps(triangle.edge2[0]), e2y = _mm_set1_ps(triangle.edge2[1]), e2z = _mm_set1_ps(triangle.edge2[2]);
+    const __m128* d = packet.direction;
+    __m128 px = _mm_sub_ps(_mm_mul_ps(d[1], e2z), _mm_mul_ps(d[2], e2y));
+    __m128 py = _mm_sub_ps(_mm_mul_ps(d[2], e2x), _mm_mul_ps(d[0], e2z));
+    __m128 pz = _mm_sub_ps(_mm_mul_ps(d[0], e2y), _mm_mul_ps(d[1], e2x));
+    __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+    __m128 inverse = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+    __m128 sx = _mm_sub_ps(packet.origin[0], _mm_set1_ps(triangle.p0[0]));
+    __m128 sy = _mm_sub_ps(packet.origin[1], _mm_set1_ps(triangle.p0[1]));
+    __m128 sz = _mm_sub_ps(packet.origin[2], _mm_set1_ps(triangle.p0[2]));
+    __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), inverse);
+
+    __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+    __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+    __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+    __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(d[0], qx), _mm_mul_ps(d[1], qy)), _mm_mul_ps(d[2], qz)), inverse);
+    __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inverse);
+
+    __m128 zero = _mm_setzero_ps();
+    __m128 mask = _mm_cmpneq_ps(det, zero);
+    mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmpge_ps(v, zero)));
+    mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), _mm_set1_ps(1.0f)));
+    mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(t, zero), _mm_cmplt_ps(t, packet.closest)));
+    if ( _mm_movemask_ps(mask) == 0 ) return;
+
+    packet.closest = Bvh_Select(mask, t, packet.closest);
+    packet.face = Bvh_Select(mask, _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(triangle.face))), packet.face);
+    packet.u = Bvh_Select(mask, u, packet.u);
+    packet.v = Bvh_Select(mask, v, packet.v);
+}
+#endif
+
+void MeshBvh::intersectPacket(const MeshRay* rays, std::size_t rayCount, MeshRayHit* hits) const {
+#ifdef MESH_BVH_SSE2
+    //--------------------------------------------------------------------------
+    // Unused lanes of a partial packet have a negative closest distance, so
+    // they never enter a node or hit a face.
+    //--------------------------------------------------------------------------
+    float values[3][3][MESH_RAY_PACKET_SIZE] = { { { 0.0f } } };
+    float closest[MESH_RAY_PACKET_SIZE];
+    for ( std::size_t r = 0; r < MESH_RAY_PACKET_SIZE; r++ ) {
+        closest[r] = (r < rayCount) ? rays[r].maxDistance : -1.0f;
+        if ( r >= rayCount ) continue;
+        values[0][0][r] = rays[r].origin.x(); values[0][1][r] = rays[r].origin.y(); values[0][2][r] = rays[r].origin.z();
+        values[1][0][r] = rays[r].direction.x(); values[1][1][r] = rays[r].direction.y(); values[1][2][r] = rays[r].direction.z();
+        for ( unsigned int k = 0; k < 3; k++ ) values[2][k][r] = Bvh_Inverse(values[1][k][r]);
+    }
+
+    Bvh_Packet packet;
+    for ( unsigned int k = 0; k < 3; k++ ) {
+        packet.origin[k] = _mm_loadu_ps(values[0][k]);
+        packet.direction[k] = _mm_loadu_ps(values[1][k]);
+        packet.inverse[k] = _mm_loadu_ps(values[2][k]);
+    }
+
+    packet.closest = _mm_loadu_ps(closest);
+    packet.face = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(MESH_RAY_NO_HIT)));
+    packet.u = _mm_setzero_ps();
+    packet.v = _mm_setzero_ps();
+
+    //--------------------------------------------------------------------------
+    // A node is visited while any ray of the packet enters it; the child the
+    // rays enter first is visited first.
+    //--------------------------------------------------------------------------
+    __m128 entry;
+    if ( this->nodes.size() != 0 && Bvh_IntersectNode(this->nodes[0], packet, entry) != 0 ) {
+        std::uint32_t stack[BVH_MAX_DEPTH + 1u];
+        std::size_t stackSize = 0u;
+        std::uint32_t nodeIndex = 0u;
+        while ( true ) {
+            const MeshBvhNode& node = this->nodes[nodeIndex];
+            if ( node.count != 0u ) {
+                for ( std::uint32_t i = node.offset; i < node.offset + node.count; i++ ) Bvh_IntersectTriangle(this->triangles[i], packet);
+            }
+            else {
+                __m128 entries[2];
+                int masks[2];
+                for ( unsigned int c = 0; c < 2; c++ ) masks[c] = Bvh_IntersectNode(this->nodes[node.offset + c], packet, entries[c]);
+                if ( masks[0] != 0 && masks[1] != 0 ) {
+                    unsigned int near = (Bvh_Minimum(entries[1]) < Bvh_Minimum(entries[0])) ? 1u : 0u;
+                    stack[stackSize++] = node.offset + 1u - near;
+                    nodeIndex = node.offset + near;
+                    continue;
+                }
+
+                if ( masks[0] != 0 || masks[1] != 0 ) {
+                    nodeIndex = node.offset + (masks[0] != 0 ? 0u : 1u);
+                    continue;
+                }
+            }
+
+            if ( stackSize == 0u ) break;
+            nodeIndex = stack[--stackSize];
+        }
+    }
+
+    float faces[MESH_RAY_PACKET_SIZE], us[MESH_RAY_PACKET_SIZE], vs[MESH_RAY_PACKET_SIZE];
+    _mm_storeu_ps(closest, packet.closest);
+    _mm_storeu_ps(faces, packet.face);
+    _mm_storeu_ps(us, packet.u);
+    _mm_storeu_ps(vs, packet.v);
+    for ( std::size_t r = 0; r < rayCount; r++ ) {
+        std::memcpy(&hits[r].face, &faces[r], sizeof(std::uint32_t));
+        hits[r].distance = closest[r];
+        hits[r].u = us[r];
+        hits[r].v = vs[r];
+    }
+#else
+    for ( std::size_t r = 0; r < rayCount; r++ ) this->intersect(rays[r], hits[r]);
+#endif
+}
+
+std::size_t MeshBvh::intersect(const MeshRay* rays, std::size_t rayCount, MeshRayHit* hits) const {
+    std::size_t packetCount = (rayCount + MESH_RAY_PACKET_SIZE - 1u) / MESH_RAY_PACKET_SIZE;
+    std::size_t threadCount = (rayCount >= BVH_MIN_PARALLEL_RAYS) ? std::min(GetThreadCount(), packetCount) : 1u;
+    ParallelFor(threadCount, [&](std::size_t t) {
+        for ( std::size_t p = packetCount * t / threadCount; p < packetCount * (t + 1) / threadCount; p++ ) {
+            std::size_t first = p * MESH_RAY_PACKET_SIZE;
+            this->intersectPacket(rays + first, std::min(MESH_RAY_PACKET_SIZE, rayCount - first), hits + first);
+        }
+    });
+
+    std::size_t hitCount = 0u;
+    for ( std::size_t r = 0; r < rayCount; r++ )
+        if ( hits[r].face != MESH_RAY_NO_HIT ) hitCount++;
+    return hitCount;
+}
+
+bool MeshBvh::isEmpty() const {
+    return this->nodes.size() == 0;
+}
+
+std::size_t MeshBvh::getNodeCount() const {
+    return this->nodes.size();
+}
+
+std::size_t MeshBvh::getDepth() const {
+    return this->depth;
+}
+
+const std::vector<MeshBvhNode>& MeshBvh::getNodes() const {
+    return this->nodes;
+}
+
+const std::vector<MeshBvhTriangle>& MeshBvh::getTriangles() const {
+    return this->triangles;
+}
+
+}
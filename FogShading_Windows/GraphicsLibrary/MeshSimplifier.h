@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include <vector>
+#include <cstdint>
+#include <Mathematics.h>
+#include "Vertex.h"
+#include "Face.h"
+
+namespace sgpu {
+
+/* Most simplified levels built by BuildMeshLods. */
+const std::size_t MESH_LOD_MAX_LEVELS = 5u;
+
+/* Face count of each level of detail relative to the previous level. */
+const float MESH_LOD_REDUCTION = 0.5f;
+
+/* Fewest faces of a level of detail. */
+const std::size_t MESH_LOD_MIN_FACES = 32u;
+
+/* Simplified level of detail of a mesh (see BuildMeshLods). */
+struct MeshLod {
+    /* Object space error of the level (see SimplifyMesh). */
+    float error;
+
+    /* Face ranges of the level, one for each sub-mesh of the mesh in order. */
+    std::vector<SubMesh> subMeshes;
+};
+
+/* Levels of detail of a mesh and the bounds of its vertex positions. */
+struct MeshLodChain {
+    Vector3f boundsMinimum;
+    Vector3f boundsMaximum;
+
+    /* Levels of increasing error; the mesh itself is not a level. */
+    std::vector<MeshLod> levels;
+};
+
+/*
+ * Simplifies each sub-mesh of a mesh to about ratio of its faces by
+ * collapsing edges in the order of their quadric error (Garland and
+ * Heckbert, "Surface Simplification Using Quadric Error Metrics"). Vertices
+ * collapse onto a neighboring vertex, so the simplified faces index the
+ * original vertices. Vertices that share a position but differ in their
+ * attributes (UV seams and hard normals) collapse only along their seam,
+ * border vertices only along their border, and vertices shared by several
+ * sub-meshes stay in place so the sub-meshes keep meeting. Collapses that
+ * turn a face over are rejected.
+ *
+ * @param ratio - The fraction of the faces of each sub-mesh to keep.
+ * @param simplifiedFaces - Receives the faces of the simplified sub-meshes.
+ * @param simplifiedSubMeshes - Receives the sub-meshes in order with their
+ * face ranges within simplifiedFaces.
+ *
+ * @return Returns the error of the simplification: the largest root mean
+ * square distance of a collapsed vertex from the planes of its faces.
+ */
+float SimplifyMesh(const std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces, const std::vector<SubMesh>& subMeshes, float ratio, std::vector<TriangleFace>& simplifiedFaces, std::vector<SubMesh>& simplifiedSubMeshes);
+
+/*
+ * Builds up to MESH_LOD_MAX_LEVELS levels of detail of a mesh, each with
+ * MESH_LOD_REDUCTION of the faces of the previous level. Every level is
+ * simplified from the mesh itself on its own thread (see SimplifyMesh) and
+ * appended to the faces of the mesh, ordered for the vertex cache, so all
+ * levels are drawn from the same vertex and index buffers. Levels that
+ * barely reduce the previous level are dropped.
+ */
+void BuildMeshLods(const std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces, const std::vector<SubMesh>& subMeshes, MeshLodChain& chain);
+
+}
+
+#endif
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MESH_CONNECTIVITY_H
+#define MESH_CONNECTIVITY_H
+
+#include <vector>
+#include <cstdint>
+#include <Mathematics.h>
+#include "Vertex.h"
+#include "Face.h"
+
+namespace sgpu {
+
+/* Corner of a MeshConnectivity query that does not exist (ex. across a boundary). */
+const std::uint32_t MESH_CORNER_NONE = 0xFFFFFFFFu;
+
+/* Number of indices per face of an adjacency index buffer (GL_TRIANGLES_ADJACENCY). */
+const std::size_t MESH_ADJACENCY_FACE_INDEX_COUNT = 6u;
+
+/*
+ * Corner table of the faces of a mesh for neighbor queries in constant time.
+ * Corner 3 * f + k is the corner of face f at its k-th vertex. Besides the
+ * vertex of every corner, the table stores the opposite corner: the corner of
+ * the neighboring face across the edge that faces the corner. Walking from
+ * corner to corner (next, previous, getOpposite, and getSwing) visits the
+ * faces around an edge or a vertex without searching.
+ *
+ * Edges are matched by the positions of their vertices, so faces split by a
+ * normal or texture-coord seam remain neighbors. An edge has neighbors only
+ * if exactly two faces share it in opposite directions; open, non-manifold,
+ * and inconsistently oriented edges are boundaries.
+ */
+class MeshConnectivity {
+public:
+    MeshConnectivity();
+
+    /*
+     * Builds the corner table of the provided faces, replacing any previous
+     * table. The edges of large meshes are matched on several threads.
+     *
+     * @return If the faces reference valid vertices then this function will
+     * return true; otherwise it will return false and the table is empty.
+     */
+    bool build(const Vertex* vertices, std::size_t vertexCount, const TriangleFace* faces, std::size_t faceCount);
+
+    /* Releases the table. */
+    void clear();
+
+    /*
+     * Writes MESH_ADJACENCY_FACE_INDEX_COUNT indices per face for drawing the
+     * faces as GL_TRIANGLES_ADJACENCY: the vertices of the face interleaved
+     * with the vertex across each of its edges (see getNeighbor). A boundary
+     * edge repeats the opposite vertex of the face itself, which a geometry
+     * shader sees as a neighbor facing the other way (ex. open edges belong
+     * to the silhouette).
+     */
+    void getAdjacencyIndices(std::uint32_t* indices) const;
+
+    /* Returns the next corner of the face of a corner (counter-clockwise). */
+    static std::uint32_t next(std::uint32_t corner);
+
+    /* Returns the previous corner of the face of a corner. */
+    static std::uint32_t previous(std::uint32_t corner);
+
+    /* Returns the face of a corner. */
+    static std::uint32_t getFace(std::uint32_t corner);
+
+    /*
+     * Returns the corner across the edge that faces a corner, or
+     * MESH_CORNER_NONE for a boundary edge.
+     */
+    std::uint32_t getOpposite(std::uint32_t corner) const;
+
+    /*
+     * Returns the corner at the same position as a corner in the next face
+     * counter-clockwise around it, or MESH_CORNER_NONE at a boundary.
+     */
+    std::uint32_t getSwing(std::uint32_t corner) const;
+
+    /*
+     * Returns the face across edge k of a face (from its k-th to its next
+     * vertex), or MESH_CORNER_NONE for a boundary edge.
+     */
+    std::uint32_t getNeighbor(std::uint32_t face, unsigned int edge) const;
+
+    /*
+     * Returns a corner of a vertex, or MESH_CORNER_NONE if no face uses it.
+     * At a boundary this is the first corner of a counter-clockwise swing.
+     */
+    std::uint32_t getVertexCorner(std::uint32_t vertex) const;
+
+    std::uint32_t getVertex(std::uint32_t corner) const;
+    bool isBoundary(std::uint32_t corner) const;
+    bool isEmpty() const;
+    std::size_t getCornerCount() const;
+    std::size_t getFaceCount() const;
+    std::size_t getBoundaryEdgeCount() const;
+
+protected:
+    std::vector<std::uint32_t> cornerVertices;
+    std::vector<std::uint32_t> opposites;
+    std::vector<std::uint32_t> vertexCorners;
+    std::size_t boundaryEdgeCount;
+};
+
+}
+
+#endif
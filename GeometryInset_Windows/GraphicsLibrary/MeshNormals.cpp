@@ -0,0 +1,491 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "MeshNormals.h"
+#include "ParallelFor.h"
+#include <iostream>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MESH_NORMALS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace sgpu {
+
+/* Number of faces or vertices processed together by the SIMD kernels. */
+static const std::size_t NORMALS_BATCH_SIZE = 4u;
+
+/* Smallest number of faces worth processing on several threads. */
+static const std::size_t NORMALS_MIN_PARALLEL_FACES = 1u << 14;
+
+/* Tolerance of the up and down normals that receive a fallback tangent. */
+static const float NORMALS_FALLBACK_TOLERANCE = 1.0e-4f;
+
+/* Structure-of-arrays batch of vectors: one vector per lane. */
+struct Normals_Batch {
+    void set(std::size_t lane, const Vector3f& v) {
+        this->x[lane] = v.x();
+        this->y[lane] = v.y();
+        this->z[lane] = v.z();
+    }
+
+    Vector3f get(std::size_t lane) const {
+        return Vector3f(this->x[lane], this->y[lane], this->z[lane]);
+    }
+
+    float x[NORMALS_BATCH_SIZE];
+    float y[NORMALS_BATCH_SIZE];
+    float z[NORMALS_BATCH_SIZE];
+};
+
+/* Returns the number of threads used for the provided number of faces. */
+inline std::size_t Normals_ThreadCount(std::size_t faceCount) {
+    return (faceCount >= NORMALS_MIN_PARALLEL_FACES) ? GetThreadCount() : 1u;
+}
+
+/* Runs function(begin, end) on a slice of whole batches of [0, count) per thread. */
+template <typename Function>
+void Normals_ParallelBatches(std::size_t count, std::size_t threadCount, Function function) {
+    std::size_t batchCount = (count + NORMALS_BATCH_SIZE - 1u) / NORMALS_BATCH_SIZE;
+    ParallelFor(threadCount, [&](std::size_t t) {
+        function(batchCount * t / threadCount * NORMALS_BATCH_SIZE, std::min(count, batchCount * (t + 1) / threadCount * NORMALS_BATCH_SIZE));
+    });
+}
+
+/*
+ * Runs function(corner, vertex) for every face corner. Each thread owns a
+ * range of the vertices; the corners are first partitioned by the owner of
+ * their vertex (see ParallelPartition), so each thread only visits its own
+ * corners, in order. The faces of a vertex are summed in face order
+ * whatever the number of threads.
+ */
+template <typename Function>
+void Normals_ForEachCorner(const unsigned int* indices, std::size_t cornerCount, std::size_t vertexCount, std::size_t threadCount, Function function) {
+    std::vector<std::uint32_t> corners;
+    std::vector<std::size_t> offsets;
+    ParallelPartition(cornerCount, threadCount, threadCount, [&](std::size_t i) { return indices[i] * threadCount / vertexCount; }, corners, offsets);
+
+    ParallelFor(threadCount, [&](std::size_t t) {
+        for ( std::size_t c = offsets[t]; c < offsets[t + 1u]; c++ ) function(corners[c], indices[corners[c]]);
+    });
+}
+
+/* Stores the difference of two vectors into a lane of a batch. */
+inline void Normals_SetEdge(Normals_Batch& edge, std::size_t lane, const Vector3f& from, const Vector3f& to) {
+    edge.x[lane] = to.x() - from.x();
+    edge.y[lane] = to.y() - from.y();
+    edge.z[lane] = to.z() - from.z();
+}
+
+#ifdef MESH_NORMALS_SSE2
+/* Returns the dot products of the lanes of two batches. */
+inline __m128 Normals_Dot(__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz) {
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+}
+
+/* Returns 1 / sqrt(value), or 0 for lanes where value is 0. */
+inline __m128 Normals_InverseSqrt(__m128 value) {
+    __m128 root = _mm_sqrt_ps(value);
+    return _mm_and_ps(_mm_cmpgt_ps(root, _mm_setzero_ps()), _mm_div_ps(_mm_set1_ps(1.0f), root));
+}
+#else
+/* Returns 1 / sqrt(value), or 0 if value is 0. */
+inline float Normals_InverseSqrt(float value) {
+    float root = std::sqrt(value);
+    return (root > 0.0f) ? 1.0f / root : 0.0f;
+}
+#endif
+
+/*
+ * Normals of a batch of faces with the edges a = p1 - p0, b = p2 - p0, and
+ * c = p2 - p1: the cross product of a and b, normalized unless weighted by
+ * area. Angle weighting also receives the cosine of the angle at each corner.
+ */
+void Normals_FaceKernel(const Normals_Batch& a, const Normals_Batch& b, const Normals_Batch& c, MeshNormalWeighting weighting, Normals_Batch& normal, float (&cosines)[TRIANGLE_EDGE_COUNT][NORMALS_BATCH_SIZE]) {
+#ifdef MESH_NORMALS_SSE2
+    __m128 ax = _mm_loadu_ps(a.x), ay = _mm_loadu_ps(a.y), az = _mm_loadu_ps(a.z);
+    __m128 bx = _mm_loadu_ps(b.x), by = _mm_loadu_ps(b.y), bz = _mm_loadu_ps(b.z);
+    __m128 nx = _mm_sub_ps(_mm_mul_ps(ay, bz), _mm_mul_ps(az, by));
+    __m128 ny = _mm_sub_ps(_mm_mul_ps(az, bx), _mm_mul_ps(ax, bz));
+    __m128 nz = _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(ay, bx));
+    if ( weighting != MESH_NORMAL_AREA ) {
+        __m128 inverseLength = Normals_InverseSqrt(Normals_Dot(nx, ny, nz, nx, ny, nz));
+        nx = _mm_mul_ps(nx, inverseLength);
+        ny = _mm_mul_ps(ny, inverseLength);
+        nz = _mm_mul_ps(nz, inverseLength);
+    }
+
+    _mm_storeu_ps(normal.x, nx);
+    _mm_storeu_ps(normal.y, ny);
+    _mm_storeu_ps(normal.z, nz);
+    if ( weighting != MESH_NORMAL_ANGLE ) return;
+
+    __m128 cx = _mm_loadu_ps(c.x), cy = _mm_loadu_ps(c.y), cz = _mm_loadu_ps(c.z);
+    __m128 inverseA = Normals_InverseSqrt(Normals_Dot(ax, ay, az, ax, ay, az));
+    __m128 inverseB = Normals_InverseSqrt(Normals_Dot(bx, by, bz, bx, by, bz));
+    __m128 inverseC = Normals_InverseSqrt(Normals_Dot(cx, cy, cz, cx, cy, cz));
+    _mm_storeu_ps(cosines[A], _mm_mul_ps(Normals_Dot(ax, ay, az, bx, by, bz), _mm_mul_ps(inverseA, inverseB)));
+    _mm_storeu_ps(cosines[B], _mm_mul_ps(Normals_Dot(ax, ay, az, cx, cy, cz), _mm_mul_ps(_mm_set1_ps(-1.0f), _mm_mul_ps(inverseA, inverseC))));
+    _mm_storeu_ps(cosines[C], _mm_mul_ps(Normals_Dot(bx, by, bz, cx, cy, cz), _mm_mul_ps(inverseB, inverseC)));
+#else
+    for ( std::size_t lane = 0; lane < NORMALS_BATCH_SIZE; lane++ ) {
+        float nx = a.y[lane] * b.z[lane] - a.z[lane] * b.y[lane];
+        float ny = a.z[lane] * b.x[lane] - a.x[lane] * b.z[lane];
+        float nz = a.x[lane] * b.y[lane] - a.y[lane] * b.x[lane];
+        float inverseLength = (weighting != MESH_NORMAL_AREA) ? Normals_InverseSqrt(nx * nx + ny * ny + nz * nz) : 1.0f;
+        normal.x[lane] = nx * inverseLength;
+        normal.y[lane] = ny * inverseLength;
+        normal.z[lane] = nz * inverseLength;
+        if ( weighting != MESH_NORMAL_ANGLE ) continue;
+
+        float inverseA = Normals_InverseSqrt(a.x[lane] * a.x[lane] + a.y[lane] * a.y[lane] + a.z[lane] * a.z[lane]);
+        float inverseB = Normals_InverseSqrt(b.x[lane] * b.x[lane] + b.y[lane] * b.y[lane] + b.z[lane] * b.z[lane]);
+        float inverseC = Normals_InverseSqrt(c.x[lane] * c.x[lane] + c.y[lane] * c.y[lane] + c.z[lane] * c.z[lane]);
+        cosines[A][lane] = (a.x[lane] * b.x[lane] + a.y[lane] * b.y[lane] + a.z[lane] * b.z[lane]) * (inverseA * inverseB);
+        cosines[B][lane] = (a.x[lane] * c.x[lane] + a.y[lane] * c.y[lane] + a.z[lane] * c.z[lane]) * -(inverseA * inverseC);
+        cosines[C][lane] = (b.x[lane] * c.x[lane] + b.y[lane] * c.y[lane] + b.z[lane] * c.z[lane]) * (inverseB * inverseC);
+    }
+#endif
+}
+
+/* Normalizes a vector of three floats in place (a zero vector stays zero). */
+inline void Normals_Normalize(float* v) {
+    float lengthSquared = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+    float inverseLength = (lengthSquared > 0.0f) ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+    v[0] *= inverseLength;
+    v[1] *= inverseLength;
+    v[2] *= inverseLength;
+}
+
+/*
+ * Normalizes four consecutive vectors of three floats in place. The lengths
+ * are computed on the transposed vectors and the scales are shuffled back to
+ * the interleaved layout, so the vectors are never transposed back.
+ */
+void Normals_NormalizeKernel(float* v) {
+#ifdef MESH_NORMALS_SSE2
+    __m128 m0 = _mm_loadu_ps(v + 0);    // x0 y0 z0 x1
+    __m128 m1 = _mm_loadu_ps(v + 4);    // y1 z1 x2 y2
+    __m128 m2 = _mm_loadu_ps(v + 8);    // z2 x3 y3 z3
+    __m128 x2y2x3y3 = _mm_shuffle_ps(m1, m2, _MM_SHUFFLE(2, 1, 3, 2));
+    __m128 y0z0y1z1 = _mm_shuffle_ps(m0, m1, _MM_SHUFFLE(1, 0, 2, 1));
+    __m128 x = _mm_shuffle_ps(m0, x2y2x3y3, _MM_SHUFFLE(2, 0, 3, 0));
+    __m128 y = _mm_shuffle_ps(y0z0y1z1, x2y2x3y3, _MM_SHUFFLE(3, 1, 2, 0));
+    __m128 z = _mm_shuffle_ps(y0z0y1z1, m2, _MM_SHUFFLE(3, 0, 3, 1));
+
+    __m128 scale = Normals_InverseSqrt(Normals_Dot(x, y, z, x, y, z));
+    _mm_storeu_ps(v + 0, _mm_mul_ps(m0, _mm_shuffle_ps(scale, scale, _MM_SHUFFLE(1, 0, 0, 0))));
+    _mm_storeu_ps(v + 4, _mm_mul_ps(m1, _mm_shuffle_ps(scale, scale, _MM_SHUFFLE(2, 2, 1, 1))));
+    _mm_storeu_ps(v + 8, _mm_mul_ps(m2, _mm_shuffle_ps(scale, scale, _MM_SHUFFLE(3, 3, 3, 2))));
+#else
+    for ( std::size_t lane = 0; lane < NORMALS_BATCH_SIZE; lane++ ) Normals_Normalize(v + lane * 3);
+#endif
+}
+
+bool CalculateNormals(const std::vector<unsigned int>& indices, const std::vector<Vector3f>& vertices, std::vector<Vector3f>& normals, MeshNormalWeighting weighting) {
+    static_assert(sizeof(Vector3f) == 3 * sizeof(float), "[MeshNormals] Error: Vector3f must be 3 tightly packed floats.");
+
+    if ( vertices.size() == 0 ) {
+        std::cerr << "[Mesh:calculateNormals] Error: Vertex array of length 0." << std::endl;
+        return false;
+    }
+
+    if ( indices.size() < TRIANGLE_EDGE_COUNT ) {
+        std::cerr << "[Mesh:calculateNormals] Error: Face count = 0." << std::endl;
+        return false;
+    }
+
+    std::size_t faceCount = indices.size() / TRIANGLE_EDGE_COUNT;
+    std::size_t threadCount = Normals_ThreadCount(faceCount);
+
+    //--------------------------------------------------------------------------
+    // Face normals (and the angles of their corners for angle weighting). A
+    // single thread adds them to the sums of their vertices right away; with
+    // several threads they are stored and each thread sums its own vertices.
+    //--------------------------------------------------------------------------
+    bool bDirect = (threadCount == 1u);
+    std::vector<Vector3f> sums(vertices.size());
+    float* sumData = reinterpret_cast<float*>(sums.data());
+    std::vector<Vector3f> faceNormals(bDirect ? 0u : faceCount);
+    std::vector<float> angles((!bDirect && weighting == MESH_NORMAL_ANGLE) ? faceCount * TRIANGLE_EDGE_COUNT : 0u);
+    Normals_ParallelBatches(faceCount, threadCount, [&](std::size_t begin, std::size_t end) {
+        Normals_Batch a = {}, b = {}, c = {}, normal;
+        float cosines[TRIANGLE_EDGE_COUNT][NORMALS_BATCH_SIZE];
+        for ( std::size_t f = begin; f < end; f += NORMALS_BATCH_SIZE ) {
+            std::size_t laneCount = std::min(NORMALS_BATCH_SIZE, end - f);
+            for ( std::size_t lane = 0; lane < NORMALS_BATCH_SIZE; lane++ ) {
+                const unsigned int* face = indices.data() + std::min(f + lane, end - 1u) * TRIANGLE_EDGE_COUNT;
+                Normals_SetEdge(a, lane, vertices[face[A]], vertices[face[B]]);
+                Normals_SetEdge(b, lane, vertices[face[A]], vertices[face[C]]);
+                Normals_SetEdge(c, lane, vertices[face[B]], vertices[face[C]]);
+            }
+
+            Normals_FaceKernel(a, b, c, weighting, normal, cosines);
+            for ( std::size_t lane = 0; lane < laneCount; lane++ ) {
+                const unsigned int* face = indices.data() + (f + lane) * TRIANGLE_EDGE_COUNT;
+                float weights[TRIANGLE_EDGE_COUNT] = { 1.0f, 1.0f, 1.0f };
+                if ( weighting == MESH_NORMAL_ANGLE ) {
+                    for ( unsigned int k = 0; k < TRIANGLE_EDGE_COUNT; k++ ) weights[k] = std::acos(std::max(-1.0f, std::min(1.0f, cosines[k][lane])));
+                }
+
+                if ( bDirect ) {
+                    for ( unsigned int k = 0; k < TRIANGLE_EDGE_COUNT; k++ ) {
+                        float* sum = sumData + face[k] * 3u;
+                        sum[0] += normal.x[lane] * weights[k];
+                        sum[1] += normal.y[lane] * weights[k];
+                        sum[2] += normal.z[lane] * weights[k];
+                    }
+                    continue;
+                }
+
+                faceNormals[f + lane] = normal.get(lane);
+                if ( weighting == MESH_NORMAL_ANGLE ) std::copy(weights, weights + TRIANGLE_EDGE_COUNT, angles.begin() + (f + lane) * TRIANGLE_EDGE_COUNT);
+            }
+        }
+    });
+
+    if ( !bDirect ) {
+        Normals_ForEachCorner(indices.data(), faceCount * TRIANGLE_EDGE_COUNT, vertices.size(), threadCount, [&](std::size_t corner, unsigned int vertex) {
+            if ( weighting == MESH_NORMAL_ANGLE ) sums[vertex] += faceNormals[corner / TRIANGLE_EDGE_COUNT] * angles[corner];
+            else sums[vertex] += faceNormals[corner / TRIANGLE_EDGE_COUNT];
+        });
+    }
+
+    //--------------------------------------------------------------------------
+    // Normalize the sums of the vertices.
+    //--------------------------------------------------------------------------
+    Normals_ParallelBatches(sums.size(), threadCount, [&](std::size_t begin, std::size_t end) {
+        std::size_t i = begin;
+        for ( ; i + NORMALS_BATCH_SIZE <= end; i += NORMALS_BATCH_SIZE ) Normals_NormalizeKernel(sumData + i * 3);
+        for ( ; i < end; i++ ) Normals_Normalize(sumData + i * 3);
+    });
+
+    normals.swap(sums);
+    return true;
+}
+
+/*
+ * Tangent (s) and bitangent (t) directions of a batch of faces from the
+ * position edges e1 = p1 - p0 and e2 = p2 - p0 and the texture-coord edges
+ * w1 and w2. Faces whose texture-coords are degenerate receive zero.
+ */
+void Normals_TangentKernel(const Normals_Batch& e1, const Normals_Batch& e2, const Normals_Batch& w1, const Normals_Batch& w2, Normals_Batch& s, Normals_Batch& t) {
+#ifdef MESH_NORMALS_SSE2
+    __m128 s1 = _mm_loadu_ps(w1.x), t1 = _mm_loadu_ps(w1.y);
+    __m128 s2 = _mm_loadu_ps(w2.x), t2 = _mm_loadu_ps(w2.y);
+    __m128 determinant = _mm_sub_ps(_mm_mul_ps(s1, t2), _mm_mul_ps(s2, t1));
+    __m128 r = _mm_and_ps(_mm_cmpneq_ps(determinant, _mm_setzero_ps()), _mm_div_ps(_mm_set1_ps(1.0f), determinant));
+
+    __m128 ax = _mm_loadu_ps(e1.x), ay = _mm_loadu_ps(e1.y), az = _mm_loadu_ps(e1.z);
+    __m128 bx = _mm_loadu_ps(e2.x), by = _mm_loadu_ps(e2.y), bz = _mm_loadu_ps(e2.z);
+    _mm_storeu_ps(s.x, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(t2, ax), _mm_mul_ps(t1, bx)), r));
+    _mm_storeu_ps(s.y, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(t2, ay), _mm_mul_ps(t1, by)), r));
+    _mm_storeu_ps(s.z, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(t2, az), _mm_mul_ps(t1, bz)), r));
+    _mm_storeu_ps(t.x, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(s1, bx), _mm_mul_ps(s2, ax)), r));
+    _mm_storeu_ps(t.y, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(s1, by), _mm_mul_ps(s2, ay)), r));
+    _mm_storeu_ps(t.z, _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(s1, bz), _mm_mul_ps(s2, az)), r));
+#else
+    for ( std::size_t lane = 0; lane < NORMALS_BATCH_SIZE; lane++ ) {
+        float determinant = w1.x[lane] * w2.y[lane] - w2.x[lane] * w1.y[lane];
+        float r = (determinant != 0.0f) ? 1.0f / determinant : 0.0f;
+        s.x[lane] = (w2.y[lane] * e1.x[lane] - w1.y[lane] * e2.x[lane]) * r;
+        s.y[lane] = (w2.y[lane] * e1.y[lane] - w1.y[lane] * e2.y[lane]) * r;
+        s.z[lane] = (w2.y[lane] * e1.z[lane] - w1.y[lane] * e2.z[lane]) * r;
+        t.x[lane] = (w1.x[lane] * e2.x[lane] - w2.x[lane] * e1.x[lane]) * r;
+        t.y[lane] = (w1.x[lane] * e2.y[lane] - w2.x[lane] * e1.y[lane]) * r;
+        t.z[lane] = (w1.x[lane] * e2.z[lane] - w2.x[lane] * e1.z[lane]) * r;
+    }
+#endif
+}
+
+/*
+ * Orthogonalizes a batch of tangent sums t against the normals n (Gram-
+ * Schmidt) and normalizes them in place. The handedness receives the sign of
+ * dot(cross(n, t), b) for the bitangent sums b.
+ */
+void Normals_OrthogonalizeKernel(const Normals_Batch& n, Normals_Batch& t, const Normals_Batch& b, float* handedness) {
+#ifdef MESH_NORMALS_SSE2
+    __m128 nx = _mm_loadu_ps(n.x), ny = _mm_loadu_ps(n.y), nz = _mm_loadu_ps(n.z);
+    __m128 tx = _mm_loadu_ps(t.x), ty = _mm_loadu_ps(t.y), tz = _mm_loadu_ps(t.z);
+    __m128 d = Normals_Dot(nx, ny, nz, tx, ty, tz);
+    __m128 ox = _mm_sub_ps(tx, _mm_mul_ps(nx, d));
+    __m128 oy = _mm_sub_ps(ty, _mm_mul_ps(ny, d));
+    __m128 oz = _mm_sub_ps(tz, _mm_mul_ps(nz, d));
+    __m128 inverseLength = Normals_InverseSqrt(Normals_Dot(ox, oy, oz, ox, oy, oz));
+    _mm_storeu_ps(t.x, _mm_mul_ps(ox, inverseLength));
+    _mm_storeu_ps(t.y, _mm_mul_ps(oy, inverseLength));
+    _mm_storeu_ps(t.z, _mm_mul_ps(oz, inverseLength));
+
+    __m128 cx = _mm_sub_ps(_mm_mul_ps(ny, tz), _mm_mul_ps(nz, ty));
+    __m128 cy = _mm_sub_ps(_mm_mul_ps(nz, tx), _mm_mul_ps(nx, tz));
+    __m128 cz = _mm_sub_ps(_mm_mul_ps(nx, ty), _mm_mul_ps(ny, tx));
+    __m128 negative = _mm_cmplt_ps(Normals_Dot(cx, cy, cz, _mm_loadu_ps(b.x), _mm_loadu_ps(b.y), _mm_loadu_ps(b.z)), _mm_setzero_ps());
+    _mm_storeu_ps(handedness, _mm_or_ps(_mm_and_ps(negative, _mm_set1_ps(-1.0f)), _mm_andnot_ps(negative, _mm_set1_ps(1.0f))));
+#else
+    for ( std::size_t lane = 0; lane < NORMALS_BATCH_SIZE; lane++ ) {
+        float cx = n.y[lane] * t.z[lane] - n.z[lane] * t.y[lane];
+        float cy = n.z[lane] * t.x[lane] - n.x[lane] * t.z[lane];
+        float cz = n.x[lane] * t.y[lane] - n.y[lane] * t.x[lane];
+        handedness[lane] = (cx * b.x[lane] + cy * b.y[lane] + cz * b.z[lane] < 0.0f) ? -1.0f : 1.0f;
+
+        float d = n.x[lane] * t.x[lane] + n.y[lane] * t.y[lane] + n.z[lane] * t.z[lane];
+        float ox = t.x[lane] - n.x[lane] * d;
+        float oy = t.y[lane] - n.y[lane] * d;
+        float oz = t.z[lane] - n.z[lane] * d;
+        float inverseLength = Normals_InverseSqrt(ox * ox + oy * oy + oz * oz);
+        t.x[lane] = ox * inverseLength;
+        t.y[lane] = oy * inverseLength;
+        t.z[lane] = oz * inverseLength;
+    }
+#endif
+}
+
+/* Stores the tangent and bitangent directions of a lane (sx sy sz tx ty tz). */
+inline void Normals_SetDirections(float* directions, const Normals_Batch& s, const Normals_Batch& t, std::size_t lane) {
+    directions[0] = s.x[lane];
+    directions[1] = s.y[lane];
+    directions[2] = s.z[lane];
+    directions[3] = t.x[lane];
+    directions[4] = t.y[lane];
+    directions[5] = t.z[lane];
+}
+
+/* Adds the tangent and bitangent directions of a lane to the sums of a vertex. */
+inline void Normals_AddDirections(float* sum, const Normals_Batch& s, const Normals_Batch& t, std::size_t lane) {
+    sum[0] += s.x[lane];
+    sum[1] += s.y[lane];
+    sum[2] += s.z[lane];
+    sum[3] += t.x[lane];
+    sum[4] += t.y[lane];
+    sum[5] += t.z[lane];
+}
+
+/* http://www.terathon.com/code/tangent.html */
+bool CalculateTangents(std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces) {
+    static_assert(sizeof(TriangleFace) == TRIANGLE_EDGE_COUNT * sizeof(unsigned int), "[MeshNormals] Error: TriangleFace must be tightly packed.");
+
+    if ( vertices.size() == 0 ) {
+        std::cerr << "[Mesh:calculateTangents] Error: Vertex array of length 0." << std::endl;
+        return false;
+    }
+
+    if ( faces.size() == 0 ) {
+        std::cerr << "[Mesh:calculateTangents] Error: Face count = 0." << std::endl;
+        return false;
+    }
+
+    std::size_t faceCount = faces.size();
+    std::size_t threadCount = Normals_ThreadCount(faceCount);
+    const unsigned int* indices = reinterpret_cast<const unsigned int*>(faces.data());
+
+    //--------------------------------------------------------------------------
+    // Tangent (s) and bitangent (t) directions of the faces, summed per vertex
+    // like the face normals in CalculateNormals. Both sums of a vertex are
+    // interleaved (sx sy sz tx ty tz), so a face corner touches one of them.
+    //--------------------------------------------------------------------------
+    bool bDirect = (threadCount == 1u);
+    std::vector<float> sums(vertices.size() * 6u, 0.0f);
+    std::vector<float> directions(bDirect ? 0u : faceCount * 6u);
+    Normals_ParallelBatches(faceCount, threadCount, [&](std::size_t begin, std::size_t end) {
+        Normals_Batch e1 = {}, e2 = {}, w1 = {}, w2 = {}, s, t;
+        for ( std::size_t f = begin; f < end; f += NORMALS_BATCH_SIZE ) {
+            std::size_t laneCount = std::min(NORMALS_BATCH_SIZE, end - f);
+            for ( std::size_t lane = 0; lane < NORMALS_BATCH_SIZE; lane++ ) {
+                const unsigned int* face = indices + std::min(f + lane, end - 1u) * TRIANGLE_EDGE_COUNT;
+                const Vertex& v0 = vertices[face[A]];
+                const Vertex& v1 = vertices[face[B]];
+                const Vertex& v2 = vertices[face[C]];
+                Normals_SetEdge(e1, lane, v0.position, v1.position);
+                Normals_SetEdge(e2, lane, v0.position, v2.position);
+                Normals_SetEdge(w1, lane, v0.textureCoord, v1.textureCoord);
+                Normals_SetEdge(w2, lane, v0.textureCoord, v2.textureCoord);
+            }
+
+            Normals_TangentKernel(e1, e2, w1, w2, s, t);
+            for ( std::size_t lane = 0; lane < laneCount; lane++ ) {
+                if ( !bDirect ) {
+                    Normals_SetDirections(directions.data() + (f + lane) * 6u, s, t, lane);
+                    continue;
+                }
+
+                for ( unsigned int k = 0; k < TRIANGLE_EDGE_COUNT; k++ )
+                    Normals_AddDirections(sums.data() + indices[(f + lane) * TRIANGLE_EDGE_COUNT + k] * 6u, s, t, lane);
+            }
+        }
+    });
+
+    if ( !bDirect ) {
+        Normals_ForEachCorner(indices, faceCount * TRIANGLE_EDGE_COUNT, vertices.size(), threadCount, [&](std::size_t corner, unsigned int vertex) {
+            float* sum = sums.data() + vertex * 6u;
+            const float* direction = directions.data() + corner / TRIANGLE_EDGE_COUNT * 6u;
+            sum[0] += direction[0];
+            sum[1] += direction[1];
+            sum[2] += direction[2];
+            sum[3] += direction[3];
+            sum[4] += direction[4];
+            sum[5] += direction[5];
+        });
+    }
+
+    //--------------------------------------------------------------------------
+    // Vertices whose tangent vanishes keep the x-axis if their normal points
+    // straight up or down.
+    //--------------------------------------------------------------------------
+    Normals_ParallelBatches(vertices.size(), threadCount, [&](std::size_t begin, std::size_t end) {
+        Normals_Batch n = {}, t = {}, b = {};
+        float handedness[NORMALS_BATCH_SIZE];
+        for ( std::size_t i = begin; i < end; i += NORMALS_BATCH_SIZE ) {
+            std::size_t laneCount = std::min(NORMALS_BATCH_SIZE, end - i);
+            for ( std::size_t lane = 0; lane < NORMALS_BATCH_SIZE; lane++ ) {
+                std::size_t vertex = std::min(i + lane, end - 1u);
+                const float* sum = sums.data() + vertex * 6u;
+                n.set(lane, vertices[vertex].normal);
+                t.x[lane] = sum[0];
+                t.y[lane] = sum[1];
+                t.z[lane] = sum[2];
+                b.x[lane] = sum[3];
+                b.y[lane] = sum[4];
+                b.z[lane] = sum[5];
+            }
+
+            Normals_OrthogonalizeKernel(n, t, b, handedness);
+            for ( std::size_t lane = 0; lane < laneCount; lane++ ) {
+                Vector4f& tangent = vertices[i + lane].tangent;
+                tangent.x() = t.x[lane];
+                tangent.y() = t.y[lane];
+                tangent.z() = t.z[lane];
+                tangent.w() = handedness[lane];
+                if ( t.x[lane] != 0.0f || t.y[lane] != 0.0f || t.z[lane] != 0.0f ) continue;
+
+                const Vector3f& normal = vertices[i + lane].normal;
+                if ( normal.isEquivalent(Vector3f::UnitY(), NORMALS_FALLBACK_TOLERANCE) || normal.isEquivalent(Vector3f::UnitNY(), NORMALS_FALLBACK_TOLERANCE) ) tangent.x() = 1.0f;
+            }
+        }
+    });
+
+    return true;
+}
+
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <vector>
+#include <cstdint>
+#include <Mathematics.h>
+#include "Vertex.h"
+#include "Face.h"
+
+namespace sgpu {
+
+/* Size of the FIFO post-transform vertex cache simulated by AnalyzeVertexCache. */
+const unsigned int VERTEX_CACHE_ANALYSIS_SIZE = 16u;
+
+/* Size of the LRU vertex cache modeled by OptimizeVertexCache. */
+const unsigned int VERTEX_CACHE_OPTIMIZATION_SIZE = 32u;
+
+/*
+ * Largest increase of the cache miss ratio OptimizeOverdraw accepts, both for
+ * each cluster it splits off and for the reordered faces as a whole (1.05
+ * allows 5% more transforms than the cache optimized order).
+ */
+const float OVERDRAW_DEFAULT_THRESHOLD = 1.05f;
+
+/* Post-transform vertex cache efficiency of an index buffer. */
+struct VertexCacheStatistics {
+    float acmr;     /* Average cache miss ratio: transforms per triangle [0.5, 3]. */
+    float atvr;     /* Average transform to vertex ratio: transforms per vertex [1, 6]. */
+};
+
+/* Vertex cache efficiency of a mesh before and after OptimizeMesh. */
+struct MeshOptimizationStatistics {
+    VertexCacheStatistics original;
+    VertexCacheStatistics optimized;
+};
+
+/*
+ * Simulates a FIFO post-transform vertex cache of the provided size over the
+ * faces and returns the number of vertex transforms relative to the faces and
+ * to the vertices they reference.
+ */
+VertexCacheStatistics AnalyzeVertexCache(const TriangleFace* faces, std::size_t faceCount, std::size_t vertexCount, unsigned int cacheSize = VERTEX_CACHE_ANALYSIS_SIZE);
+
+/*
+ * Reorders the faces [faceOffset, faceOffset + faceCount) so that faces
+ * sharing vertices are drawn close together (Forsyth, "Linear-Speed Vertex
+ * Cache Optimisation"). The next face is the one with the highest score among
+ * the faces of the vertices in a simulated LRU cache; a vertex scores higher
+ * the more recently it was used and the fewer faces it has left. The faces
+ * keep their order if it transforms fewer vertices (see AnalyzeVertexCache).
+ *
+ * @return Returns false if a face references a vertex >= vertexCount.
+ */
+bool OptimizeVertexCache(std::vector<TriangleFace>& faces, std::size_t faceOffset, std::size_t faceCount, std::size_t vertexCount);
+
+/*
+ * Reorders clusters of the cache optimized faces [faceOffset, faceOffset +
+ * faceCount) so that outward facing clusters are drawn first and occlude the
+ * rest of the mesh (Sander et al., "Fast Triangle Reordering for Vertex
+ * Locality and Reduced Overdraw"). The faces are split wherever a new cluster
+ * costs at most threshold times the cache misses of the original order. The
+ * original order is kept if the reordered faces miss the cache more than
+ * threshold times as often (see AnalyzeVertexCache).
+ */
+bool OptimizeOverdraw(std::vector<TriangleFace>& faces, std::size_t faceOffset, std::size_t faceCount, const std::vector<Vertex>& vertices, float threshold = OVERDRAW_DEFAULT_THRESHOLD);
+
+/*
+ * Reorders the vertices in the order they are first referenced by the faces
+ * and remaps the faces, so the vertices are fetched sequentially. Vertices
+ * that are not referenced are moved to the end.
+ */
+bool OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces);
+
+/*
+ * Optimizes the faces of each sub-mesh for the vertex cache and then for
+ * overdraw, and the vertices for fetching. The faces stay in their sub-mesh;
+ * the vertex ranges of the sub-meshes must be recalculated afterwards (see
+ * CalculateSubMeshBounds).
+ *
+ * @param statistics - If not nullptr, receives the vertex cache efficiency
+ * of the mesh before and after the optimization.
+ */
+bool OptimizeMesh(std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces, const std::vector<SubMesh>& subMeshes, MeshOptimizationStatistics* statistics = nullptr);
+
+}
+
+#endif
@@ -21,12 +21,17 @@
  * THE SOFTWARE.
  */
 #include "ObjMesh.h"
+#include "MappedFile.h"
+#include "ParallelFor.h"
 
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <cstdlib>
-#include <iomanip>
+#include <charconv>
+#include <cstring>
+#include <algorithm>
+#include <filesystem>
 
 namespace sgpu {
 
@@ -43,6 +48,15 @@ static const std::string OBJ_VERTEX = "v";
 static const std::string OBJ_MATERIAL_LIBRARY = "mtllib";
 static const std::string OBJ_USE_MATERIAL = "usemtl";
 
+static const std::string MTL_NEW_MATERIAL = "newmtl";
+static const std::string MTL_DIFFUSE = "Kd";
+static const std::string MTL_SPECULAR = "Ks";
+static const std::string MTL_SHININESS = "Ns";
+static const std::string MTL_DIFFUSE_MAP = "map_Kd";
+static const std::string MTL_SPECULAR_MAP = "map_Ks";
+static const std::string MTL_NORMAL_MAP = "map_Bump";
+static const std::string MTL_NORMAL_MAP_ALT = "bump";
+
 /* Default names for groups and materials if they are not specified. */
 static const std::string OBJ_NO_MESH_NAME = "DefaultName";
 static const std::string OBJ_NO_MATERIAL = "DefaultMaterial";
@@ -300,17 +314,13 @@ bool Parse_Obj_Node(ObjFile* const objFile, std::istringstream& argumentStream,
 }
 
 /* 
- * Ensures that a valid Obj face will be added to a mesh. If an index
- * invalidates the face, then it will be ignored and not added to the mesh.
+ * Discards the nodes appended to the index streams of a mesh past the provided
+ * node count (used to drop a face that could not be parsed).
  */
-bool Valid_Obj_Face(const Obj_Face& face) {
-	for ( unsigned int i = 0; i < face.vertexIndices.size(); i++ )
-		if ( face.vertexIndices[i] < 0 ) return false;
-	for ( unsigned int i = 0; i < face.textureIndices.size(); i++ )
-		if ( face.textureIndices[i] < 0 ) return false;
-	for ( unsigned int i = 0; i < face.normalIndices.size(); i++ )
-		if ( face.normalIndices[i] < 0 ) return false;
-	return true;
+void Truncate_Obj_Nodes(ObjMesh* const mesh, std::size_t nodeCount) {
+    mesh->vertexIndices.resize(nodeCount);
+    mesh->textureIndices.resize(nodeCount);
+    mesh->normalIndices.resize(nodeCount);
 }
 
 bool Parse_Obj_Face(ObjFile* const objFile, std::istringstream& argumentStream, std::size_t& curGroupIndex, std::size_t& curSmoothingGroupIndex, std::size_t& curMaterialIndex) {
@@ -322,6 +332,10 @@ bool Parse_Obj_Face(ObjFile* const objFile, std::istringstream& argumentStream,
     int textureCoordIndex = OBJ_INVALID_FACE_INDEX;
     int normalIndex = OBJ_INVALID_FACE_INDEX;
 
+    if ( objFile->getMesh(objFile->size() - 1) == nullptr ) objFile->addMesh();
+    std::shared_ptr<ObjMesh> mesh = objFile->getMesh(objFile->size() - 1);
+    face.offset = static_cast<std::uint32_t>(mesh->vertexIndices.size());
+
     //--------------------------------------------------------------------------
     // For each node that defines a face, parse each of the vertex, texture-
     // coord, and normal indices. A node is defined as: vtx/tex/n where a face
@@ -334,22 +348,23 @@ bool Parse_Obj_Face(ObjFile* const objFile, std::istringstream& argumentStream,
 
         if ( vertexIndex < 0 ) {
 			std::cout << "[ObjFile:Parse_Obj_Face] Error: Invalid vertex index. Aborting." << std::endl;
+			Truncate_Obj_Nodes(mesh.get(), face.offset);
 			return false;
 		}
 
-        if ( vertexIndex >= 0 ) face.vertexIndices.push_back(vertexIndex);
-		else face.vertexIndices.push_back(0);
+        mesh->vertexIndices.push_back(static_cast<std::uint32_t>(vertexIndex));
 
-		if ( textureCoordIndex >= 0 ) face.textureIndices.push_back(textureCoordIndex);
-		else face.textureIndices.push_back(0);
+		if ( textureCoordIndex >= 0 ) mesh->textureIndices.push_back(static_cast<std::uint32_t>(textureCoordIndex));
+		else mesh->textureIndices.push_back(0);
 
-		if ( normalIndex >= 0 ) face.normalIndices.push_back(normalIndex);
-		else face.normalIndices.push_back(0);
+		if ( normalIndex >= 0 ) mesh->normalIndices.push_back(static_cast<std::uint32_t>(normalIndex));
+		else mesh->normalIndices.push_back(0);
 		nodeCount++;
     }
 
     if ( nodeCount <= 2 ) {
 		std::cout << "[ObjFile:Parse_Obj_Face] Warning: Invalid OBJ face. Each OBJ face must have at least 3 sides. Ignoring face." << std::endl;
+		Truncate_Obj_Nodes(mesh.get(), face.offset);
 		return true;
 	}
 
@@ -362,12 +377,12 @@ bool Parse_Obj_Face(ObjFile* const objFile, std::istringstream& argumentStream,
 	else if ( nodeCount == 4 ) face.type = QUAD;
     else face.type = POLYGON;
 
+    face.count = static_cast<std::uint32_t>(nodeCount);
     face.groupIndex = curGroupIndex;
 	face.smoothingGroupIndex = curSmoothingGroupIndex;
 	face.materialIndex = curMaterialIndex;
 
-    if ( objFile->getMesh(objFile->size() - 1) == nullptr ) objFile->addMesh();
-	if ( Valid_Obj_Face(face) ) objFile->getMesh(objFile->size() - 1)->faces.push_back(face);
+    mesh->faces.push_back(face);
 	return true;
 }
 
@@ -405,12 +420,487 @@ bool Parse_ObjFileLine(ObjFile* const objFile, const std::string& line, std::siz
     return true;
 }
 
-bool ObjFile::load(const std::string& filename) {
+/* Returns true for the characters that separate tokens within an Obj line. */
+inline bool Obj_IsSpace(char c) {
+    return c == OBJ_DELIMITER_CHAR || c == '\t' || c == '\r';
+}
+
+/* Advances the provided cursor past any token delimiters. */
+inline void Obj_SkipSpace(const char*& cur, const char* end) {
+    while ( cur < end && Obj_IsSpace(*cur) ) cur++;
+}
+
+/* 
+ * Extracts the next whitespace delimited token [tokenBegin, tokenEnd) from the
+ * range [cur, end) without copying it. Returns false if no token remains.
+ */
+inline bool Obj_NextToken(const char*& cur, const char* end, const char*& tokenBegin, const char*& tokenEnd) {
+    Obj_SkipSpace(cur, end);
+    tokenBegin = cur;
+    while ( cur < end && !Obj_IsSpace(*cur) ) cur++;
+    tokenEnd = cur;
+    return tokenBegin != tokenEnd;
+}
+
+/* Compares the token [begin, end) against the provided Obj keyword. */
+inline bool Obj_TokenEquals(const char* begin, const char* end, const std::string& keyword) {
+    return static_cast<std::size_t>(end - begin) == keyword.length() && keyword.compare(0, keyword.length(), begin, keyword.length()) == 0;
+}
+
+/* 
+ * Parse a single float in place. Missing or malformed components are read
+ * as 0 (the same result as a failed stream extraction).
+ */
+inline float Parse_Obj_Float(const char*& cur, const char* end) {
+    float value = 0.0f;
+    Obj_SkipSpace(cur, end);
+    if ( cur < end && *cur == '+' ) cur++;
+
+    std::from_chars_result result = std::from_chars(cur, end, value);
+    if ( result.ec != std::errc() ) return 0.0f;
+
+    cur = result.ptr;
+    return value;
+}
+
+/* Parse a 3-component vector from the provided range: 1.0 2.0 3.0 */
+inline bool Parse_Obj_Vector(const char* cur, const char* end, Vector3f& vector) {
+    vector.x() = Parse_Obj_Float(cur, end);
+    vector.y() = Parse_Obj_Float(cur, end);
+    vector.z() = Parse_Obj_Float(cur, end);
+    return true;
+}
+
+/* Parse an individual int from the provided range (atoi semantics). */
+inline int Parse_Obj_Int(const char* begin, const char* end) {
+    int value = 0;
+    if ( begin < end && *begin == '+' ) begin++;
+    std::from_chars(begin, end, value);
+    return value;
+}
+
+/*
+ * In-place version of Parse_Obj_Node. The node [begin, end) is split at its
+ * delimiting slashes and interpreted identically to the stream based parser.
+ */
+bool Parse_Obj_Node(const char* begin, const char* end, int& vertexIndex, int& textureCoordIndex, int& normalIndex) {
+    const char* slashes[2] = { end, end };
+    unsigned int slashCount = 0u;
+    for ( const char* c = begin; c < end; c++ ) {
+        if ( *c != OBJ_NODE_DELIMITER ) continue;
+        if ( slashCount < 2 ) slashes[slashCount] = c;
+        slashCount++;
+    }
+
+    if ( slashCount == 0 ) {
+        vertexIndex = Parse_Obj_Int(begin, end) - OBJ_INDEX_OFFSET;
+        return true;
+    }
+    else if ( slashCount == 1 ) {
+        vertexIndex = Parse_Obj_Int(begin, slashes[0]) - OBJ_INDEX_OFFSET;
+        normalIndex = 0;
+        textureCoordIndex = Parse_Obj_Int(slashes[0] + 1, end) - OBJ_INDEX_OFFSET;
+        return true;
+    }
+    else if ( slashCount == 2 ) {
+        vertexIndex = Parse_Obj_Int(begin, slashes[0]) - OBJ_INDEX_OFFSET;
+        textureCoordIndex = Parse_Obj_Int(slashes[0] + 1, slashes[1]) - OBJ_INDEX_OFFSET;
+        normalIndex = Parse_Obj_Int(slashes[1] + 1, end);
+
+        if ( normalIndex == 0 ) {
+            normalIndex = textureCoordIndex;
+            textureCoordIndex = OBJ_INVALID_FACE_INDEX;
+        }
+        else normalIndex -= OBJ_INDEX_OFFSET;
+    }
+    else {
+        std::cout << "[ObjFile:Parse_Obj_Node] Error: Invalid face node encountered." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/* Running number of v, vt, and vn records read from an Obj file. */
+struct Obj_RecordCounts {
+    Obj_RecordCounts() : vertices(0), textureCoordinates(0), normals(0) {}
+
+    std::size_t vertices;
+    std::size_t textureCoordinates;
+    std::size_t normals;
+};
+
+/* 
+ * Relative (negative) face index that could not be resolved while parsing a
+ * chunk of an Obj file. The node is the position within the index streams of
+ * the chunk, the offset is relative to the record counts at the beginning of
+ * the chunk and is rebased once those counts are known.
+ */
+struct Obj_IndexFixup {
+    std::size_t node;
+    unsigned int component;
+    long long offset;
+};
+
+enum Obj_FaceComponent { OBJ_FACE_VERTEX, OBJ_FACE_TEXTURE, OBJ_FACE_NORMAL };
+
+/*
+ * Resolves a face index parsed by Parse_Obj_Node. Indices less than
+ * OBJ_INVALID_FACE_INDEX were written as relative (negative) indices in the
+ * file (ex. f -3 -2 -1) and are resolved against the number of records read so
+ * far. If fixups are provided (chunked parsing) the relative index is recorded
+ * instead and written once the chunk has been rebased.
+ */
+inline bool Resolve_Obj_Index(int& index, std::size_t count, std::size_t node, unsigned int component, std::vector<Obj_IndexFixup>* fixups) {
+    if ( index >= OBJ_INVALID_FACE_INDEX ) return true;
+
+    long long resolved = static_cast<long long>(count) + (index + OBJ_INDEX_OFFSET);
+    if ( fixups != nullptr ) {
+        Obj_IndexFixup fixup;
+        fixup.node = node;
+        fixup.component = component;
+        fixup.offset = resolved;
+        fixups->push_back(fixup);
+        index = 0;
+        return true;
+    }
+
+    if ( resolved < 0 ) return false;
+    index = static_cast<int>(resolved);
+    return true;
+}
+
+/* In-place version of Parse_Obj_Face that writes directly into the mesh. */
+bool Parse_Obj_Face(ObjMesh* const mesh, const char* cur, const char* end, const Obj_RecordCounts& counts, std::vector<Obj_IndexFixup>* fixups, std::size_t curGroupIndex, std::size_t curSmoothingGroupIndex, std::size_t curMaterialIndex) {
+    //--------------------------------------------------------------------------
+    // Count the nodes first so the index streams are only resized once.
+    //--------------------------------------------------------------------------
+    const char* tokenBegin = nullptr;
+    const char* tokenEnd = nullptr;
+    std::size_t nodeCount = 0u;
+    for ( const char* c = cur; Obj_NextToken(c, end, tokenBegin, tokenEnd); ) nodeCount++;
+
+    if ( nodeCount <= 2 ) {
+        std::cout << "[ObjFile:Parse_Obj_Face] Warning: Invalid OBJ face. Each OBJ face must have at least 3 sides. Ignoring face." << std::endl;
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+    // The nodes are written straight into the index streams of the mesh.
+    //--------------------------------------------------------------------------
+    std::size_t offset = mesh->vertexIndices.size();
+    std::size_t fixupCount = (fixups != nullptr) ? fixups->size() : 0u;
+    mesh->vertexIndices.resize(offset + nodeCount);
+    mesh->textureIndices.resize(offset + nodeCount);
+    mesh->normalIndices.resize(offset + nodeCount);
+
+    int vertexIndex = OBJ_INVALID_FACE_INDEX;
+    int textureCoordIndex = OBJ_INVALID_FACE_INDEX;
+    int normalIndex = OBJ_INVALID_FACE_INDEX;
+
+    for ( std::size_t node = offset; Obj_NextToken(cur, end, tokenBegin, tokenEnd); node++ ) {
+        Parse_Obj_Node(tokenBegin, tokenEnd, vertexIndex, textureCoordIndex, normalIndex);
+
+        int v = vertexIndex, t = textureCoordIndex, n = normalIndex;
+        bool valid = Resolve_Obj_Index(v, counts.vertices, node, OBJ_FACE_VERTEX, fixups);
+        valid = valid && Resolve_Obj_Index(t, counts.textureCoordinates, node, OBJ_FACE_TEXTURE, fixups);
+        valid = valid && Resolve_Obj_Index(n, counts.normals, node, OBJ_FACE_NORMAL, fixups);
+
+        if ( !valid || v < 0 ) {
+            std::cout << "[ObjFile:Parse_Obj_Face] Error: Invalid vertex index. Aborting." << std::endl;
+            Truncate_Obj_Nodes(mesh, offset);
+            if ( fixups != nullptr ) fixups->resize(fixupCount);
+            return false;
+        }
+
+        mesh->vertexIndices[node] = static_cast<std::uint32_t>(v);
+        mesh->textureIndices[node] = static_cast<std::uint32_t>(t >= 0 ? t : 0);
+        mesh->normalIndices[node] = static_cast<std::uint32_t>(n >= 0 ? n : 0);
+    }
+
+    Obj_Face face;
+    if ( nodeCount == 3 ) face.type = TRIANGLE;
+    else if ( nodeCount == 4 ) face.type = QUAD;
+    else face.type = POLYGON;
+
+    face.offset = static_cast<std::uint32_t>(offset);
+    face.count = static_cast<std::uint32_t>(nodeCount);
+    face.groupIndex = curGroupIndex;
+    face.smoothingGroupIndex = curSmoothingGroupIndex;
+    face.materialIndex = curMaterialIndex;
+
+    mesh->faces.push_back(face);
+    return true;
+}
+
+/* Obj records that are parsed in place (v, vt, vn, f) and everything else. */
+enum Obj_Record { OBJ_RECORD_EMPTY, OBJ_RECORD_VERTEX, OBJ_RECORD_TEXTURE, OBJ_RECORD_NORMAL, OBJ_RECORD_FACE, OBJ_RECORD_DIRECTIVE };
+
+/*
+ * Identifies the record stored in the line [cur, end). On return the keyword
+ * of the line is [idBegin, idEnd) and cur points past it.
+ */
+Obj_Record Classify_Obj_Line(const char*& cur, const char* end, const char*& idBegin, const char*& idEnd) {
+    if ( !Obj_NextToken(cur, end, idBegin, idEnd) ) return OBJ_RECORD_EMPTY;
+    if ( *idBegin == OBJ_COMMENT ) return OBJ_RECORD_EMPTY;
+
+    if ( Obj_TokenEquals(idBegin, idEnd, OBJ_VERTEX) ) return OBJ_RECORD_VERTEX;
+    if ( Obj_TokenEquals(idBegin, idEnd, OBJ_VERTEX_TEXTURE) ) return OBJ_RECORD_TEXTURE;
+    if ( Obj_TokenEquals(idBegin, idEnd, OBJ_VERTEX_NORMAL) ) return OBJ_RECORD_NORMAL;
+    if ( Obj_TokenEquals(idBegin, idEnd, OBJ_FACE) ) return OBJ_RECORD_FACE;
+    return OBJ_RECORD_DIRECTIVE;
+}
+
+/* Parses a v, vt, vn, or f record directly into the provided mesh. */
+bool Parse_Obj_GeometryRecord(ObjMesh* const mesh, Obj_Record record, const char* cur, const char* end, Obj_RecordCounts& counts, std::vector<Obj_IndexFixup>* fixups, std::size_t curGroupIndex, std::size_t curSmoothingGroupIndex, std::size_t curMaterialIndex) {
+    Vector3f vector;
+
+    switch ( record ) {
+        case OBJ_RECORD_VERTEX:
+            Parse_Obj_Vector(cur, end, vector);
+            mesh->vertices.push_back(vector);
+            counts.vertices++;
+            return true;
+        case OBJ_RECORD_TEXTURE:
+            Parse_Obj_Vector(cur, end, vector);
+            mesh->textureCoordinates.push_back(vector);
+            counts.textureCoordinates++;
+            return true;
+        case OBJ_RECORD_NORMAL:
+            Parse_Obj_Vector(cur, end, vector);
+            mesh->normals.push_back(vector);
+            counts.normals++;
+            return true;
+        case OBJ_RECORD_FACE:
+            return Parse_Obj_Face(mesh, cur, end, counts, fixups, curGroupIndex, curSmoothingGroupIndex, curMaterialIndex);
+        default:
+            return true;
+    }
+}
+
+/*
+ * Parses the infrequent object, group, and material records [idBegin, end)
+ * by forwarding their arguments to the stream based parsers.
+ */
+bool Parse_Obj_Directive(ObjFile* const objFile, const char* idBegin, const char* idEnd, const char* end, std::size_t& curGroupIndex, std::size_t& curSmoothingGroupIndex, std::size_t& curMaterialIndex) {
+    const char* argumentBegin = idEnd;
+    const char* argumentEnd = end;
+    Obj_SkipSpace(argumentBegin, argumentEnd);
+    while ( argumentEnd > argumentBegin && Obj_IsSpace(*(argumentEnd - 1)) ) argumentEnd--;
+    std::istringstream argumentStream(std::string(argumentBegin, argumentEnd));
+
+    if ( Obj_TokenEquals(idBegin, idEnd, OBJ_SMOOTHING_GROUP) ) return Parse_Obj_SmoothingGroup(objFile, argumentStream, curSmoothingGroupIndex);
+    else if ( Obj_TokenEquals(idBegin, idEnd, OBJ_GROUP) ) return Parse_Obj_Group(objFile, argumentStream, curGroupIndex);
+    else if ( Obj_TokenEquals(idBegin, idEnd, OBJ_OBJECT) ) return Parse_Obj_Object(objFile, argumentStream, curSmoothingGroupIndex);
+    else if ( Obj_TokenEquals(idBegin, idEnd, OBJ_MATERIAL_LIBRARY) ) return Parse_Obj_MaterialLibrary(objFile, argumentStream);
+    else if ( Obj_TokenEquals(idBegin, idEnd, OBJ_USE_MATERIAL) ) return Parse_Obj_Material(objFile, argumentStream, curMaterialIndex);
+    else std::cerr << "[ObjFile:Parse_ObjFileLine] Warning: Encountered an unrecognized OBJ file line. Ignoring Command." << std::endl;
+
+    return true;
+}
+
+/*
+ * In-place version of Parse_ObjFileLine operating on the line [begin, end) of
+ * a mapped Obj file. Vertex, texture-coord, normal, and face records (the bulk
+ * of any Obj file) are parsed without constructing any strings or streams and
+ * are appended to the cached current mesh.
+ */
+bool Parse_ObjFileLine(ObjFile* const objFile, const char* begin, const char* end, ObjMesh*& curMesh, Obj_RecordCounts& counts, std::size_t& curGroupIndex, std::size_t& curSmoothingGroupIndex, std::size_t& curMaterialIndex) {
+    const char* cur = begin;
+    const char* idBegin = nullptr;
+    const char* idEnd = nullptr;
+
+    Obj_Record record = Classify_Obj_Line(cur, end, idBegin, idEnd);
+    if ( record == OBJ_RECORD_EMPTY ) return true;
+
+    if ( record != OBJ_RECORD_DIRECTIVE ) {
+        if ( curMesh == nullptr ) {
+            if ( objFile->getMesh(objFile->size() - 1) == nullptr ) objFile->addMesh();
+            curMesh = objFile->getMesh(objFile->size() - 1).get();
+        }
+
+        return Parse_Obj_GeometryRecord(curMesh, record, cur, end, counts, nullptr, curGroupIndex, curSmoothingGroupIndex, curMaterialIndex);
+    }
+
+    //--------------------------------------------------------------------------
+    // Object, group and material records can add meshes to the Obj file, so
+    // the cached mesh is refreshed on the next geometry record.
+    //--------------------------------------------------------------------------
+    curMesh = nullptr;
+    return Parse_Obj_Directive(objFile, idBegin, idEnd, end, curGroupIndex, curSmoothingGroupIndex, curMaterialIndex);
+}
+
+/* Smallest amount of an Obj file (in bytes) worth parsing on its own thread. */
+static const std::size_t OBJ_MIN_CHUNK_SIZE = 1u << 20;
+
+/*
+ * Run of geometry records within a chunk of an Obj file. Every directive
+ * record (o, g, s, usemtl, ...) starts a new segment so that the directives
+ * can be replayed in file order when the chunks are merged. All faces of a
+ * segment share the same group, smoothing group, and material.
+ */
+struct Obj_ChunkSegment {
+    Obj_ChunkSegment() : geometry(std::string()) {
+        this->directiveBegin = nullptr;
+        this->directiveEnd = nullptr;
+        this->lineEnd = nullptr;
+        this->target = nullptr;
+        this->vertexOffset = 0u;
+        this->textureOffset = 0u;
+        this->normalOffset = 0u;
+        this->nodeOffset = 0u;
+        this->faceOffset = 0u;
+        this->groupIndex = 0u;
+        this->smoothingGroupIndex = 0u;
+        this->materialIndex = 0u;
+    }
+
+    bool empty() const {
+        return this->geometry.vertices.empty() && this->geometry.textureCoordinates.empty() && this->geometry.normals.empty() && this->geometry.faces.empty();
+    }
+
+    /* Directive that starts this segment (none for the first segment). */
+    const char* directiveBegin;
+    const char* directiveEnd;
+    const char* lineEnd;
+
+    /* Geometry parsed from the chunk; face indices are file-global. */
+    ObjMesh geometry;
+    std::vector<Obj_IndexFixup> fixups;
+
+    /* Destination of the geometry, assigned when the chunks are merged. */
+    ObjMesh* target;
+    std::size_t vertexOffset;
+    std::size_t textureOffset;
+    std::size_t normalOffset;
+    std::size_t nodeOffset;
+    std::size_t faceOffset;
+    std::size_t groupIndex;
+    std::size_t smoothingGroupIndex;
+    std::size_t materialIndex;
+};
+
+/* Newline aligned range [begin, end) of an Obj file parsed by one thread. */
+struct Obj_Chunk {
+    Obj_Chunk() {
+        this->begin = nullptr;
+        this->end = nullptr;
+        this->errorLineBegin = nullptr;
+        this->errorLineEnd = nullptr;
+        this->success = true;
+    }
+
+    const char* begin;
+    const char* end;
+    std::vector<Obj_ChunkSegment> segments;
+
+    /* Records in this chunk and records in all of the preceding chunks. */
+    Obj_RecordCounts counts;
+    Obj_RecordCounts base;
+
+    const char* errorLineBegin;
+    const char* errorLineEnd;
+    bool success;
+};
+
+/* Parses the v, vt, vn, and f records of a chunk into its segments. */
+void Parse_Obj_Chunk(Obj_Chunk& chunk) {
+    chunk.segments.emplace_back();
+
+    const char* cur = chunk.begin;
+    while ( cur < chunk.end ) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(cur, '\n', static_cast<std::size_t>(chunk.end - cur)));
+        if ( lineEnd == nullptr ) lineEnd = chunk.end;
+
+        const char* argument = cur;
+        const char* idBegin = nullptr;
+        const char* idEnd = nullptr;
+        Obj_Record record = Classify_Obj_Line(argument, lineEnd, idBegin, idEnd);
+
+        if ( record == OBJ_RECORD_DIRECTIVE ) {
+            chunk.segments.emplace_back();
+            chunk.segments.back().directiveBegin = idBegin;
+            chunk.segments.back().directiveEnd = idEnd;
+            chunk.segments.back().lineEnd = lineEnd;
+        }
+        else if ( record != OBJ_RECORD_EMPTY ) {
+            Obj_ChunkSegment& segment = chunk.segments.back();
+            if ( !Parse_Obj_GeometryRecord(&segment.geometry, record, argument, lineEnd, chunk.counts, &segment.fixups, 0u, 0u, 0u) ) {
+                chunk.errorLineBegin = cur;
+                chunk.errorLineEnd = lineEnd;
+                chunk.success = false;
+                return;
+            }
+        }
+
+        cur = lineEnd + 1;
+    }
+}
+
+/* Moves the geometry of a chunk into the meshes selected during the merge. */
+void Merge_Obj_Chunk(Obj_Chunk& chunk) {
+    for ( std::size_t s = 0; s < chunk.segments.size(); s++ ) {
+        Obj_ChunkSegment& segment = chunk.segments[s];
+        if ( segment.target == nullptr ) continue;
+
+        ObjMesh& source = segment.geometry;
+        ObjMesh& target = *segment.target;
+        std::copy(source.vertices.begin(), source.vertices.end(), target.vertices.begin() + segment.vertexOffset);
+        std::copy(source.textureCoordinates.begin(), source.textureCoordinates.end(), target.textureCoordinates.begin() + segment.textureOffset);
+        std::copy(source.normals.begin(), source.normals.end(), target.normals.begin() + segment.normalOffset);
+
+        //----------------------------------------------------------------------
+        // Rebase the relative face indices against the number of records that
+        // preceded this chunk.
+        //----------------------------------------------------------------------
+        for ( std::size_t i = 0; i < segment.fixups.size(); i++ ) {
+            const Obj_IndexFixup& fixup = segment.fixups[i];
+
+            long long index = fixup.offset;
+            if ( fixup.component == OBJ_FACE_VERTEX ) index += static_cast<long long>(chunk.base.vertices);
+            else if ( fixup.component == OBJ_FACE_TEXTURE ) index += static_cast<long long>(chunk.base.textureCoordinates);
+            else index += static_cast<long long>(chunk.base.normals);
+
+            if ( index < 0 ) {
+                std::cout << "[ObjFile:Parse_Obj_Face] Error: Invalid vertex index. Aborting." << std::endl;
+                chunk.success = false;
+                index = 0;
+            }
+
+            if ( fixup.component == OBJ_FACE_VERTEX ) source.vertexIndices[fixup.node] = static_cast<std::uint32_t>(index);
+            else if ( fixup.component == OBJ_FACE_TEXTURE ) source.textureIndices[fixup.node] = static_cast<std::uint32_t>(index);
+            else source.normalIndices[fixup.node] = static_cast<std::uint32_t>(index);
+        }
+
+        std::copy(source.vertexIndices.begin(), source.vertexIndices.end(), target.vertexIndices.begin() + segment.nodeOffset);
+        std::copy(source.textureIndices.begin(), source.textureIndices.end(), target.textureIndices.begin() + segment.nodeOffset);
+        std::copy(source.normalIndices.begin(), source.normalIndices.end(), target.normalIndices.begin() + segment.nodeOffset);
+
+        for ( std::size_t f = 0; f < source.faces.size(); f++ ) {
+            Obj_Face& face = target.faces[segment.faceOffset + f];
+            face = source.faces[f];
+            face.offset += static_cast<std::uint32_t>(segment.nodeOffset);
+            face.groupIndex = segment.groupIndex;
+            face.smoothingGroupIndex = segment.smoothingGroupIndex;
+            face.materialIndex = segment.materialIndex;
+        }
+
+        segment.geometry = ObjMesh(std::string());
+    }
+}
+
+bool ObjFile::load(const std::string& filename, ObjLoadMode mode) {
     if ( filename.length() == 0 ) {
         std::cerr << "[ObjFile:load] Error: Invalid filename of length 0." << std::endl;
         return false;
     }
 
+    if ( mode == OBJ_LOAD_STREAM ) return this->loadStream(filename);
+    if ( mode == OBJ_LOAD_PARALLEL ) return this->loadParallel(filename);
+    return this->loadMapped(filename);
+}
+
+bool ObjFile::loadStream(const std::string& filename) {
     std::ifstream file(filename.c_str());
     if ( file.is_open() == false ) {
         std::cerr << "[ObjFile:load] Error: The file: " << filename << " could not be opened." << std::endl;
@@ -440,215 +930,719 @@ bool ObjFile::load(const std::string& filename) {
     return true;
 }
 
-/* 
- * Prints out an information header for an Obj file. This information is only
- * included in a comment.
+bool ObjFile::loadMapped(const std::string& filename) {
+    MappedFile file;
+    if ( !file.open(filename) ) {
+        std::cerr << "[ObjFile:load] Error: The file: " << filename << " could not be opened." << std::endl;
+        return false;
+    }
+
+    std::size_t curGroupIndex = 0u;
+    std::size_t curSmoothingGroupIndex = 0u;
+    std::size_t curMaterialIndex = 0u;
+    Obj_RecordCounts counts;
+    ObjMesh* curMesh = nullptr;
+
+    this->materials.insert(std::make_pair(curMaterialIndex, OBJ_NO_MATERIAL));
+    this->groups.insert(std::make_pair(curGroupIndex, OBJ_NO_GROUP));
+
+    //--------------------------------------------------------------------------
+    // Tokenizes the mapped Obj file line-by-line in place. Each line is only
+    // described by its [begin, end) range within the mapping.
+    //--------------------------------------------------------------------------
+    const char* cur = file.data();
+    const char* end = file.data() + file.size();
+    while ( cur < end ) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(cur, '\n', static_cast<std::size_t>(end - cur)));
+        if ( lineEnd == nullptr ) lineEnd = end;
+
+        if ( !Parse_ObjFileLine(this, cur, lineEnd, curMesh, counts, curGroupIndex, curSmoothingGroupIndex, curMaterialIndex) ) {
+            std::cout << "[ObjFile:load] Error: Failed to parse an OBJ file line and cannot recover." << std::endl;
+            std::cout << "  Aborting OBJ file parsing process at line: " << std::string(cur, lineEnd) << std::endl;
+            return false;
+        }
+
+        cur = lineEnd + 1;
+    }
+
+    return true;
+}
+
+bool ObjFile::loadParallel(const std::string& filename) {
+    MappedFile file;
+    if ( !file.open(filename) ) {
+        std::cerr << "[ObjFile:load] Error: The file: " << filename << " could not be opened." << std::endl;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // Small files are not worth the threading overhead.
+    //--------------------------------------------------------------------------
+    std::size_t threadCount = GetThreadCount();
+    std::size_t chunkCount = std::min(threadCount, file.size() / OBJ_MIN_CHUNK_SIZE);
+    if ( chunkCount <= 1 ) {
+        file.close();
+        return this->loadMapped(filename);
+    }
+
+    std::size_t curGroupIndex = 0u;
+    std::size_t curSmoothingGroupIndex = 0u;
+    std::size_t curMaterialIndex = 0u;
+
+    this->materials.insert(std::make_pair(curMaterialIndex, OBJ_NO_MATERIAL));
+    this->groups.insert(std::make_pair(curGroupIndex, OBJ_NO_GROUP));
+
+    //--------------------------------------------------------------------------
+    // Split the file into chunks of roughly equal size that start at the
+    // beginning of a line.
+    //--------------------------------------------------------------------------
+    const char* begin = file.data();
+    const char* end = file.data() + file.size();
+    std::vector<Obj_Chunk> chunks(chunkCount);
+    for ( std::size_t i = 0; i < chunkCount; i++ ) {
+        chunks[i].begin = (i == 0) ? begin : chunks[i - 1].end;
+        chunks[i].end = end;
+        if ( i + 1 == chunkCount ) break;
+
+        const char* split = std::max(chunks[i].begin, begin + (file.size() / chunkCount) * (i + 1));
+        const char* lineEnd = static_cast<const char*>(std::memchr(split, '\n', static_cast<std::size_t>(end - split)));
+        if ( lineEnd != nullptr ) chunks[i].end = lineEnd + 1;
+    }
+
+    //--------------------------------------------------------------------------
+    // Parse the geometry records of every chunk concurrently.
+    //--------------------------------------------------------------------------
+    ParallelFor(chunkCount, [&chunks](std::size_t i) { Parse_Obj_Chunk(chunks[i]); });
+
+    for ( std::size_t i = 0; i < chunkCount; i++ ) {
+        if ( chunks[i].success ) continue;
+        std::cout << "[ObjFile:load] Error: Failed to parse an OBJ file line and cannot recover." << std::endl;
+        std::cout << "  Aborting OBJ file parsing process at line: " << std::string(chunks[i].errorLineBegin, chunks[i].errorLineEnd) << std::endl;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // Replay the directives in file order. This creates the meshes, groups and
+    // materials exactly as the serial parser would and determines where the
+    // geometry of every segment is placed within its mesh.
+    //--------------------------------------------------------------------------
+    Obj_RecordCounts base;
+    for ( std::size_t i = 0; i < chunkCount; i++ ) {
+        Obj_Chunk& chunk = chunks[i];
+        chunk.base = base;
+
+        for ( std::size_t s = 0; s < chunk.segments.size(); s++ ) {
+            Obj_ChunkSegment& segment = chunk.segments[s];
+
+            if ( segment.directiveBegin != nullptr ) {
+                if ( !Parse_Obj_Directive(this, segment.directiveBegin, segment.directiveEnd, segment.lineEnd, curGroupIndex, curSmoothingGroupIndex, curMaterialIndex) ) {
+                    std::cout << "[ObjFile:load] Error: Failed to parse an OBJ file line and cannot recover." << std::endl;
+                    std::cout << "  Aborting OBJ file parsing process at line: " << std::string(segment.directiveBegin, segment.lineEnd) << std::endl;
+                    return false;
+                }
+            }
+
+            if ( segment.empty() ) continue;
+            if ( this->getMesh(this->size() - 1) == nullptr ) this->addMesh();
+
+            ObjMesh* target = this->getMesh(this->size() - 1).get();
+            segment.target = target;
+            segment.vertexOffset = target->vertices.size();
+            segment.textureOffset = target->textureCoordinates.size();
+            segment.normalOffset = target->normals.size();
+            segment.nodeOffset = target->vertexIndices.size();
+            segment.faceOffset = target->faces.size();
+            segment.groupIndex = curGroupIndex;
+            segment.smoothingGroupIndex = curSmoothingGroupIndex;
+            segment.materialIndex = curMaterialIndex;
+
+            target->vertices.resize(segment.vertexOffset + segment.geometry.vertices.size());
+            target->textureCoordinates.resize(segment.textureOffset + segment.geometry.textureCoordinates.size());
+            target->normals.resize(segment.normalOffset + segment.geometry.normals.size());
+            target->vertexIndices.resize(segment.nodeOffset + segment.geometry.vertexIndices.size());
+            target->textureIndices.resize(segment.nodeOffset + segment.geometry.textureIndices.size());
+            target->normalIndices.resize(segment.nodeOffset + segment.geometry.normalIndices.size());
+            target->faces.resize(segment.faceOffset + segment.geometry.faces.size());
+        }
+
+        base.vertices += chunk.counts.vertices;
+        base.textureCoordinates += chunk.counts.textureCoordinates;
+        base.normals += chunk.counts.normals;
+    }
+
+    //--------------------------------------------------------------------------
+    // Move the geometry of every chunk into place concurrently.
+    //--------------------------------------------------------------------------
+    ParallelFor(chunkCount, [&chunks](std::size_t i) { Merge_Obj_Chunk(chunks[i]); });
+
+    for ( std::size_t i = 0; i < chunkCount; i++ ) {
+        if ( !chunks[i].success ) {
+            std::cout << "[ObjFile:load] Error: Failed to resolve the relative face indices of the OBJ file." << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Visitor version of Parse_Obj_Face. The nodes of the face are resolved into
+ * the provided index arrays (reused between faces) and passed to the visitor.
  */
-bool Save_Obj_Header(std::ostream& out) {
-    out << "# CG Library Wavefront Obj Version 1.0 April 2015" << std::endl;
-	out << std::endl;
-	return true;
+bool Parse_Obj_Face(ObjVisitor& visitor, const char* cur, const char* end, const Obj_RecordCounts& counts, std::vector<std::uint32_t>& vertexIndices, std::vector<std::uint32_t>& textureIndices, std::vector<std::uint32_t>& normalIndices, bool& bContinue) {
+    const char* tokenBegin = nullptr;
+    const char* tokenEnd = nullptr;
+    vertexIndices.clear();
+    textureIndices.clear();
+    normalIndices.clear();
+
+    int vertexIndex = OBJ_INVALID_FACE_INDEX;
+    int textureCoordIndex = OBJ_INVALID_FACE_INDEX;
+    int normalIndex = OBJ_INVALID_FACE_INDEX;
+
+    while ( Obj_NextToken(cur, end, tokenBegin, tokenEnd) ) {
+        Parse_Obj_Node(tokenBegin, tokenEnd, vertexIndex, textureCoordIndex, normalIndex);
+
+        int v = vertexIndex, t = textureCoordIndex, n = normalIndex;
+        bool valid = Resolve_Obj_Index(v, counts.vertices, 0u, OBJ_FACE_VERTEX, nullptr);
+        valid = valid && Resolve_Obj_Index(t, counts.textureCoordinates, 0u, OBJ_FACE_TEXTURE, nullptr);
+        valid = valid && Resolve_Obj_Index(n, counts.normals, 0u, OBJ_FACE_NORMAL, nullptr);
+
+        if ( !valid || v < 0 ) {
+            std::cout << "[ObjFile:Parse_Obj_Face] Error: Invalid vertex index. Aborting." << std::endl;
+            return false;
+        }
+
+        vertexIndices.push_back(static_cast<std::uint32_t>(v));
+        textureIndices.push_back(static_cast<std::uint32_t>(t >= 0 ? t : 0));
+        normalIndices.push_back(static_cast<std::uint32_t>(n >= 0 ? n : 0));
+    }
+
+    if ( vertexIndices.size() <= 2 ) {
+        std::cout << "[ObjFile:Parse_Obj_Face] Warning: Invalid OBJ face. Each OBJ face must have at least 3 sides. Ignoring face." << std::endl;
+        return true;
+    }
+
+    bContinue = visitor.onFace(vertexIndices.data(), textureIndices.data(), normalIndices.data(), vertexIndices.size());
+    return true;
+}
+
+/* Visitor version of Parse_ObjFileLine for the line [begin, end). */
+bool Parse_ObjFileLine(ObjVisitor& visitor, const char* begin, const char* end, Obj_RecordCounts& counts, std::vector<std::uint32_t>& vertexIndices, std::vector<std::uint32_t>& textureIndices, std::vector<std::uint32_t>& normalIndices, bool& bContinue) {
+    const char* cur = begin;
+    const char* idBegin = nullptr;
+    const char* idEnd = nullptr;
+    Vector3f vector;
+
+    switch ( Classify_Obj_Line(cur, end, idBegin, idEnd) ) {
+        case OBJ_RECORD_EMPTY:
+            return true;
+        case OBJ_RECORD_VERTEX:
+            Parse_Obj_Vector(cur, end, vector);
+            counts.vertices++;
+            bContinue = visitor.onVertex(vector);
+            return true;
+        case OBJ_RECORD_TEXTURE:
+            Parse_Obj_Vector(cur, end, vector);
+            counts.textureCoordinates++;
+            bContinue = visitor.onTexcoord(vector);
+            return true;
+        case OBJ_RECORD_NORMAL:
+            Parse_Obj_Vector(cur, end, vector);
+            counts.normals++;
+            bContinue = visitor.onNormal(vector);
+            return true;
+        case OBJ_RECORD_FACE:
+            return Parse_Obj_Face(visitor, cur, end, counts, vertexIndices, textureIndices, normalIndices, bContinue);
+        default:
+            break;
+    }
+
+    //--------------------------------------------------------------------------
+    // Groups, objects, and materials are named by their first argument, the
+    // remaining records (smoothing groups, material libraries) are not
+    // visited.
+    //--------------------------------------------------------------------------
+    const char* nameBegin = nullptr;
+    const char* nameEnd = nullptr;
+    Obj_NextToken(cur, end, nameBegin, nameEnd);
+
+    if ( Obj_TokenEquals(idBegin, idEnd, OBJ_GROUP) ) bContinue = visitor.onGroup(std::string(nameBegin, nameEnd));
+    else if ( Obj_TokenEquals(idBegin, idEnd, OBJ_OBJECT) ) bContinue = visitor.onObject(std::string(nameBegin, nameEnd));
+    else if ( Obj_TokenEquals(idBegin, idEnd, OBJ_SMOOTHING_GROUP) ) return true;
+    else if ( Obj_TokenEquals(idBegin, idEnd, OBJ_MATERIAL_LIBRARY) ) {
+        for ( bool bName = (nameBegin != nameEnd); bName && bContinue; bName = Obj_NextToken(cur, end, nameBegin, nameEnd) )
+            bContinue = visitor.onMaterialLibrary(std::string(nameBegin, nameEnd));
+    }
+    else if ( Obj_TokenEquals(idBegin, idEnd, OBJ_USE_MATERIAL) ) bContinue = visitor.onMaterial(std::string(nameBegin, nameEnd));
+    else std::cerr << "[ObjFile:Parse_ObjFileLine] Warning: Encountered an unrecognized OBJ file line. Ignoring Command." << std::endl;
+
+    return true;
+}
+
+bool ParseObjFile(const std::string& filename, ObjVisitor& visitor) {
+    MappedFile file;
+    if ( !file.open(filename) ) {
+        std::cerr << "[ParseObjFile] Error: The file: " << filename << " could not be opened." << std::endl;
+        return false;
+    }
+
+    Obj_RecordCounts counts;
+    std::vector<std::uint32_t> vertexIndices;
+    std::vector<std::uint32_t> textureIndices;
+    std::vector<std::uint32_t> normalIndices;
+    bool bContinue = true;
+
+    const char* cur = file.data();
+    const char* end = file.data() + file.size();
+    while ( cur < end && bContinue ) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(cur, '\n', static_cast<std::size_t>(end - cur)));
+        if ( lineEnd == nullptr ) lineEnd = end;
+
+        if ( !Parse_ObjFileLine(visitor, cur, lineEnd, counts, vertexIndices, textureIndices, normalIndices, bContinue) ) {
+            std::cout << "[ParseObjFile] Error: Failed to parse an OBJ file line and cannot recover." << std::endl;
+            std::cout << "  Aborting OBJ file parsing process at line: " << std::string(cur, lineEnd) << std::endl;
+            return false;
+        }
+
+        cur = lineEnd + 1;
+    }
+
+    return true;
+}
+
+ObjMaterial::ObjMaterial() {
+    this->diffuse = Vector3f(0.6f, 0.6f, 0.6f);
+    this->specular = Vector3f(0.2f, 0.2f, 0.2f);
+    this->shininess = 10.0f;
 }
 
 /* 
- * Prints out the names of the external libraries that are referenced by an
- * Obj file.
+ * Parse the texture map of a material library line. Options (-bm 1.0, ...)
+ * precede the filename so the last token is used. The filename is resolved
+ * against the directory of the material library.
  */
-bool Save_Obj_MaterialLibraries(std::ostream& out, const StringArray& materialLibraries) {
-    if ( materialLibraries.size() == 0 ) return true;
+bool Parse_Mtl_Map(const std::string& directory, const char* cur, const char* end, std::string& map) {
+    const char* tokenBegin = nullptr;
+    const char* tokenEnd = nullptr;
+    const char* nameBegin = nullptr;
+    const char* nameEnd = nullptr;
+    while ( Obj_NextToken(cur, end, tokenBegin, tokenEnd) ) {
+        nameBegin = tokenBegin;
+        nameEnd = tokenEnd;
+    }
 
-    out << "# Obj Material Libraries" << std::endl;
-    for ( unsigned int i = 0; i < materialLibraries.size(); i++ )
-        out << OBJ_MATERIAL_LIBRARY << OBJ_DELIMITER << materialLibraries[i] << std::endl;
-    out << std::endl;
+    if ( nameBegin == nullptr ) {
+        std::cerr << "[ObjFile:Parse_Mtl_Map] Warning: Texture map without a filename. Ignoring map." << std::endl;
+        return true;
+    }
+
+    std::filesystem::path path(std::string(nameBegin, nameEnd));
+    if ( path.is_relative() ) path = std::filesystem::path(directory) / path;
+    map = path.string();
     return true;
 }
 
-/*
- * Save all of the provided meshes texture coordinates to the provided stream.
- * Ex: for each texture coordinate
- *         vt 1.0 1.0 0.0
- *     # n texture coordinates
- */
-bool Save_ObjMesh_TextureCoords(std::ostream& out, const std::shared_ptr<ObjMesh>& mesh) {
-    for ( unsigned int i = 0; i < mesh->textureCoordinates.size(); i++ ) {
-        out << OBJ_VERTEX_TEXTURE 
-            << OBJ_DELIMITER 
-            << mesh->textureCoordinates[i].x() 
-            << OBJ_DELIMITER 
-            << mesh->textureCoordinates[i].y() 
-            << OBJ_DELIMITER 
-            << mesh->textureCoordinates[i].z() 
-            << std::endl;      
+bool LoadObjMaterialLibrary(const std::string& filename, std::vector<ObjMaterial>& materials) {
+    MappedFile file;
+    if ( !file.open(filename) ) {
+        std::cerr << "[LoadObjMaterialLibrary] Error: The file: " << filename << " could not be opened." << std::endl;
+        return false;
     }
 
-    if ( mesh->textureCoordinates.size() > 0 ) {
-        out << "# " << mesh->textureCoordinates.size() << " texture coordinates" << std::endl;
-        out << std::endl;
+    std::string directory = std::filesystem::path(filename).parent_path().string();
+    ObjMaterial* material = nullptr;
+    Vector3f vector;
+
+    const char* cur = file.data();
+    const char* end = file.data() + file.size();
+    while ( cur < end ) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(cur, '\n', static_cast<std::size_t>(end - cur)));
+        if ( lineEnd == nullptr ) lineEnd = end;
+
+        const char* idBegin = nullptr;
+        const char* idEnd = nullptr;
+        const char* argument = cur;
+        cur = lineEnd + 1;
+        if ( !Obj_NextToken(argument, lineEnd, idBegin, idEnd) || *idBegin == OBJ_COMMENT ) continue;
+
+        //----------------------------------------------------------------------
+        // Each newmtl record starts a material, the following properties 
+        // belong to that material. Unsupported properties are ignored.
+        //----------------------------------------------------------------------
+        if ( Obj_TokenEquals(idBegin, idEnd, MTL_NEW_MATERIAL) ) {
+            const char* nameBegin = nullptr;
+            const char* nameEnd = nullptr;
+            Obj_NextToken(argument, lineEnd, nameBegin, nameEnd);
+            materials.push_back(ObjMaterial());
+            material = &materials.back();
+            material->name = std::string(nameBegin, nameEnd);
+            continue;
+        }
+
+        if ( material == nullptr ) continue;
+
+        if ( Obj_TokenEquals(idBegin, idEnd, MTL_DIFFUSE) ) Parse_Obj_Vector(argument, lineEnd, material->diffuse);
+        else if ( Obj_TokenEquals(idBegin, idEnd, MTL_SPECULAR) ) Parse_Obj_Vector(argument, lineEnd, material->specular);
+        else if ( Obj_TokenEquals(idBegin, idEnd, MTL_SHININESS) ) material->shininess = Parse_Obj_Float(argument, lineEnd);
+        else if ( Obj_TokenEquals(idBegin, idEnd, MTL_DIFFUSE_MAP) ) Parse_Mtl_Map(directory, argument, lineEnd, material->diffuseMap);
+        else if ( Obj_TokenEquals(idBegin, idEnd, MTL_SPECULAR_MAP) ) Parse_Mtl_Map(directory, argument, lineEnd, material->specularMap);
+        else if ( Obj_TokenEquals(idBegin, idEnd, MTL_NORMAL_MAP) || Obj_TokenEquals(idBegin, idEnd, MTL_NORMAL_MAP_ALT) ) Parse_Mtl_Map(directory, argument, lineEnd, material->normalMap);
     }
 
     return true;
 }
 
+/* Number of v, vt, vn, or f records formatted as a single save chunk. */
+static const std::size_t OBJ_SAVE_CHUNK_SIZE = 1u << 16;
+
+/*
+ * Expected formatted size of a v, vt, or vn record (keyword and three fixed
+ * floats with up to four integer digits) and largest size of a face node
+ * (three 32-bit indices and their delimiters), used to reserve the buffers
+ * of ObjFile::save.
+ */
+static const std::size_t OBJ_SAVE_VECTOR_RECORD_SIZE = 3u + 3u * (OBJ_PRECISION + 7u);
+static const std::size_t OBJ_SAVE_FACE_NODE_SIZE = 3u * 11u + 1u;
+
+/* Appends text to an Obj output buffer. */
+inline void Obj_AppendText(std::string& out, const std::string& text) {
+    out.append(text);
+}
+
+/* Appends an integer to an Obj output buffer. */
+inline void Obj_AppendInteger(std::string& out, std::uint64_t value) {
+    char digits[32];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
 /* 
- * Save all of the provided meshes normals to the provided out stream.
- * Ex: for each normal:
- *         vn 1.0 2.0 3.0
- *     # n vertex normals
+ * Appends a float with OBJ_PRECISION fixed digits to an Obj output buffer,
+ * identical to streaming it with std::fixed and std::setprecision.
  */
-bool Save_ObjMesh_Normals(std::ostream& out, const std::shared_ptr<ObjMesh>& mesh) {
-    for ( unsigned int i = 0; i < mesh->normals.size(); i++ ) {
-        out << OBJ_VERTEX_NORMAL 
-            << OBJ_DELIMITER 
-            << mesh->normals[i].x() 
-            << OBJ_DELIMITER 
-            << mesh->normals[i].y() 
-            << OBJ_DELIMITER 
-            << mesh->normals[i].z() 
-            << std::endl;
+inline void Obj_AppendFloat(std::string& out, float value) {
+    char digits[64];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, static_cast<int>(OBJ_PRECISION));
+    out.append(digits, result.ptr);
+}
+
+/* 
+ * Prints out an information header for an Obj file. This information is only
+ * included in a comment.
+ */
+bool Save_Obj_Header(std::string& out) {
+    Obj_AppendText(out, "# CG Library Wavefront Obj Version 1.0 April 2015\n\n");
+	return true;
+}
+
+/* 
+ * Prints out the names of the external libraries that are referenced by an
+ * Obj file.
+ */
+bool Save_Obj_MaterialLibraries(std::string& out, const StringArray& materialLibraries) {
+    if ( materialLibraries.size() == 0 ) return true;
+
+    Obj_AppendText(out, "# Obj Material Libraries\n");
+    for ( unsigned int i = 0; i < materialLibraries.size(); i++ ) {
+        Obj_AppendText(out, OBJ_MATERIAL_LIBRARY + OBJ_DELIMITER + materialLibraries[i]);
+        out.push_back('\n');
     }
+    out.push_back('\n');
+    return true;
+}
 
-    if ( mesh->normals.size() > 0 ) {
-        out << "# " << mesh->normals.size() << " vertex normals" << std::endl;
-        out << std::endl;
+/*
+ * Save the vectors [begin, end) of a mesh (vertices, texture coordinates, or
+ * normals) as records with the provided keyword.
+ * Ex: for each vector:
+ *         v 1.0 2.0 3.0
+ */
+bool Save_ObjMesh_Vectors(std::string& out, const std::string& keyword, const std::vector<Vector3f>& vectors, std::size_t begin, std::size_t end) {
+    for ( std::size_t i = begin; i < end; i++ ) {
+        Obj_AppendText(out, keyword);
+        out.push_back(OBJ_DELIMITER_CHAR);
+        Obj_AppendFloat(out, vectors[i].x());
+        out.push_back(OBJ_DELIMITER_CHAR);
+        Obj_AppendFloat(out, vectors[i].y());
+        out.push_back(OBJ_DELIMITER_CHAR);
+        Obj_AppendFloat(out, vectors[i].z());
+        out.push_back('\n');
     }
 
     return true;
 }
 
-bool Save_ObjMesh_Faces(std::ostream& out, const ObjFile* const objFile, std::shared_ptr<ObjMesh>& mesh, bool saveTextureCoords, bool saveNormals) {
-    std::size_t lastMaterialIndex = 0;
-	std::size_t lastGroupIndex = 0;
-	std::size_t lastSmoothingGroupIndex = 0;
-    std::size_t numFaces = mesh->faces.size();
-	Obj_Face face;
+/*
+ * Group, material, and smoothing group most recently written before a face.
+ * A directive is only written when the face changes it.
+ */
+struct Obj_SaveState {
+    Obj_SaveState() : lastGroupIndex(0), lastMaterialIndex(0), lastSmoothingGroupIndex(0) {}
+
+    std::size_t lastGroupIndex;
+    std::size_t lastMaterialIndex;
+    std::size_t lastSmoothingGroupIndex;
+};
+
+/* Advances the save state past the provided face without writing it. */
+inline void Advance_Obj_SaveState(Obj_SaveState& state, const Obj_Face& face) {
+    if ( face.groupIndex != 0 ) state.lastGroupIndex = face.groupIndex;
+    if ( face.materialIndex != 0 ) state.lastMaterialIndex = face.materialIndex;
+    if ( face.smoothingGroupIndex != 0 ) state.lastSmoothingGroupIndex = face.smoothingGroupIndex;
+}
 
-    for ( unsigned int i = 0; i < numFaces; i++ ) {
-		face = mesh->faces[i];
+/* Save the faces [begin, end) of a mesh starting from the provided state. */
+bool Save_ObjMesh_Faces(std::string& out, const ObjFile* const objFile, const ObjMesh* const mesh, std::size_t begin, std::size_t end, Obj_SaveState state, bool saveTextureCoords, bool saveNormals) {
+    for ( std::size_t f = begin; f < end; f++ ) {
+		const Obj_Face& face = mesh->faces[f];
 
 		//----------------------------------------------------------------------
 		// If the face belongs to a group, define the group. If the faces group
 		// index is 0 that means it belongs to no group.
 		//----------------------------------------------------------------------
-		if ( face.groupIndex != 0 && face.groupIndex != lastGroupIndex ) {
-            if ( objFile->getFaceGroup(face.groupIndex).compare(OBJ_NO_GROUP) == 0 )
-                out << OBJ_GROUP << OBJ_DELIMITER << mesh->name << std::endl;
-			else out << OBJ_GROUP << OBJ_DELIMITER << objFile->getFaceGroup(face.groupIndex) << std::endl;
-			lastGroupIndex = face.groupIndex;
+		if ( face.groupIndex != 0 && face.groupIndex != state.lastGroupIndex ) {
+            Obj_AppendText(out, OBJ_GROUP + OBJ_DELIMITER);
+            if ( objFile->getFaceGroup(face.groupIndex).compare(OBJ_NO_GROUP) == 0 ) Obj_AppendText(out, mesh->name);
+			else Obj_AppendText(out, objFile->getFaceGroup(face.groupIndex));
+            out.push_back('\n');
 		}
 
 		//----------------------------------------------------------------------
 		// If the face has a material, define the material. If the faces 
 		// material index is 0 that means it has no material.
 		//----------------------------------------------------------------------
-		if ( face.materialIndex != 0 && face.materialIndex != lastMaterialIndex ) {
-			out << OBJ_USE_MATERIAL << OBJ_DELIMITER << objFile->getFaceMaterial(face.groupIndex) << std::endl;
-			lastMaterialIndex = face.materialIndex;
+		if ( face.materialIndex != 0 && face.materialIndex != state.lastMaterialIndex ) {
+			Obj_AppendText(out, OBJ_USE_MATERIAL + OBJ_DELIMITER + objFile->getFaceMaterial(face.groupIndex));
+            out.push_back('\n');
 		}
 
 		//----------------------------------------------------------------------
 		// If a face does not belong to a smoothing group then it is simply not
 		// included.
 		//----------------------------------------------------------------------
-		if ( face.smoothingGroupIndex != 0 && face.smoothingGroupIndex != lastSmoothingGroupIndex ) {
-			out << OBJ_SMOOTHING_GROUP << OBJ_DELIMITER << face.smoothingGroupIndex << std::endl;
-			lastSmoothingGroupIndex = face.smoothingGroupIndex;
+		if ( face.smoothingGroupIndex != 0 && face.smoothingGroupIndex != state.lastSmoothingGroupIndex ) {
+			Obj_AppendText(out, OBJ_SMOOTHING_GROUP + OBJ_DELIMITER);
+            Obj_AppendInteger(out, face.smoothingGroupIndex);
+            out.push_back('\n');
 		}
 
+        Advance_Obj_SaveState(state, face);
+
 		//----------------------------------------------------------------------
 		// Write the face indices of the face. Vertices are required, therefore
 		// the size of that index array is used for indexing through all of the
 		// indice arrays.
 		//----------------------------------------------------------------------
-		out << OBJ_FACE << OBJ_DELIMITER;
-		for ( unsigned int i = 0; i < face.vertexIndices.size(); i++ ) {
+		Obj_AppendText(out, OBJ_FACE);
+        out.push_back(OBJ_DELIMITER_CHAR);
+		for ( std::size_t i = face.offset; i < face.offset + face.count; i++ ) {
 			//------------------------------------------------------------------
 			// Depending on which vertex components are included (normal, 
 			// texture coordinate), write the proper definition of each face 
 			// node.
 			//------------------------------------------------------------------
-			out << face.vertexIndices[i] + OBJ_INDEX_OFFSET;
+			Obj_AppendInteger(out, mesh->vertexIndices[i] + OBJ_INDEX_OFFSET);
 			if ( saveTextureCoords == true && saveNormals == true ) {
-				if ( face.textureIndices.size() > 0 && face.normalIndices.size() > 0 )
-					out << OBJ_NODE_DELIMITER << face.textureIndices[i] + OBJ_INDEX_OFFSET << OBJ_NODE_DELIMITER << face.normalIndices[i] + OBJ_INDEX_OFFSET;
-				else if ( face.textureIndices.size() > 0 && face.normalIndices.size() == 0 )
-					out << OBJ_NODE_DELIMITER << face.textureIndices[i] + OBJ_INDEX_OFFSET;
+				if ( mesh->textureIndices.size() > 0 ) {
+                    out.push_back(OBJ_NODE_DELIMITER);
+					Obj_AppendInteger(out, mesh->textureIndices[i] + OBJ_INDEX_OFFSET);
+                }
+				if ( mesh->textureIndices.size() > 0 && mesh->normalIndices.size() > 0 ) {
+                    out.push_back(OBJ_NODE_DELIMITER);
+					Obj_AppendInteger(out, mesh->normalIndices[i] + OBJ_INDEX_OFFSET);
+                }
 			}
 			else if ( saveTextureCoords == true && saveNormals == false ) {
-				if ( face.textureIndices.size() > 0 )
-					out << OBJ_NODE_DELIMITER << face.textureIndices[i] + OBJ_INDEX_OFFSET;
+				if ( mesh->textureIndices.size() > 0 ) {
+                    out.push_back(OBJ_NODE_DELIMITER);
+					Obj_AppendInteger(out, mesh->textureIndices[i] + OBJ_INDEX_OFFSET);
+                }
 			}
 			else {
-				if ( face.normalIndices.size() > 0 )
-					out << OBJ_NODE_DELIMITER << OBJ_NODE_DELIMITER << face.normalIndices[i] + OBJ_INDEX_OFFSET;
+				if ( mesh->normalIndices.size() > 0 ) {
+                    out.push_back(OBJ_NODE_DELIMITER);
+                    out.push_back(OBJ_NODE_DELIMITER);
+					Obj_AppendInteger(out, mesh->normalIndices[i] + OBJ_INDEX_OFFSET);
+                }
 			}
 			
-			out << OBJ_DELIMITER;
+			out.push_back(OBJ_DELIMITER_CHAR);
 		}
 
-        out << std::endl;
+        out.push_back('\n');
     }
 
-    if ( mesh->faces.size() > 0 ) {
-        out << "# " << mesh->faces.size() << " faces" << std::endl;
-        out << std::endl;
+    return true;
+}
+
+/* Kind of content formatted by an Obj_SaveChunk. */
+enum Obj_SaveChunkType { OBJ_SAVE_TEXT, OBJ_SAVE_VERTICES, OBJ_SAVE_TEXTURE_COORDS, OBJ_SAVE_NORMALS, OBJ_SAVE_FACES };
+
+/* 
+ * Independently formatted portion of an Obj file: a run of records [begin,
+ * end) of a mesh or literal text (headers and record counts).
+ */
+struct Obj_SaveChunk {
+    Obj_SaveChunkType type;
+    const ObjMesh* mesh;
+    std::string text;
+    std::size_t begin;
+    std::size_t end;
+
+    /* Directive state at the first face of a face chunk. */
+    Obj_SaveState state;
+    bool saveTextureCoords;
+    bool saveNormals;
+};
+
+/* Appends the record chunks covering [0, count) of a mesh. */
+void Add_Obj_SaveChunks(std::vector<Obj_SaveChunk>& chunks, Obj_SaveChunkType type, const ObjMesh* const mesh, std::size_t count) {
+    for ( std::size_t begin = 0; begin < count; begin += OBJ_SAVE_CHUNK_SIZE ) {
+        Obj_SaveChunk chunk;
+        chunk.type = type;
+        chunk.mesh = mesh;
+        chunk.begin = begin;
+        chunk.end = std::min(count, begin + OBJ_SAVE_CHUNK_SIZE);
+        chunk.saveTextureCoords = false;
+        chunk.saveNormals = false;
+        chunks.push_back(chunk);
     }
+}
 
-    return true;
+/* Appends a text chunk (merged with a preceding text chunk). */
+void Add_Obj_SaveText(std::vector<Obj_SaveChunk>& chunks, const std::string& text) {
+    if ( chunks.size() == 0 || chunks.back().type != OBJ_SAVE_TEXT ) {
+        Obj_SaveChunk chunk;
+        chunk.type = OBJ_SAVE_TEXT;
+        chunk.mesh = nullptr;
+        chunk.begin = 0u;
+        chunk.end = 0u;
+        chunk.saveTextureCoords = false;
+        chunk.saveNormals = false;
+        chunks.push_back(chunk);
+    }
+
+    chunks.back().text.append(text);
 }
 
 /*
- * This function saves all of the meshes contained within the provided Obj file.
- * For each mesh, its vertices, texture-coords, normals, and face information
- * will be printed individually.
+ * This function splits all of the meshes contained within the provided Obj
+ * file into chunks that can be formatted independently. For each mesh, its 
+ * vertices, texture-coords, normals, and face information will be printed
+ * individually.
  *
- * @param out - The output stream (file).
+ * @param chunks - The chunks of the Obj file in file order.
  * @param objFile - The Obj file defintion containing an array of ObjMeshes
  * @param saveTextureCoords - Flag to save the texture coords of each mesh
  * @param saveNormals - Flag to save the normals of each mesh
  * 
- * @return If the meshes are saved successfully then this function will return
+ * @return If the meshes are split successfully then this function will return
  * true; otherwise it will return false.
  */
-bool Save_ObjMeshes(std::ostream& out, const ObjFile* const objFile, bool saveTextureCoords, bool saveNormals) {
+bool Save_ObjMeshes(std::vector<Obj_SaveChunk>& chunks, const ObjFile* const objFile, bool saveTextureCoords, bool saveNormals) {
     if ( objFile == nullptr ) {
         std::cerr << "[Save_ObjMesh:save] Error: Cannot save nullptr ObjFile." << std::endl;
         return true;
     }
 
-    //--------------------------------------------------------------------------
-    // For each mesh within the Obj file, save it to the provided out stream.
-    //--------------------------------------------------------------------------
+    std::string text;
     for ( unsigned int i = 0; i < objFile->size(); i++ ) {
         auto mesh = objFile->getMesh(i);
         bool saveMeshTextureCoords = saveTextureCoords;
         bool saveMeshNormals = saveNormals;
 
-        for ( unsigned int i = 0; i < mesh->vertices.size(); i++ ) {
-		    out << OBJ_VERTEX 
-                << OBJ_DELIMITER 
-                << mesh->vertices[i].x() 
-                << OBJ_DELIMITER 
-                << mesh->vertices[i].y() 
-                << OBJ_DELIMITER 
-                << mesh->vertices[i].z() 
-                << std::endl;
-        }
-
-	    out << "# " << mesh->vertices.size() << " vertices" << std::endl;
-	    out << std::endl;
+        Add_Obj_SaveChunks(chunks, OBJ_SAVE_VERTICES, mesh.get(), mesh->vertices.size());
+        text.clear();
+        text.append("# ");
+        Obj_AppendInteger(text, mesh->vertices.size());
+        text.append(" vertices\n\n");
+        Add_Obj_SaveText(chunks, text);
 
         if ( mesh->textureCoordinates.size() == 0 ) saveMeshTextureCoords = false;
         if ( mesh->normals.size() == 0 ) saveMeshNormals = false;
 
-        if ( saveMeshTextureCoords == true ) Save_ObjMesh_TextureCoords(out, mesh);
-        if ( saveMeshNormals == true ) Save_ObjMesh_Normals(out, mesh);
-        Save_ObjMesh_Faces(out, objFile, mesh, saveMeshTextureCoords, saveMeshNormals);
+        if ( saveMeshTextureCoords == true ) {
+            Add_Obj_SaveChunks(chunks, OBJ_SAVE_TEXTURE_COORDS, mesh.get(), mesh->textureCoordinates.size());
+            text.clear();
+            text.append("# ");
+            Obj_AppendInteger(text, mesh->textureCoordinates.size());
+            text.append(" texture coordinates\n\n");
+            Add_Obj_SaveText(chunks, text);
+        }
+
+        if ( saveMeshNormals == true ) {
+            Add_Obj_SaveChunks(chunks, OBJ_SAVE_NORMALS, mesh.get(), mesh->normals.size());
+            text.clear();
+            text.append("# ");
+            Obj_AppendInteger(text, mesh->normals.size());
+            text.append(" vertex normals\n\n");
+            Add_Obj_SaveText(chunks, text);
+        }
+
+        //----------------------------------------------------------------------
+        // The group, material, and smoothing group directives written depend
+        // on the preceding faces, so the state at the start of each face chunk
+        // is determined up front.
+        //----------------------------------------------------------------------
+        std::size_t firstChunk = chunks.size();
+        Add_Obj_SaveChunks(chunks, OBJ_SAVE_FACES, mesh.get(), mesh->faces.size());
+
+        Obj_SaveState state;
+        for ( std::size_t c = firstChunk; c < chunks.size(); c++ ) {
+            chunks[c].state = state;
+            chunks[c].saveTextureCoords = saveMeshTextureCoords;
+            chunks[c].saveNormals = saveMeshNormals;
+            for ( std::size_t f = chunks[c].begin; f < chunks[c].end; f++ )
+                Advance_Obj_SaveState(state, mesh->faces[f]);
+        }
+
+        if ( mesh->faces.size() > 0 ) {
+            text.clear();
+            text.append("# ");
+            Obj_AppendInteger(text, mesh->faces.size());
+            text.append(" faces\n\n");
+            Add_Obj_SaveText(chunks, text);
+        }
     }
 
     return true;
 }
 
+/*
+ * Returns the expected formatted size of a save chunk from the number of its
+ * records (exact for text). Group and material directives between faces are
+ * not counted; a buffer simply grows past its reserve if needed.
+ */
+std::size_t Estimate_Obj_SaveChunkSize(const Obj_SaveChunk& chunk) {
+    if ( chunk.type == OBJ_SAVE_TEXT ) return chunk.text.size();
+    if ( chunk.type != OBJ_SAVE_FACES ) return (chunk.end - chunk.begin) * OBJ_SAVE_VECTOR_RECORD_SIZE;
+    if ( chunk.end == chunk.begin ) return 0u;
+
+    //--------------------------------------------------------------------------
+    // The nodes of consecutive faces are consecutive in the index streams.
+    //--------------------------------------------------------------------------
+    const Obj_Face& first = chunk.mesh->faces[chunk.begin];
+    const Obj_Face& last = chunk.mesh->faces[chunk.end - 1];
+    std::size_t nodeCount = static_cast<std::size_t>(last.offset) + last.count - first.offset;
+    return (chunk.end - chunk.begin) * (OBJ_FACE.length() + 2u) + nodeCount * OBJ_SAVE_FACE_NODE_SIZE;
+}
+
+/* Formats the chunks [begin, end) of an Obj file into the provided buffer. */
+void Format_Obj_SaveChunks(std::string& out, const ObjFile* const objFile, const std::vector<Obj_SaveChunk>& chunks, std::size_t begin, std::size_t end) {
+    for ( std::size_t c = begin; c < end; c++ ) {
+        const Obj_SaveChunk& chunk = chunks[c];
+
+        switch ( chunk.type ) {
+            case OBJ_SAVE_TEXT: Obj_AppendText(out, chunk.text); break;
+            case OBJ_SAVE_VERTICES: Save_ObjMesh_Vectors(out, OBJ_VERTEX, chunk.mesh->vertices, chunk.begin, chunk.end); break;
+            case OBJ_SAVE_TEXTURE_COORDS: Save_ObjMesh_Vectors(out, OBJ_VERTEX_TEXTURE, chunk.mesh->textureCoordinates, chunk.begin, chunk.end); break;
+            case OBJ_SAVE_NORMALS: Save_ObjMesh_Vectors(out, OBJ_VERTEX_NORMAL, chunk.mesh->normals, chunk.begin, chunk.end); break;
+            case OBJ_SAVE_FACES: Save_ObjMesh_Faces(out, objFile, chunk.mesh, chunk.begin, chunk.end, chunk.state, chunk.saveTextureCoords, chunk.saveNormals); break;
+        }
+    }
+}
+
 bool ObjFile::save(const std::string& filename, bool saveTextureCoords, bool saveNormals) {
     if ( filename.length() == 0 ) {
         std::cerr << "[ObjFile:save] Error: Cannot save to obj filename of length 0." << std::endl;
@@ -657,7 +1651,6 @@ bool ObjFile::save(const std::string& filename, bool saveTextureCoords, bool sav
 
     std::ofstream out;
     out.open(filename.c_str());
-    out << std::fixed << std::setprecision(OBJ_PRECISION);
 
     if ( out.is_open() == false ) {
         std::cerr << "[ObjFile:save] Error: Could not open file: " << filename << std::endl;
@@ -665,11 +1658,39 @@ bool ObjFile::save(const std::string& filename, bool saveTextureCoords, bool sav
     }
 
     //--------------------------------------------------------------------------
-    // Write the Obj file.
+    // Split the Obj file into chunks in file order.
     //--------------------------------------------------------------------------
-    Save_Obj_Header(out);
-    Save_Obj_MaterialLibraries(out, this->materialLibraries);
-    Save_ObjMeshes(out, this, saveTextureCoords, saveNormals);
+    std::vector<Obj_SaveChunk> chunks;
+    std::string text;
+    Save_Obj_Header(text);
+    Save_Obj_MaterialLibraries(text, this->materialLibraries);
+    Add_Obj_SaveText(chunks, text);
+    Save_ObjMeshes(chunks, this, saveTextureCoords, saveNormals);
+
+    //--------------------------------------------------------------------------
+    // Each thread formats a contiguous run of chunks into its own buffer. The
+    // buffers are written in order, one write per thread.
+    //--------------------------------------------------------------------------
+    std::size_t threadCount = GetThreadCount();
+    threadCount = std::max<std::size_t>(1u, std::min(threadCount, chunks.size()));
+    std::vector<std::string> buffers(threadCount);
+
+    ParallelFor(threadCount, [&](std::size_t t) {
+        std::size_t begin = chunks.size() * t / threadCount;
+        std::size_t end = chunks.size() * (t + 1) / threadCount;
+        std::size_t size = 0u;
+        for ( std::size_t c = begin; c < end; c++ ) size += Estimate_Obj_SaveChunkSize(chunks[c]);
+        buffers[t].reserve(size);
+        Format_Obj_SaveChunks(buffers[t], this, chunks, begin, end);
+    });
+
+    for ( std::size_t t = 0; t < threadCount; t++ )
+        out.write(buffers[t].data(), static_cast<std::streamsize>(buffers[t].size()));
+
+    if ( !out.good() ) {
+        std::cerr << "[ObjFile:save] Error: Could not write file: " << filename << std::endl;
+        return false;
+    }
 
     out.close();
     return true;
@@ -744,8 +1765,8 @@ void Print_ObjMesh(std::stringstream& str, const std::shared_ptr<ObjMesh>& mesh)
     for ( unsigned int f = 0; f < mesh->faces.size(); f++ ) {
         face = mesh->faces[f];
         str << "\t\t\tf ";
-        for ( unsigned int x = 0; x < face.vertexIndices.size(); x++ ) {
-            str << face.vertexIndices[x]+1 << "/" << face.textureIndices[x]+1 << "/" << face.normalIndices[x]+1 << " ";
+        for ( std::size_t x = face.offset; x < face.offset + face.count; x++ ) {
+            str << mesh->vertexIndices[x]+1 << "/" << mesh->textureIndices[x]+1 << "/" << mesh->normalIndices[x]+1 << " ";
         }
         str << std::endl;
     }
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "VertexLayout.h"
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+namespace sgpu {
+
+VertexLayout::VertexLayout() {
+    this->directionFormat = VERTEX_DIRECTION_FLOAT;
+    this->textureCoordFormat = VERTEX_TEXTURE_COORD_FLOAT;
+    this->colorFormat = VERTEX_COLOR_FLOAT;
+    this->bShortIndices = false;
+}
+
+VertexLayout VertexLayout::Compact() {
+    VertexLayout layout;
+    layout.directionFormat = VERTEX_DIRECTION_INT_2_10_10_10;
+    layout.textureCoordFormat = VERTEX_TEXTURE_COORD_HALF;
+    layout.colorFormat = VERTEX_COLOR_NONE;
+    layout.bShortIndices = true;
+    return layout;
+}
+
+std::size_t GetVertexAttributeSize(const VertexLayout& layout, VertexAttribute attribute) {
+    switch ( attribute ) {
+        case VERTEX_POSITION: return 3u * sizeof(float);
+        case VERTEX_NORMAL:
+            if ( layout.directionFormat == VERTEX_DIRECTION_FLOAT ) return 3u * sizeof(float);
+            return 4u;
+        case VERTEX_TANGENT:
+            if ( layout.directionFormat == VERTEX_DIRECTION_FLOAT ) return 4u * sizeof(float);
+            if ( layout.directionFormat == VERTEX_DIRECTION_OCTAHEDRAL ) return 4u * sizeof(std::int16_t);
+            return 4u;
+        case VERTEX_TEXTURE_COORD:
+            if ( layout.textureCoordFormat == VERTEX_TEXTURE_COORD_FLOAT ) return 3u * sizeof(float);
+            return 2u * sizeof(std::uint16_t);
+        case VERTEX_COLOR:
+            if ( layout.colorFormat == VERTEX_COLOR_FLOAT ) return 3u * sizeof(float);
+            if ( layout.colorFormat == VERTEX_COLOR_UNORM8 ) return 4u;
+            return 0u;
+        default: return 0u;
+    }
+}
+
+std::size_t GetVertexAttributeOffset(const VertexLayout& layout, VertexAttribute attribute) {
+    std::size_t offset = 0;
+    for ( int i = VERTEX_POSITION; i < attribute; i++ )
+        offset += GetVertexAttributeSize(layout, static_cast<VertexAttribute>(i));
+    return offset;
+}
+
+std::size_t GetVertexSize(const VertexLayout& layout) {
+    return GetVertexAttributeOffset(layout, VERTEX_ATTRIBUTE_COUNT);
+}
+
+bool IsUnpackedVertexLayout(const VertexLayout& layout) {
+    return layout.directionFormat == VERTEX_DIRECTION_FLOAT &&
+        layout.textureCoordFormat == VERTEX_TEXTURE_COORD_FLOAT &&
+        layout.colorFormat == VERTEX_COLOR_FLOAT;
+}
+
+//----------------------------------------------------------------------------
+// Attribute packing
+//----------------------------------------------------------------------------
+inline float Layout_Clamp(float value, float minimum, float maximum) {
+    if ( !(value >= minimum) ) return minimum;
+    return std::min(value, maximum);
+}
+
+/* Signed normalized 10-bit component of a 2_10_10_10 word. */
+inline std::uint32_t Layout_PackSnorm10(float value) {
+    std::int32_t quantized = static_cast<std::int32_t>(std::lround(Layout_Clamp(value, -1.0f, 1.0f) * 511.0f));
+    return static_cast<std::uint32_t>(quantized) & 0x3FFu;
+}
+
+/* Packs x, y, z into the 10-bit and the sign of w into the 2-bit components. */
+inline std::uint32_t Layout_PackInt2101010(float x, float y, float z, float w) {
+    std::uint32_t packedW = (w < 0.0f) ? 0x3u : (w > 0.0f ? 0x1u : 0x0u);
+    return Layout_PackSnorm10(x) | (Layout_PackSnorm10(y) << 10) | (Layout_PackSnorm10(z) << 20) | (packedW << 30);
+}
+
+inline std::int16_t Layout_PackSnorm16(float value) {
+    return static_cast<std::int16_t>(std::lround(Layout_Clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+/* Octahedral mapping of a direction (see MeshCodec); zero vectors map to (0, 0). */
+inline void Layout_EncodeOctahedral(float x, float y, float z, std::int16_t* packed) {
+    float sum = std::fabs(x) + std::fabs(y) + std::fabs(z);
+    if ( !(sum > 0.0f) ) {
+        packed[0] = packed[1] = 0;
+        return;
+    }
+
+    float u = x / sum;
+    float v = y / sum;
+    if ( z < 0.0f ) {
+        float foldedU = (1.0f - std::fabs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+        float foldedV = (1.0f - std::fabs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+        u = foldedU;
+        v = foldedV;
+    }
+
+    packed[0] = Layout_PackSnorm16(u);
+    packed[1] = Layout_PackSnorm16(v);
+}
+
+/* IEEE half float nearest to value (ties to even); overflows become infinity. */
+inline std::uint16_t Layout_PackHalf(float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    std::uint32_t sign = (bits >> 16) & 0x8000u;
+    std::uint32_t magnitude = bits & 0x7FFFFFFFu;
+
+    if ( magnitude > 0x7F800000u ) return static_cast<std::uint16_t>(sign | 0x7E00u);
+    if ( magnitude >= 0x477FF000u ) return static_cast<std::uint16_t>(sign | 0x7C00u);
+
+    // Below the smallest normal half the value is a multiple of 2^-24
+    if ( magnitude < 0x38800000u ) {
+        float absolute;
+        std::memcpy(&absolute, &magnitude, sizeof(absolute));
+        return static_cast<std::uint16_t>(sign | static_cast<std::uint32_t>(std::nearbyint(absolute * 16777216.0f)));
+    }
+
+    // Rebias the exponent (127 to 15) and round the 13 dropped mantissa bits
+    magnitude += 0xC8000FFFu + ((magnitude >> 13) & 1u);
+    return static_cast<std::uint16_t>(sign | (magnitude >> 13));
+}
+
+inline std::uint8_t Layout_PackUnorm8(float value) {
+    return static_cast<std::uint8_t>(std::lround(Layout_Clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+
+void PackVertices(const VertexLayout& layout, const Vertex* vertices, std::size_t vertexCount, void* packed) {
+    if ( vertexCount == 0 ) return;
+    if ( IsUnpackedVertexLayout(layout) ) {
+        std::memcpy(packed, vertices, vertexCount * sizeof(Vertex));
+        return;
+    }
+
+    std::size_t stride = GetVertexSize(layout);
+    std::size_t normalOffset = GetVertexAttributeOffset(layout, VERTEX_NORMAL);
+    std::size_t tangentOffset = GetVertexAttributeOffset(layout, VERTEX_TANGENT);
+    std::size_t textureCoordOffset = GetVertexAttributeOffset(layout, VERTEX_TEXTURE_COORD);
+    std::size_t colorOffset = GetVertexAttributeOffset(layout, VERTEX_COLOR);
+
+    unsigned char* destination = static_cast<unsigned char*>(packed);
+    for ( std::size_t i = 0; i < vertexCount; i++, destination += stride ) {
+        const Vertex& vertex = vertices[i];
+        float position[3] = { vertex.position.x(), vertex.position.y(), vertex.position.z() };
+        std::memcpy(destination, position, sizeof(position));
+
+        if ( layout.directionFormat == VERTEX_DIRECTION_FLOAT ) {
+            float normal[3] = { vertex.normal.x(), vertex.normal.y(), vertex.normal.z() };
+            float tangent[4] = { vertex.tangent.x(), vertex.tangent.y(), vertex.tangent.z(), vertex.tangent.w() };
+            std::memcpy(destination + normalOffset, normal, sizeof(normal));
+            std::memcpy(destination + tangentOffset, tangent, sizeof(tangent));
+        }
+        else if ( layout.directionFormat == VERTEX_DIRECTION_INT_2_10_10_10 ) {
+            std::uint32_t normal = Layout_PackInt2101010(vertex.normal.x(), vertex.normal.y(), vertex.normal.z(), 0.0f);
+            std::uint32_t tangent = Layout_PackInt2101010(vertex.tangent.x(), vertex.tangent.y(), vertex.tangent.z(), vertex.tangent.w() < 0.0f ? -1.0f : 1.0f);
+            std::memcpy(destination + normalOffset, &normal, sizeof(normal));
+            std::memcpy(destination + tangentOffset, &tangent, sizeof(tangent));
+        }
+        else {
+            std::int16_t normal[2];
+            std::int16_t tangent[4];
+            Layout_EncodeOctahedral(vertex.normal.x(), vertex.normal.y(), vertex.normal.z(), normal);
+            Layout_EncodeOctahedral(vertex.tangent.x(), vertex.tangent.y(), vertex.tangent.z(), tangent);
+            tangent[2] = (vertex.tangent.w() < 0.0f) ? -32767 : 32767;
+            tangent[3] = 0;
+            std::memcpy(destination + normalOffset, normal, sizeof(normal));
+            std::memcpy(destination + tangentOffset, tangent, sizeof(tangent));
+        }
+
+        if ( layout.textureCoordFormat == VERTEX_TEXTURE_COORD_FLOAT ) {
+            float textureCoord[3] = { vertex.textureCoord.x(), vertex.textureCoord.y(), vertex.textureCoord.z() };
+            std::memcpy(destination + textureCoordOffset, textureCoord, sizeof(textureCoord));
+        }
+        else {
+            std::uint16_t textureCoord[2] = { Layout_PackHalf(vertex.textureCoord.x()), Layout_PackHalf(vertex.textureCoord.y()) };
+            std::memcpy(destination + textureCoordOffset, textureCoord, sizeof(textureCoord));
+        }
+
+        if ( layout.colorFormat == VERTEX_COLOR_FLOAT ) {
+            float color[3] = { vertex.color.r(), vertex.color.g(), vertex.color.b() };
+            std::memcpy(destination + colorOffset, color, sizeof(color));
+        }
+        else if ( layout.colorFormat == VERTEX_COLOR_UNORM8 ) {
+            std::uint8_t color[4] = { Layout_PackUnorm8(vertex.color.r()), Layout_PackUnorm8(vertex.color.g()), Layout_PackUnorm8(vertex.color.b()), 255u };
+            std::memcpy(destination + colorOffset, color, sizeof(color));
+        }
+    }
+}
+
+void PackShortIndices(const TriangleFace* faces, std::size_t faceCount, std::uint16_t* indices) {
+    for ( std::size_t i = 0; i < faceCount; i++ ) {
+        indices[3 * i + 0] = static_cast<std::uint16_t>(faces[i][0]);
+        indices[3 * i + 1] = static_cast<std::uint16_t>(faces[i][1]);
+        indices[3 * i + 2] = static_cast<std::uint16_t>(faces[i][2]);
+    }
+}
+
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "MeshPrimitives.h"
+#include "ParallelFor.h"
+#include <iostream>
+#include <cmath>
+
+namespace sgpu {
+
+/* Smallest number of vertices worth generating on several threads. */
+static const std::size_t PRIMITIVE_MIN_PARALLEL_VERTICES = 1u << 16;
+
+static const double PRIMITIVE_PI = 3.14159265358979323846;
+
+static const unsigned int PRIMITIVE_CUBE_SIDE_COUNT = 6u;
+
+/* Side of a plane or cube: the points origin + u * uAxis + v * vAxis for u, v in [0, 1]. */
+struct Primitives_Patch {
+    Vector3f origin;
+    Vector3f uAxis;
+    Vector3f vAxis;
+};
+
+/*
+ * Runs function(begin, end) over ranges of rows that cover [0, rowCount),
+ * one range per thread if the shape is large enough.
+ */
+template <typename Function>
+void Primitives_ForRows(std::size_t rowCount, std::size_t vertexCount, Function function) {
+    std::size_t threadCount = (vertexCount >= PRIMITIVE_MIN_PARALLEL_VERTICES) ? std::min(GetThreadCount(), rowCount) : std::size_t(1);
+    ParallelFor(threadCount, [&](std::size_t thread) {
+        function(rowCount * thread / threadCount, rowCount * (thread + 1) / threadCount);
+    });
+}
+
+/* Returns false (and reports it) if a shape would have too many vertices for 32-bit indices. */
+bool Primitives_CheckVertexCount(unsigned long long vertexCount, const char* function) {
+    if ( vertexCount <= MESH_PRIMITIVE_MAX_VERTICES ) return true;
+    std::cerr << "[MeshPrimitives:" << function << "] Error: Too many vertices: " << vertexCount << std::endl;
+    return false;
+}
+
+/*
+ * Writes the (columns + 1) x (rows + 1) vertices of a patch and its two faces
+ * per quad, whose vertices are numbered from vertexOffset. The faces of a
+ * quad are turned towards uAxis x vAxis.
+ */
+void Primitives_GeneratePatch(const Primitives_Patch& patch, unsigned int columns, unsigned int rows, Vertex* vertices, std::uint32_t vertexOffset, TriangleFace* faces) {
+    Vector3f normal = Vector3f::Cross(patch.uAxis, patch.vAxis);
+    normal.normalize();
+    Vector3f tangent = patch.uAxis;
+    tangent.normalize();
+    float handedness = (Vector3f::Cross(normal, tangent).dot(patch.vAxis) < 0.0) ? -1.0f : 1.0f;
+
+    std::size_t rowSize = std::size_t(columns) + 1u;
+    Primitives_ForRows(std::size_t(rows) + 1u, rowSize * (std::size_t(rows) + 1u), [&](std::size_t begin, std::size_t end) {
+        for ( std::size_t j = begin; j < end; j++ ) {
+            float v = static_cast<float>(j) / static_cast<float>(rows);
+            for ( std::size_t i = 0; i < rowSize; i++ ) {
+                float u = static_cast<float>(i) / static_cast<float>(columns);
+                Vertex& vertex = vertices[j * rowSize + i];
+                vertex.position = patch.origin + patch.uAxis * u + patch.vAxis * v;
+                vertex.normal = normal;
+                vertex.tangent = Vector4f(tangent, handedness);
+                vertex.textureCoord = Vector3f(u, v, 0.0f);
+                vertex.color = Color3f(0.0f, 0.0f, 0.0f);
+            }
+
+            if ( j == rows ) continue;
+            for ( std::size_t i = 0; i < columns; i++ ) {
+                std::uint32_t a = vertexOffset + static_cast<std::uint32_t>(j * rowSize + i);
+                std::uint32_t c = a + static_cast<std::uint32_t>(rowSize);
+                TriangleFace* quad = faces + (j * columns + i) * 2u;
+                quad[0].indices[A] = a;
+                quad[0].indices[B] = a + 1u;
+                quad[0].indices[C] = c;
+                quad[1].indices[A] = a + 1u;
+                quad[1].indices[B] = c + 1u;
+                quad[1].indices[C] = c;
+            }
+        }
+    });
+}
+
+bool GeneratePlane(float width, float depth, unsigned int columns, unsigned int rows, std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces) {
+    if ( !(width > 0.0f) || !(depth > 0.0f) || columns == 0 || rows == 0 ) {
+        std::cerr << "[MeshPrimitives:GeneratePlane] Error: Invalid plane size or number of quads." << std::endl;
+        return false;
+    }
+
+    if ( !Primitives_CheckVertexCount((columns + 1ull) * (rows + 1ull), "GeneratePlane") ) return false;
+
+    Primitives_Patch patch;
+    patch.origin = Vector3f(-0.5f * width, 0.0f, 0.5f * depth);
+    patch.uAxis = Vector3f(width, 0.0f, 0.0f);
+    patch.vAxis = Vector3f(0.0f, 0.0f, -depth);
+
+    vertices.resize((std::size_t(columns) + 1u) * (std::size_t(rows) + 1u));
+    faces.resize(std::size_t(columns) * rows * 2u);
+    Primitives_GeneratePatch(patch, columns, rows, vertices.data(), 0u, faces.data());
+    return true;
+}
+
+bool GenerateSphere(float radius, unsigned int slices, unsigned int stacks, std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces) {
+    if ( !(radius > 0.0f) || slices < 3 || stacks < 2 ) {
+        std::cerr << "[MeshPrimitives:GenerateSphere] Error: Invalid sphere radius or number of slices or stacks." << std::endl;
+        return false;
+    }
+
+    if ( !Primitives_CheckVertexCount((slices + 1ull) * (stacks + 1ull), "GenerateSphere") ) return false;
+
+    //--------------------------------------------------------------------------
+    // The angles of each column and row are computed once. The last column
+    // repeats the first and the poles are exact, so the seam and the poles
+    // have no cracks.
+    //--------------------------------------------------------------------------
+    std::vector<float> sinPhi(slices + 1u), cosPhi(slices + 1u), sinTheta(stacks + 1u), cosTheta(stacks + 1u);
+    for ( unsigned int i = 0; i <= slices; i++ ) {
+        double phi = 2.0 * PRIMITIVE_PI * static_cast<double>(i % slices) / slices - PRIMITIVE_PI;
+        sinPhi[i] = static_cast<float>(std::sin(phi));
+        cosPhi[i] = static_cast<float>(std::cos(phi));
+    }
+
+    for ( unsigned int j = 0; j <= stacks; j++ ) {
+        double theta = PRIMITIVE_PI * (1.0 - static_cast<double>(j) / stacks);
+        sinTheta[j] = (j == 0 || j == stacks) ? 0.0f : static_cast<float>(std::sin(theta));
+        cosTheta[j] = (j == 0) ? -1.0f : (j == stacks) ? 1.0f : static_cast<float>(std::cos(theta));
+    }
+
+    std::size_t rowSize = std::size_t(slices) + 1u;
+    vertices.resize(rowSize * (std::size_t(stacks) + 1u));
+    faces.resize(std::size_t(slices) * (stacks - 1u) * 2u);
+    Primitives_ForRows(std::size_t(stacks) + 1u, vertices.size(), [&](std::size_t begin, std::size_t end) {
+        for ( std::size_t j = begin; j < end; j++ ) {
+            float v = static_cast<float>(j) / static_cast<float>(stacks);
+            for ( std::size_t i = 0; i < rowSize; i++ ) {
+                Vertex& vertex = vertices[j * rowSize + i];
+                vertex.normal = Vector3f(sinTheta[j] * sinPhi[i], cosTheta[j], sinTheta[j] * cosPhi[i]);
+                vertex.position = vertex.normal * radius;
+                vertex.tangent = Vector4f(Vector3f(cosPhi[i], 0.0f, -sinPhi[i]), 1.0f);
+                vertex.textureCoord = Vector3f(static_cast<float>(i) / static_cast<float>(slices), v, 0.0f);
+                vertex.color = Color3f(0.0f, 0.0f, 0.0f);
+            }
+
+            //------------------------------------------------------------------
+            // The quads of the first and last row have one corner at a pole,
+            // so only their other triangle is kept.
+            //------------------------------------------------------------------
+            if ( j == stacks ) continue;
+            TriangleFace* face = faces.data() + ((j == 0) ? 0u : slices + (j - 1u) * 2u * slices);
+            for ( std::size_t i = 0; i < slices; i++ ) {
+                std::uint32_t a = static_cast<std::uint32_t>(j * rowSize + i);
+                std::uint32_t c = a + static_cast<std::uint32_t>(rowSize);
+                if ( j != 0 ) {
+                    face->indices[A] = a;
+                    face->indices[B] = a + 1u;
+                    face->indices[C] = c;
+                    face++;
+                }
+
+                if ( j != stacks - 1u ) {
+                    face->indices[A] = a + 1u;
+                    face->indices[B] = c + 1u;
+                    face->indices[C] = c;
+                    face++;
+                }
+            }
+        }
+    });
+
+    return true;
+}
+
+bool GenerateCube(float size, unsigned int divisions, bool bInward, std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces) {
+    if ( !(size > 0.0f) || divisions == 0 ) {
+        std::cerr << "[MeshPrimitives:GenerateCube] Error: Invalid cube size or number of divisions." << std::endl;
+        return false;
+    }
+
+    if ( !Primitives_CheckVertexCount(6ull * (divisions + 1ull) * (divisions + 1ull), "GenerateCube") ) return false;
+
+    //--------------------------------------------------------------------------
+    // Each side is seen from the outside with u to the right and v up (the
+    // top and bottom as if the cube were tipped towards the viewer): +x, -x,
+    // +y, -y, +z, -z.
+    //--------------------------------------------------------------------------
+    float h = 0.5f * size;
+    Primitives_Patch sides[PRIMITIVE_CUBE_SIDE_COUNT] = {
+        { Vector3f(h, -h, h), Vector3f(0.0f, 0.0f, -size), Vector3f(0.0f, size, 0.0f) },
+        { Vector3f(-h, -h, -h), Vector3f(0.0f, 0.0f, size), Vector3f(0.0f, size, 0.0f) },
+        { Vector3f(-h, h, h), Vector3f(size, 0.0f, 0.0f), Vector3f(0.0f, 0.0f, -size) },
+        { Vector3f(-h, -h, -h), Vector3f(size, 0.0f, 0.0f), Vector3f(0.0f, 0.0f, size) },
+        { Vector3f(-h, -h, h), Vector3f(size, 0.0f, 0.0f), Vector3f(0.0f, size, 0.0f) },
+        { Vector3f(h, -h, -h), Vector3f(-size, 0.0f, 0.0f), Vector3f(0.0f, size, 0.0f) }
+    };
+
+    std::size_t sideVertexCount = (std::size_t(divisions) + 1u) * (std::size_t(divisions) + 1u);
+    std::size_t sideFaceCount = std::size_t(divisions) * divisions * 2u;
+    vertices.resize(sideVertexCount * PRIMITIVE_CUBE_SIDE_COUNT);
+    faces.resize(sideFaceCount * PRIMITIVE_CUBE_SIDE_COUNT);
+    for ( unsigned int s = 0; s < PRIMITIVE_CUBE_SIDE_COUNT; s++ ) {
+        //----------------------------------------------------------------------
+        // Reversing u turns the faces of a side inwards and keeps its texture
+        // the right way round when seen from the inside.
+        //----------------------------------------------------------------------
+        if ( bInward ) {
+            sides[s].origin = sides[s].origin + sides[s].uAxis;
+            sides[s].uAxis = -sides[s].uAxis;
+        }
+
+        Primitives_GeneratePatch(sides[s], divisions, divisions, vertices.data() + s * sideVertexCount, static_cast<std::uint32_t>(s * sideVertexCount), faces.data() + s * sideFaceCount);
+    }
+
+    return true;
+}
+
+}
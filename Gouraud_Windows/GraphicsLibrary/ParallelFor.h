@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace sgpu {
+
+/* Returns the number of worker threads used by the parallel loaders. */
+inline std::size_t GetThreadCount() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/* Runs function(i) for every i in [0, count), each on its own thread. */
+template <typename Function>
+void ParallelFor(std::size_t count, Function function) {
+    std::vector<std::thread> threads;
+    threads.reserve(count);
+    for ( std::size_t i = 1; i < count; i++ ) threads.emplace_back(function, i);
+    if ( count > 0 ) function(0);
+    for ( std::size_t i = 0; i < threads.size(); i++ ) threads[i].join();
+}
+
+/*
+ * Stable partition of the elements [0, count) into partCount parts by
+ * part(i). Each of threadCount threads counts and then scatters one slice of
+ * the elements, so no element is visited by more than one thread. Afterwards
+ * the elements of part p are elements[offsets[p]] to
+ * elements[offsets[p + 1] - 1] in increasing order.
+ */
+template <typename Part>
+void ParallelPartition(std::size_t count, std::size_t partCount, std::size_t threadCount, Part part, std::vector<std::uint32_t>& elements, std::vector<std::size_t>& offsets) {
+    std::vector<std::size_t> positions(threadCount * partCount, 0u);
+    ParallelFor(threadCount, [&](std::size_t t) {
+        std::size_t* histogram = positions.data() + t * partCount;
+        for ( std::size_t i = count * t / threadCount; i < count * (t + 1) / threadCount; i++ ) histogram[part(i)]++;
+    });
+
+    //--------------------------------------------------------------------------
+    // Exclusive prefix sum of the counts in part-major, slice-minor order.
+    //--------------------------------------------------------------------------
+    std::size_t sum = 0u;
+    offsets.resize(partCount + 1u);
+    for ( std::size_t p = 0; p < partCount; p++ ) {
+        offsets[p] = sum;
+        for ( std::size_t t = 0; t < threadCount; t++ ) {
+            std::size_t partSize = positions[t * partCount + p];
+            positions[t * partCount + p] = sum;
+            sum += partSize;
+        }
+    }
+    offsets[partCount] = sum;
+
+    elements.resize(count);
+    ParallelFor(threadCount, [&](std::size_t t) {
+        std::size_t* position = positions.data() + t * partCount;
+        for ( std::size_t i = count * t / threadCount; i < count * (t + 1) / threadCount; i++ ) elements[position[part(i)]++] = static_cast<std::uint32_t>(i);
+    });
+}
+
+}
+
+#endif
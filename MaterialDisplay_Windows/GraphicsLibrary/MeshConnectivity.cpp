@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "MeshConnectivity.h"
+#include "ParallelFor.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+namespace sgpu {
+
+/* Smallest number of corners worth matching on several threads. */
+static const std::size_t CONNECTIVITY_MIN_PARALLEL_CORNERS = 1u << 16;
+
+/* Empty slot of the hash tables of MeshConnectivity::build, and the hash of corners facing no edge. */
+static const std::uint32_t CONNECTIVITY_EMPTY = 0xFFFFFFFFu;
+
+/* Opposite of the corners of an edge shared by more than two faces or in the same direction. */
+static const std::uint32_t CONNECTIVITY_NON_MANIFOLD = 0xFFFFFFFEu;
+
+/* Finishes a 64-bit hash into 32 bits. */
+inline std::uint32_t Connectivity_FinishHash(std::uint64_t hash) {
+    hash = (hash ^ (hash >> 30)) * 0x94D049BB133111EBull;
+    return static_cast<std::uint32_t>(hash ^ (hash >> 32));
+}
+
+/* Returns the hash of the bit pattern of a position (zero is hashed as +0). */
+inline std::uint32_t Connectivity_HashPosition(const Vector3f& position) {
+    std::uint64_t hash = 0u;
+    for ( unsigned int k = 0; k < 3; k++ ) {
+        std::uint32_t bits = 0u;
+        if ( position[k] != 0.0f ) std::memcpy(&bits, &position[k], sizeof(bits));
+        hash = (hash ^ bits) * 0xBF58476D1CE4E5B9ull;
+        hash ^= hash >> 31;
+    }
+
+    return Connectivity_FinishHash(hash);
+}
+
+/*
+ * Returns the hash of an edge between two positions (in either direction).
+ * The hash is never CONNECTIVITY_EMPTY, which marks corners facing no edge.
+ */
+inline std::uint32_t Connectivity_HashEdge(std::uint32_t a, std::uint32_t b) {
+    std::uint64_t key = (static_cast<std::uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+    return std::min(Connectivity_FinishHash(key * 0xBF58476D1CE4E5B9ull), CONNECTIVITY_EMPTY - 1u);
+}
+
+/* Returns the thread that owns a hash if hashes are split between threadCount threads. */
+inline std::size_t Connectivity_Partition(std::uint32_t hash, std::size_t threadCount) {
+    return static_cast<std::size_t>((static_cast<std::uint64_t>(hash) * threadCount) >> 32);
+}
+
+/*
+ * Returns a power of two capacity of a hash table that holds up to
+ * (count / share) of count elements at most half full.
+ */
+inline std::size_t Connectivity_TableCapacity(std::size_t count, std::size_t share) {
+    std::size_t capacity = 64u;
+    while ( capacity * share < count * 2u ) capacity *= 2u;
+    return capacity;
+}
+
+/* Slot of the edge table of MeshConnectivity::build: the first corner facing an edge. */
+struct Connectivity_Edge {
+    std::uint32_t hash;
+    std::uint32_t corner;
+};
+
+/*
+ * Maps every vertex to the first vertex at the same position. Vertices are
+ * partitioned between the threads by the upper bits of the hash of their
+ * position, so each thread owns every vertex of its positions and only
+ * visits those, in order.
+ */
+void Connectivity_WeldPositions(const Vertex* vertices, std::size_t vertexCount, std::size_t threadCount, std::vector<std::uint32_t>& positions) {
+    std::vector<std::uint32_t> hashes(vertexCount);
+    ParallelFor(threadCount, [&](std::size_t t) {
+        for ( std::size_t i = vertexCount * t / threadCount; i < vertexCount * (t + 1) / threadCount; i++ )
+            hashes[i] = Connectivity_HashPosition(vertices[i].position);
+    });
+
+    std::vector<std::uint32_t> partition;
+    std::vector<std::size_t> offsets;
+    ParallelPartition(vertexCount, threadCount, threadCount, [&](std::size_t i) { return Connectivity_Partition(hashes[i], threadCount); }, partition, offsets);
+
+    positions.resize(vertexCount);
+    ParallelFor(threadCount, [&](std::size_t t) {
+        std::vector<std::uint32_t> table(Connectivity_TableCapacity(offsets[t + 1u] - offsets[t], 1u), CONNECTIVITY_EMPTY);
+        std::size_t mask = table.size() - 1u;
+        for ( std::size_t k = offsets[t]; k < offsets[t + 1u]; k++ ) {
+            std::size_t i = partition[k];
+            std::size_t j = hashes[i] & mask;
+            while ( table[j] != CONNECTIVITY_EMPTY && (hashes[table[j]] != hashes[i] || !(vertices[table[j]].position == vertices[i].position)) ) j = (j + 1u) & mask;
+            if ( table[j] == CONNECTIVITY_EMPTY ) table[j] = static_cast<std::uint32_t>(i);
+            positions[i] = table[j];
+        }
+    });
+}
+
+MeshConnectivity::MeshConnectivity() {
+    this->boundaryEdgeCount = 0u;
+}
+
+bool MeshConnectivity::build(const Vertex* vertices, std::size_t vertexCount, const TriangleFace* faces, std::size_t faceCount) {
+    this->clear();
+
+    std::size_t cornerCount = faceCount * TRIANGLE_EDGE_COUNT;
+    this->cornerVertices.resize(cornerCount);
+    for ( std::size_t c = 0; c < cornerCount; c++ ) {
+        std::size_t f = c / TRIANGLE_EDGE_COUNT;
+        if ( faces[f][c % TRIANGLE_EDGE_COUNT] >= vertexCount ) {
+            std::cerr << "[MeshConnectivity:build] Error: Face " << f << " references a missing vertex." << std::endl;
+            this->clear();
+            return false;
+        }
+
+        this->cornerVertices[c] = faces[f][c % TRIANGLE_EDGE_COUNT];
+    }
+
+    this->opposites.assign(cornerCount, MESH_CORNER_NONE);
+
+    //--------------------------------------------------------------------------
+    // Corners are matched through the positions of their vertices. The edge
+    // that faces a corner starts at the position of the next corner and ends
+    // at the start of the edge of the next corner. Corners of faces with
+    // coincident positions face no edge.
+    //--------------------------------------------------------------------------
+    std::size_t threadCount = (cornerCount >= CONNECTIVITY_MIN_PARALLEL_CORNERS) ? GetThreadCount() : 1u;
+    std::vector<std::uint32_t> positions;
+    Connectivity_WeldPositions(vertices, vertexCount, threadCount, positions);
+
+    std::vector<std::uint32_t> starts(cornerCount);
+    ParallelFor(threadCount, [&](std::size_t t) {
+        for ( std::size_t c = cornerCount * t / threadCount; c < cornerCount * (t + 1) / threadCount; c++ )
+            starts[c] = positions[this->cornerVertices[next(static_cast<std::uint32_t>(c))]];
+    });
+
+    std::vector<std::uint32_t> edgeHashes(cornerCount);
+    ParallelFor(threadCount, [&](std::size_t t) {
+        for ( std::size_t c = cornerCount * t / threadCount; c < cornerCount * (t + 1) / threadCount; c++ ) {
+            std::uint32_t corner = static_cast<std::uint32_t>(c);
+            std::uint32_t start = starts[c];
+            std::uint32_t end = starts[next(corner)];
+            std::uint32_t position = starts[previous(corner)];
+            bool bDegenerate = (start == end || start == position || end == position);
+            edgeHashes[c] = bDegenerate ? CONNECTIVITY_EMPTY : Connectivity_HashEdge(start, end);
+        }
+    });
+
+    //--------------------------------------------------------------------------
+    // Corners are partitioned between the threads by the upper bits of the
+    // hash of their edge, so each thread owns every corner facing its edges,
+    // visits only those in order and sets their opposites alone. Corners
+    // facing no edge go to an extra partition that no thread visits. The table of a thread holds the first corner of
+    // each of its edges; the second corner facing an edge in the opposite
+    // direction becomes its opposite. Any further corner, or one facing the
+    // edge in the same direction, makes every corner of the edge a boundary.
+    //--------------------------------------------------------------------------
+    std::vector<std::uint32_t> partition;
+    std::vector<std::size_t> offsets;
+    ParallelPartition(cornerCount, threadCount + 1u, threadCount, [&](std::size_t c) {
+        return (edgeHashes[c] == CONNECTIVITY_EMPTY) ? threadCount : Connectivity_Partition(edgeHashes[c], threadCount);
+    }, partition, offsets);
+
+    ParallelFor(threadCount, [&](std::size_t t) {
+        //----------------------------------------------------------------------
+        // Most edges are faced by two corners, so the table is sized for half
+        // of the corners. Slots keep the hash of their edge to skip other
+        // edges without looking up their corners.
+        //----------------------------------------------------------------------
+        Connectivity_Edge empty = { CONNECTIVITY_EMPTY, CONNECTIVITY_EMPTY };
+        std::vector<Connectivity_Edge> table(Connectivity_TableCapacity(offsets[t + 1u] - offsets[t], 2u), empty);
+        std::size_t mask = table.size() - 1u;
+        for ( std::size_t k = offsets[t]; k < offsets[t + 1u]; k++ ) {
+            std::uint32_t corner = partition[k];
+            std::size_t c = corner;
+            std::uint32_t start = starts[c];
+            std::uint32_t end = starts[next(corner)];
+            bool bSameDirection = false;
+
+            std::size_t j = edgeHashes[c] & mask;
+            for ( ; table[j].corner != CONNECTIVITY_EMPTY; j = (j + 1u) & mask ) {
+                if ( table[j].hash != edgeHashes[c] ) continue;
+                std::uint32_t first = table[j].corner;
+                if ( starts[first] == end && starts[next(first)] == start ) break;
+                if ( starts[first] == start && starts[next(first)] == end ) {
+                    bSameDirection = true;
+                    break;
+                }
+            }
+
+            if ( table[j].corner == CONNECTIVITY_EMPTY ) {
+                table[j].hash = edgeHashes[c];
+                table[j].corner = corner;
+                continue;
+            }
+
+            std::uint32_t first = table[j].corner;
+            std::uint32_t opposite = this->opposites[first];
+            if ( !bSameDirection && opposite == MESH_CORNER_NONE ) {
+                this->opposites[first] = corner;
+                this->opposites[corner] = first;
+                continue;
+            }
+
+            if ( opposite != MESH_CORNER_NONE && opposite != CONNECTIVITY_NON_MANIFOLD ) this->opposites[opposite] = CONNECTIVITY_NON_MANIFOLD;
+            this->opposites[first] = CONNECTIVITY_NON_MANIFOLD;
+            this->opposites[corner] = CONNECTIVITY_NON_MANIFOLD;
+        }
+    });
+
+    //--------------------------------------------------------------------------
+    // The corner of a vertex is shared by every vertex at its position, and
+    // is preferably a corner whose previous edge is a boundary, so swinging
+    // from it visits every face of an open fan.
+    //--------------------------------------------------------------------------
+    std::vector<std::uint32_t> positionCorners(vertexCount, MESH_CORNER_NONE);
+    for ( std::size_t c = 0; c < cornerCount; c++ )
+        if ( this->opposites[c] == CONNECTIVITY_NON_MANIFOLD ) this->opposites[c] = MESH_CORNER_NONE;
+
+    for ( std::size_t c = 0; c < cornerCount; c++ ) {
+        std::uint32_t corner = static_cast<std::uint32_t>(c);
+        std::uint32_t& first = positionCorners[positions[this->cornerVertices[c]]];
+        if ( first == MESH_CORNER_NONE || (this->opposites[previous(corner)] == MESH_CORNER_NONE && this->opposites[previous(first)] != MESH_CORNER_NONE) ) first = corner;
+        if ( this->opposites[c] == MESH_CORNER_NONE ) this->boundaryEdgeCount++;
+    }
+
+    this->vertexCorners.resize(vertexCount);
+    for ( std::size_t v = 0; v < vertexCount; v++ ) this->vertexCorners[v] = positionCorners[positions[v]];
+    return true;
+}
+
+void MeshConnectivity::clear() {
+    std::vector<std::uint32_t>().swap(this->cornerVertices);
+    std::vector<std::uint32_t>().swap(this->opposites);
+    std::vector<std::uint32_t>().swap(this->vertexCorners);
+    this->boundaryEdgeCount = 0u;
+}
+
+void MeshConnectivity::getAdjacencyIndices(std::uint32_t* indices) const {
+    for ( std::size_t c = 0; c < this->cornerVertices.size(); c++ ) {
+        std::uint32_t corner = static_cast<std::uint32_t>(c);
+        std::uint32_t facing = previous(corner);
+        std::uint32_t opposite = this->opposites[facing];
+        indices[2u * c] = this->cornerVertices[c];
+        indices[2u * c + 1u] = this->cornerVertices[(opposite != MESH_CORNER_NONE) ? opposite : facing];
+    }
+}
+
+std::uint32_t MeshConnectivity::next(std::uint32_t corner) {
+    return (corner % TRIANGLE_EDGE_COUNT == TRIANGLE_EDGE_COUNT - 1u) ? corner - (TRIANGLE_EDGE_COUNT - 1u) : corner + 1u;
+}
+
+std::uint32_t MeshConnectivity::previous(std::uint32_t corner) {
+    return (corner % TRIANGLE_EDGE_COUNT == 0u) ? corner + (TRIANGLE_EDGE_COUNT - 1u) : corner - 1u;
+}
+
+std::uint32_t MeshConnectivity::getFace(std::uint32_t corner) {
+    return corner / TRIANGLE_EDGE_COUNT;
+}
+
+std::uint32_t MeshConnectivity::getOpposite(std::uint32_t corner) const {
+    return this->opposites[corner];
+}
+
+std::uint32_t MeshConnectivity::getSwing(std::uint32_t corner) const {
+    std::uint32_t opposite = this->opposites[next(corner)];
+    return (opposite != MESH_CORNER_NONE) ? next(opposite) : MESH_CORNER_NONE;
+}
+
+std::uint32_t MeshConnectivity::getNeighbor(std::uint32_t face, unsigned int edge) const {
+    std::uint32_t opposite = this->opposites[previous(face * TRIANGLE_EDGE_COUNT + edge)];
+    return (opposite != MESH_CORNER_NONE) ? getFace(opposite) : MESH_CORNER_NONE;
+}
+
+std::uint32_t MeshConnectivity::getVertexCorner(std::uint32_t vertex) const {
+    return this->vertexCorners[vertex];
+}
+
+std::uint32_t MeshConnectivity::getVertex(std::uint32_t corner) const {
+    return this->cornerVertices[corner];
+}
+
+bool MeshConnectivity::isBoundary(std::uint32_t corner) const {
+    return this->opposites[corner] == MESH_CORNER_NONE;
+}
+
+bool MeshConnectivity::isEmpty() const {
+    return this->cornerVertices.size() == 0;
+}
+
+std::size_t MeshConnectivity::getCornerCount() const {
+    return this->cornerVertices.size();
+}
+
+std::size_t MeshConnectivity::getFaceCount() const {
+    return this->cornerVertices.size() / TRIANGLE_EDGE_COUNT;
+}
+
+std::size_t MeshConnectivity::getBoundaryEdgeCount() const {
+    return this->boundaryEdgeCount;
+}
+
+}
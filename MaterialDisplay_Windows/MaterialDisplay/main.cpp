@@ -6,6 +6,7 @@
 
 #include <MouseCamera.h>
 #include <Mesh.h>
+#include <SceneIndex.h>
 #include <Shader.h>
 #include <Texture.h>
 
@@ -34,6 +35,8 @@ const int MESH_COUNT = 4;
 
 std::shared_ptr<MouseCameraf> camera = nullptr;
 std::vector<SharedMesh> meshes;
+std::vector<std::size_t> visibleMeshes;
+SceneIndex sceneIndex;
 std::vector<Light> lights;
 
 enum MeshResource {
@@ -101,6 +104,9 @@ void SetupMeshes() {
 	meshes[1]->setPosition(-8.0f, 3.0f, 0.0f);
 	meshes[2]->setPosition(0.0f, 3.0f, 0.0f);
 	meshes[3]->setPosition(8.0f, 3.0f, 0.0f);
+
+	// The meshes do not move, so the scene index is built once.
+	sceneIndex.build(meshes);
 }
 
 void SetupLights() {
@@ -154,8 +160,12 @@ void g_glutDisplayFunc() {
 	// (1) for each mesh -> uniformMatrix for projection, modelView, normal matrices
 	//		(2) for each light -> uniform position, ambient, diffuse, specular
 
-	for ( int mesh_index = 0; mesh_index < meshes.size(); mesh_index++ ) {
-		auto mesh = meshes[mesh_index];
+	// Only the meshes inside the view frustum are drawn.
+	Frustum frustum(view * projectionMatrix);
+	sceneIndex.cull(frustum, visibleMeshes);
+
+	for ( std::size_t visible_index = 0; visible_index < visibleMeshes.size(); visible_index++ ) {
+		auto mesh = meshes[visibleMeshes[visible_index]];
 
 		model = mesh->getTransform().toMatrix();
 		modelViewMatrix = model * camera->getViewMatrix();
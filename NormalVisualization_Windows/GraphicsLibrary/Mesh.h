@@ -29,9 +29,83 @@
 #include "Color3.h"
 #include "Vertex.h"
 #include "Face.h"
+#include "MeshCodec.h"
+#include "MeshNormals.h"
+#include "MeshOptimizer.h"
+#include "VertexLayout.h"
+#include "MeshSimplifier.h"
+#include "MeshClusters.h"
+#include "MeshBvh.h"
+#include "MeshConnectivity.h"
+#include "Frustum.h"
+#include "Camera.h"
 
 namespace sgpu {
 
+class MeshResidencyManager;
+
+/*
+ * Material of the sub-meshes of a Mesh, read from the Obj material libraries
+ * of the mesh. Texture maps the material does not provide are nullptr; those
+ * textures are provided by the shader of the mesh.
+ */
+struct MeshMaterial {
+    std::string name;
+    Color3f diffuse;
+    Color3f specular;
+    float shininess;
+
+    std::shared_ptr<Texture> diffuseTexture;
+    std::shared_ptr<Texture> normalTexture;
+    std::shared_ptr<Texture> specularTexture;
+};
+
+/* Default CPU memory budget of Mesh::loadOutOfCore (256 MB). */
+const std::size_t MESH_DEFAULT_MEMORY_BUDGET = 256u << 20;
+
+/* Default screen-space error of Mesh::selectLod (in pixels). */
+const float MESH_LOD_DEFAULT_PIXEL_ERROR = 1.0f;
+
+/* Default number of slices and stacks of Mesh::createSphere. */
+const unsigned int MESH_SPHERE_DEFAULT_SLICES = 32u;
+const unsigned int MESH_SPHERE_DEFAULT_STACKS = 16u;
+
+/*
+ * Vertex and index buffer holding one window of the faces of an out-of-core
+ * mesh (see Mesh::loadOutOfCore). The sub-meshes of a chunk index its own
+ * vertex buffer.
+ */
+struct MeshChunk {
+    unsigned int vboVertex;
+    unsigned int vboIndex;
+    std::uint32_t faceCount;
+    std::vector<SubMesh> subMeshes;
+};
+
+/*
+ * Summary of a lazily loaded mesh (see Mesh::loadLazy). Until the mesh is
+ * first loaded it is read from the header of a compressed mesh or of the
+ * binary cache of an Obj file; bKnown is false if neither exists.
+ */
+struct MeshInfo {
+    std::size_t vertexCount;
+    std::size_t faceCount;
+    Vector3f boundsMinimum;
+    Vector3f boundsMaximum;
+    bool bKnown;
+};
+
+/*
+ * Object space bounds of a mesh (see Mesh::getBounds): the box of its
+ * vertices and a sphere around the center of the box that contains them.
+ */
+struct MeshBounds {
+    Vector3f boundsMinimum;
+    Vector3f boundsMaximum;
+    Vector3f center;
+    float radius;
+};
+
 class Mesh {
 public:
     Mesh();
@@ -39,6 +113,52 @@ public:
     virtual ~Mesh();
 
     bool load(const std::string& filename);
+
+    /*
+     * Loads an Obj file that may not fit into memory. The Obj vertex
+     * attributes are spilled into temporary files and the faces are streamed
+     * into chunks of at most memoryBudget bytes, each uploaded into its own
+     * GPU buffers. No CPU copy of the mesh is kept.
+     */
+    bool loadOutOfCore(const std::string& filename, std::size_t memoryBudget = MESH_DEFAULT_MEMORY_BUDGET, bool bComputeNormals = false);
+
+    /*
+     * Replace this mesh with a generated plane, sphere, or cube (see
+     * GeneratePlane, GenerateSphere, and GenerateCube) without reading a
+     * file. The tessellation can be chosen freely; the generated faces are
+     * processed like loaded ones (face order, clusters, levels of detail, and
+     * hierarchy) and uploaded. An inward cube can be used as a skybox.
+     */
+    bool createPlane(float width, float depth, unsigned int columns = 1, unsigned int rows = 1);
+    bool createSphere(float radius, unsigned int slices = MESH_SPHERE_DEFAULT_SLICES, unsigned int stacks = MESH_SPHERE_DEFAULT_STACKS);
+    bool createCube(float size, unsigned int divisions = 1, bool bInward = false);
+
+    /*
+     * Writes this mesh as a compressed (*.sgmz) file that load reads back.
+     * Material libraries are stored by name and resolved against the
+     * directory of the compressed file. Out-of-core meshes cannot be saved.
+     */
+    bool saveCompressed(const std::string& filename, const MeshCodecOptions& options = MeshCodecOptions()) const;
+
+    /*
+     * Registers this mesh with a residency manager without loading it; only
+     * the header of the mesh is read (see getInfo). The mesh is loaded on a
+     * loader thread when it is first drawn or prefetched and uploaded by the
+     * next MeshResidencyManager::update. Until then beginRender and endRender
+     * only enable and disable the shader, and draw nothing.
+     */
+    bool loadLazy(const std::string& filename, MeshResidencyManager& manager);
+
+    /* Requests the load of a lazy mesh that is predicted to be visible. */
+    void prefetch() const;
+
+    /* Loads a lazy mesh on this thread. Returns true if it is resident. */
+    bool makeResident();
+
+    /* Returns true if this mesh is uploaded to the GPU and can be drawn. */
+    bool isResident() const;
+
+
     bool save(const std::string& filename);
 
     void beginRender() const;
@@ -59,15 +179,179 @@ public:
     void setScale(const Vector3f& scale);
     void setRotation(const Quaternionf& rotation);
 
+    /*
+     * Sets the weighting of the normals computed by the following loads (see
+     * CalculateNormals). Normals are weighted uniformly by default.
+     */
+    void setNormalWeighting(MeshNormalWeighting weighting);
+
+    /*
+     * Sets whether the following loads reorder the faces of each sub-mesh for
+     * the post-transform vertex cache and then for overdraw, and the vertices
+     * in the order they are drawn (see OptimizeMesh). Enabled by default.
+     */
+    void setOptimizeFaceOrder(bool bOptimize);
+
+    /*
+     * Sets whether the following Obj loads merge equal face corners by radix
+     * sorting their index triples after the file has been parsed, instead of
+     * inserting them into a vertex set as the faces arrive (see Decompress).
+     * Sorting is faster on large meshes but holds every face index until the
+     * end of the parse; loads with computed normals always sort. Disabled by
+     * default.
+     */
+    void setSortObjCorners(bool bSort);
+
+    /*
+     * Sets the layout the following loads upload vertices and indices in. It
+     * must match the vertex attributes declared by the shader of this mesh
+     * (see VertexLayout); VertexLayout::Compact() works with the shaders of
+     * the default layout. Out-of-core meshes always use 32-bit indices.
+     */
+    void setVertexLayout(const VertexLayout& layout);
+
+    /*
+     * Sets whether the following loads build levels of detail by edge-collapse
+     * simplification (see BuildMeshLods). Disabled by default. Compressed,
+     * out-of-core, and mapped glTF meshes have no levels of detail.
+     */
+    void setGenerateLods(bool bGenerate);
+
+    /*
+     * Selects the coarsest level of detail whose error, projected by the
+     * camera onto a viewport viewportHeight pixels high, stays within
+     * pixelError pixels. Returns the selected level (0 is the full mesh).
+     */
+    std::size_t selectLod(const Cameraf& camera, float viewportHeight, float pixelError = MESH_LOD_DEFAULT_PIXEL_ERROR);
+
+    /* Sets the level of detail drawn by endRender (0 is the full mesh). */
+    void setLodLevel(std::size_t level);
+
+    /*
+     * Sets whether the following loads split the faces into clusters (see
+     * BuildMeshClusters). Disabled by default. Compressed, out-of-core, and
+     * mapped glTF meshes have no clusters.
+     */
+    void setGenerateClusters(bool bGenerate);
+
+    /*
+     * Culls the clusters that are outside the view frustum of the camera or
+     * whose faces all face away from it. Until resetClusterCulling, endRender
+     * draws only the remaining clusters of the full level of detail. Returns
+     * the number of faces of the remaining clusters.
+     */
+    std::size_t cullClusters(const Cameraf& camera);
+
+    /* Draws every cluster again (see cullClusters). */
+    void resetClusterCulling();
+
+    /*
+     * Sets whether the following loads build a bounding volume hierarchy over
+     * the faces for intersect (see MeshBvh). Disabled by default. Out-of-core
+     * meshes have no hierarchy.
+     */
+    void setBuildBvh(bool bBuild);
+
+    /*
+     * Sets whether endRender draws each face as a patch of three control
+     * points (GL_PATCHES) instead of a triangle, for shaders with tessellation
+     * control and evaluation stages. Disabled by default.
+     */
+    void setDrawPatches(bool bPatches);
+
+    /*
+     * Sets whether the following loads build the corner table of the faces
+     * (see MeshConnectivity) and an adjacency index buffer. Disabled by
+     * default. endRender then draws GL_TRIANGLES_ADJACENCY, so a geometry
+     * shader sees the neighbors of each face (layout (triangles_adjacency)
+     * in); without a geometry shader the neighbors are ignored. Compressed
+     * and out-of-core meshes have no adjacency.
+     */
+    void setBuildAdjacency(bool bBuild);
+
+    /*
+     * Finds the closest face of the full level of detail hit by a world space
+     * ray (see Camera::pick). Hits are at the same distance along the ray as
+     * in the object space of the mesh, so the hits of several meshes can be
+     * compared.
+     *
+     * @return If a face is hit then this function will return true; otherwise
+     * (or if the mesh has no hierarchy) it will return false.
+     */
+    bool intersect(const MeshRay& ray, MeshRayHit& hit) const;
+
+    /*
+     * Returns the object space bounds of the vertices of the last load. A
+     * lazy mesh that is not resident returns the box of its header (see
+     * getInfo) and the sphere around it.
+     *
+     * @return Returns false if the bounds are not known.
+     */
+    bool getBounds(MeshBounds& bounds) const;
+
+    /*
+     * Returns the world space bounds of this mesh under its transformation:
+     * the box around its transformed box, and its sphere moved and scaled by
+     * the largest scale factor.
+     */
+    bool getWorldBounds(MeshBounds& bounds) const;
+
+    /*
+     * Returns false if the world space bounds of this mesh are outside of a
+     * world space frustum, so it does not have to be drawn. A mesh whose
+     * bounds are not known is always visible.
+     */
+    bool isVisible(const Frustum& frustum) const;
+
     std::string& getName();
     const std::string& getName() const;
     Transformationf& getTransform();
     const Transformationf& getTransform() const;
     std::shared_ptr<Shader>& getShader();
     const std::shared_ptr<Shader>& getShader() const;
+    std::size_t getSubMeshCount() const;
+    const SubMesh& getSubMesh(std::size_t index) const;
+    std::size_t getMaterialCount() const;
+    const MeshMaterial& getMaterial(std::size_t index) const;
+    const MeshInfo& getInfo() const;
+    MeshNormalWeighting getNormalWeighting() const;
+    const MeshOptimizationStatistics& getOptimizationStatistics() const;
+    const VertexLayout& getVertexLayout() const;
+    std::size_t getLodCount() const;
+    std::size_t getLodLevel() const;
+    std::size_t getClusterCount() const;
+    const MeshBvh& getBvh() const;
+    bool getDrawPatches() const;
+    const MeshConnectivity& getConnectivity() const;
 
 protected:
+    bool loadGltf(const std::string& filename, bool bComputeNormals);
+    bool loadPly(const std::string& filename, bool bComputeNormals);
+    bool loadStl(const std::string& filename);
+    bool loadCompressed(const std::string& filename);
+
+    /*
+     * Discards the previous load before this mesh is replaced: its buffers
+     * and the state derived from them (see release), and its vertices and
+     * faces. A lazy mesh is no longer managed by its residency manager.
+     */
+    void reset();
+
+    bool loadMaterials(const std::string& filename, const std::vector<std::string>& materialLibraries);
+    bool constructPrimitive(const std::string& name, std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces);
     bool constructOnGPU();
+    bool constructOnGPU(const Vertex* vertices, std::size_t vertexCount, const TriangleFace* faces, std::size_t faceCount);
+
+    /*
+     * Residency of lazy meshes (see MeshResidencyManager). A staging mesh is
+     * loaded on a loader thread without OpenGL; adopt uploads it into this
+     * mesh and returns the size of its buffers, and release frees them.
+     */
+    friend class MeshResidencyManager;
+    std::shared_ptr<Mesh> createStaging() const;
+    bool loadStaging();
+    std::size_t adopt(Mesh& staging);
+    void release();
 
 protected:
     /* 
@@ -81,9 +365,93 @@ protected:
     std::vector<TriangleFace> faces;
     std::shared_ptr<Shader> shader;
 
+    /*
+     * Face ranges of the Obj objects, groups, and materials of this mesh. All
+     * sub-meshes are drawn from the same vertex and index buffer.
+     */
+    std::vector<SubMesh> subMeshes;
+    std::vector<MeshMaterial> materials;
+
+    /* Obj material libraries the materials were read from. */
+    std::vector<std::string> materialLibraries;
+
+    /* GPU buffers of an out-of-core mesh (empty for every other mesh). */
+    std::vector<MeshChunk> chunks;
+
     /* Mesh VBO ID */
     unsigned int vboVertex;
     unsigned int vboIndex;
+
+    /* 
+     * Number of faces uploaded to the GPU. If this mesh was loaded from its
+     * binary cache then the faces are never copied into the face array.
+     */
+    std::size_t faceCount;
+
+    /* Residency manager of a lazy mesh (nullptr for every other mesh). */
+    MeshResidencyManager* residencyManager;
+    std::string sourceFilename;
+    MeshInfo info;
+
+    /* Weighting of the normals computed by load (see setNormalWeighting). */
+    MeshNormalWeighting normalWeighting;
+
+    /*
+     * Face order option of load, and the vertex cache efficiency of the last
+     * load (zero for compressed and out-of-core meshes).
+     */
+    bool bOptimizeFaceOrder;
+    MeshOptimizationStatistics optimizationStatistics;
+
+    /* Corner deduplication of Obj loads (see setSortObjCorners). */
+    bool bSortObjCorners;
+
+    /* Layout of load (see setVertexLayout), and of the uploaded buffers. */
+    VertexLayout vertexLayout;
+    VertexLayout bufferLayout;
+
+    /*
+     * Level of detail option of load, the levels of detail of the last load
+     * (their faces follow the faces of the mesh in the same buffers), and the
+     * level drawn by endRender.
+     */
+    bool bGenerateLods;
+    MeshLodChain lodChain;
+    std::size_t lodLevel;
+
+    /*
+     * Cluster option of load, the clusters of the last load (ranges of its
+     * faces), and the sub-mesh ranges of the clusters left by cullClusters.
+     */
+    bool bGenerateClusters;
+    std::vector<MeshCluster> clusters;
+    std::vector<SubMesh> visibleSubMeshes;
+    bool bClusterCulling;
+
+    /* Hierarchy option of load, and the hierarchy of the last load. */
+    bool bBuildBvh;
+    MeshBvh bvh;
+
+    /*
+     * Adjacency option of load, the corner table of the full level of detail
+     * of the last load, and the buffer of its adjacency indices.
+     */
+    bool bBuildAdjacency;
+    MeshConnectivity connectivity;
+    unsigned int vboAdjacency;
+
+    /* Object space bounds of the last load (see getBounds). */
+    MeshBounds bounds;
+    bool bBounds;
+
+    /* Primitive option of endRender (see setDrawPatches). */
+    bool bDrawPatches;
+
+    /*
+     * Set on staging meshes loaded by a loader thread. Their vertices, faces,
+     * and material libraries are kept in memory instead of being uploaded.
+     */
+    bool bDeferUpload;
 };
 
 }
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef STL_MESH_H
+#define STL_MESH_H
+
+#include <string>
+#include <vector>
+#include <Mathematics.h>
+
+namespace sgpu {
+
+/*
+ * Loads the triangles of a binary Stl file as a triangle soup: three
+ * positions per triangle, in the winding order of the file. The facet normals
+ * and attribute bytes of the file are ignored. ASCII Stl files are not
+ * supported.
+ *
+ * @param filename - The name of the Stl file to be read (include .stl).
+ * @param positions - Receives the corner positions of every triangle.
+ *
+ * @return If the file is successfully loaded then this function will return
+ * true; otherwise it will return false.
+ */
+bool LoadStlMesh(const std::string& filename, std::vector<Vector3f>& positions);
+
+/*
+ * Welds the corners of a triangle soup into shared vertices. Positions are
+ * snapped to a grid of the provided cell size and positions within the same
+ * cell are merged into the first of them (exact duplicates are always
+ * merged). Cells are hashed in parallel; every thread owns the cells of one
+ * hash partition, so the result does not depend on the number of threads.
+ *
+ * @param positions - The positions to be welded.
+ * @param cellSize - The size of a grid cell (0 to only merge exact duplicates).
+ * @param vertices - Receives the welded positions, in order of first use.
+ * @param indices - Receives the index within vertices of every position.
+ */
+void WeldVertices(const std::vector<Vector3f>& positions, float cellSize, std::vector<Vector3f>& vertices, std::vector<unsigned int>& indices);
+
+}
+
+#endif
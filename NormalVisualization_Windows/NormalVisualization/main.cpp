@@ -21,6 +21,7 @@ std::shared_ptr<MouseCameraf> camera = nullptr;
 std::shared_ptr<Mesh> mesh = nullptr;
 std::shared_ptr<Shader> phongShader = nullptr;
 std::shared_ptr<GeometryShader> normalShader = nullptr;
+std::shared_ptr<GeometryShader> silhouetteShader = nullptr;
 
 float normalScale = 1.0f;
 
@@ -32,6 +33,11 @@ void g_init() {
     camera = std::make_shared<MouseCameraf>(3.0f);
     mesh = std::make_shared<Mesh>();
 
+    //--------------------------------------------------------------------------
+    // The faces are drawn with their neighbors (GL_TRIANGLES_ADJACENCY), so
+    // the silhouette shader finds the silhouette edges in a single draw.
+    //--------------------------------------------------------------------------
+    mesh->setBuildAdjacency(true);
     mesh->load("models/teapot.obj");
 
     phongShader = std::make_shared<Shader>();
@@ -44,6 +50,11 @@ void g_init() {
     normalShader->compile();
     normalShader->link();
 
+    silhouetteShader = std::make_shared<GeometryShader>();
+    silhouetteShader->load("shaders/NormalVisualization.vert", "shaders/Silhouette.geom", "shaders/Silhouette.frag");
+    silhouetteShader->compile();
+    silhouetteShader->link();
+
     camera->setPosition(18.0f, 1.5707f, 1.570f * 0.7f);
 }
 
@@ -80,6 +91,13 @@ void g_glutDisplayFunc() {
         mesh->getShader()->uniform1f("normalScale", normalScale);
     mesh->endRender();
 
+    /* Third Pass: Silhouette */
+    mesh->setShader(silhouetteShader);
+    mesh->beginRender();
+        mesh->getShader()->uniformMatrix("projectionMatrix", projectionMatrix);
+        mesh->getShader()->uniformMatrix("modelViewMatrix", modelViewMatrix);
+    mesh->endRender();
+
     glutSwapBuffers();
 	glFlush();
 }
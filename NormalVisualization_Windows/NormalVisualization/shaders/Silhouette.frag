@@ -0,0 +1,8 @@
+#version 410 core
+
+out vec4 fragColor;
+
+void main(void) {
+	// The silhouette color is just hard coded to black.
+	fragColor = vec4(0.0f, 0.0f, 0.0f, 1.0f);
+}
\ No newline at end of file
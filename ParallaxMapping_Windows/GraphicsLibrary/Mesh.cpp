@@ -22,7 +22,27 @@
  */
 #include "Mesh.h"
 #include "ObjMesh.h"
+#include "MeshCache.h"
+#include "GltfMesh.h"
+#include "PlyMesh.h"
+#include "StlMesh.h"
+#include "MeshCodec.h"
+#include "MeshResidency.h"
+#include "MeshNormals.h"
+#include "MeshOptimizer.h"
+#include "VertexLayout.h"
+#include "MeshPrimitives.h"
+#include "ParallelFor.h"
+#include "Frustum.h"
 #include <unordered_map>
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <cctype>
+#include <fstream>
+#include <chrono>
+#include <cstring>
+#include <cmath>
 #include <GL/glew.h>
 
 #define BUFFER_OFFSET(i) ((char *)NULL + (i))
@@ -35,11 +55,122 @@ const static unsigned int TANGENT_LOC = 2;
 const static unsigned int TEXTURE_COORD_LOC = 3;
 const static unsigned int COLOR_LOC = 4;
 
+const static std::string DIFFUSE_TEXTURE = "diffuseTexture";
+const static std::string NORMAL_TEXTURE = "normalTexture";
+const static std::string SPECULAR_TEXTURE = "specularTexture";
+const static std::string MATERIAL_DIFFUSE = "materialDiffuse";
+const static std::string MATERIAL_SPECULAR = "materialSpecular";
+const static std::string MATERIAL_SHININESS = "materialShininess";
+const static std::string GLTF_BINARY_EXTENSION = ".glb";
+const static std::string PLY_EXTENSION = ".ply";
+const static std::string STL_EXTENSION = ".stl";
+const static std::string COMPRESSED_MESH_EXTENSION = ".sgmz";
+
+/* Tolerance of the Stl vertex weld, relative to the diagonal of the mesh. */
+const static float STL_WELD_TOLERANCE = 1.0e-6f;
+
+/* Size of the write buffer of each spilled Obj attribute array. */
+const static std::size_t MESH_SPILL_BUFFER_SIZE = 1u << 20;
+
+/* 
+ * Smallest chunk budget of an out-of-core mesh, and the estimated memory
+ * needed to deduplicate one vertex of a chunk.
+ */
+const static std::size_t MESH_MIN_CHUNK_BUDGET = 1u << 20;
+const static std::size_t MESH_CHUNK_VERTEX_OVERHEAD = 64u;
+
+/* 
+ * Digit size of the radix sort of Decompress, and the number of face corners
+ * above which Decompress runs in parallel.
+ */
+const static unsigned int MESH_RADIX_BITS = 11u;
+const static std::size_t MESH_RADIX_BUCKETS = std::size_t(1) << MESH_RADIX_BITS;
+const static std::size_t MESH_MIN_PARALLEL_CORNERS = 1u << 16;
+
+/* Releases the vertex and index buffers of out-of-core mesh chunks. */
+void Mesh_DeleteChunks(std::vector<MeshChunk>& chunks) {
+    for ( std::size_t i = 0; i < chunks.size(); i++ ) {
+        glDeleteBuffers(1, &chunks[i].vboVertex);
+        glDeleteBuffers(1, &chunks[i].vboIndex);
+    }
+    chunks.clear();
+}
+
+/* Grows the box of bounds to contain the vertices (starting from none if bEmpty). */
+void Mesh_ExtendBounds(const Vertex* vertices, std::size_t vertexCount, bool bEmpty, MeshBounds& bounds) {
+    if ( vertexCount == 0 ) return;
+    if ( bEmpty ) {
+        bounds.boundsMinimum = vertices[0].position;
+        bounds.boundsMaximum = vertices[0].position;
+    }
+
+    for ( std::size_t i = 0; i < vertexCount; i++ ) {
+        for ( unsigned int k = 0; k < 3; k++ ) {
+            bounds.boundsMinimum[k] = std::min(bounds.boundsMinimum[k], vertices[i].position[k]);
+            bounds.boundsMaximum[k] = std::max(bounds.boundsMaximum[k], vertices[i].position[k]);
+        }
+    }
+}
+
+/* Sets the sphere of bounds to the sphere around its box. */
+void Mesh_SetBoxSphere(MeshBounds& bounds) {
+    bounds.center = (bounds.boundsMinimum + bounds.boundsMaximum) * 0.5f;
+    bounds.radius = static_cast<float>((bounds.boundsMaximum - bounds.center).length());
+}
+
+/*
+ * Computes the box of the vertices and the smallest sphere around the center
+ * of the box that contains them, which is usually tighter than the sphere
+ * around the box. Returns false if there are no vertices.
+ */
+bool Mesh_CalculateBounds(const Vertex* vertices, std::size_t vertexCount, MeshBounds& bounds) {
+    if ( vertexCount == 0 ) return false;
+
+    Mesh_ExtendBounds(vertices, vertexCount, true, bounds);
+    bounds.center = (bounds.boundsMinimum + bounds.boundsMaximum) * 0.5f;
+    float radiusSquared = 0.0f;
+    for ( std::size_t i = 0; i < vertexCount; i++ ) {
+        Vector3f offset = vertices[i].position - bounds.center;
+        radiusSquared = std::max(radiusSquared, static_cast<float>(offset.dot(offset)));
+    }
+
+    bounds.radius = std::sqrt(radiusSquared);
+    return true;
+}
+
 Mesh::Mesh() {
     this->transform = Transformation<float>::Identity();
     this->shader = nullptr;
 	this->vboVertex = 0u;
 	this->vboIndex = 0u;
+	this->vboAdjacency = 0u;
+	this->faceCount = 0u;
+	this->residencyManager = nullptr;
+	this->bSourceComputeNormals = false;
+	this->info.vertexCount = 0u;
+	this->info.faceCount = 0u;
+	this->info.bKnown = false;
+	this->bDeferUpload = false;
+	this->normalWeighting = MESH_NORMAL_UNIFORM;
+	this->bOptimizeFaceOrder = true;
+	this->bSortObjCorners = false;
+	this->bGenerateLods = false;
+	this->bGenerateClusters = false;
+	this->bBuildBvh = false;
+	this->bBuildAdjacency = false;
+	this->bounds = MeshBounds();
+	this->bBounds = false;
+	this->bDrawPatches = false;
+	this->vertexLayout = VertexLayout();
+	this->bufferLayout = VertexLayout();
+	this->optimizationStatistics = MeshOptimizationStatistics();
+	this->bvh.clear();
+	this->connectivity.clear();
+	this->clusters.clear();
+	this->visibleSubMeshes.clear();
+	this->bClusterCulling = false;
+	this->lodChain = MeshLodChain();
+	this->lodLevel = 0u;
 }
 
 Mesh::Mesh(const Mesh& mesh) {
@@ -48,267 +179,1865 @@ Mesh::Mesh(const Mesh& mesh) {
 	this->shader = mesh.shader;
 	this->vboVertex = mesh.vboVertex;
 	this->vboIndex = mesh.vboIndex;
+	this->vboAdjacency = mesh.vboAdjacency;
+	this->faceCount = mesh.faceCount;
 	this->faces = mesh.faces;
 	this->vertices = mesh.vertices;
+	this->subMeshes = mesh.subMeshes;
+	this->materials = mesh.materials;
+	this->chunks = mesh.chunks;
+	this->materialLibraries = mesh.materialLibraries;
+    this->residencyManager = nullptr;
+    this->sourceFilename = mesh.sourceFilename;
+    this->bSourceComputeNormals = mesh.bSourceComputeNormals;
+    this->info = mesh.info;
+    this->normalWeighting = mesh.normalWeighting;
+    this->bOptimizeFaceOrder = mesh.bOptimizeFaceOrder;
+    this->bSortObjCorners = mesh.bSortObjCorners;
+    this->bGenerateLods = mesh.bGenerateLods;
+    this->lodChain = mesh.lodChain;
+    this->lodLevel = mesh.lodLevel;
+    this->bGenerateClusters = mesh.bGenerateClusters;
+    this->clusters = mesh.clusters;
+    this->visibleSubMeshes = mesh.visibleSubMeshes;
+    this->bClusterCulling = mesh.bClusterCulling;
+    this->bBuildBvh = mesh.bBuildBvh;
+    this->bvh = mesh.bvh;
+    this->bBuildAdjacency = mesh.bBuildAdjacency;
+    this->connectivity = mesh.connectivity;
+    this->bounds = mesh.bounds;
+    this->bBounds = mesh.bBounds;
+    this->bDrawPatches = mesh.bDrawPatches;
+    this->vertexLayout = mesh.vertexLayout;
+    this->bufferLayout = mesh.bufferLayout;
+    this->optimizationStatistics = mesh.optimizationStatistics;
+    this->bDeferUpload = false;
+
+    //--------------------------------------------------------------------------
+    // A copy of a lazy mesh is registered on its own and loads its own buffers.
+    //--------------------------------------------------------------------------
+    if ( mesh.residencyManager != nullptr ) {
+        this->vboVertex = 0u;
+        this->vboIndex = 0u;
+        this->vboAdjacency = 0u;
+        this->faceCount = 0u;
+        this->subMeshes.clear();
+        this->materials.clear();
+        this->chunks.clear();
+        this->lodChain.levels.clear();
+        this->lodLevel = 0u;
+        this->clusters.clear();
+        this->visibleSubMeshes.clear();
+        this->bClusterCulling = false;
+        this->bvh.clear();
+        this->connectivity.clear();
+        this->bBounds = false;
+        mesh.residencyManager->add(this);
+    }
 }
 
 Mesh::~Mesh() {
+    if ( this->residencyManager != nullptr ) this->residencyManager->remove(this);
 	if ( this->vboVertex != 0u ) glDeleteBuffers(1, &this->vboVertex);
     if ( this->vboIndex != 0u ) glDeleteBuffers(1, &this->vboIndex);
+    if ( this->vboAdjacency != 0u ) glDeleteBuffers(1, &this->vboAdjacency);
+	Mesh_DeleteChunks(this->chunks);
+}
+
+/* Returns the number of bits needed to store an index into count elements. */
+inline unsigned int Mesh_IndexBits(std::size_t count) {
+    unsigned int bits = 0u;
+    while ( bits < 64u && (std::uint64_t(1) << bits) < count ) bits++;
+    return bits;
+}
+
+/*
+ * Stable LSD radix sort of the low keyBits bits of the keys; the values are
+ * moved with their keys. Every pass counts the digits of one slice of the
+ * keys per thread and scatters the slices in order, so the result does not
+ * depend on the number of threads. Passes in which every key has the same
+ * digit are skipped.
+ */
+void Mesh_RadixSort(std::vector<std::uint64_t>& keys, std::vector<std::uint32_t>& values, unsigned int keyBits) {
+    std::size_t count = keys.size();
+    std::size_t threadCount = (count >= MESH_MIN_PARALLEL_CORNERS) ? GetThreadCount() : 1u;
+    std::vector<std::uint64_t> sortedKeys(count);
+    std::vector<std::uint32_t> sortedValues(count);
+    std::vector<std::size_t> offsets(threadCount * MESH_RADIX_BUCKETS);
+
+    for ( unsigned int shift = 0; shift < keyBits; shift += MESH_RADIX_BITS ) {
+        std::fill(offsets.begin(), offsets.end(), 0u);
+        ParallelFor(threadCount, [&](std::size_t t) {
+            std::size_t* histogram = offsets.data() + t * MESH_RADIX_BUCKETS;
+            for ( std::size_t i = count * t / threadCount; i < count * (t + 1) / threadCount; i++ )
+                histogram[(keys[i] >> shift) & (MESH_RADIX_BUCKETS - 1u)]++;
+        });
+
+        //----------------------------------------------------------------------
+        // Exclusive prefix sum of the counts in digit-major, slice-minor order.
+        //----------------------------------------------------------------------
+        std::size_t sum = 0u;
+        bool bSingleDigit = false;
+        for ( std::size_t d = 0; d < MESH_RADIX_BUCKETS; d++ ) {
+            std::size_t digitStart = sum;
+            for ( std::size_t t = 0; t < threadCount; t++ ) {
+                std::size_t digitCount = offsets[t * MESH_RADIX_BUCKETS + d];
+                offsets[t * MESH_RADIX_BUCKETS + d] = sum;
+                sum += digitCount;
+            }
+
+            if ( sum - digitStart == count ) bSingleDigit = true;
+        }
+
+        if ( bSingleDigit ) continue;
+
+        ParallelFor(threadCount, [&](std::size_t t) {
+            std::size_t* offset = offsets.data() + t * MESH_RADIX_BUCKETS;
+            for ( std::size_t i = count * t / threadCount; i < count * (t + 1) / threadCount; i++ ) {
+                std::size_t& position = offset[(keys[i] >> shift) & (MESH_RADIX_BUCKETS - 1u)];
+                sortedKeys[position] = keys[i];
+                sortedValues[position] = values[i];
+                position++;
+            }
+        });
+
+        keys.swap(sortedKeys);
+        values.swap(sortedValues);
+    }
+}
+
+/* Mixes the bit patterns of a vector into a hash (zero is hashed as +0). */
+inline std::uint64_t Mesh_HashVector(const Vector3f& vector, std::uint64_t hash) {
+    for ( unsigned int k = 0; k < 3; k++ ) {
+        std::uint32_t bits = 0u;
+        if ( vector[k] != 0.0f ) std::memcpy(&bits, &vector[k], sizeof(bits));
+        hash = (hash ^ bits) * 0xBF58476D1CE4E5B9ull;
+        hash ^= hash >> 31;
+    }
+
+    return hash;
+}
+
+/*
+ * Maps every element to the first element that is equal to it. Elements are
+ * partitioned between the threads by the upper bits of their hash, so each
+ * thread owns every element of its sets of equal elements and only visits
+ * those, in order (see ParallelPartition).
+ */
+template <typename Hash, typename Equal>
+void Mesh_FirstEqualElements(std::size_t count, Hash hash, Equal equal, std::vector<std::uint32_t>& firsts) {
+    std::size_t threadCount = (count >= MESH_MIN_PARALLEL_CORNERS) ? GetThreadCount() : 1u;
+    std::vector<std::uint32_t> hashes(count);
+    ParallelFor(threadCount, [&](std::size_t t) {
+        for ( std::size_t i = count * t / threadCount; i < count * (t + 1) / threadCount; i++ ) {
+            std::uint64_t value = hash(i);
+            value = (value ^ (value >> 30)) * 0x94D049BB133111EBull;
+            hashes[i] = static_cast<std::uint32_t>(value ^ (value >> 32));
+        }
+    });
+
+    std::vector<std::uint32_t> partition;
+    std::vector<std::size_t> offsets;
+    ParallelPartition(count, threadCount, threadCount, [&](std::size_t i) {
+        return static_cast<std::size_t>(static_cast<std::uint64_t>(hashes[i]) * threadCount >> 32);
+    }, partition, offsets);
+
+    firsts.resize(count);
+    ParallelFor(threadCount, [&](std::size_t t) {
+        std::size_t capacity = 64u;
+        while ( capacity < (offsets[t + 1u] - offsets[t]) * 2u ) capacity *= 2u;
+        std::vector<std::uint32_t> table(capacity, VERTEX_SET_EMPTY);
+
+        //----------------------------------------------------------------------
+        // Linear probing table of the first element of every value.
+        //----------------------------------------------------------------------
+        std::size_t mask = capacity - 1u;
+        for ( std::size_t k = offsets[t]; k < offsets[t + 1u]; k++ ) {
+            std::size_t i = partition[k];
+            std::size_t j = hashes[i] & mask;
+            while ( table[j] != VERTEX_SET_EMPTY && (hashes[table[j]] != hashes[i] || !equal(table[j], i)) ) j = (j + 1u) & mask;
+            if ( table[j] == VERTEX_SET_EMPTY ) table[j] = static_cast<std::uint32_t>(i);
+            firsts[i] = table[j];
+        }
+    });
+}
+
+/*
+ * Index-triple path of Decompress. The canonical position, normal, and texture
+ * indices of every face corner are packed into a 64-bit key and the keys are
+ * radix sorted, so corners with the same indices form a run. Each run becomes
+ * one vertex, numbered in order of the first corner of the run. Returns false
+ * (and leaves the output untouched) if the indices do not fit into 64 bits.
+ */
+bool Mesh_DecompressSorted(
+        const std::vector<unsigned int>& indices,
+        const std::vector<unsigned int>& normalIndices,
+        const std::vector<unsigned int>& textureIndices,
+        const std::vector<Vector3f>& vertices,
+        const std::vector<Vector3f>& normals,
+        const std::vector<Vector3f>& textureCoords,
+        std::vector<Vertex>& outVertices,
+        std::vector<TriangleFace>& outFaces
+    ) {
+
+    //--------------------------------------------------------------------------
+    // The normal indices are left out of the key if they are the position
+    // indices (computed normals).
+    //--------------------------------------------------------------------------
+    bool bPositionNormals = (&normalIndices == &indices);
+    unsigned int normalBits = bPositionNormals ? 0u : Mesh_IndexBits(normals.size());
+    unsigned int textureBits = Mesh_IndexBits(textureCoords.size());
+    unsigned int keyBits = Mesh_IndexBits(vertices.size()) + normalBits + textureBits;
+    if ( keyBits > 64u ) return false;
+
+    //--------------------------------------------------------------------------
+    // Attributes with equal values but different Obj indices share a key, so
+    // the result matches the vertex set: each position (with its normal),
+    // normal, and texture-coord is keyed by the index of its first equal.
+    //--------------------------------------------------------------------------
+    std::vector<std::uint32_t> positionKeys;
+    std::vector<std::uint32_t> normalKeys;
+    std::vector<std::uint32_t> textureKeys;
+    Mesh_FirstEqualElements(vertices.size(),
+        [&](std::size_t i) { return Mesh_HashVector(vertices[i], bPositionNormals ? Mesh_HashVector(normals[i], 0u) : 0u); },
+        [&](std::size_t i, std::size_t j) { return vertices[i] == vertices[j] && (!bPositionNormals || normals[i] == normals[j]); },
+        positionKeys);
+    Mesh_FirstEqualElements(textureCoords.size(),
+        [&](std::size_t i) { return Mesh_HashVector(textureCoords[i], 0u); },
+        [&](std::size_t i, std::size_t j) { return textureCoords[i] == textureCoords[j]; },
+        textureKeys);
+    if ( !bPositionNormals ) {
+        Mesh_FirstEqualElements(normals.size(),
+            [&](std::size_t i) { return Mesh_HashVector(normals[i], 0u); },
+            [&](std::size_t i, std::size_t j) { return normals[i] == normals[j]; },
+            normalKeys);
+    }
+
+    std::size_t cornerCount = indices.size() / TRIANGLE_EDGE_COUNT * TRIANGLE_EDGE_COUNT;
+    std::size_t threadCount = (cornerCount >= MESH_MIN_PARALLEL_CORNERS) ? GetThreadCount() : 1u;
+    std::vector<std::uint64_t> keys(cornerCount);
+    std::vector<std::uint32_t> corners(cornerCount);
+    ParallelFor(threadCount, [&](std::size_t t) {
+        for ( std::size_t i = cornerCount * t / threadCount; i < cornerCount * (t + 1) / threadCount; i++ ) {
+            std::uint64_t key = positionKeys[indices[i]];
+            if ( !bPositionNormals ) key = (key << normalBits) | normalKeys[normalIndices[i]];
+            keys[i] = (key << textureBits) | textureKeys[textureIndices[i]];
+            corners[i] = static_cast<std::uint32_t>(i);
+        }
+    });
+
+    Mesh_RadixSort(keys, corners, keyBits);
+
+    //--------------------------------------------------------------------------
+    // The leader of a corner is the first corner of its run (the sort is
+    // stable). A slice that starts within a run looks back to its start.
+    //--------------------------------------------------------------------------
+    std::vector<std::uint32_t> leaders(cornerCount);
+    ParallelFor(threadCount, [&](std::size_t t) {
+        std::size_t begin = cornerCount * t / threadCount;
+        std::size_t end = cornerCount * (t + 1) / threadCount;
+        std::size_t runStart = begin;
+        while ( runStart > 0 && runStart < end && keys[runStart - 1] == keys[begin] ) runStart--;
+
+        for ( std::size_t i = begin; i < end; i++ ) {
+            if ( keys[i] != keys[runStart] ) runStart = i;
+            leaders[corners[i]] = corners[runStart];
+        }
+    });
+
+    //--------------------------------------------------------------------------
+    // Number the vertices in order of their leaders. A leader never follows
+    // the corners it leads, so their numbers are already known.
+    //--------------------------------------------------------------------------
+    std::vector<std::uint64_t>().swap(keys);
+    std::vector<std::uint32_t>& numbers = corners;
+    std::uint32_t vertexCount = static_cast<std::uint32_t>(outVertices.size());
+    for ( std::size_t i = 0; i < cornerCount; i++ )
+        numbers[i] = (leaders[i] == i) ? vertexCount++ : numbers[leaders[i]];
+
+    std::size_t faceOffset = outFaces.size();
+    outVertices.resize(vertexCount);
+    outFaces.resize(faceOffset + cornerCount / TRIANGLE_EDGE_COUNT);
+    ParallelFor(threadCount, [&](std::size_t t) {
+        for ( std::size_t i = cornerCount * t / threadCount; i < cornerCount * (t + 1) / threadCount; i++ ) {
+            outFaces[faceOffset + i / TRIANGLE_EDGE_COUNT].indices[i % TRIANGLE_EDGE_COUNT] = numbers[i];
+            if ( leaders[i] != i ) continue;
+
+            Vertex& vertex = outVertices[numbers[i]];
+            vertex.position = vertices[indices[i]];
+            vertex.normal = normals[normalIndices[i]];
+            vertex.textureCoord = textureCoords[textureIndices[i]];
+        }
+    });
+
+    return true;
+}
+
+bool Decompress(
+        const std::vector<unsigned int>& indices,
+        const std::vector<unsigned int>& normalIndices,
+        const std::vector<unsigned int>& textureIndices,
+        const std::vector<Vector3f>& vertices, 
+        const std::vector<Vector3f>& normals, 
+        const std::vector<Vector3f>& textureCoords,
+        std::vector<Vertex>& outVertices,
+        std::vector<TriangleFace>& outFaces
+    ) {
+
+    //--------------------------------------------------------------------------
+    // Corners are deduplicated by sorting their index triples. The vertex set
+    // is only used if the indices do not fit into a 64-bit key.
+    //--------------------------------------------------------------------------
+    if ( Mesh_DecompressSorted(indices, normalIndices, textureIndices, vertices, normals, textureCoords, outVertices, outFaces) ) return true;
+
+    VertexSet vertexSet;
+    unsigned int triangleCount = static_cast<unsigned int>(indices.size()) / TRIANGLE_EDGE_COUNT;
+    vertexSet.reserve(vertices.size());
+
+    unsigned int index = 0;
+    Vector3f v1, v2, v3;
+    Vector3f n1, n2, n3;
+    Vector3f t1, t2, t3;
+    TriangleFace face;
+    Vertex v;
+
+    outFaces.reserve(outFaces.size() + triangleCount);
+    for ( unsigned int i = 0; i < triangleCount; i++ ) {
+
+        unsigned int vIndex, nIndex, tIndex;
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+            vIndex = indices[index + j];
+            nIndex = normalIndices[index + j];
+            tIndex = textureIndices[index + j];
+
+            v.position = vertices[vIndex];
+            v.normal = normals[nIndex];
+            v.textureCoord = textureCoords[tIndex];
+
+            face.indices[j] = vertexSet.insert(v, outVertices);
+        }
+
+        outFaces.push_back(face);
+        index += TRIANGLE_EDGE_COUNT;
+    }
+
+    return true;
 }
 
-/* http://www.terathon.com/code/tangent.html */
-bool CalculateTangents(std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces) {
-	if ( vertices.size() == 0 ) {
-		std::cerr << "[Mesh:calculateTangents] Error: Vertex array of length 0." << std::endl;
+/*
+ * Reorders the faces of a mesh so that the sub-meshes of each material form a
+ * single contiguous range. Materials keep the order in which they first
+ * appear and the sub-meshes of a material keep their file order. Adjacent
+ * sub-meshes with the same name and material are merged.
+ */
+bool SortSubMeshesByMaterial(std::vector<TriangleFace>& faces, std::vector<SubMesh>& subMeshes) {
+    std::map<std::string, std::size_t> materialRanks;
+    std::vector<std::size_t> ranks(subMeshes.size());
+    for ( std::size_t i = 0; i < subMeshes.size(); i++ )
+        ranks[i] = materialRanks.insert(std::make_pair(subMeshes[i].material, materialRanks.size())).first->second;
+
+    //--------------------------------------------------------------------------
+    // Faces are only moved if a material is interleaved with another.
+    //--------------------------------------------------------------------------
+    if ( !std::is_sorted(ranks.begin(), ranks.end()) ) {
+        std::vector<std::size_t> order(subMeshes.size());
+        for ( std::size_t i = 0; i < order.size(); i++ ) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&ranks](std::size_t a, std::size_t b) { return ranks[a] < ranks[b]; });
+
+        std::vector<TriangleFace> sortedFaces;
+        std::vector<SubMesh> sortedSubMeshes;
+        sortedFaces.reserve(faces.size());
+        sortedSubMeshes.reserve(subMeshes.size());
+        for ( std::size_t i = 0; i < order.size(); i++ ) {
+            SubMesh subMesh = subMeshes[order[i]];
+            if ( static_cast<std::size_t>(subMesh.faceOffset) + subMesh.faceCount > faces.size() ) {
+                std::cerr << "[Mesh:sortSubMeshesByMaterial] Error: Sub-mesh exceeds the face array." << std::endl;
+                return false;
+            }
+
+            sortedFaces.insert(sortedFaces.end(), faces.begin() + subMesh.faceOffset, faces.begin() + subMesh.faceOffset + subMesh.faceCount);
+            subMesh.faceOffset = static_cast<std::uint32_t>(sortedFaces.size() - subMesh.faceCount);
+            sortedSubMeshes.push_back(subMesh);
+        }
+
+        faces.swap(sortedFaces);
+        subMeshes.swap(sortedSubMeshes);
+    }
+
+    std::size_t subMeshCount = 0;
+    for ( std::size_t i = 0; i < subMeshes.size(); i++ ) {
+        if ( subMeshCount != 0 && subMeshes[subMeshCount - 1].name == subMeshes[i].name && subMeshes[subMeshCount - 1].material == subMeshes[i].material ) {
+            subMeshes[subMeshCount - 1].faceCount += subMeshes[i].faceCount;
+            continue;
+        }
+
+        if ( subMeshCount != i ) subMeshes[subMeshCount] = subMeshes[i];
+        subMeshCount++;
+    }
+
+    subMeshes.resize(subMeshCount);
+    return true;
+}
+
+/*
+ * Calculates the range of vertices [minIndex, maxIndex] referenced by each
+ * sub-mesh of a mesh.
+ */
+bool CalculateSubMeshBounds(const std::vector<TriangleFace>& faces, std::vector<SubMesh>& subMeshes) {
+    for ( std::size_t i = 0; i < subMeshes.size(); i++ ) {
+        SubMesh& subMesh = subMeshes[i];
+        if ( static_cast<std::size_t>(subMesh.faceOffset) + subMesh.faceCount > faces.size() ) {
+            std::cerr << "[Mesh:calculateSubMeshBounds] Error: Sub-mesh exceeds the face array." << std::endl;
+            return false;
+        }
+
+        unsigned int minIndex = ~0u;
+        unsigned int maxIndex = 0u;
+        for ( std::size_t f = subMesh.faceOffset; f < subMesh.faceOffset + subMesh.faceCount; f++ ) {
+            for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+                minIndex = std::min(minIndex, faces[f].indices[j]);
+                maxIndex = std::max(maxIndex, faces[f].indices[j]);
+            }
+        }
+
+        subMesh.minIndex = (subMesh.faceCount > 0) ? minIndex : 0u;
+        subMesh.maxIndex = maxIndex;
+    }
+
+    return true;
+}
+
+/*
+ * Reorders the faces of each sub-mesh and the vertices of a mesh for the GPU
+ * if bOptimize is set (see OptimizeMesh) and recalculates the vertex ranges
+ * of the sub-meshes. The vertex cache statistics are reported either way.
+ */
+void Mesh_OptimizeFaceOrder(std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces, std::vector<SubMesh>& subMeshes, bool bOptimize, MeshOptimizationStatistics& statistics) {
+    if ( !bOptimize || !OptimizeMesh(vertices, faces, subMeshes, &statistics) ) {
+        statistics.original = AnalyzeVertexCache(faces.data(), faces.size(), vertices.size());
+        statistics.optimized = statistics.original;
+    }
+
+    CalculateSubMeshBounds(faces, subMeshes);
+}
+
+/*
+ * Builds the levels of detail of a mesh if bGenerate is set (see
+ * BuildMeshLods) and calculates the vertex ranges of their sub-meshes. The
+ * faces of the levels are appended to the faces of the mesh.
+ */
+void Mesh_BuildLods(const std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces, const std::vector<SubMesh>& subMeshes, bool bGenerate, MeshLodChain& chain) {
+    chain = MeshLodChain();
+    if ( !bGenerate ) return;
+
+    BuildMeshLods(vertices, faces, subMeshes, chain);
+    for ( std::size_t level = 0; level < chain.levels.size(); level++ )
+        CalculateSubMeshBounds(faces, chain.levels[level].subMeshes);
+}
+
+/*
+ * Splits the faces of a mesh into clusters if bGenerate is set (see
+ * BuildMeshClusters), which reorders the faces within each sub-mesh.
+ */
+void Mesh_BuildClusters(const std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces, const std::vector<SubMesh>& subMeshes, bool bGenerate, std::vector<MeshCluster>& clusters) {
+    clusters.clear();
+    if ( !bGenerate ) return;
+
+    BuildMeshClusters(vertices, faces, subMeshes, clusters);
+}
+
+/* Returns the number of faces of a mesh without the faces of its levels of detail. */
+std::size_t Mesh_GetDetailFaceCount(const std::vector<SubMesh>& subMeshes, const MeshLodChain& chain, std::size_t faceCount) {
+    if ( chain.levels.size() == 0 ) return faceCount;
+
+    std::size_t detailFaceCount = 0u;
+    for ( std::size_t i = 0; i < subMeshes.size(); i++ )
+        detailFaceCount = std::max(detailFaceCount, static_cast<std::size_t>(subMeshes[i].faceOffset) + subMeshes[i].faceCount);
+    return detailFaceCount;
+}
+
+/*
+ * Points the indices of Obj face nodes without an attribute (indices past the
+ * end of the attribute array) at a single zero attribute appended to the array.
+ */
+void Mesh_ReplaceMissingIndices(std::vector<unsigned int>& indices, std::vector<Vector3f>& values) {
+    unsigned int missing = static_cast<unsigned int>(values.size());
+    for ( std::size_t i = 0; i < indices.size(); i++ ) {
+        if ( indices[i] < missing ) continue;
+        if ( values.size() == missing ) values.push_back(Vector3f());
+        indices[i] = missing;
+    }
+}
+
+/*
+ * Builds the final vertices, faces, and sub-meshes of a Mesh while an Obj file
+ * is parsed (see ParseObjFile). Every object of the Obj file is loaded into
+ * the same vertex and face arrays; each run of faces of the same object,
+ * group, and material becomes a sub-mesh.
+ *
+ * By default the vertices are deduplicated as the faces arrive, so only the
+ * Obj vertex attributes are held besides the final mesh. Computed normals
+ * depend on every face of the mesh; in that case, or if bSortCorners is set,
+ * the face indices are kept until the Obj file has been parsed and equal
+ * corners are merged by sorting their index triples (see decompress).
+ */
+class Mesh_ObjVisitor : public ObjVisitor {
+public:
+    Mesh_ObjVisitor(std::string& name, std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces, std::vector<SubMesh>& subMeshes, bool bComputeNormals, MeshNormalWeighting normalWeighting, bool bSortCorners = false) : name(name), vertices(vertices), faces(faces), subMeshes(subMeshes) {
+        this->bComputeNormals = bComputeNormals;
+        this->bSortCorners = bSortCorners || bComputeNormals;
+        this->normalWeighting = normalWeighting;
+        this->bNewSubMesh = true;
+        this->objectCount = 0u;
+        this->faceCount = 0u;
+        this->started = false;
+        this->failed = false;
+    }
+
+    bool onVertex(const Vector3f& position) {
+        this->started = true;
+        this->positions.push_back(position);
+        return true;
+    }
+
+    bool onNormal(const Vector3f& normal) {
+        this->started = true;
+        this->normals.push_back(normal);
+        return true;
+    }
+
+    bool onTexcoord(const Vector3f& textureCoord) {
+        this->started = true;
+        this->textureCoords.push_back(textureCoord);
+        return true;
+    }
+
+    bool onFace(const std::uint32_t* vertexIndices, const std::uint32_t* textureIndices, const std::uint32_t* normalIndices, std::size_t nodeCount) {
+        this->started = true;
+        if ( nodeCount != TRIANGLE_EDGE_COUNT ) {
+            std::cerr << "[Mesh:load] Error: Only triangle-face Obj files supported." << std::endl;
+            this->failed = true;
+            return false;
+        }
+
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+            if ( vertexIndices[j] >= this->positions.size() ) {
+                std::cerr << "[Mesh:load] Error: Face references an undefined vertex." << std::endl;
+                this->failed = true;
+                return false;
+            }
+        }
+
+        //----------------------------------------------------------------------
+        // The first face after an object, group, or material change starts a
+        // new sub-mesh.
+        //----------------------------------------------------------------------
+        if ( this->bNewSubMesh ) this->startSubMesh();
+
+        this->subMeshes.back().faceCount++;
+        this->faceCount++;
+
+        if ( this->bSortCorners ) {
+            this->vertexIndices.insert(this->vertexIndices.end(), vertexIndices, vertexIndices + TRIANGLE_EDGE_COUNT);
+            this->textureIndices.insert(this->textureIndices.end(), textureIndices, textureIndices + TRIANGLE_EDGE_COUNT);
+            if ( !this->bComputeNormals ) this->normalIndices.insert(this->normalIndices.end(), normalIndices, normalIndices + TRIANGLE_EDGE_COUNT);
+            return true;
+        }
+
+        //----------------------------------------------------------------------
+        // Identical to Decompress: each unique position, normal, texture-coord
+        // combination becomes a single vertex. Missing normals and texture-
+        // coords are left at 0.
+        //----------------------------------------------------------------------
+        TriangleFace face;
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+            this->vertex.position = this->positions[vertexIndices[j]];
+            this->vertex.normal = (normalIndices[j] < this->normals.size()) ? this->normals[normalIndices[j]] : Vector3f();
+            this->vertex.textureCoord = (textureIndices[j] < this->textureCoords.size()) ? this->textureCoords[textureIndices[j]] : Vector3f();
+
+            face.indices[j] = this->vertexSet.insert(this->vertex, this->vertices);
+        }
+
+        this->faces.push_back(face);
+        return true;
+    }
+
+    bool onGroup(const std::string& name) {
+        this->started = true;
+        if ( this->objectCount <= 1u && name.length() != 0 ) this->name = name;
+        if ( name != this->groupName ) this->bNewSubMesh = true;
+        this->groupName = name;
+        return true;
+    }
+
+    bool onObject(const std::string& name) {
+        this->started = true;
+        this->objectCount++;
+        if ( this->objectCount == 1u ) this->name = name;
+        this->objectName = name;
+        this->groupName.clear();
+        this->bNewSubMesh = true;
+        return true;
+    }
+
+    bool onMaterial(const std::string& name) {
+        this->started = true;
+        if ( name != this->materialName ) this->bNewSubMesh = true;
+        this->materialName = name;
+        return true;
+    }
+
+    bool onMaterialLibrary(const std::string& name) {
+        this->materialLibraries.push_back(name);
+        return true;
+    }
+
+    /*
+     * Decompresses the kept face indices into the final vertices and faces,
+     * calculating the vertex normals first if they are computed (see
+     * CalculateNormals and Decompress). Does nothing if the vertices were
+     * deduplicated as the faces arrived.
+     */
+    bool decompress() {
+        if ( !this->bSortCorners ) return true;
+
+        Mesh_ReplaceMissingIndices(this->textureIndices, this->textureCoords);
+        if ( !this->bComputeNormals ) {
+            Mesh_ReplaceMissingIndices(this->normalIndices, this->normals);
+            return Decompress(this->vertexIndices, this->normalIndices, this->textureIndices, this->positions, this->normals, this->textureCoords, this->vertices, this->faces);
+        }
+
+        std::vector<Vector3f> normals;
+        if ( !CalculateNormals(this->vertexIndices, this->positions, normals, this->normalWeighting) ) return false;
+        return Decompress(this->vertexIndices, this->vertexIndices, this->textureIndices, this->positions, normals, this->textureCoords, this->vertices, this->faces);
+    }
+
+    /* Returns the material libraries referenced by the Obj file. */
+    const std::vector<std::string>& getMaterialLibraries() const { return this->materialLibraries; }
+
+    /* Returns true if the Obj file contained a mesh. */
+    bool hasMesh() const { return this->started; }
+
+    /* Returns true if the Obj mesh could not be converted. */
+    bool hasFailed() const { return this->failed; }
+
+protected:
+    void startSubMesh() {
+        SubMesh subMesh;
+        subMesh.name = (this->groupName.length() != 0) ? this->groupName : this->objectName;
+        subMesh.material = this->materialName;
+        subMesh.faceOffset = this->faceCount;
+        subMesh.faceCount = 0u;
+        subMesh.minIndex = 0u;
+        subMesh.maxIndex = 0u;
+        subMesh.materialIndex = SUBMESH_NO_MATERIAL;
+        this->subMeshes.push_back(subMesh);
+        this->bNewSubMesh = false;
+    }
+
+protected:
+    std::string& name;
+    std::vector<Vertex>& vertices;
+    std::vector<TriangleFace>& faces;
+    std::vector<SubMesh>& subMeshes;
+
+    std::vector<Vector3f> positions;
+    std::vector<Vector3f> normals;
+    std::vector<Vector3f> textureCoords;
+    VertexSet vertexSet;
+    Vertex vertex;
+
+    /* Face indices kept until decompress if the corners are sorted (normal indices unless computed). */
+    std::vector<unsigned int> vertexIndices;
+    std::vector<unsigned int> textureIndices;
+    std::vector<unsigned int> normalIndices;
+
+    /* Object, group, and material of the following faces. */
+    std::string objectName;
+    std::string groupName;
+    std::string materialName;
+    std::vector<std::string> materialLibraries;
+
+    bool bComputeNormals;
+    bool bSortCorners;
+    MeshNormalWeighting normalWeighting;
+    bool bNewSubMesh;
+    unsigned int objectCount;
+    std::uint32_t faceCount;
+    bool started;
+    bool failed;
+};
+
+bool Mesh::load(const std::string& filename, bool bComputeNormals) {
+	this->reset();
+
+	//--------------------------------------------------------------------------
+	// Binary glTF, Ply, Stl, and compressed files are read directly from their
+	// mapped files and are not cached.
+	//--------------------------------------------------------------------------
+	std::string extension = std::filesystem::path(filename).extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	if ( extension == GLTF_BINARY_EXTENSION ) return this->loadGltf(filename, bComputeNormals);
+	if ( extension == PLY_EXTENSION ) return this->loadPly(filename, bComputeNormals);
+	if ( extension == STL_EXTENSION ) return this->loadStl(filename);
+	if ( extension == COMPRESSED_MESH_EXTENSION ) return this->loadCompressed(filename);
+
+	//--------------------------------------------------------------------------
+	// If a valid binary cache of this mesh exists then its mapped vertices and
+	// faces are uploaded directly, skipping the parsing and processing below.
+	//--------------------------------------------------------------------------
+	MeshCache cache;
+	if ( cache.open(filename, bComputeNormals, this->normalWeighting, this->bOptimizeFaceOrder, this->bGenerateLods, this->bGenerateClusters) ) {
+		this->name = cache.getName();
+		cache.getSubMeshes(this->subMeshes);
+		cache.getStatistics(this->optimizationStatistics);
+		cache.getLods(this->lodChain);
+		cache.getClusters(this->clusters);
+		this->constructOnGPU(cache.getVertices(), cache.getVertexCount(), cache.getFaces(), cache.getFaceCount());
+
+		std::vector<std::string> materialLibraries;
+		cache.getMaterialLibraries(materialLibraries);
+		this->loadMaterials(filename, materialLibraries);
+		return true;
+	}
+
+	//--------------------------------------------------------------------------
+	// Every object of the Obj file is streamed into the vertices and faces of
+	// this mesh, one sub-mesh per object, group, and material.
+	//--------------------------------------------------------------------------
+	Mesh_ObjVisitor visitor(this->name, this->vertices, this->faces, this->subMeshes, bComputeNormals, this->normalWeighting, this->bSortObjCorners);
+	if ( !ParseObjFile(filename, visitor) || visitor.hasFailed() || !visitor.decompress() ) {
+		std::cerr << "[Mesh:load] Error: Could not load Obj file: " << filename << std::endl;
+		this->vertices.clear();
+		this->faces.clear();
+		this->subMeshes.clear();
 		return false;
 	}
 
-	if ( faces.size() == 0 ) {
-		std::cerr << "[Mesh:calculateNormals] Error: Face count = 0." << std::endl;
+	if ( !visitor.hasMesh() ) {
+		std::cerr << "[Mesh:load] Error: Obj file: " << filename << " contains no meshes." << std::endl;
 		return false;
 	}
 
-	std::size_t triangleCount = faces.size();
-	std::vector<Vector3f> tan1 = std::vector<Vector3f>(vertices.size());
-	std::vector<Vector3f> tan2 = std::vector<Vector3f>(vertices.size());
-
-	std::size_t i0 = 0, i1 = 0, i2 = 0;
-	Vector3f p1, p2, p3;
-	Vector3f w1, w2, w3;
-	for ( std::size_t i = 0; i < triangleCount; i++ ) {
-		i0 = faces[i].indices[A];
-		i1 = faces[i].indices[B];
-		i2 = faces[i].indices[C];
-
-		p1 = vertices[i0].position;
-		p2 = vertices[i1].position;
-		p3 = vertices[i2].position;
-
-		w1 = vertices[i0].textureCoord;
-		w2 = vertices[i1].textureCoord;
-		w3 = vertices[i2].textureCoord;
-
-		float x1 = p2.x() - p1.x();
-		float x2 = p3.x() - p1.x();
-		float y1 = p2.y() - p1.y();
-		float y2 = p3.y() - p1.y();
-		float z1 = p2.z() - p1.z();
-		float z2 = p3.z() - p1.z();
-
-		float s1 = w2.x() - w1.x();
-		float s2 = w3.x() - w1.x();
-		float t1 = w2.y() - w1.y();
-		float t2 = w3.y() - w1.y();
-
-		float r = 1.0f / (s1 * t2 - s2 * t1);
-		Vector3f sdir((t2 * x1 - t1 * x2) * r, (t2 * y1 - t1 * y2) * r, (t2 * z1 - t1 * z2) * r);
-		Vector3f tdir((s1 * x2 - s2 * x1) * r, (s1 * y2 - s2 * y1) * r, (s1 * z2 - s2 * z1) * r);
-
-		tan1[i0] += sdir;
-		tan1[i1] += sdir;
-		tan1[i2] += sdir;
-
-		tan2[i0] += tdir;
-		tan2[i1] += tdir;
-		tan2[i2] += tdir;
-	}
+	SortSubMeshesByMaterial(this->faces, this->subMeshes);
+	Mesh_OptimizeFaceOrder(this->vertices, this->faces, this->subMeshes, this->bOptimizeFaceOrder, this->optimizationStatistics);
+	CalculateTangents(this->vertices, this->faces);
+	Mesh_BuildClusters(this->vertices, this->faces, this->subMeshes, this->bGenerateClusters, this->clusters);
+	Mesh_BuildLods(this->vertices, this->faces, this->subMeshes, this->bGenerateLods, this->lodChain);
+
+	//--------------------------------------------------------------------------
+	// Set all colors to black since they are not provided by an OBJ file.
+	//--------------------------------------------------------------------------
+	for ( unsigned int i = 0; i < this->vertices.size(); i++ )
+		this->vertices[i].color = Color3f(0.0f, 0.0f, 0.0f);
+
+	if ( !SaveMeshCache(filename, bComputeNormals, this->normalWeighting, this->bOptimizeFaceOrder, this->optimizationStatistics, this->bGenerateLods, this->lodChain, this->bGenerateClusters, this->clusters, this->name, this->vertices, this->faces, this->subMeshes, visitor.getMaterialLibraries()) )
+		std::cerr << "[Mesh:load] Warning: Could not write the mesh cache of: " << filename << std::endl;
+
+	this->constructOnGPU();
+	this->loadMaterials(filename, visitor.getMaterialLibraries());
+	return true;
+}
+
+/*
+ * Returns the layout of the buffers of a mesh of vertexCount vertices uploaded
+ * in a vertex layout; 16-bit indices can only index the first 65536 vertices.
+ */
+VertexLayout Mesh_GetBufferLayout(const VertexLayout& layout, std::size_t vertexCount) {
+    VertexLayout bufferLayout = layout;
+    bufferLayout.bShortIndices = layout.bShortIndices && vertexCount <= VERTEX_LAYOUT_SHORT_INDEX_LIMIT;
+    return bufferLayout;
+}
+
+/* Returns the size in bytes of an index of the buffers of a layout. */
+std::size_t Mesh_GetIndexSize(const VertexLayout& layout) {
+    return layout.bShortIndices ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+}
+
+/*
+ * Fills the bound vertex buffer with vertices in a vertex layout. Vertices
+ * are only converted if the layout does not store Vertex structures.
+ */
+void Mesh_BufferVertices(const VertexLayout& layout, const Vertex* vertices, std::size_t vertexCount) {
+    if ( IsUnpackedVertexLayout(layout) ) {
+        glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(Vertex), vertices, GL_STATIC_DRAW);
+        return;
+    }
+
+    std::vector<unsigned char> packed(vertexCount * GetVertexSize(layout));
+    PackVertices(layout, vertices, vertexCount, packed.data());
+    glBufferData(GL_ARRAY_BUFFER, packed.size(), packed.data(), GL_STATIC_DRAW);
+}
+
+/* Fills the bound index buffer with the indices of faces in the index size of a layout. */
+void Mesh_BufferIndices(const VertexLayout& layout, const TriangleFace* faces, std::size_t faceCount) {
+    if ( !layout.bShortIndices ) {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, faceCount * sizeof(TriangleFace), faces, GL_STATIC_DRAW);
+        return;
+    }
+
+    std::vector<std::uint16_t> indices(faceCount * TRIANGLE_EDGE_COUNT);
+    PackShortIndices(faces, faceCount, indices.data());
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(std::uint16_t), indices.data(), GL_STATIC_DRAW);
+}
+
+/*
+ * Fills the bound index buffer with the adjacency indices of faces (see
+ * MeshConnectivity::getAdjacencyIndices) in the index size of a layout. The
+ * corner table covers the full level of detail; each level of detail gets a
+ * table of its own, so neighbors never cross levels.
+ */
+void Mesh_BufferAdjacency(const VertexLayout& layout, const MeshConnectivity& connectivity, const MeshLodChain& chain, const Vertex* vertices, std::size_t vertexCount, const TriangleFace* faces, std::size_t faceCount) {
+    std::vector<std::uint32_t> indices(faceCount * MESH_ADJACENCY_FACE_INDEX_COUNT, 0u);
+    connectivity.getAdjacencyIndices(indices.data());
+
+    for ( std::size_t level = 0; level < chain.levels.size(); level++ ) {
+        const std::vector<SubMesh>& subMeshes = chain.levels[level].subMeshes;
+        if ( subMeshes.size() == 0 ) continue;
+
+        std::size_t begin = subMeshes[0].faceOffset;
+        std::size_t end = begin;
+        for ( std::size_t i = 0; i < subMeshes.size(); i++ ) {
+            begin = std::min(begin, static_cast<std::size_t>(subMeshes[i].faceOffset));
+            end = std::max(end, static_cast<std::size_t>(subMeshes[i].faceOffset) + subMeshes[i].faceCount);
+        }
+
+        MeshConnectivity levelConnectivity;
+        if ( end <= faceCount && levelConnectivity.build(vertices, vertexCount, faces + begin, end - begin) )
+            levelConnectivity.getAdjacencyIndices(indices.data() + begin * MESH_ADJACENCY_FACE_INDEX_COUNT);
+    }
+
+    if ( !layout.bShortIndices ) {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(std::uint32_t), indices.data(), GL_STATIC_DRAW);
+        return;
+    }
+
+    std::vector<std::uint16_t> shortIndices(indices.begin(), indices.end());
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, shortIndices.size() * sizeof(std::uint16_t), shortIndices.data(), GL_STATIC_DRAW);
+}
+
+/*
+ * Uploads a compressed mesh into new vertex and index buffers of a layout
+ * (see Mesh_GetBufferLayout). The buffers are deleted if the mesh cannot be
+ * decoded.
+ */
+bool Mesh_UploadCompressed(const CompressedMesh& compressed, const VertexLayout& layout, unsigned int& vboVertex, unsigned int& vboIndex) {
+    std::size_t vertexSize = compressed.getVertexCount() * sizeof(Vertex);
+    std::size_t faceSize = compressed.getFaceCount() * sizeof(TriangleFace);
+    glGenBuffers(1, &vboVertex);
+    glBindBuffer(GL_ARRAY_BUFFER, vboVertex);
+    glGenBuffers(1, &vboIndex);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vboIndex);
+
+    //--------------------------------------------------------------------------
+    // The vertices and faces are decoded straight into the mapped buffers. If
+    // a buffer cannot be mapped (or its contents are lost while mapped) the
+    // mesh is decoded into memory and uploaded from there instead, as are
+    // meshes uploaded in a packed layout.
+    //--------------------------------------------------------------------------
+    bool bMapped = false;
+    bool bDecoded = false;
+    if ( IsUnpackedVertexLayout(layout) && !layout.bShortIndices ) {
+        glBufferData(GL_ARRAY_BUFFER, vertexSize, nullptr, GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, faceSize, nullptr, GL_STATIC_DRAW);
+        Vertex* vertices = static_cast<Vertex*>(glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY));
+        TriangleFace* faces = static_cast<TriangleFace*>(glMapBuffer(GL_ELEMENT_ARRAY_BUFFER, GL_WRITE_ONLY));
+        bMapped = (vertices != nullptr && faces != nullptr);
+        bDecoded = bMapped && compressed.decode(vertices, faces);
+        if ( vertices != nullptr && glUnmapBuffer(GL_ARRAY_BUFFER) == GL_FALSE ) bMapped = false;
+        if ( faces != nullptr && glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER) == GL_FALSE ) bMapped = false;
+    }
+
+    if ( !bMapped ) {
+        std::vector<Vertex> decodedVertices(compressed.getVertexCount());
+        std::vector<TriangleFace> decodedFaces(compressed.getFaceCount());
+        bDecoded = compressed.decode(decodedVertices.data(), decodedFaces.data());
+        if ( bDecoded ) {
+            Mesh_BufferVertices(layout, decodedVertices.data(), decodedVertices.size());
+            Mesh_BufferIndices(layout, decodedFaces.data(), decodedFaces.size());
+        }
+    }
+
+    if ( !bDecoded ) {
+        glDeleteBuffers(1, &vboVertex);
+        glDeleteBuffers(1, &vboIndex);
+        vboVertex = 0u;
+        vboIndex = 0u;
+    }
+
+    return bDecoded;
+}
+
+bool Mesh::loadCompressed(const std::string& filename) {
+    CompressedMesh compressed;
+    if ( !compressed.open(filename) ) return false;
+    if ( compressed.getVertexCount() == 0 || compressed.getFaceCount() == 0 ) {
+        std::cerr << "[Mesh:loadCompressed] Error: Compressed mesh: " << filename << " contains no faces." << std::endl;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // A staging mesh (see MeshResidencyManager) is decoded into memory and
+    // uploaded later by the thread that owns the OpenGL context.
+    //--------------------------------------------------------------------------
+    bool bDecoded = false;
+    if ( this->bDeferUpload ) {
+        this->vertices.resize(compressed.getVertexCount());
+        this->faces.resize(compressed.getFaceCount());
+        bDecoded = compressed.decode(this->vertices.data(), this->faces.data());
+    }
+    else {
+        this->bufferLayout = Mesh_GetBufferLayout(this->vertexLayout, compressed.getVertexCount());
+        bDecoded = Mesh_UploadCompressed(compressed, this->bufferLayout, this->vboVertex, this->vboIndex);
+    }
+
+    if ( !bDecoded ) {
+        std::cerr << "[Mesh:loadCompressed] Error: Could not decode compressed mesh: " << filename << std::endl;
+        this->vertices.clear();
+        this->faces.clear();
+        return false;
+    }
+
+    this->name = compressed.getName();
+    this->faceCount = compressed.getFaceCount();
+    compressed.getSubMeshes(this->subMeshes);
+
+    //--------------------------------------------------------------------------
+    // The vertices are decoded straight into their buffer, so the sphere is
+    // the one around the box stored in the header.
+    //--------------------------------------------------------------------------
+    compressed.getBounds(this->bounds.boundsMinimum, this->bounds.boundsMaximum);
+    Mesh_SetBoxSphere(this->bounds);
+    this->bBounds = true;
+
+    std::vector<std::string> materialLibraries;
+    compressed.getMaterialLibraries(materialLibraries);
+    this->loadMaterials(filename, materialLibraries);
+    return true;
+}
+
+bool Mesh::saveCompressed(const std::string& filename, const MeshCodecOptions& options) const {
+    if ( this->chunks.size() != 0 || this->vboVertex == 0u ) {
+        std::cerr << "[Mesh:saveCompressed] Error: Mesh: " << this->name << " is not loaded or is out-of-core." << std::endl;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // Meshes uploaded without a CPU copy (from a cache, compressed, or mapped
+    // file) are read back from their GPU buffers, unless they were uploaded in
+    // a packed layout. The faces of the levels of detail are not saved.
+    //--------------------------------------------------------------------------
+    std::size_t detailFaceCount = Mesh_GetDetailFaceCount(this->subMeshes, this->lodChain, this->faceCount);
+    if ( this->vertices.size() == 0 || this->faces.size() != this->faceCount ) {
+        if ( !IsUnpackedVertexLayout(this->bufferLayout) || this->bufferLayout.bShortIndices ) {
+            std::cerr << "[Mesh:saveCompressed] Error: Mesh: " << this->name << " was uploaded in a packed vertex layout without a CPU copy." << std::endl;
+            return false;
+        }
+
+        GLint vertexSize = 0;
+        glBindBuffer(GL_ARRAY_BUFFER, this->vboVertex);
+        glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &vertexSize);
+        std::vector<Vertex> vertices(static_cast<std::size_t>(vertexSize) / sizeof(Vertex));
+        glGetBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(Vertex), vertices.data());
+
+        std::vector<TriangleFace> faces(detailFaceCount);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->vboIndex);
+        glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, faces.size() * sizeof(TriangleFace), faces.data());
+        return SaveCompressedMesh(filename, this->name, vertices, faces, this->subMeshes, this->materialLibraries, options);
+    }
+
+    if ( detailFaceCount != this->faces.size() ) {
+        std::vector<TriangleFace> faces(this->faces.begin(), this->faces.begin() + detailFaceCount);
+        return SaveCompressedMesh(filename, this->name, this->vertices, faces, this->subMeshes, this->materialLibraries, options);
+    }
+
+    return SaveCompressedMesh(filename, this->name, this->vertices, this->faces, this->subMeshes, this->materialLibraries, options);
+}
+
+/*
+ * Array of Vector3f records that is appended to a temporary file while an Obj
+ * file is streamed and mapped for random access afterwards, so the Obj
+ * vertex attributes of an out-of-core mesh are never held in memory. The
+ * temporary file is removed when the array is closed.
+ */
+class Mesh_SpillArray {
+public:
+    Mesh_SpillArray() {
+        this->count = 0u;
+    }
+
+    ~Mesh_SpillArray() {
+        this->close();
+    }
+
+    bool create(const std::filesystem::path& path) {
+        this->path = path;
+        this->stream.open(path, std::ios::binary | std::ios::trunc);
+        return this->stream.is_open();
+    }
+
+    void append(const Vector3f& value) {
+        float components[3] = { value.x(), value.y(), value.z() };
+        const char* bytes = reinterpret_cast<const char*>(components);
+        this->buffer.insert(this->buffer.end(), bytes, bytes + sizeof(components));
+        if ( this->buffer.size() >= MESH_SPILL_BUFFER_SIZE ) this->flush();
+        this->count++;
+    }
+
+    /* Writes the remaining records and maps the file for reading. */
+    bool map() {
+        this->flush();
+        this->stream.close();
+        if ( this->stream.fail() ) return false;
+        return (this->count == 0u) || this->file.open(this->path.string());
+    }
+
+    Vector3f get(std::size_t index) const {
+        float components[3];
+        std::memcpy(components, this->file.data() + index * sizeof(components), sizeof(components));
+        return Vector3f(components[0], components[1], components[2]);
+    }
+
+    std::size_t size() const {
+        return this->count;
+    }
+
+    void close() {
+        this->file.close();
+        if ( this->stream.is_open() ) this->stream.close();
+        if ( this->path.empty() ) return;
+
+        std::error_code error;
+        std::filesystem::remove(this->path, error);
+        this->path.clear();
+    }
+
+protected:
+    void flush() {
+        this->stream.write(this->buffer.data(), static_cast<std::streamsize>(this->buffer.size()));
+        this->buffer.clear();
+    }
+
+protected:
+    std::filesystem::path path;
+    std::ofstream stream;
+    std::vector<char> buffer;
+    MappedFile file;
+    std::size_t count;
+};
+
+/* First pass of Mesh::loadOutOfCore: spills the Obj vertex attributes. */
+class Mesh_ObjSpillVisitor : public ObjVisitor {
+public:
+    Mesh_ObjSpillVisitor(Mesh_SpillArray& positions, Mesh_SpillArray& normals, Mesh_SpillArray& textureCoords) : positions(positions), normals(normals), textureCoords(textureCoords) {}
+
+    bool onVertex(const Vector3f& position) {
+        this->positions.append(position);
+        return true;
+    }
+
+    bool onNormal(const Vector3f& normal) {
+        this->normals.append(normal);
+        return true;
+    }
+
+    bool onTexcoord(const Vector3f& textureCoord) {
+        this->textureCoords.append(textureCoord);
+        return true;
+    }
+
+protected:
+    Mesh_SpillArray& positions;
+    Mesh_SpillArray& normals;
+    Mesh_SpillArray& textureCoords;
+};
+
+/* Position, texture-coord, and normal index of a face node. */
+struct Mesh_NodeKey {
+    bool operator == (const Mesh_NodeKey& key) const {
+        return this->position == key.position && this->textureCoord == key.textureCoord && this->normal == key.normal;
+    }
+
+    std::uint32_t position;
+    std::uint32_t textureCoord;
+    std::uint32_t normal;
+};
+
+struct Mesh_NodeKeyHash {
+    std::size_t operator () (const Mesh_NodeKey& key) const {
+        std::uint64_t hash = key.position * 0x9E3779B97F4A7C15ull;
+        hash ^= (key.textureCoord + 0x7F4A7C15ull) * 0xBF58476D1CE4E5B9ull;
+        hash ^= (key.normal + 0x94D049BBull) * 0x94D049BB133111EBull;
+        return static_cast<std::size_t>(hash ^ (hash >> 29));
+    }
+};
+
+/*
+ * Second pass of Mesh::loadOutOfCore. The faces of the Obj file are collected
+ * into chunks whose vertices are deduplicated by their face node indices;
+ * the attributes are read from the spilled arrays. Once a chunk reaches the
+ * memory budget it is uploaded into its own vertex and index buffer and its
+ * CPU memory is reused for the next chunk. Vertices shared by two chunks are
+ * duplicated, and computed normals only average the faces of a chunk.
+ */
+class Mesh_ObjChunkVisitor : public Mesh_ObjVisitor {
+public:
+    Mesh_ObjChunkVisitor(std::string& name, std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces, std::vector<SubMesh>& subMeshes, bool bComputeNormals, MeshNormalWeighting normalWeighting,
+                         const Mesh_SpillArray& positions, const Mesh_SpillArray& normals, const Mesh_SpillArray& textureCoords, const VertexLayout& layout, std::size_t memoryBudget, std::vector<MeshChunk>& chunks) :
+        Mesh_ObjVisitor(name, vertices, faces, subMeshes, bComputeNormals || normals.size() == 0u, normalWeighting), spilledPositions(positions), spilledNormals(normals), spilledTextureCoords(textureCoords), layout(layout), chunks(chunks) {
+        this->memoryBudget = std::max(memoryBudget, MESH_MIN_CHUNK_BUDGET);
+        this->totalFaceCount = 0u;
+        this->bBounds = false;
+    }
+
+    bool onVertex(const Vector3f& /*position*/) {
+        this->started = true;
+        return true;
+    }
+
+    bool onNormal(const Vector3f& /*normal*/) {
+        return true;
+    }
+
+    bool onTexcoord(const Vector3f& /*textureCoord*/) {
+        return true;
+    }
+
+    bool onFace(const std::uint32_t* vertexIndices, const std::uint32_t* textureIndices, const std::uint32_t* normalIndices, std::size_t nodeCount) {
+        this->started = true;
+        if ( nodeCount != TRIANGLE_EDGE_COUNT ) {
+            std::cerr << "[Mesh:loadOutOfCore] Error: Only triangle-face Obj files supported." << std::endl;
+            this->failed = true;
+            return false;
+        }
+
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+            if ( vertexIndices[j] >= this->spilledPositions.size() ) {
+                std::cerr << "[Mesh:loadOutOfCore] Error: Face references an undefined vertex." << std::endl;
+                this->failed = true;
+                return false;
+            }
+        }
+
+        if ( this->bNewSubMesh ) this->startSubMesh();
+        this->subMeshes.back().faceCount++;
+        this->faceCount++;
+        this->totalFaceCount++;
+
+        TriangleFace face;
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+            Mesh_NodeKey key;
+            key.position = vertexIndices[j];
+            key.textureCoord = (textureIndices[j] < this->spilledTextureCoords.size()) ? textureIndices[j] : ~0u;
+            key.normal = (!this->bComputeNormals && normalIndices[j] < this->spilledNormals.size()) ? normalIndices[j] : ~0u;
+
+            std::pair<std::unordered_map<Mesh_NodeKey, unsigned int, Mesh_NodeKeyHash>::iterator, bool> node = this->nodes.insert(std::make_pair(key, static_cast<unsigned int>(this->vertices.size())));
+            face.indices[j] = node.first->second;
+            if ( !node.second ) continue;
+
+            Vertex vertex;
+            vertex.position = this->spilledPositions.get(key.position);
+            vertex.normal = (key.normal != ~0u) ? this->spilledNormals.get(key.normal) : Vector3f();
+            vertex.tangent = Vector4f(0.0f, 0.0f, 0.0f, 0.0f);
+            vertex.textureCoord = (key.textureCoord != ~0u) ? this->spilledTextureCoords.get(key.textureCoord) : Vector3f();
+            vertex.color = Color3f(0.0f, 0.0f, 0.0f);
+            this->vertices.push_back(vertex);
+            this->vertexPositions.push_back(key.position);
+        }
+
+        this->faces.push_back(face);
+
+        std::size_t chunkSize = this->vertices.size() * (sizeof(Vertex) + MESH_CHUNK_VERTEX_OVERHEAD) + this->faces.size() * sizeof(TriangleFace);
+        if ( chunkSize >= this->memoryBudget ) return this->flush();
+        return true;
+    }
+
+    /* Uploads the current chunk (if it contains any faces). */
+    bool flush() {
+        if ( this->faces.size() == 0 ) return true;
+
+        //----------------------------------------------------------------------
+        // Computed normals average the faces of this chunk around each Obj
+        // position (see CalculateNormals).
+        //----------------------------------------------------------------------
+        if ( this->bComputeNormals ) {
+            std::unordered_map<std::uint32_t, unsigned int> positionIndices;
+            std::vector<Vector3f> positions;
+            std::vector<unsigned int> vertexIndices(this->vertices.size());
+            for ( std::size_t i = 0; i < this->vertices.size(); i++ ) {
+                auto inserted = positionIndices.emplace(this->vertexPositions[i], static_cast<unsigned int>(positions.size()));
+                if ( inserted.second ) positions.push_back(this->vertices[i].position);
+                vertexIndices[i] = inserted.first->second;
+            }
+
+            std::vector<unsigned int> indices(this->faces.size() * TRIANGLE_EDGE_COUNT);
+            for ( std::size_t i = 0; i < indices.size(); i++ ) indices[i] = vertexIndices[this->faces[i / TRIANGLE_EDGE_COUNT].indices[i % TRIANGLE_EDGE_COUNT]];
+
+            std::vector<Vector3f> normals;
+            if ( !CalculateNormals(indices, positions, normals, this->normalWeighting) ) return false;
+            for ( std::size_t i = 0; i < this->vertices.size(); i++ ) this->vertices[i].normal = normals[vertexIndices[i]];
+        }
+
+        SortSubMeshesByMaterial(this->faces, this->subMeshes);
+        CalculateSubMeshBounds(this->faces, this->subMeshes);
+        CalculateTangents(this->vertices, this->faces);
+        Mesh_ExtendBounds(this->vertices.data(), this->vertices.size(), !this->bBounds, this->bounds);
+        this->bBounds = true;
+
+        MeshChunk chunk;
+        chunk.faceCount = static_cast<std::uint32_t>(this->faces.size());
+        chunk.subMeshes = this->subMeshes;
+
+        glGenBuffers(1, &chunk.vboVertex);
+        glBindBuffer(GL_ARRAY_BUFFER, chunk.vboVertex);
+        Mesh_BufferVertices(this->layout, this->vertices.data(), this->vertices.size());
+
+        glGenBuffers(1, &chunk.vboIndex);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, chunk.vboIndex);
+        Mesh_BufferIndices(this->layout, this->faces.data(), this->faces.size());
+        this->chunks.push_back(chunk);
+
+        //----------------------------------------------------------------------
+        // The next chunk continues the current object, group, and material.
+        //----------------------------------------------------------------------
+        this->vertices.clear();
+        this->faces.clear();
+        this->subMeshes.clear();
+        this->nodes.clear();
+        this->vertexPositions.clear();
+        this->faceCount = 0u;
+        this->bNewSubMesh = true;
+        return true;
+    }
+
+    /* Returns the number of faces of all chunks. */
+    std::size_t getFaceCount() const { return this->totalFaceCount; }
+
+    /* Returns the box of the vertices of all chunks and the sphere around it. */
+    bool getBounds(MeshBounds& bounds) const {
+        if ( !this->bBounds ) return false;
+        bounds = this->bounds;
+        Mesh_SetBoxSphere(bounds);
+        return true;
+    }
+
+protected:
+    const Mesh_SpillArray& spilledPositions;
+    const Mesh_SpillArray& spilledNormals;
+    const Mesh_SpillArray& spilledTextureCoords;
+    const VertexLayout& layout;
+    std::vector<MeshChunk>& chunks;
+
+    /* Vertex of every face node of the current chunk. */
+    std::unordered_map<Mesh_NodeKey, unsigned int, Mesh_NodeKeyHash> nodes;
+    std::vector<std::uint32_t> vertexPositions;
+
+    std::size_t memoryBudget;
+    std::size_t totalFaceCount;
+
+    /* Box of the vertices of the chunks uploaded so far. */
+    MeshBounds bounds;
+    bool bBounds;
+};
+
+bool Mesh::loadOutOfCore(const std::string& filename, std::size_t memoryBudget, bool bComputeNormals) {
+    this->reset();
+
+    //--------------------------------------------------------------------------
+    // The first pass spills the Obj vertex attributes into temporary files.
+    //--------------------------------------------------------------------------
+    std::filesystem::path spillPath = std::filesystem::temp_directory_path() / std::filesystem::path(filename).stem();
+    spillPath += "." + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+
+    Mesh_SpillArray positions, normals, textureCoords;
+    if ( !positions.create(spillPath.string() + ".v") || !normals.create(spillPath.string() + ".vn") || !textureCoords.create(spillPath.string() + ".vt") ) {
+        std::cerr << "[Mesh:loadOutOfCore] Error: Could not create the temporary files of: " << filename << std::endl;
+        return false;
+    }
+
+    Mesh_ObjSpillVisitor spillVisitor(positions, normals, textureCoords);
+    if ( !ParseObjFile(filename, spillVisitor) || !positions.map() || !normals.map() || !textureCoords.map() ) {
+        std::cerr << "[Mesh:loadOutOfCore] Error: Could not load Obj file: " << filename << std::endl;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // The second pass streams the faces into chunks that are uploaded as soon
+    // as they reach the memory budget. No CPU copy of the mesh is kept.
+    // Chunks are indexed with 32-bit indices in any vertex layout.
+    //--------------------------------------------------------------------------
+    std::vector<Vertex> vertices;
+    std::vector<TriangleFace> faces;
+    std::vector<SubMesh> subMeshes;
+    this->bufferLayout = Mesh_GetBufferLayout(this->vertexLayout, VERTEX_LAYOUT_SHORT_INDEX_LIMIT + 1u);
+    Mesh_ObjChunkVisitor visitor(this->name, vertices, faces, subMeshes, bComputeNormals, this->normalWeighting, positions, normals, textureCoords, this->bufferLayout, memoryBudget, this->chunks);
+    if ( !ParseObjFile(filename, visitor) || visitor.hasFailed() || !visitor.flush() ) {
+        std::cerr << "[Mesh:loadOutOfCore] Error: Could not load Obj file: " << filename << std::endl;
+        Mesh_DeleteChunks(this->chunks);
+        return false;
+    }
+
+    if ( !visitor.hasMesh() ) {
+        std::cerr << "[Mesh:loadOutOfCore] Error: Obj file: " << filename << " contains no meshes." << std::endl;
+        return false;
+    }
+
+    this->vertices.clear();
+    this->faces.clear();
+    this->subMeshes.clear();
+    this->faceCount = visitor.getFaceCount();
+    this->bBounds = visitor.getBounds(this->bounds);
+    this->loadMaterials(filename, visitor.getMaterialLibraries());
+    return true;
+}
+
+/* Reads element i of a glTF accessor into a vector of up to 4 components. */
+template <typename VectorType>
+void Gltf_ReadVector(const GltfAccessor& accessor, std::size_t i, VectorType& vector, unsigned int componentCount) {
+    for ( unsigned int c = 0; c < componentCount && c < accessor.componentCount; c++ )
+        vector[c] = accessor.getFloat(i, c);
+}
+
+bool Mesh::loadGltf(const std::string& filename, bool bComputeNormals) {
+    GltfFile file;
+    if ( !file.load(filename) ) {
+        std::cerr << "[Mesh:load] Error: Could not load glTF file: " << filename << std::endl;
+        return false;
+    }
+
+    if ( file.getPrimitiveCount() == 0 ) {
+        std::cerr << "[Mesh:load] Error: glTF file: " << filename << " contains no meshes." << std::endl;
+        return false;
+    }
+
+    this->vertices.clear();
+    this->faces.clear();
+    this->subMeshes.clear();
+    this->name = file.getPrimitive(0).name;
+
+    //--------------------------------------------------------------------------
+    // A single primitive with 32-bit indices, normals, and tangents is drawn
+    // with the index buffer mapped from the binary chunk; its faces are only
+    // validated and never copied.
+    //--------------------------------------------------------------------------
+    const GltfPrimitive& first = file.getPrimitive(0);
+    bool bMappedIndices = file.getPrimitiveCount() == 1 && !bComputeNormals && first.normals.isValid() && first.tangents.isValid() &&
+                          first.indices.isValid() && first.indices.componentType == GLTF_UNSIGNED_INT &&
+                          first.indices.stride == sizeof(std::uint32_t) && first.indices.count % TRIANGLE_EDGE_COUNT == 0;
+
+    //--------------------------------------------------------------------------
+    // The vertex attributes of every primitive are read with a single strided
+    // pass from the mapped binary chunk into the interleaved vertex layout
+    // expected by beginRender. Indices are offset by the first vertex of the
+    // primitive within the shared vertex buffer.
+    //--------------------------------------------------------------------------
+    std::vector<std::size_t> baseVertices(file.getPrimitiveCount() + 1);
+    for ( std::size_t p = 0; p < file.getPrimitiveCount(); p++ ) {
+        const GltfPrimitive& primitive = file.getPrimitive(p);
+        std::size_t baseVertex = this->vertices.size();
+        baseVertices[p] = baseVertex;
+
+        this->vertices.resize(baseVertex + primitive.positions.count);
+        for ( std::size_t i = 0; i < primitive.positions.count; i++ ) {
+            Vertex& vertex = this->vertices[baseVertex + i];
+            Gltf_ReadVector(primitive.positions, i, vertex.position, 3u);
+            if ( primitive.normals.isValid() ) Gltf_ReadVector(primitive.normals, i, vertex.normal, 3u);
+            if ( primitive.tangents.isValid() ) Gltf_ReadVector(primitive.tangents, i, vertex.tangent, 4u);
+            if ( primitive.textureCoords.isValid() ) Gltf_ReadVector(primitive.textureCoords, i, vertex.textureCoord, 2u);
+            if ( primitive.colors.isValid() ) Gltf_ReadVector(primitive.colors, i, vertex.color, 3u);
+            else vertex.color = Color3f(0.0f, 0.0f, 0.0f);
+        }
+
+        std::size_t indexCount = primitive.indices.isValid() ? primitive.indices.count : primitive.positions.count;
+        SubMesh subMesh;
+        subMesh.name = primitive.name;
+        subMesh.material = primitive.material;
+        subMesh.faceOffset = static_cast<std::uint32_t>(this->faces.size());
+        subMesh.faceCount = static_cast<std::uint32_t>(indexCount / TRIANGLE_EDGE_COUNT);
+        subMesh.minIndex = (subMesh.faceCount > 0) ? ~0u : 0u;
+        subMesh.maxIndex = 0u;
+        subMesh.materialIndex = SUBMESH_NO_MATERIAL;
+        this->subMeshes.push_back(subMesh);
+
+        TriangleFace mappedFace;
+        if ( !bMappedIndices ) this->faces.resize(this->faces.size() + subMesh.faceCount);
+        for ( std::size_t f = 0; f < subMesh.faceCount; f++ ) {
+            TriangleFace& face = bMappedIndices ? mappedFace : this->faces[subMesh.faceOffset + f];
+            for ( unsigned int e = 0; e < TRIANGLE_EDGE_COUNT; e++ ) {
+                std::size_t index = f * TRIANGLE_EDGE_COUNT + e;
+                if ( primitive.indices.isValid() ) index = primitive.indices.getIndex(index, 0);
+                if ( index >= primitive.positions.count ) {
+                    std::cerr << "[Mesh:load] Error: Face references an undefined vertex in: " << filename << std::endl;
+                    this->vertices.clear();
+                    this->faces.clear();
+                    this->subMeshes.clear();
+                    return false;
+                }
+
+                face.indices[e] = static_cast<unsigned int>(baseVertex + index);
+                this->subMeshes.back().minIndex = std::min(this->subMeshes.back().minIndex, face.indices[e]);
+                this->subMeshes.back().maxIndex = std::max(this->subMeshes.back().maxIndex, face.indices[e]);
+            }
+        }
+    }
+    baseVertices.back() = this->vertices.size();
+
+    //--------------------------------------------------------------------------
+    // Normals and tangents are only computed for the primitives that do not
+    // provide them (normals of all primitives if bComputeNormals is set).
+    //--------------------------------------------------------------------------
+    bool bComputeTangents = false;
+    for ( std::size_t p = 0; p < file.getPrimitiveCount(); p++ ) {
+        const GltfPrimitive& primitive = file.getPrimitive(p);
+        if ( !primitive.tangents.isValid() ) bComputeTangents = true;
+        if ( primitive.normals.isValid() && !bComputeNormals ) continue;
+
+        std::size_t baseVertex = baseVertices[p];
+        std::vector<Vector3f> positions(primitive.positions.count);
+        for ( std::size_t i = 0; i < positions.size(); i++ )
+            positions[i] = this->vertices[baseVertex + i].position;
+
+        const SubMesh& subMesh = this->subMeshes[p];
+        std::vector<unsigned int> indices(subMesh.faceCount * TRIANGLE_EDGE_COUNT);
+        for ( std::size_t i = 0; i < indices.size(); i++ )
+            indices[i] = static_cast<unsigned int>(this->faces[subMesh.faceOffset + i / TRIANGLE_EDGE_COUNT].indices[i % TRIANGLE_EDGE_COUNT] - baseVertex);
+
+        std::vector<Vector3f> normals;
+        if ( indices.size() == 0 || !CalculateNormals(indices, positions, normals, this->normalWeighting) ) continue;
+        for ( std::size_t i = 0; i < normals.size(); i++ )
+            this->vertices[baseVertex + i].normal = normals[i];
+    }
+
+    if ( bComputeTangents ) {
+        std::vector<Vector4f> tangents(this->vertices.size());
+        for ( std::size_t i = 0; i < this->vertices.size(); i++ ) tangents[i] = this->vertices[i].tangent;
+        CalculateTangents(this->vertices, this->faces);
+
+        for ( std::size_t p = 0; p < file.getPrimitiveCount(); p++ ) {
+            if ( !file.getPrimitive(p).tangents.isValid() ) continue;
+            for ( std::size_t i = baseVertices[p]; i < baseVertices[p + 1]; i++ ) this->vertices[i].tangent = tangents[i];
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    // The base color factor of a glTF material is used as its diffuse color.
+    //--------------------------------------------------------------------------
+    this->materials.clear();
+    const std::vector<GltfMaterial>& gltfMaterials = file.getMaterials();
+    for ( std::size_t i = 0; i < gltfMaterials.size(); i++ ) {
+        MeshMaterial material;
+        material.name = gltfMaterials[i].name;
+        material.diffuse = Color3f(gltfMaterials[i].baseColor[0], gltfMaterials[i].baseColor[1], gltfMaterials[i].baseColor[2]);
+        material.specular = Color3f(0.2f, 0.2f, 0.2f);
+        material.shininess = 10.0f;
+        this->materials.push_back(material);
+    }
+
+    if ( !bMappedIndices ) {
+        SortSubMeshesByMaterial(this->faces, this->subMeshes);
+        Mesh_OptimizeFaceOrder(this->vertices, this->faces, this->subMeshes, this->bOptimizeFaceOrder, this->optimizationStatistics);
+    }
+
+    for ( std::size_t i = 0; i < this->subMeshes.size(); i++ ) {
+        for ( std::size_t m = 0; m < this->materials.size(); m++ ) {
+            if ( this->materials[m].name != this->subMeshes[i].material ) continue;
+            this->subMeshes[i].materialIndex = static_cast<std::uint32_t>(m);
+            break;
+        }
+    }
+
+    if ( !bMappedIndices ) {
+        Mesh_BuildClusters(this->vertices, this->faces, this->subMeshes, this->bGenerateClusters, this->clusters);
+        Mesh_BuildLods(this->vertices, this->faces, this->subMeshes, this->bGenerateLods, this->lodChain);
+    }
+
+    //--------------------------------------------------------------------------
+    // Mapped faces are drawn in the order of the file, which is usually
+    // optimized by the exporter already.
+    //--------------------------------------------------------------------------
+    if ( bMappedIndices ) {
+        const TriangleFace* mappedFaces = reinterpret_cast<const TriangleFace*>(first.indices.data);
+        std::size_t mappedFaceCount = first.indices.count / TRIANGLE_EDGE_COUNT;
+        this->optimizationStatistics.original = AnalyzeVertexCache(mappedFaces, mappedFaceCount, this->vertices.size());
+        this->optimizationStatistics.optimized = this->optimizationStatistics.original;
+        return this->constructOnGPU(this->vertices.data(), this->vertices.size(), mappedFaces, mappedFaceCount);
+    }
+
+    return this->constructOnGPU();
+}
+
+/* 
+ * Replaces the sub-meshes of a mesh with a single sub-mesh, named after the
+ * file, that covers all of its faces.
+ */
+void Mesh_SetSingleSubMesh(const std::string& filename, const std::vector<TriangleFace>& faces, std::vector<SubMesh>& subMeshes) {
+    SubMesh subMesh;
+    subMesh.name = std::filesystem::path(filename).stem().string();
+    subMesh.faceOffset = 0u;
+    subMesh.faceCount = static_cast<std::uint32_t>(faces.size());
+    subMesh.materialIndex = SUBMESH_NO_MATERIAL;
+
+    subMeshes.clear();
+    subMeshes.push_back(subMesh);
+    CalculateSubMeshBounds(faces, subMeshes);
+}
+
+/* Computes the normals of indexed vertices (see CalculateNormals). */
+bool Mesh_CalculateVertexNormals(std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces, MeshNormalWeighting weighting) {
+    std::vector<Vector3f> positions(vertices.size());
+    for ( std::size_t i = 0; i < vertices.size(); i++ ) positions[i] = vertices[i].position;
+
+    std::vector<unsigned int> indices(faces.size() * TRIANGLE_EDGE_COUNT);
+    for ( std::size_t i = 0; i < indices.size(); i++ ) indices[i] = faces[i / TRIANGLE_EDGE_COUNT].indices[i % TRIANGLE_EDGE_COUNT];
+
+    std::vector<Vector3f> normals;
+    if ( !CalculateNormals(indices, positions, normals, weighting) ) return false;
+    for ( std::size_t i = 0; i < vertices.size(); i++ ) vertices[i].normal = normals[i];
+    return true;
+}
+
+bool Mesh::loadPly(const std::string& filename, bool bComputeNormals) {
+    unsigned int attributes = 0u;
+    if ( !LoadPlyMesh(filename, this->vertices, this->faces, attributes) ) {
+        std::cerr << "[Mesh:load] Error: Could not load Ply file: " << filename << std::endl;
+        return false;
+    }
+
+    if ( this->faces.size() == 0 ) {
+        std::cerr << "[Mesh:load] Error: Ply file: " << filename << " contains no faces." << std::endl;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // Tangents require texture coordinates; without them they stay zero.
+    //--------------------------------------------------------------------------
+    if ( bComputeNormals || (attributes & PLY_NORMALS) == 0 ) Mesh_CalculateVertexNormals(this->vertices, this->faces, this->normalWeighting);
+    if ( (attributes & PLY_TEXTURE_COORDS) != 0 ) CalculateTangents(this->vertices, this->faces);
+
+    this->name = std::filesystem::path(filename).stem().string();
+    this->materials.clear();
+    Mesh_SetSingleSubMesh(filename, this->faces, this->subMeshes);
+    Mesh_OptimizeFaceOrder(this->vertices, this->faces, this->subMeshes, this->bOptimizeFaceOrder, this->optimizationStatistics);
+    Mesh_BuildClusters(this->vertices, this->faces, this->subMeshes, this->bGenerateClusters, this->clusters);
+    Mesh_BuildLods(this->vertices, this->faces, this->subMeshes, this->bGenerateLods, this->lodChain);
+    return this->constructOnGPU();
+}
+
+bool Mesh::loadStl(const std::string& filename) {
+    std::vector<Vector3f> positions;
+    if ( !LoadStlMesh(filename, positions) ) {
+        std::cerr << "[Mesh:load] Error: Could not load Stl file: " << filename << std::endl;
+        return false;
+    }
+
+    if ( positions.size() == 0 ) {
+        std::cerr << "[Mesh:load] Error: Stl file: " << filename << " contains no faces." << std::endl;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // Weld the triangle soup of the Stl file into shared vertices. The weld
+    // tolerance is relative to the size of the mesh.
+    //--------------------------------------------------------------------------
+    Vector3f minimum = positions[0];
+    Vector3f maximum = positions[0];
+    for ( std::size_t i = 1; i < positions.size(); i++ ) {
+        for ( unsigned int c = 0; c < 3; c++ ) {
+            minimum[c] = std::min(minimum[c], positions[i][c]);
+            maximum[c] = std::max(maximum[c], positions[i][c]);
+        }
+    }
+
+    std::vector<Vector3f> welded;
+    std::vector<unsigned int> indices;
+    WeldVertices(positions, (maximum - minimum).length() * STL_WELD_TOLERANCE, welded, indices);
 
-	for ( std::size_t i = 0; i < vertices.size(); i++ ) {
-		const Vector3f& n = vertices[i].normal;
-		const Vector3f& t = tan1[i];
+    this->vertices.resize(welded.size());
+    for ( std::size_t i = 0; i < welded.size(); i++ ) {
+        this->vertices[i].position = welded[i];
+        this->vertices[i].tangent = Vector4f(0.0f, 0.0f, 0.0f, 0.0f);
+        this->vertices[i].textureCoord = Vector3f(0.0f, 0.0f, 0.0f);
+        this->vertices[i].color = Color3f(0.0f, 0.0f, 0.0f);
+    }
 
-		vertices[i].tangent = Vector4f((t - n * (float)Vector3f::Dot(n, t)).normalized());
-		if ( vertices[i].tangent.isEquivalent(Vector3f::Zero(), 0.01f) ) {
-			if ( n.isEquivalent(Vector3f::UnitY(), 1.0e-4f) )
-				vertices[i].tangent = Vector3f::UnitX();
-			if ( n.isEquivalent(Vector3f::UnitNY(), 1.0e-4f) )
-				vertices[i].tangent = Vector3f::UnitX();
-		}
+    this->faces.resize(indices.size() / TRIANGLE_EDGE_COUNT);
+    for ( std::size_t i = 0; i < indices.size(); i++ )
+        this->faces[i / TRIANGLE_EDGE_COUNT].indices[i % TRIANGLE_EDGE_COUNT] = indices[i];
 
-		if ( Vector3f::Dot(Vector3f::Cross(n, t), tan2[i]) < 0.0f ) vertices[i].tangent.w() = -1.0f;
-		else vertices[i].tangent.w() = 1.0f;
-	}
+    Mesh_CalculateVertexNormals(this->vertices, this->faces, this->normalWeighting);
 
-	return false;
+    this->name = std::filesystem::path(filename).stem().string();
+    this->materials.clear();
+    Mesh_SetSingleSubMesh(filename, this->faces, this->subMeshes);
+    Mesh_OptimizeFaceOrder(this->vertices, this->faces, this->subMeshes, this->bOptimizeFaceOrder, this->optimizationStatistics);
+    Mesh_BuildClusters(this->vertices, this->faces, this->subMeshes, this->bGenerateClusters, this->clusters);
+    Mesh_BuildLods(this->vertices, this->faces, this->subMeshes, this->bGenerateLods, this->lodChain);
+    return this->constructOnGPU();
 }
 
-bool CalculateNormals(
-    const std::vector<unsigned int>& indices,
-    const std::vector<Vector3f>& vertices,
-    std::vector<Vector3f>& normals
-    ) {
-
-    if ( vertices.size() == 0 ) {
-		std::cerr << "[Mesh:calculateNormals] Error: Vertex array of length 0." << std::endl;
-		return false;
-	}
-
-	if ( indices.size() == 0 ) {
-		std::cerr << "[Mesh:calculateNormals] Error: Face count = 0." << std::endl;
-		return false;
-	}
-
-	std::vector<unsigned int> normalCounts = std::vector<unsigned int>(vertices.size());
-    normals = std::vector<Vector3f>(vertices.size());
-	std::size_t triangleCount = indices.size() / TRIANGLE_EDGE_COUNT;
+/* 
+ * Loads the texture map of a material. Textures shared by several materials
+ * are only loaded once.
+ */
+std::shared_ptr<Texture> Mesh_LoadMaterialTexture(std::map<std::string, std::shared_ptr<Texture>>& textures, const std::string& filename) {
+    if ( filename.length() == 0 ) return nullptr;
 
-	std::size_t i0 = 0, i1 = 0, i2 = 0;
-	Vector3f p0, p1, p2, a, b, faceNormal;
-    unsigned int index = 0;
-	for ( std::size_t i = 0; i < triangleCount; i++) {
-		i0 = indices[index];
-        i1 = indices[index + 1];
-        i2 = indices[index + 2];
+    std::map<std::string, std::shared_ptr<Texture>>::const_iterator it = textures.find(filename);
+    if ( it != textures.end() ) return it->second;
 
-		p0 = vertices[i0];
-		p1 = vertices[i1];
-		p2 = vertices[i2];
+    std::shared_ptr<Texture> texture = std::make_shared<Texture>();
+    if ( !texture->load(filename) ) {
+        std::cerr << "[Mesh:loadMaterials] Warning: Could not load texture map: " << filename << std::endl;
+        texture = nullptr;
+    }
 
-		a = p1 - p0;
-		b = p2 - p0;
+    textures[filename] = texture;
+    return texture;
+}
 
-		faceNormal = a.cross(b);
-		faceNormal.normalize();
+bool Mesh::loadMaterials(const std::string& filename, const std::vector<std::string>& materialLibraries) {
+    this->materials.clear();
+    this->materialLibraries = materialLibraries;
 
-        normals[i0] += faceNormal;
-        normals[i1] += faceNormal;
-        normals[i2] += faceNormal;
+    //--------------------------------------------------------------------------
+    // Textures of a staging mesh are loaded when it is adopted (see adopt).
+    //--------------------------------------------------------------------------
+    if ( this->bDeferUpload ) return true;
 
-		normalCounts[i0] += 1;
-		normalCounts[i1] += 1;
-		normalCounts[i2] += 1;
+    //--------------------------------------------------------------------------
+    // Material libraries are resolved against the directory of the Obj file.
+    //--------------------------------------------------------------------------
+    std::vector<ObjMaterial> objMaterials;
+    std::filesystem::path directory = std::filesystem::path(filename).parent_path();
+    for ( std::size_t i = 0; i < materialLibraries.size(); i++ ) {
+        std::filesystem::path path(materialLibraries[i]);
+        if ( path.is_relative() ) path = directory / path;
+        if ( !LoadObjMaterialLibrary(path.string(), objMaterials) )
+            std::cerr << "[Mesh:loadMaterials] Warning: Could not load material library: " << path.string() << std::endl;
+    }
 
-        index += TRIANGLE_EDGE_COUNT;
-	}
+    std::map<std::string, std::shared_ptr<Texture>> textures;
+    std::map<std::string, std::uint32_t> materialIndices;
+    for ( std::size_t i = 0; i < objMaterials.size(); i++ ) {
+        const ObjMaterial& objMaterial = objMaterials[i];
+        if ( !materialIndices.insert(std::make_pair(objMaterial.name, static_cast<std::uint32_t>(this->materials.size()))).second ) continue;
+
+        MeshMaterial material;
+        material.name = objMaterial.name;
+        material.diffuse = Color3f(objMaterial.diffuse.x(), objMaterial.diffuse.y(), objMaterial.diffuse.z());
+        material.specular = Color3f(objMaterial.specular.x(), objMaterial.specular.y(), objMaterial.specular.z());
+        material.shininess = objMaterial.shininess;
+        material.diffuseTexture = Mesh_LoadMaterialTexture(textures, objMaterial.diffuseMap);
+        material.normalTexture = Mesh_LoadMaterialTexture(textures, objMaterial.normalMap);
+        material.specularTexture = Mesh_LoadMaterialTexture(textures, objMaterial.specularMap);
+        this->materials.push_back(material);
+    }
 
-	for ( unsigned int i = 0; i < vertices.size(); i++ ) {
-        normals[i] = normals[i] / static_cast<float>(normalCounts[i]);
-        normals[i].normalize();
-	}
+    //--------------------------------------------------------------------------
+    // Sub-meshes (and those of out-of-core chunks and levels of detail) refer
+    // to their material by name within the Obj file.
+    //--------------------------------------------------------------------------
+    std::vector<std::vector<SubMesh>*> subMeshLists(1u, &this->subMeshes);
+    for ( std::size_t c = 0; c < this->chunks.size(); c++ ) subMeshLists.push_back(&this->chunks[c].subMeshes);
+    for ( std::size_t level = 0; level < this->lodChain.levels.size(); level++ ) subMeshLists.push_back(&this->lodChain.levels[level].subMeshes);
+
+    for ( std::size_t c = 0; c < subMeshLists.size(); c++ ) {
+        std::vector<SubMesh>& subMeshes = *subMeshLists[c];
+        for ( std::size_t i = 0; i < subMeshes.size(); i++ ) {
+            std::map<std::string, std::uint32_t>::const_iterator it = materialIndices.find(subMeshes[i].material);
+            subMeshes[i].materialIndex = (it != materialIndices.end()) ? it->second : SUBMESH_NO_MATERIAL;
+        }
+    }
 
-	return true;
+    return true;
 }
 
-bool Decompress(
-        const std::vector<unsigned int>& indices,
-        const std::vector<unsigned int>& normalIndices,
-        const std::vector<unsigned int>& textureIndices,
-        const std::vector<Vector3f>& vertices, 
-        const std::vector<Vector3f>& normals, 
-        const std::vector<Vector3f>& textureCoords,
-        const std::vector<Vector4f>& tangents,
-        std::vector<Vertex>& outVertices,
-        std::vector<TriangleFace>& outFaces
-    ) {
+bool Mesh::createPlane(float width, float depth, unsigned int columns, unsigned int rows) {
+    std::vector<Vertex> vertices;
+    std::vector<TriangleFace> faces;
+    if ( !GeneratePlane(width, depth, columns, rows, vertices, faces) ) return false;
+    return this->constructPrimitive("plane", vertices, faces);
+}
 
-    VertexSet vertexSet;
-    unsigned int triangleCount = static_cast<unsigned int>(indices.size()) / TRIANGLE_EDGE_COUNT;
+bool Mesh::createSphere(float radius, unsigned int slices, unsigned int stacks) {
+    std::vector<Vertex> vertices;
+    std::vector<TriangleFace> faces;
+    if ( !GenerateSphere(radius, slices, stacks, vertices, faces) ) return false;
+    return this->constructPrimitive("sphere", vertices, faces);
+}
 
-    unsigned int index = 0;
-    unsigned int freeIndex = 0;
-    Vector3f v1, v2, v3;
-    Vector3f n1, n2, n3;
-    Vector3f t1, t2, t3;
-    TriangleFace face;
-    Vertex v;
+bool Mesh::createCube(float size, unsigned int divisions, bool bInward) {
+    std::vector<Vertex> vertices;
+    std::vector<TriangleFace> faces;
+    if ( !GenerateCube(size, divisions, bInward, vertices, faces) ) return false;
+    return this->constructPrimitive(bInward ? "skybox" : "cube", vertices, faces);
+}
 
-    for ( unsigned int i = 0; i < triangleCount; i++ ) {
+bool Mesh::constructPrimitive(const std::string& name, std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces) {
+    this->reset();
 
-        unsigned int vIndex, nIndex, tIndex;
-        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
-            vIndex = indices[index + j];
-            nIndex = normalIndices[index + j];
-            tIndex = textureIndices[index + j];
+    //--------------------------------------------------------------------------
+    // Generated normals and tangents are exact, so only the face order, the
+    // clusters, and the levels of detail are computed as for a loaded mesh.
+    //--------------------------------------------------------------------------
+    this->name = name;
+    this->vertices.swap(vertices);
+    this->faces.swap(faces);
+    Mesh_SetSingleSubMesh(name, this->faces, this->subMeshes);
+    Mesh_OptimizeFaceOrder(this->vertices, this->faces, this->subMeshes, this->bOptimizeFaceOrder, this->optimizationStatistics);
+    Mesh_BuildClusters(this->vertices, this->faces, this->subMeshes, this->bGenerateClusters, this->clusters);
+    Mesh_BuildLods(this->vertices, this->faces, this->subMeshes, this->bGenerateLods, this->lodChain);
+    return this->constructOnGPU();
+}
 
-            v.position = vertices[vIndex];
-            v.normal = normals[nIndex];
-            v.textureCoord = textureCoords[tIndex];
+bool Mesh::loadLazy(const std::string& filename, MeshResidencyManager& manager, bool bComputeNormals) {
+    std::error_code error;
+    if ( !std::filesystem::is_regular_file(filename, error) ) {
+        std::cerr << "[Mesh:loadLazy] Error: Could not find mesh file: " << filename << std::endl;
+        return false;
+    }
 
-            VertexSet::const_iterator it = vertexSet.find(v);
+    if ( this->residencyManager != nullptr ) this->residencyManager->remove(this);
+    this->release();
+    this->sourceFilename = filename;
+    this->bSourceComputeNormals = bComputeNormals;
+    this->name = std::filesystem::path(filename).stem().string();
 
-            if ( it != vertexSet.end() ) {
-                face.indices[j] = vertexSet.find(v)->second;
-            }
-            else {
-                vertexSet.insert(std::make_pair(v, freeIndex));
-                face.indices[j] = freeIndex;
-                outVertices.push_back(v);
-                freeIndex++;
-            }
+    //--------------------------------------------------------------------------
+    // Only the header of a compressed mesh or of a valid cache is read here;
+    // the vertices and faces are not touched until the mesh is loaded.
+    //--------------------------------------------------------------------------
+    this->info.vertexCount = 0u;
+    this->info.faceCount = 0u;
+    this->info.boundsMinimum = Vector3f(0.0f, 0.0f, 0.0f);
+    this->info.boundsMaximum = Vector3f(0.0f, 0.0f, 0.0f);
+    this->info.bKnown = false;
+
+    std::string extension = std::filesystem::path(filename).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if ( extension == COMPRESSED_MESH_EXTENSION ) {
+        CompressedMesh compressed;
+        if ( compressed.open(filename) ) {
+            this->name = compressed.getName();
+            this->info.vertexCount = compressed.getVertexCount();
+            this->info.faceCount = compressed.getFaceCount();
+            compressed.getBounds(this->info.boundsMinimum, this->info.boundsMaximum);
+            this->info.bKnown = true;
+        }
+    }
+    else if ( extension != GLTF_BINARY_EXTENSION && extension != PLY_EXTENSION && extension != STL_EXTENSION ) {
+        MeshCache cache;
+        if ( cache.open(filename, bComputeNormals, this->normalWeighting, this->bOptimizeFaceOrder, this->bGenerateLods, this->bGenerateClusters) ) {
+            this->name = cache.getName();
+            this->info.vertexCount = cache.getVertexCount();
+            this->info.faceCount = cache.getFaceCount();
+            cache.getBounds(this->info.boundsMinimum, this->info.boundsMaximum);
+            this->info.bKnown = true;
         }
-
-        outFaces.push_back(face);
-        index += TRIANGLE_EDGE_COUNT;
     }
 
+    manager.add(this);
     return true;
 }
 
-bool Mesh::load(const std::string& filename, bool bComputeNormals) {
-	std::shared_ptr<ObjMesh> mesh = nullptr;
+void Mesh::prefetch() const {
+    if ( this->residencyManager != nullptr ) this->residencyManager->request(this);
+}
 
-	if ( !LoadObjMesh(filename, mesh) ) return false;
+bool Mesh::makeResident() {
+    if ( this->residencyManager == nullptr ) return this->isResident();
+    return this->residencyManager->makeResident(this);
+}
 
-	if ( mesh->faces.size() > 0 ) {
-		if ( mesh->faces[0].type != TRIANGLE ) {
-			std::cerr << "[Mesh:load] Error: Only triangle-face Obj files supported." << std::endl;
-			return false;
-		}
-	}
+bool Mesh::isResident() const {
+    return this->vboVertex != 0u || this->chunks.size() != 0;
+}
 
-	this->name = mesh->name;
-	std::vector<Vector3f> normals;
-	std::vector<Vector4f> tangents;
-	std::vector<unsigned int> indices;
-	std::vector<unsigned int> textureIndices;
-	std::vector<unsigned int> normalIndices;
+std::shared_ptr<Mesh> Mesh::createStaging() const {
+    std::shared_ptr<Mesh> staging = std::make_shared<Mesh>();
+    staging->sourceFilename = this->sourceFilename;
+    staging->normalWeighting = this->normalWeighting;
+    staging->bOptimizeFaceOrder = this->bOptimizeFaceOrder;
+    staging->bGenerateLods = this->bGenerateLods;
+    staging->bGenerateClusters = this->bGenerateClusters;
+    staging->bBuildBvh = this->bBuildBvh;
+    staging->bBuildAdjacency = this->bBuildAdjacency;
+    staging->vertexLayout = this->vertexLayout;
+    staging->bSourceComputeNormals = this->bSourceComputeNormals;
+    staging->bDeferUpload = true;
+    return staging;
+}
 
-	//--------------------------------------------------------------------------
-	// Copy the face indices from the *.obj file to this mesh.
-	//--------------------------------------------------------------------------
-	indices.resize(mesh->faces.size() * TRIANGLE_EDGE_COUNT);
-	normalIndices.resize(mesh->faces.size() * TRIANGLE_EDGE_COUNT);
-	textureIndices.resize(mesh->faces.size() * TRIANGLE_EDGE_COUNT);
-	unsigned int index = 0;
-	for ( unsigned int i = 0; i < mesh->faces.size(); i++ ) {
-		indices[index] = static_cast<unsigned int>(mesh->faces[i].vertexIndices[A]);
-		indices[index + 1] = static_cast<unsigned int>(mesh->faces[i].vertexIndices[B]);
-		indices[index + 2] = static_cast<unsigned int>(mesh->faces[i].vertexIndices[C]);
-
-		normalIndices[index] = static_cast<unsigned int>(mesh->faces[i].normalIndices[A]);
-		normalIndices[index + 1] = static_cast<unsigned int>(mesh->faces[i].normalIndices[B]);
-		normalIndices[index + 2] = static_cast<unsigned int>(mesh->faces[i].normalIndices[C]);
-
-		textureIndices[index] = static_cast<unsigned int>(mesh->faces[i].textureIndices[A]);
-		textureIndices[index + 1] = static_cast<unsigned int>(mesh->faces[i].textureIndices[B]);
-		textureIndices[index + 2] = static_cast<unsigned int>(mesh->faces[i].textureIndices[C]);
-
-		index += TRIANGLE_EDGE_COUNT;
-	}
+bool Mesh::loadStaging() {
+    return this->load(this->sourceFilename, this->bSourceComputeNormals);
+}
 
-	//--------------------------------------------------------------------------
-	// Calcualte the vertex normals, tangents, and face normals.
-	//--------------------------------------------------------------------------
-	if ( bComputeNormals == false ) {
-		normals.resize(mesh->normals.size());
-		for ( unsigned int i = 0; i < mesh->normals.size(); i++ )
-			normals[i] = mesh->normals[i];
-	}
-	else CalculateNormals(indices, mesh->vertices, normals);
-	
-	Decompress(indices, normalIndices, textureIndices, mesh->vertices, normals, mesh->textureCoordinates, tangents, this->vertices, this->faces);
-	CalculateTangents(this->vertices, this->faces);
+std::size_t Mesh::adopt(Mesh& staging) {
+    this->release();
+    this->name = staging.name;
+    this->vertices.swap(staging.vertices);
+    this->faces.swap(staging.faces);
+    this->subMeshes.swap(staging.subMeshes);
+    this->lodChain = staging.lodChain;
+    this->clusters.swap(staging.clusters);
+    this->bvh = std::move(staging.bvh);
+    this->connectivity = std::move(staging.connectivity);
+    this->materials.swap(staging.materials);
+    this->optimizationStatistics = staging.optimizationStatistics;
 
-	//--------------------------------------------------------------------------
-	// Set all colors to black since they are not provided by an OBJ file.
-	//--------------------------------------------------------------------------
-	for ( unsigned int i = 0; i < this->vertices.size(); i++ )
-		this->vertices[i].color = Color3f(0.0f, 0.0f, 0.0f);
+    //--------------------------------------------------------------------------
+    // Textures of the Obj materials are loaded here since loader threads
+    // cannot use OpenGL.
+    //--------------------------------------------------------------------------
+    this->constructOnGPU();
+    std::vector<std::string> materialLibraries = staging.materialLibraries;
+    if ( materialLibraries.size() != 0 ) this->loadMaterials(this->sourceFilename, materialLibraries);
 
+    this->info.vertexCount = this->vertices.size();
+    this->info.faceCount = this->faces.size();
+    this->info.bKnown = true;
+    this->info.boundsMinimum = this->bBounds ? this->bounds.boundsMinimum : Vector3f(0.0f, 0.0f, 0.0f);
+    this->info.boundsMaximum = this->bBounds ? this->bounds.boundsMaximum : Vector3f(0.0f, 0.0f, 0.0f);
 
-	this->constructOnGPU();
-	return true;
+    //--------------------------------------------------------------------------
+    // A lazy mesh is drawn from its buffers only; it is loaded again from its
+    // file if it is evicted.
+    //--------------------------------------------------------------------------
+    std::size_t size = this->vertices.size() * GetVertexSize(this->bufferLayout) + this->faces.size() * TRIANGLE_EDGE_COUNT * Mesh_GetIndexSize(this->bufferLayout);
+    if ( this->vboAdjacency != 0u ) size += this->faces.size() * MESH_ADJACENCY_FACE_INDEX_COUNT * Mesh_GetIndexSize(this->bufferLayout);
+    std::vector<Vertex>().swap(this->vertices);
+    std::vector<TriangleFace>().swap(this->faces);
+    return size;
+}
+
+void Mesh::release() {
+    if ( this->vboVertex != 0u ) glDeleteBuffers(1, &this->vboVertex);
+    if ( this->vboIndex != 0u ) glDeleteBuffers(1, &this->vboIndex);
+    if ( this->vboAdjacency != 0u ) glDeleteBuffers(1, &this->vboAdjacency);
+    Mesh_DeleteChunks(this->chunks);
+    this->vboVertex = 0u;
+    this->vboIndex = 0u;
+    this->vboAdjacency = 0u;
+    this->faceCount = 0u;
+    this->subMeshes.clear();
+    this->materials.clear();
+    this->materialLibraries.clear();
+    this->lodChain.levels.clear();
+    this->lodLevel = 0u;
+    this->clusters.clear();
+    this->visibleSubMeshes.clear();
+    this->bClusterCulling = false;
+    this->bvh.clear();
+    this->connectivity.clear();
+    this->bBounds = false;
+}
+
+void Mesh::reset() {
+    if ( this->residencyManager != nullptr ) this->residencyManager->remove(this);
+    this->release();
+    this->vertices.clear();
+    this->faces.clear();
+    this->optimizationStatistics = MeshOptimizationStatistics();
 }
 
 bool Mesh::loadShader(const std::string& vertexFilename, const std::string& fragmentFilename) {
@@ -332,57 +2061,185 @@ bool Mesh::loadShader(const std::string& vertexFilename, const std::string& frag
     return true;
 }
 
-void Mesh::beginRender() const {
-	if ( nullptr != this->shader ) this->shader->enable();
+/* OpenGL format of an attribute of a vertex layout (zero components if not stored). */
+struct Mesh_AttributeFormat {
+    GLint componentCount;
+    GLenum type;
+    GLboolean bNormalized;
+};
+
+Mesh_AttributeFormat Mesh_GetAttributeFormat(const VertexLayout& layout, VertexAttribute attribute) {
+    switch ( attribute ) {
+        case VERTEX_POSITION: return { 3, GL_FLOAT, GL_FALSE };
+        case VERTEX_NORMAL:
+            if ( layout.directionFormat == VERTEX_DIRECTION_INT_2_10_10_10 ) return { 4, GL_INT_2_10_10_10_REV, GL_TRUE };
+            if ( layout.directionFormat == VERTEX_DIRECTION_OCTAHEDRAL ) return { 2, GL_SHORT, GL_TRUE };
+            return { 3, GL_FLOAT, GL_FALSE };
+        case VERTEX_TANGENT:
+            if ( layout.directionFormat == VERTEX_DIRECTION_INT_2_10_10_10 ) return { 4, GL_INT_2_10_10_10_REV, GL_TRUE };
+            if ( layout.directionFormat == VERTEX_DIRECTION_OCTAHEDRAL ) return { 4, GL_SHORT, GL_TRUE };
+            return { 4, GL_FLOAT, GL_FALSE };
+        case VERTEX_TEXTURE_COORD:
+            if ( layout.textureCoordFormat == VERTEX_TEXTURE_COORD_HALF ) return { 2, GL_HALF_FLOAT, GL_FALSE };
+            return { 3, GL_FLOAT, GL_FALSE };
+        case VERTEX_COLOR:
+            if ( layout.colorFormat == VERTEX_COLOR_UNORM8 ) return { 4, GL_UNSIGNED_BYTE, GL_TRUE };
+            if ( layout.colorFormat == VERTEX_COLOR_NONE ) return { 0, GL_FLOAT, GL_FALSE };
+            return { 3, GL_FLOAT, GL_FALSE };
+        default: return { 0, GL_FLOAT, GL_FALSE };
+    }
+}
 
-	glBindBuffer(GL_ARRAY_BUFFER, this->vboVertex);
+/* Binds a vertex and index buffer with the attributes of a vertex layout. */
+void Mesh_BindVertexBuffers(const VertexLayout& layout, unsigned int vboVertex, unsigned int vboIndex) {
+	glBindBuffer(GL_ARRAY_BUFFER, vboVertex);
 
 	//--------------------------------------------------------------------------
-	// Vertex position data is the first component in the vertex structure so
-	// it is loaded first (with a byte offset of 0).
+	// The position, normal, tangent, texture coordinate, and color follow each
+	// other within a vertex (see VertexLayout). In the default layout these
+	// are the members of the Vertex structure at byte offsets 0, 12, 24, 40,
+	// and 52. Attributes a layout does not store are disabled so the shader
+	// reads a constant (black for colors) instead.
 	//--------------------------------------------------------------------------
-	glEnableVertexAttribArray(POSITION_LOC);
-	glVertexAttribPointer(POSITION_LOC, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), BUFFER_OFFSET(0));
+	const unsigned int locations[VERTEX_ATTRIBUTE_COUNT] = { POSITION_LOC, NORMAL_LOC, TANGENT_LOC, TEXTURE_COORD_LOC, COLOR_LOC };
+	GLsizei stride = static_cast<GLsizei>(GetVertexSize(layout));
+	for ( int i = 0; i < VERTEX_ATTRIBUTE_COUNT; i++ ) {
+		VertexAttribute attribute = static_cast<VertexAttribute>(i);
+		Mesh_AttributeFormat format = Mesh_GetAttributeFormat(layout, attribute);
+		if ( format.componentCount == 0 ) {
+			glDisableVertexAttribArray(locations[i]);
+			glVertexAttrib4f(locations[i], 0.0f, 0.0f, 0.0f, 1.0f);
+			continue;
+		}
 
-	//--------------------------------------------------------------------------
-	// Vertex normals occupy the second element of the vertex and must be
-	// offset by 3 * sizeof(float) bytes due to the position taking the first
-	// 3 * 4 = 12 bytes of the structure.
-	//--------------------------------------------------------------------------
-	glEnableVertexAttribArray(NORMAL_LOC);
-	glVertexAttribPointer(NORMAL_LOC, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), BUFFER_OFFSET(3 * sizeof(float)));
+		glEnableVertexAttribArray(locations[i]);
+		glVertexAttribPointer(locations[i], format.componentCount, format.type, format.bNormalized, stride, BUFFER_OFFSET(GetVertexAttributeOffset(layout, attribute)));
+	}
 
-	//--------------------------------------------------------------------------
-	// Vertex tangents are offset by 6 * sizeof(float) due to the position
-	// and normal values.
-	//--------------------------------------------------------------------------
-	glEnableVertexAttribArray(TANGENT_LOC);
-	glVertexAttribPointer(TANGENT_LOC, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), BUFFER_OFFSET(6 * sizeof(float)));
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vboIndex);
+}
 
-	//--------------------------------------------------------------------------
-	// Vertex texture coordinate is offset by 10 * sizeof(float) due to the
-	// position, normal, and tangent.
-	//--------------------------------------------------------------------------
-	glEnableVertexAttribArray(TEXTURE_COORD_LOC);
-	glVertexAttribPointer(TEXTURE_COORD_LOC, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), BUFFER_OFFSET(10 * sizeof(float)));
+void Mesh::beginRender() const {
+    if ( this->residencyManager != nullptr ) this->residencyManager->request(this);
+	if ( nullptr != this->shader ) this->shader->enable();
 
-	//--------------------------------------------------------------------------
-	// Vertex color is offset by 13 * sizeof(float) due to the position,
-	// normal, tangent, and texture coordinate.
-	//--------------------------------------------------------------------------
-	glEnableVertexAttribArray(COLOR_LOC);
-	glVertexAttribPointer(COLOR_LOC, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), BUFFER_OFFSET(13 * sizeof(float)));
+    if ( !this->isResident() ) return;
+	if ( this->chunks.size() == 0 ) Mesh_BindVertexBuffers(this->bufferLayout, this->vboVertex, (this->vboAdjacency != 0u && !this->bDrawPatches) ? this->vboAdjacency : this->vboIndex);
+	else Mesh_BindVertexBuffers(this->bufferLayout, this->chunks[0].vboVertex, this->chunks[0].vboIndex);
+}
+
+/*
+ * Binds a texture map of a material to a texture unit and points the sampler
+ * of the given name at it. Shaders that do not declare the sampler (such as
+ * the numbered samplers of texture blending) keep their own textures, and
+ * false is returned.
+ */
+bool Mesh_RenderMaterialTexture(const Shader& shader, const std::shared_ptr<Texture>& texture, const std::string& name, unsigned int unit) {
+    if ( texture == nullptr ) return false;
 
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->vboIndex);
+    GLint location = glGetUniformLocation(shader.getProgramID(), name.c_str());
+    if ( location < 0 ) return false;
+
+    glActiveTextureARB(GL_TEXTURE0 + unit);
+    texture->render();
+    glUniform1i(location, static_cast<GLint>(unit));
+    return true;
+}
+
+/*
+ * Binds the texture maps of a material to the texture units of the shader
+ * (see Shader::enable) and uploads the material colors. Returns true if any
+ * texture of the shader was replaced.
+ */
+bool Mesh_RenderMaterial(const Shader& shader, const MeshMaterial& material) {
+    bool bReplaced = false;
+    if ( Mesh_RenderMaterialTexture(shader, material.diffuseTexture, DIFFUSE_TEXTURE, 0u) ) bReplaced = true;
+    if ( Mesh_RenderMaterialTexture(shader, material.normalTexture, NORMAL_TEXTURE, 1u) ) bReplaced = true;
+    if ( Mesh_RenderMaterialTexture(shader, material.specularTexture, SPECULAR_TEXTURE, 2u) ) bReplaced = true;
+
+    shader.uniformColor(MATERIAL_DIFFUSE, material.diffuse);
+    shader.uniformColor(MATERIAL_SPECULAR, material.specular);
+    shader.uniform1f(MATERIAL_SHININESS, material.shininess);
+    return bReplaced;
+}
+
+/* Returns the number of indices of a face drawn as primitives of the given mode. */
+std::size_t Mesh_GetFaceIndexCount(GLenum mode) {
+    return (mode == GL_TRIANGLES_ADJACENCY) ? MESH_ADJACENCY_FACE_INDEX_COUNT : static_cast<std::size_t>(TRIANGLE_EDGE_COUNT);
+}
+
+/*
+ * Draws sub-meshes from the currently bound buffers as primitives of the
+ * given mode (GL_TRIANGLES, GL_TRIANGLES_ADJACENCY, or GL_PATCHES). Adjacent
+ * sub-meshes of the same material are drawn as one range, so the material
+ * only changes once per range. Textures a material does not provide fall
+ * back to the textures of the shader, which are rebound if a previous
+ * material replaced them.
+ */
+void Mesh_DrawSubMeshes(GLenum mode, const std::vector<SubMesh>& subMeshes, const VertexLayout& layout, Shader* shader, const std::vector<MeshMaterial>& materials, std::uint32_t& currentMaterial, bool& bShaderTextures) {
+    GLenum indexType = layout.bShortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    std::size_t faceIndexCount = Mesh_GetFaceIndexCount(mode);
+    std::size_t faceSize = faceIndexCount * Mesh_GetIndexSize(layout);
+
+    std::size_t i = 0;
+    while ( i < subMeshes.size() ) {
+        const SubMesh& subMesh = subMeshes[i];
+        std::uint32_t faceCount = subMesh.faceCount;
+        std::uint32_t minIndex = subMesh.minIndex;
+        std::uint32_t maxIndex = subMesh.maxIndex;
+
+        for ( i++; i < subMeshes.size(); i++ ) {
+            const SubMesh& next = subMeshes[i];
+            if ( next.materialIndex != subMesh.materialIndex || next.faceOffset != subMesh.faceOffset + faceCount ) break;
+            faceCount += next.faceCount;
+            minIndex = std::min(minIndex, next.minIndex);
+            maxIndex = std::max(maxIndex, next.maxIndex);
+        }
+
+        if ( shader != nullptr && subMesh.materialIndex != currentMaterial ) {
+            if ( !bShaderTextures ) bShaderTextures = shader->enable();
+            if ( subMesh.materialIndex < materials.size() ) bShaderTextures = !Mesh_RenderMaterial(*shader, materials[subMesh.materialIndex]);
+            currentMaterial = subMesh.materialIndex;
+        }
+
+        glDrawRangeElements(mode, minIndex, maxIndex, static_cast<GLsizei>(faceCount * faceIndexCount), indexType, BUFFER_OFFSET(subMesh.faceOffset * faceSize));
+    }
 }
 
 void Mesh::endRender() const {
     //--------------------------------------------------------------------------
     // Render this mesh. Based on the vertex and element indices uploaded to the
     // GPU (see constructOnGPU), this function will call the GPU to render all
-    // of the elements based on the face indices.
+    // of the elements based on the face indices. The sub-meshes share the
+    // buffers bound in beginRender; the sub-meshes of an out-of-core mesh are
+    // drawn chunk by chunk from the buffers of their chunk. A level of detail
+    // (see selectLod) draws its own sub-meshes from the same buffers. The full
+    // mesh skips the clusters culled by cullClusters. Patches (see
+    // setDrawPatches) pass each face to the tessellation stages of the shader
+    // as three control points; otherwise a mesh with adjacency (see
+    // setBuildAdjacency) is drawn from its adjacency buffer.
     //--------------------------------------------------------------------------
-    glDrawRangeElements(GL_TRIANGLES, 0, static_cast<GLsizei>((this->faces.size() * TRIANGLE_EDGE_COUNT) - 1), static_cast<GLsizei>(this->faces.size() * TRIANGLE_EDGE_COUNT), GL_UNSIGNED_INT, 0);
+    if ( this->isResident() ) {
+        GLenum mode = (this->vboAdjacency != 0u) ? GL_TRIANGLES_ADJACENCY : GL_TRIANGLES;
+        if ( this->bDrawPatches ) {
+            glPatchParameteri(GL_PATCH_VERTICES, TRIANGLE_EDGE_COUNT);
+            mode = GL_PATCHES;
+        }
+
+        if ( this->subMeshes.size() == 0 && this->chunks.size() == 0 ) {
+            glDrawElements(mode, static_cast<GLsizei>(this->faceCount * Mesh_GetFaceIndexCount(mode)), this->bufferLayout.bShortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, 0);
+        }
+
+        std::uint32_t currentMaterial = SUBMESH_NO_MATERIAL;
+        bool bShaderTextures = true;
+        const std::vector<SubMesh>& subMeshes = (this->lodLevel > 0u) ? this->lodChain.levels[this->lodLevel - 1u].subMeshes : (this->bClusterCulling ? this->visibleSubMeshes : this->subMeshes);
+        Mesh_DrawSubMeshes(mode, subMeshes, this->bufferLayout, this->shader.get(), this->materials, currentMaterial, bShaderTextures);
+
+        for ( std::size_t c = 0; c < this->chunks.size(); c++ ) {
+            if ( c > 0 ) Mesh_BindVertexBuffers(this->bufferLayout, this->chunks[c].vboVertex, this->chunks[c].vboIndex);
+            Mesh_DrawSubMeshes(mode, this->chunks[c].subMeshes, this->bufferLayout, this->shader.get(), this->materials, currentMaterial, bShaderTextures);
+        }
+    }
 
     if ( this->shader != nullptr ) this->shader->disable();
 }
@@ -435,6 +2292,161 @@ void Mesh::setRotation(const Quaternionf& rotation) {
     this->transform.setRotation(rotation);
 }
 
+void Mesh::setNormalWeighting(MeshNormalWeighting weighting) {
+    this->normalWeighting = weighting;
+}
+
+void Mesh::setOptimizeFaceOrder(bool bOptimize) {
+    this->bOptimizeFaceOrder = bOptimize;
+}
+
+void Mesh::setSortObjCorners(bool bSort) {
+    this->bSortObjCorners = bSort;
+}
+
+void Mesh::setVertexLayout(const VertexLayout& layout) {
+    this->vertexLayout = layout;
+}
+
+void Mesh::setGenerateLods(bool bGenerate) {
+    this->bGenerateLods = bGenerate;
+}
+
+std::size_t Mesh::selectLod(const Cameraf& camera, float viewportHeight, float pixelError) {
+    this->lodLevel = 0u;
+    if ( this->lodChain.levels.size() == 0 ) return 0u;
+
+    //--------------------------------------------------------------------------
+    // The errors are projected at the distance of the closest point of a
+    // sphere around the position of this mesh that contains it under any
+    // rotation, so a rotated mesh is never drawn coarser than it should be.
+    //--------------------------------------------------------------------------
+    Vector3f center = (this->lodChain.boundsMinimum + this->lodChain.boundsMaximum) * 0.5f;
+    float radius = static_cast<float>((this->lodChain.boundsMaximum - center).length());
+    const Vector3f& scale = this->transform.getScale();
+    float maxScale = std::max(std::fabs(scale.x()), std::max(std::fabs(scale.y()), std::fabs(scale.z())));
+    float distance = static_cast<float>((this->transform.getPosition() - camera.getEye()).length()) - maxScale * (static_cast<float>(center.length()) + radius);
+    if ( distance <= 0.0f ) return 0u;
+
+    float pixelsPerUnit = maxScale * camera.getProjectionMatrix()[5] * 0.5f * viewportHeight / distance;
+    for ( std::size_t level = this->lodChain.levels.size(); level > 0; level-- ) {
+        if ( this->lodChain.levels[level - 1].error * pixelsPerUnit > pixelError ) continue;
+        this->lodLevel = level;
+        break;
+    }
+
+    return this->lodLevel;
+}
+
+void Mesh::setLodLevel(std::size_t level) {
+    this->lodLevel = std::min(level, this->lodChain.levels.size());
+}
+
+void Mesh::setGenerateClusters(bool bGenerate) {
+    this->bGenerateClusters = bGenerate;
+}
+
+std::size_t Mesh::cullClusters(const Cameraf& camera) {
+    this->bClusterCulling = false;
+    this->visibleSubMeshes.clear();
+    if ( this->clusters.size() == 0 ) return Mesh_GetDetailFaceCount(this->subMeshes, this->lodChain, this->faceCount);
+
+    //--------------------------------------------------------------------------
+    // The normal cones are not kept by a non-uniform scale, so only the
+    // bounding spheres are tested then.
+    //--------------------------------------------------------------------------
+    const Vector3f& scale = this->transform.getScale();
+    bool bConeCulling = std::fabs(scale.x()) == std::fabs(scale.y()) && std::fabs(scale.y()) == std::fabs(scale.z());
+    Matrix4f modelView = Matrix4f::Multiply(this->transform.toMatrix(), camera.getViewMatrix());
+    this->bClusterCulling = true;
+    return CullMeshClusters(this->clusters, this->subMeshes, modelView, camera.getProjectionMatrix(), bConeCulling, this->visibleSubMeshes);
+}
+
+void Mesh::resetClusterCulling() {
+    this->bClusterCulling = false;
+    this->visibleSubMeshes.clear();
+}
+
+void Mesh::setBuildBvh(bool bBuild) {
+    this->bBuildBvh = bBuild;
+}
+
+void Mesh::setDrawPatches(bool bPatches) {
+    this->bDrawPatches = bPatches;
+}
+
+void Mesh::setBuildAdjacency(bool bBuild) {
+    this->bBuildAdjacency = bBuild;
+}
+
+bool Mesh::intersect(const MeshRay& ray, MeshRayHit& hit) const {
+    //--------------------------------------------------------------------------
+    // The ray is moved into the object space of this mesh. Its direction is
+    // not normalized again, so a hit is at the same distance in both spaces.
+    //--------------------------------------------------------------------------
+    Matrix4f inverseModel = Matrix4f::Inverse(this->transform.toMatrix());
+    const float* m = inverseModel.constData();
+    const Vector3f& o = ray.origin;
+    const Vector3f& d = ray.direction;
+    MeshRay objectRay;
+    objectRay.origin.set(m[0] * o.x() + m[4] * o.y() + m[8] * o.z() + m[12], m[1] * o.x() + m[5] * o.y() + m[9] * o.z() + m[13], m[2] * o.x() + m[6] * o.y() + m[10] * o.z() + m[14]);
+    objectRay.direction.set(m[0] * d.x() + m[4] * d.y() + m[8] * d.z(), m[1] * d.x() + m[5] * d.y() + m[9] * d.z(), m[2] * d.x() + m[6] * d.y() + m[10] * d.z());
+    objectRay.maxDistance = ray.maxDistance;
+    return this->bvh.intersect(objectRay, hit);
+}
+
+bool Mesh::getBounds(MeshBounds& bounds) const {
+    if ( this->bBounds ) {
+        bounds = this->bounds;
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+    // A lazy mesh that is not resident is bounded by the box of its header.
+    //--------------------------------------------------------------------------
+    if ( this->residencyManager == nullptr || !this->info.bKnown ) return false;
+    bounds.boundsMinimum = this->info.boundsMinimum;
+    bounds.boundsMaximum = this->info.boundsMaximum;
+    Mesh_SetBoxSphere(bounds);
+    return true;
+}
+
+bool Mesh::getWorldBounds(MeshBounds& bounds) const {
+    MeshBounds objectBounds;
+    if ( !this->getBounds(objectBounds) ) return false;
+
+    //--------------------------------------------------------------------------
+    // The box of the transformed box is found per axis from the smaller and
+    // larger product of each matrix element with the two extents (Arvo).
+    //--------------------------------------------------------------------------
+    Matrix4f model = this->transform.toMatrix();
+    const float* m = model.constData();
+    const Vector3f& c = objectBounds.center;
+    for ( unsigned int i = 0; i < 3; i++ ) {
+        bounds.boundsMinimum[i] = m[12 + i];
+        bounds.boundsMaximum[i] = m[12 + i];
+        for ( unsigned int k = 0; k < 3; k++ ) {
+            float a = m[k * 4 + i] * objectBounds.boundsMinimum[k];
+            float b = m[k * 4 + i] * objectBounds.boundsMaximum[k];
+            bounds.boundsMinimum[i] += std::min(a, b);
+            bounds.boundsMaximum[i] += std::max(a, b);
+        }
+    }
+
+    const Vector3f& scale = this->transform.getScale();
+    bounds.center.set(m[0] * c.x() + m[4] * c.y() + m[8] * c.z() + m[12], m[1] * c.x() + m[5] * c.y() + m[9] * c.z() + m[13], m[2] * c.x() + m[6] * c.y() + m[10] * c.z() + m[14]);
+    bounds.radius = objectBounds.radius * std::max(std::fabs(scale.x()), std::max(std::fabs(scale.y()), std::fabs(scale.z())));
+    return true;
+}
+
+bool Mesh::isVisible(const Frustum& frustum) const {
+    MeshBounds bounds;
+    if ( !this->getWorldBounds(bounds) ) return true;
+
+    unsigned int planeMask = FRUSTUM_ALL_PLANES;
+    return frustum.intersectsSphere(bounds.center, bounds.radius) && frustum.intersectsBox(bounds.boundsMinimum, bounds.boundsMaximum, planeMask);
+}
+
 std::string& Mesh::getName() {
     return this->name;
 }
@@ -459,7 +2471,98 @@ const std::shared_ptr<Shader>& Mesh::getShader() const {
     return this->shader;
 }
 
+std::size_t Mesh::getSubMeshCount() const {
+    return this->subMeshes.size();
+}
+
+const SubMesh& Mesh::getSubMesh(std::size_t index) const {
+    return this->subMeshes[index];
+}
+
+std::size_t Mesh::getMaterialCount() const {
+    return this->materials.size();
+}
+
+const MeshMaterial& Mesh::getMaterial(std::size_t index) const {
+    return this->materials[index];
+}
+
+const MeshInfo& Mesh::getInfo() const {
+    return this->info;
+}
+
+MeshNormalWeighting Mesh::getNormalWeighting() const {
+    return this->normalWeighting;
+}
+
+const MeshOptimizationStatistics& Mesh::getOptimizationStatistics() const {
+    return this->optimizationStatistics;
+}
+
+const VertexLayout& Mesh::getVertexLayout() const {
+    return this->vertexLayout;
+}
+
+std::size_t Mesh::getLodCount() const {
+    return this->lodChain.levels.size() + 1u;
+}
+
+std::size_t Mesh::getLodLevel() const {
+    return this->lodLevel;
+}
+
+std::size_t Mesh::getClusterCount() const {
+    return this->clusters.size();
+}
+
+const MeshBvh& Mesh::getBvh() const {
+    return this->bvh;
+}
+
+bool Mesh::getDrawPatches() const {
+    return this->bDrawPatches;
+}
+
+const MeshConnectivity& Mesh::getConnectivity() const {
+    return this->connectivity;
+}
+
 bool Mesh::constructOnGPU() {
+    return this->constructOnGPU(this->vertices.data(), this->vertices.size(), this->faces.data(), this->faces.size());
+}
+
+bool Mesh::constructOnGPU(const Vertex* vertices, std::size_t vertexCount, const TriangleFace* faces, std::size_t faceCount) {
+    this->bBounds = Mesh_CalculateBounds(vertices, vertexCount, this->bounds);
+
+    //--------------------------------------------------------------------------
+    // The hierarchy and the corner table cover the faces of the full level of
+    // detail. A staging mesh builds them on its loader thread and hands them
+    // over in adopt.
+    //--------------------------------------------------------------------------
+    if ( this->bBuildBvh && this->bvh.isEmpty() )
+        this->bvh.build(vertices, vertexCount, faces, Mesh_GetDetailFaceCount(this->subMeshes, this->lodChain, faceCount));
+    if ( this->bBuildAdjacency && this->connectivity.isEmpty() )
+        this->connectivity.build(vertices, vertexCount, faces, Mesh_GetDetailFaceCount(this->subMeshes, this->lodChain, faceCount));
+
+    //--------------------------------------------------------------------------
+    // A staging mesh keeps a copy of the vertices and faces (which may be
+    // mapped from a file) until it is adopted by its lazy mesh (see adopt).
+    //--------------------------------------------------------------------------
+    if ( this->bDeferUpload ) {
+        if ( vertices != this->vertices.data() ) this->vertices.assign(vertices, vertices + vertexCount);
+        if ( faces != this->faces.data() ) this->faces.assign(faces, faces + faceCount);
+        this->faceCount = faceCount;
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+    // The buffers of a previous upload are replaced.
+    //--------------------------------------------------------------------------
+    if ( this->vboVertex != 0u ) glDeleteBuffers(1, &this->vboVertex);
+    if ( this->vboIndex != 0u ) glDeleteBuffers(1, &this->vboIndex);
+    if ( this->vboAdjacency != 0u ) glDeleteBuffers(1, &this->vboAdjacency);
+    this->vboAdjacency = 0u;
+
     //--------------------------------------------------------------------------
     // Vertex Buffer Object (VBO): Responsible for storing the vertex data of
     // this mesh. This segment first creates a new buffer on the GPU and then
@@ -469,23 +2572,38 @@ bool Mesh::constructOnGPU() {
     // is used because this class represents a simple model that does not 
     // change over time. The following vertex attribute pointers define
     // how and where to define each unique vertex attribute based on this
-    // original set of data (position, normal, tangent, texCoord).
+    // original set of data (position, normal, tangent, texCoord). Vertices
+    // are packed into the vertex layout of this mesh first unless it stores
+    // Vertex structures (see setVertexLayout).
     //--------------------------------------------------------------------------
+    this->bufferLayout = Mesh_GetBufferLayout(this->vertexLayout, vertexCount);
     glGenBuffers(1, &this->vboVertex);
     glBindBuffer(GL_ARRAY_BUFFER, this->vboVertex);
-    glBufferData(GL_ARRAY_BUFFER, this->vertices.size() * sizeof(Vertex), &this->vertices[0], GL_STATIC_DRAW);
+    Mesh_BufferVertices(this->bufferLayout, vertices, vertexCount);
 
     //--------------------------------------------------------------------------
     // This segment creates a new element buffer (for indexed geometry) for
     // defining the adjacencies or faces of the loaded set of vertices. This
     // section uses a trick that requires a face to be defined as a simple
     // structure containing the three indices of a face. These structures must
-    // be contiguous in memory to work correctly.
+    // be contiguous in memory to work correctly. Small meshes are converted
+    // to 16-bit indices if the vertex layout asks for them.
     //--------------------------------------------------------------------------
     glGenBuffers(1, &this->vboIndex);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->vboIndex);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, this->faces.size() * TRIANGLE_EDGE_COUNT * sizeof(unsigned int), &this->faces[0].indices[0], GL_STATIC_DRAW);
-    
+    Mesh_BufferIndices(this->bufferLayout, faces, faceCount);
+
+    //--------------------------------------------------------------------------
+    // The adjacency buffer holds six indices per face in the order of the
+    // faces, so the sub-meshes (and clusters) index both buffers alike.
+    //--------------------------------------------------------------------------
+    if ( this->bBuildAdjacency && !this->connectivity.isEmpty() ) {
+        glGenBuffers(1, &this->vboAdjacency);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->vboAdjacency);
+        Mesh_BufferAdjacency(this->bufferLayout, this->connectivity, this->lodChain, vertices, vertexCount, faces, faceCount);
+    }
+
+    this->faceCount = faceCount;
     return true;
 }
 
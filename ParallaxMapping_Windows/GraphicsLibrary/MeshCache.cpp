@@ -0,0 +1,539 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "MeshCache.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+
+namespace sgpu {
+
+static const char MESH_CACHE_MAGIC[4] = { 'S', 'G', 'M', 'C' };
+static const std::string MESH_CACHE_EXTENSION = ".sgmesh";
+static const std::size_t MESH_CACHE_ALIGNMENT = 16u;
+
+/* Returns the offset of the vertices within a cache file. */
+inline std::size_t MeshCache_VertexOffset(std::size_t nameLength) {
+    std::size_t offset = sizeof(MeshCacheHeader) + nameLength;
+    return (offset + MESH_CACHE_ALIGNMENT - 1) / MESH_CACHE_ALIGNMENT * MESH_CACHE_ALIGNMENT;
+}
+
+/*
+ * Advances offset past count elements of elementSize bytes. Returns false if
+ * they do not fit into the fileSize bytes of a cache, so corrupted counts can
+ * neither wrap the offset around nor point past the end of the file.
+ */
+inline bool MeshCache_Advance(std::size_t& offset, std::uint64_t count, std::size_t elementSize, std::size_t fileSize) {
+    if ( offset > fileSize ) return false;
+    if ( elementSize != 0u && count > (fileSize - offset) / elementSize ) return false;
+    offset += static_cast<std::size_t>(count) * elementSize;
+    return true;
+}
+
+/*
+ * Returns true if a range of faces lies within the faces of a cache and, if
+ * it is not empty, its largest index references a vertex of the cache.
+ */
+inline bool MeshCache_ValidRange(std::uint32_t faceOffset, std::uint32_t faceCount, std::uint32_t maxIndex, const MeshCacheHeader& header) {
+    if ( faceOffset > header.faceCount || faceCount > header.faceCount - faceOffset ) return false;
+    return faceCount == 0u || maxIndex < header.vertexCount;
+}
+
+/*
+ * Returns true if every face index of a cache references one of its vertices
+ * and every sub-mesh, level of detail range, and cluster lies within its
+ * faces (see MeshCache_ValidRange). Mesh::load draws the mapped data
+ * directly, so a cache that fails is reparsed from its source.
+ */
+bool MeshCache_ValidContents(const MeshCacheHeader& header, const TriangleFace* faces, const MeshCacheSubMesh* subMeshes, const MeshCacheLodRange* lodRanges, const MeshCacheCluster* clusters) {
+    std::uint64_t maxIndex = 0u;
+    for ( std::size_t i = 0; i < header.faceCount; i++ ) {
+        for ( std::size_t j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) maxIndex = std::max<std::uint64_t>(maxIndex, faces[i].indices[j]);
+    }
+
+    if ( header.faceCount != 0u && maxIndex >= header.vertexCount ) return false;
+
+    for ( std::size_t i = 0; i < header.subMeshCount; i++ ) {
+        if ( !MeshCache_ValidRange(subMeshes[i].faceOffset, subMeshes[i].faceCount, subMeshes[i].maxIndex, header) ) return false;
+    }
+
+    for ( std::size_t i = 0; i < header.lodCount * header.subMeshCount; i++ ) {
+        if ( !MeshCache_ValidRange(lodRanges[i].faceOffset, lodRanges[i].faceCount, lodRanges[i].maxIndex, header) ) return false;
+    }
+
+    for ( std::size_t i = 0; i < header.clusterCount; i++ ) {
+        if ( clusters[i].subMesh >= header.subMeshCount || !MeshCache_ValidRange(clusters[i].faceOffset, clusters[i].faceCount, clusters[i].maxIndex, header) ) return false;
+    }
+
+    return true;
+}
+
+/* Returns the stored normal option (uniform weighting matches older caches). */
+inline std::uint32_t MeshCache_NormalOption(bool bComputeNormals, MeshNormalWeighting normalWeighting) {
+    return bComputeNormals ? 1u + static_cast<std::uint32_t>(normalWeighting) : 0u;
+}
+
+/* Queries the size and modification time of the provided file. */
+bool MeshCache_QuerySource(const std::string& filename, std::uint64_t& size, std::int64_t& modifiedTime) {
+    std::error_code error;
+    size = static_cast<std::uint64_t>(std::filesystem::file_size(filename, error));
+    if ( error ) return false;
+
+    modifiedTime = static_cast<std::int64_t>(std::filesystem::last_write_time(filename, error).time_since_epoch().count());
+    if ( error ) return false;
+    return true;
+}
+
+/* Replaces the source modification time stored in the header of a cache file. */
+bool MeshCache_StoreModifiedTime(const std::string& filename, std::int64_t modifiedTime) {
+    std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+    if ( !file.is_open() ) return false;
+
+    file.seekp(offsetof(MeshCacheHeader, sourceModifiedTime));
+    file.write(reinterpret_cast<const char*>(&modifiedTime), sizeof(modifiedTime));
+    return file.good();
+}
+
+/* 64-bit FNV-1a hash of the contents of the provided file. */
+bool MeshCache_HashSource(const std::string& filename, std::uint64_t& hash) {
+    MappedFile source;
+    if ( !source.open(filename) ) return false;
+
+    hash = 14695981039346656037ull;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(source.data());
+    for ( std::size_t i = 0; i < source.size(); i++ ) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+
+    return true;
+}
+
+MeshCache::MeshCache() {
+    this->header = nullptr;
+    this->vertices = nullptr;
+    this->faces = nullptr;
+    this->subMeshes = nullptr;
+    this->lodErrors = nullptr;
+    this->lodRanges = nullptr;
+    this->clusters = nullptr;
+    this->materialLibraries = nullptr;
+}
+
+MeshCache::~MeshCache() {
+    this->close();
+}
+
+bool MeshCache::open(const std::string& sourceFilename, bool bComputeNormals, MeshNormalWeighting normalWeighting, bool bOptimizeFaceOrder, bool bGenerateLods, bool bGenerateClusters) {
+    this->close();
+
+    std::uint64_t sourceSize = 0u;
+    std::int64_t sourceModifiedTime = 0;
+    if ( !MeshCache_QuerySource(sourceFilename, sourceSize, sourceModifiedTime) ) return false;
+
+    std::string filename = GetMeshCacheFilename(sourceFilename);
+    std::error_code error;
+    if ( !std::filesystem::exists(filename, error) ) return false;
+    if ( !this->file.open(filename) ) return false;
+
+    //--------------------------------------------------------------------------
+    // Reject caches written by another version of this format, by a build
+    // with a different Vertex or TriangleFace layout, or for another option.
+    //--------------------------------------------------------------------------
+    if ( this->file.size() < sizeof(MeshCacheHeader) ) {
+        this->close();
+        return false;
+    }
+
+    const MeshCacheHeader* header = reinterpret_cast<const MeshCacheHeader*>(this->file.data());
+    if ( std::memcmp(header->magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC)) != 0 ||
+         header->version != MESH_CACHE_VERSION ||
+         header->vertexSize != sizeof(Vertex) ||
+         header->faceSize != sizeof(TriangleFace) ||
+         header->computeNormals != MeshCache_NormalOption(bComputeNormals, normalWeighting) ||
+         header->optimizeFaceOrder != (bOptimizeFaceOrder ? 1u : 0u) ||
+         header->generateLods != (bGenerateLods ? 1u : 0u) ||
+         header->generateClusters != (bGenerateClusters ? 1u : 0u) ) {
+        this->close();
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // Each section must fit into the rest of the file before the offset of
+    // the next one is computed; every material library name must be null
+    // terminated.
+    //--------------------------------------------------------------------------
+    std::size_t size = this->file.size();
+    std::size_t vertexOffset = sizeof(MeshCacheHeader);
+    bool bComplete = MeshCache_Advance(vertexOffset, header->nameLength, sizeof(char), size);
+    if ( bComplete ) vertexOffset = MeshCache_VertexOffset(header->nameLength);
+
+    std::size_t faceOffset = vertexOffset;
+    bComplete = bComplete && MeshCache_Advance(faceOffset, header->vertexCount, sizeof(Vertex), size);
+    std::size_t subMeshOffset = faceOffset;
+    bComplete = bComplete && MeshCache_Advance(subMeshOffset, header->faceCount, sizeof(TriangleFace), size);
+    std::size_t lodErrorOffset = subMeshOffset;
+    bComplete = bComplete && MeshCache_Advance(lodErrorOffset, header->subMeshCount, sizeof(MeshCacheSubMesh), size);
+    std::size_t lodRangeOffset = lodErrorOffset;
+    bComplete = bComplete && MeshCache_Advance(lodRangeOffset, header->lodCount, sizeof(float), size);
+    std::size_t clusterOffset = lodRangeOffset;
+    bComplete = bComplete && MeshCache_Advance(clusterOffset, header->lodCount, static_cast<std::size_t>(header->subMeshCount) * sizeof(MeshCacheLodRange), size);
+    std::size_t nameOffset = clusterOffset;
+    bComplete = bComplete && MeshCache_Advance(nameOffset, header->clusterCount, sizeof(MeshCacheCluster), size);
+
+    std::size_t libraryOffset = nameOffset;
+    if ( bComplete ) {
+        const MeshCacheSubMesh* subMeshes = reinterpret_cast<const MeshCacheSubMesh*>(this->file.data() + subMeshOffset);
+        for ( std::size_t i = 0; i < header->subMeshCount && bComplete; i++ ) {
+            bComplete = MeshCache_Advance(libraryOffset, subMeshes[i].nameLength, sizeof(char), size) &&
+                        MeshCache_Advance(libraryOffset, subMeshes[i].materialLength, sizeof(char), size);
+        }
+    }
+
+    std::size_t fileSize = libraryOffset;
+    bComplete = bComplete && MeshCache_Advance(fileSize, header->materialLibrarySize, sizeof(char), size) && fileSize == size;
+    if ( bComplete ) bComplete = std::count(this->file.data() + libraryOffset, this->file.data() + fileSize, '\0') == static_cast<std::ptrdiff_t>(header->materialLibraryCount);
+
+    if ( !bComplete ) {
+        std::cerr << "[MeshCache:open] Warning: Ignoring truncated mesh cache: " << filename << std::endl;
+        this->close();
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // Validate the cache against its source. The hash of the source is only
+    // computed if its modification time changed.
+    //--------------------------------------------------------------------------
+    if ( header->sourceSize != sourceSize ) {
+        this->close();
+        return false;
+    }
+
+    if ( header->sourceModifiedTime != sourceModifiedTime ) {
+        std::uint64_t sourceHash = 0u;
+        if ( !MeshCache_HashSource(sourceFilename, sourceHash) || sourceHash != header->sourceHash ) {
+            this->close();
+            return false;
+        }
+
+        //----------------------------------------------------------------------
+        // The source was touched but not changed. Its new modification time
+        // is stored (the cache cannot be written while it is mapped), so the
+        // next open does not hash the source again.
+        //----------------------------------------------------------------------
+        this->file.close();
+        if ( !MeshCache_StoreModifiedTime(filename, sourceModifiedTime) )
+            std::cerr << "[MeshCache:open] Warning: Could not update the mesh cache: " << filename << std::endl;
+
+        if ( !this->file.open(filename) || this->file.size() != fileSize ) {
+            this->close();
+            return false;
+        }
+
+        header = reinterpret_cast<const MeshCacheHeader*>(this->file.data());
+    }
+
+    //--------------------------------------------------------------------------
+    // Reject caches whose faces or ranges reference data outside the cache.
+    //--------------------------------------------------------------------------
+    const char* data = this->file.data();
+    if ( !MeshCache_ValidContents(*header, reinterpret_cast<const TriangleFace*>(data + faceOffset), reinterpret_cast<const MeshCacheSubMesh*>(data + subMeshOffset),
+                                  reinterpret_cast<const MeshCacheLodRange*>(data + lodRangeOffset), reinterpret_cast<const MeshCacheCluster*>(data + clusterOffset)) ) {
+        std::cerr << "[MeshCache:open] Warning: Ignoring corrupt mesh cache: " << filename << std::endl;
+        this->close();
+        return false;
+    }
+
+    this->header = header;
+    this->vertices = reinterpret_cast<const Vertex*>(this->file.data() + vertexOffset);
+    this->faces = reinterpret_cast<const TriangleFace*>(this->file.data() + faceOffset);
+    this->subMeshes = reinterpret_cast<const MeshCacheSubMesh*>(this->file.data() + subMeshOffset);
+    this->lodErrors = reinterpret_cast<const float*>(this->file.data() + lodErrorOffset);
+    this->lodRanges = reinterpret_cast<const MeshCacheLodRange*>(this->file.data() + lodRangeOffset);
+    this->clusters = reinterpret_cast<const MeshCacheCluster*>(this->file.data() + clusterOffset);
+    this->materialLibraries = this->file.data() + libraryOffset;
+    return true;
+}
+
+void MeshCache::close() {
+    this->file.close();
+    this->header = nullptr;
+    this->vertices = nullptr;
+    this->faces = nullptr;
+    this->subMeshes = nullptr;
+    this->lodErrors = nullptr;
+    this->lodRanges = nullptr;
+    this->clusters = nullptr;
+    this->materialLibraries = nullptr;
+}
+
+bool MeshCache::isOpen() const {
+    return this->header != nullptr;
+}
+
+std::string MeshCache::getName() const {
+    if ( this->header == nullptr ) return std::string();
+    return std::string(this->file.data() + sizeof(MeshCacheHeader), this->header->nameLength);
+}
+
+const Vertex* MeshCache::getVertices() const {
+    return this->vertices;
+}
+
+std::size_t MeshCache::getVertexCount() const {
+    if ( this->header == nullptr ) return 0u;
+    return static_cast<std::size_t>(this->header->vertexCount);
+}
+
+const TriangleFace* MeshCache::getFaces() const {
+    return this->faces;
+}
+
+std::size_t MeshCache::getFaceCount() const {
+    if ( this->header == nullptr ) return 0u;
+    return static_cast<std::size_t>(this->header->faceCount);
+}
+
+void MeshCache::getSubMeshes(std::vector<SubMesh>& subMeshes) const {
+    subMeshes.clear();
+    if ( this->header == nullptr ) return;
+
+    //--------------------------------------------------------------------------
+    // The names and materials of the sub-meshes follow the clusters in order.
+    //--------------------------------------------------------------------------
+    const char* names = reinterpret_cast<const char*>(this->clusters + this->header->clusterCount);
+    subMeshes.resize(static_cast<std::size_t>(this->header->subMeshCount));
+    for ( std::size_t i = 0; i < subMeshes.size(); i++ ) {
+        const MeshCacheSubMesh& record = this->subMeshes[i];
+        subMeshes[i].name = std::string(names, record.nameLength);
+        names += record.nameLength;
+        subMeshes[i].material = std::string(names, record.materialLength);
+        names += record.materialLength;
+        subMeshes[i].faceOffset = record.faceOffset;
+        subMeshes[i].faceCount = record.faceCount;
+        subMeshes[i].minIndex = record.minIndex;
+        subMeshes[i].maxIndex = record.maxIndex;
+        subMeshes[i].materialIndex = SUBMESH_NO_MATERIAL;
+    }
+}
+
+void MeshCache::getLods(MeshLodChain& chain) const {
+    chain.levels.clear();
+    if ( this->header == nullptr ) return;
+
+    //--------------------------------------------------------------------------
+    // The sub-meshes of every level share the names and materials of the
+    // sub-meshes of the mesh.
+    //--------------------------------------------------------------------------
+    std::vector<SubMesh> subMeshes;
+    this->getSubMeshes(subMeshes);
+    this->getBounds(chain.boundsMinimum, chain.boundsMaximum);
+
+    chain.levels.resize(this->header->lodCount);
+    for ( std::size_t level = 0; level < chain.levels.size(); level++ ) {
+        chain.levels[level].error = this->lodErrors[level];
+        chain.levels[level].subMeshes = subMeshes;
+        for ( std::size_t i = 0; i < subMeshes.size(); i++ ) {
+            const MeshCacheLodRange& range = this->lodRanges[level * subMeshes.size() + i];
+            chain.levels[level].subMeshes[i].faceOffset = range.faceOffset;
+            chain.levels[level].subMeshes[i].faceCount = range.faceCount;
+            chain.levels[level].subMeshes[i].minIndex = range.minIndex;
+            chain.levels[level].subMeshes[i].maxIndex = range.maxIndex;
+        }
+    }
+}
+
+void MeshCache::getMaterialLibraries(std::vector<std::string>& materialLibraries) const {
+    materialLibraries.clear();
+    if ( this->header == nullptr ) return;
+
+    const char* name = this->materialLibraries;
+    for ( std::size_t i = 0; i < this->header->materialLibraryCount; i++ ) {
+        materialLibraries.push_back(std::string(name));
+        name += materialLibraries.back().length() + 1;
+    }
+}
+
+void MeshCache::getBounds(Vector3f& minimum, Vector3f& maximum) const {
+    if ( this->header == nullptr ) return;
+
+    minimum = Vector3f(this->header->boundsMinimum[0], this->header->boundsMinimum[1], this->header->boundsMinimum[2]);
+    maximum = Vector3f(this->header->boundsMaximum[0], this->header->boundsMaximum[1], this->header->boundsMaximum[2]);
+}
+
+void MeshCache::getStatistics(MeshOptimizationStatistics& statistics) const {
+    if ( this->header == nullptr ) return;
+    statistics = this->header->statistics;
+}
+
+std::string GetMeshCacheFilename(const std::string& sourceFilename) {
+    return sourceFilename + MESH_CACHE_EXTENSION;
+}
+
+void MeshCache::getClusters(std::vector<MeshCluster>& clusters) const {
+    clusters.clear();
+    if ( this->header == nullptr ) return;
+
+    clusters.resize(static_cast<std::size_t>(this->header->clusterCount));
+    for ( std::size_t i = 0; i < clusters.size(); i++ ) {
+        const MeshCacheCluster& record = this->clusters[i];
+        clusters[i].faceOffset = record.faceOffset;
+        clusters[i].faceCount = record.faceCount;
+        clusters[i].minIndex = record.minIndex;
+        clusters[i].maxIndex = record.maxIndex;
+        clusters[i].subMesh = record.subMesh;
+        clusters[i].center.set(record.center[0], record.center[1], record.center[2]);
+        clusters[i].radius = record.radius;
+        clusters[i].coneAxis.set(record.coneAxis[0], record.coneAxis[1], record.coneAxis[2]);
+        clusters[i].coneCutoff = record.coneCutoff;
+    }
+}
+
+bool SaveMeshCache(const std::string& sourceFilename, bool bComputeNormals, MeshNormalWeighting normalWeighting, bool bOptimizeFaceOrder, const MeshOptimizationStatistics& statistics, bool bGenerateLods, const MeshLodChain& lodChain, bool bGenerateClusters, const std::vector<MeshCluster>& clusters, const std::string& name, const std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces, const std::vector<SubMesh>& subMeshes, const std::vector<std::string>& materialLibraries) {
+    MeshCacheHeader header;
+    std::memset(&header, 0, sizeof(MeshCacheHeader));
+    std::memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC));
+    header.version = MESH_CACHE_VERSION;
+    header.vertexSize = sizeof(Vertex);
+    header.faceSize = sizeof(TriangleFace);
+    header.computeNormals = MeshCache_NormalOption(bComputeNormals, normalWeighting);
+    header.optimizeFaceOrder = bOptimizeFaceOrder ? 1u : 0u;
+    header.statistics = statistics;
+    header.generateLods = bGenerateLods ? 1u : 0u;
+    header.lodCount = static_cast<std::uint32_t>(lodChain.levels.size());
+    header.generateClusters = bGenerateClusters ? 1u : 0u;
+    header.clusterCount = static_cast<std::uint32_t>(clusters.size());
+    header.nameLength = static_cast<std::uint32_t>(name.length());
+    header.vertexCount = vertices.size();
+    header.faceCount = faces.size();
+    header.subMeshCount = subMeshes.size();
+    header.materialLibraryCount = static_cast<std::uint32_t>(materialLibraries.size());
+    for ( std::size_t i = 0; i < materialLibraries.size(); i++ )
+        header.materialLibrarySize += static_cast<std::uint32_t>(materialLibraries[i].length() + 1);
+
+    for ( unsigned int k = 0; k < 3; k++ ) {
+        header.boundsMinimum[k] = vertices.size() > 0 ? vertices[0].position[k] : 0.0f;
+        header.boundsMaximum[k] = header.boundsMinimum[k];
+    }
+
+    for ( std::size_t i = 1; i < vertices.size(); i++ ) {
+        for ( unsigned int k = 0; k < 3; k++ ) {
+            header.boundsMinimum[k] = std::min(header.boundsMinimum[k], vertices[i].position[k]);
+            header.boundsMaximum[k] = std::max(header.boundsMaximum[k], vertices[i].position[k]);
+        }
+    }
+
+    if ( !MeshCache_QuerySource(sourceFilename, header.sourceSize, header.sourceModifiedTime) ) {
+        std::cerr << "[MeshCache:save] Error: Could not query source file: " << sourceFilename << std::endl;
+        return false;
+    }
+
+    if ( !MeshCache_HashSource(sourceFilename, header.sourceHash) ) {
+        std::cerr << "[MeshCache:save] Error: Could not hash source file: " << sourceFilename << std::endl;
+        return false;
+    }
+
+    std::string filename = GetMeshCacheFilename(sourceFilename);
+    std::ofstream out(filename.c_str(), std::ios::binary | std::ios::trunc);
+    if ( out.is_open() == false ) {
+        std::cerr << "[MeshCache:save] Error: Could not open file: " << filename << std::endl;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // Header, name (padded so the vertices are aligned), vertices, faces,
+    // sub-mesh records, level of detail errors and ranges, cluster records,
+    // sub-mesh names and materials, material libraries.
+    //--------------------------------------------------------------------------
+    static const char padding[MESH_CACHE_ALIGNMENT] = { 0 };
+    std::size_t paddingSize = MeshCache_VertexOffset(name.length()) - sizeof(MeshCacheHeader) - name.length();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(MeshCacheHeader));
+    out.write(name.data(), static_cast<std::streamsize>(name.length()));
+    out.write(padding, static_cast<std::streamsize>(paddingSize));
+    if ( vertices.size() > 0 ) out.write(reinterpret_cast<const char*>(vertices.data()), static_cast<std::streamsize>(vertices.size() * sizeof(Vertex)));
+    if ( faces.size() > 0 ) out.write(reinterpret_cast<const char*>(faces.data()), static_cast<std::streamsize>(faces.size() * sizeof(TriangleFace)));
+
+    for ( std::size_t i = 0; i < subMeshes.size(); i++ ) {
+        MeshCacheSubMesh record;
+        record.faceOffset = subMeshes[i].faceOffset;
+        record.faceCount = subMeshes[i].faceCount;
+        record.minIndex = subMeshes[i].minIndex;
+        record.maxIndex = subMeshes[i].maxIndex;
+        record.nameLength = static_cast<std::uint32_t>(subMeshes[i].name.length());
+        record.materialLength = static_cast<std::uint32_t>(subMeshes[i].material.length());
+        out.write(reinterpret_cast<const char*>(&record), sizeof(MeshCacheSubMesh));
+    }
+
+    for ( std::size_t level = 0; level < lodChain.levels.size(); level++ )
+        out.write(reinterpret_cast<const char*>(&lodChain.levels[level].error), sizeof(float));
+
+    for ( std::size_t level = 0; level < lodChain.levels.size(); level++ ) {
+        for ( std::size_t i = 0; i < subMeshes.size(); i++ ) {
+            const SubMesh& subMesh = lodChain.levels[level].subMeshes[i];
+            MeshCacheLodRange range;
+            range.faceOffset = subMesh.faceOffset;
+            range.faceCount = subMesh.faceCount;
+            range.minIndex = subMesh.minIndex;
+            range.maxIndex = subMesh.maxIndex;
+            out.write(reinterpret_cast<const char*>(&range), sizeof(MeshCacheLodRange));
+        }
+    }
+
+    for ( std::size_t i = 0; i < clusters.size(); i++ ) {
+        MeshCacheCluster record;
+        record.faceOffset = clusters[i].faceOffset;
+        record.faceCount = clusters[i].faceCount;
+        record.minIndex = clusters[i].minIndex;
+        record.maxIndex = clusters[i].maxIndex;
+        record.subMesh = clusters[i].subMesh;
+        for ( unsigned int k = 0; k < 3; k++ ) {
+            record.center[k] = clusters[i].center[k];
+            record.coneAxis[k] = clusters[i].coneAxis[k];
+        }
+        record.radius = clusters[i].radius;
+        record.coneCutoff = clusters[i].coneCutoff;
+        out.write(reinterpret_cast<const char*>(&record), sizeof(MeshCacheCluster));
+    }
+
+    for ( std::size_t i = 0; i < subMeshes.size(); i++ ) {
+        out.write(subMeshes[i].name.data(), static_cast<std::streamsize>(subMeshes[i].name.length()));
+        out.write(subMeshes[i].material.data(), static_cast<std::streamsize>(subMeshes[i].material.length()));
+    }
+
+    for ( std::size_t i = 0; i < materialLibraries.size(); i++ )
+        out.write(materialLibraries[i].c_str(), static_cast<std::streamsize>(materialLibraries[i].length() + 1));
+
+    if ( !out.good() ) {
+        std::cerr << "[MeshCache:save] Error: Could not write file: " << filename << std::endl;
+        out.close();
+        std::error_code error;
+        std::filesystem::remove(filename, error);
+        return false;
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MESH_PRIMITIVES_H
+#define MESH_PRIMITIVES_H
+
+#include <vector>
+#include <Mathematics.h>
+#include "Vertex.h"
+#include "Face.h"
+
+namespace sgpu {
+
+/* Most vertices of a generated primitive (indices are 32-bit). */
+const std::size_t MESH_PRIMITIVE_MAX_VERTICES = 0xFFFFFFFFu;
+
+/*
+ * Generators of analytic shapes directly into vertex and face arrays, with
+ * exact normals, tangents (handedness in w, see CalculateTangents), and
+ * texture-coords. Faces are counter-clockwise seen from the side the normals
+ * point to. Large shapes are generated row by row on several threads, so the
+ * result does not depend on the thread count.
+ */
+
+/*
+ * Generates a plane in the xz-plane centered at the origin with its normal
+ * along +y, split into columns x rows quads. The texture-coords span [0, 1]
+ * with u along +x and v along -z.
+ *
+ * @return Returns false if the size or the number of quads is invalid.
+ */
+bool GeneratePlane(float width, float depth, unsigned int columns, unsigned int rows, std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces);
+
+/*
+ * Generates a sphere centered at the origin with slices quads around the
+ * y-axis and stacks quads from pole to pole (the quads at the poles are
+ * triangles). The texture-coords span [0, 1] with u around the y-axis (the
+ * seam is at -z) and v from the south to the north pole.
+ *
+ * @return Returns false if the radius is invalid, there are fewer than three
+ * slices, or there are fewer than two stacks.
+ */
+bool GenerateSphere(float radius, unsigned int slices, unsigned int stacks, std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces);
+
+/*
+ * Generates a cube centered at the origin whose sides are split into
+ * divisions x divisions quads. Every side has its own vertices and its
+ * texture-coords span [0, 1]. An inward cube (ex. a skybox) has its faces
+ * and normals turned to the inside and its textures are not mirrored when
+ * seen from the inside.
+ *
+ * @return Returns false if the size or the number of divisions is invalid.
+ */
+bool GenerateCube(float size, unsigned int divisions, bool bInward, std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces);
+
+}
+
+#endif
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "SceneIndex.h"
+#include <algorithm>
+#include <limits>
+
+namespace sgpu {
+
+/* Most nodes waiting on the traversal stack of SceneIndex::cull. */
+static const std::size_t SCENE_INDEX_STACK_SIZE = 64u;
+
+/* Mesh of a SceneIndex during the build, at the center of its world box. */
+struct SceneIndex_Item {
+    Vector3f center;
+    std::uint32_t mesh;
+};
+
+/* Node of the traversal stack of SceneIndex::cull with the planes left to test. */
+struct SceneIndex_Entry {
+    std::uint32_t node;
+    unsigned int planeMask;
+};
+
+/*
+ * Builds the subtree of node over items [begin, end). The children of a node
+ * are appended after it, so every node comes before its children.
+ */
+void SceneIndex_Build(std::vector<SceneIndex_Item>& items, std::size_t begin, std::size_t end, std::size_t node, std::vector<SceneIndexNode>& nodes, std::vector<SceneIndexBatch>& batches) {
+    if ( end - begin <= FRUSTUM_BATCH_SIZE ) {
+        SceneIndexBatch batch = SceneIndexBatch();
+        for ( std::size_t i = begin; i < end; i++ ) batch.meshes[i - begin] = items[i].mesh;
+        nodes[node].offset = static_cast<std::uint32_t>(batches.size());
+        nodes[node].count = static_cast<std::uint32_t>(end - begin);
+        batches.push_back(batch);
+        return;
+    }
+
+    //--------------------------------------------------------------------------
+    // The items are split at the median of their centers along the longest
+    // axis of the box of the centers, which keeps the tree balanced.
+    //--------------------------------------------------------------------------
+    Vector3f minimum = items[begin].center;
+    Vector3f maximum = items[begin].center;
+    for ( std::size_t i = begin + 1; i < end; i++ ) {
+        for ( unsigned int k = 0; k < 3; k++ ) {
+            minimum[k] = std::min(minimum[k], items[i].center[k]);
+            maximum[k] = std::max(maximum[k], items[i].center[k]);
+        }
+    }
+
+    unsigned int axis = 0;
+    for ( unsigned int k = 1; k < 3; k++ )
+        if ( maximum[k] - minimum[k] > maximum[axis] - minimum[axis] ) axis = k;
+
+    std::size_t middle = begin + (end - begin) / 2;
+    std::nth_element(items.begin() + begin, items.begin() + middle, items.begin() + end, [axis](const SceneIndex_Item& a, const SceneIndex_Item& b) { return a.center[axis] < b.center[axis]; });
+
+    std::size_t children = nodes.size();
+    nodes.resize(children + 2, SceneIndexNode());
+    nodes[node].offset = static_cast<std::uint32_t>(children);
+    nodes[node].count = 0u;
+    SceneIndex_Build(items, begin, middle, children, nodes, batches);
+    SceneIndex_Build(items, middle, end, children + 1, nodes, batches);
+}
+
+SceneIndex::SceneIndex() {}
+
+SceneIndex::~SceneIndex() {}
+
+void SceneIndex::build(const std::vector<std::shared_ptr<Mesh>>& meshes) {
+    this->clear();
+    this->meshes = meshes;
+
+    std::vector<SceneIndex_Item> items;
+    items.reserve(meshes.size());
+    for ( std::size_t i = 0; i < meshes.size(); i++ ) {
+        MeshBounds bounds;
+        if ( meshes[i] == nullptr || !meshes[i]->getWorldBounds(bounds) ) {
+            this->unbounded.push_back(static_cast<std::uint32_t>(i));
+            continue;
+        }
+
+        SceneIndex_Item item;
+        item.center = (bounds.boundsMinimum + bounds.boundsMaximum) * 0.5f;
+        item.mesh = static_cast<std::uint32_t>(i);
+        items.push_back(item);
+    }
+
+    if ( items.size() == 0 ) return;
+
+    this->nodes.reserve(2 * (items.size() / FRUSTUM_BATCH_SIZE + 1));
+    this->nodes.push_back(SceneIndexNode());
+    SceneIndex_Build(items, 0, items.size(), 0, this->nodes, this->batches);
+    this->refit();
+}
+
+void SceneIndex::refit() {
+    const float infinity = std::numeric_limits<float>::max();
+
+    //--------------------------------------------------------------------------
+    // Children follow their parents, so the nodes are refit from the back.
+    //--------------------------------------------------------------------------
+    for ( std::size_t n = this->nodes.size(); n > 0; n-- ) {
+        SceneIndexNode& node = this->nodes[n - 1];
+        if ( node.count == 0 ) {
+            const SceneIndexNode& left = this->nodes[node.offset];
+            const SceneIndexNode& right = this->nodes[node.offset + 1];
+            for ( unsigned int k = 0; k < 3; k++ ) {
+                node.boundsMinimum[k] = std::min(left.boundsMinimum[k], right.boundsMinimum[k]);
+                node.boundsMaximum[k] = std::max(left.boundsMaximum[k], right.boundsMaximum[k]);
+            }
+            continue;
+        }
+
+        SceneIndexBatch& batch = this->batches[node.offset];
+        for ( unsigned int k = 0; k < 3; k++ ) {
+            node.boundsMinimum[k] = infinity;
+            node.boundsMaximum[k] = -infinity;
+        }
+
+        for ( std::size_t j = 0; j < node.count; j++ ) {
+            //------------------------------------------------------------------
+            // A mesh that lost its bounds (ex. a lazy mesh loaded again without
+            // a header) is kept visible.
+            //------------------------------------------------------------------
+            MeshBounds bounds;
+            if ( !this->meshes[batch.meshes[j]]->getWorldBounds(bounds) ) {
+                bounds.boundsMinimum = Vector3f(-infinity, -infinity, -infinity);
+                bounds.boundsMaximum = Vector3f(infinity, infinity, infinity);
+                bounds.center = Vector3f(0.0f, 0.0f, 0.0f);
+                bounds.radius = infinity;
+            }
+
+            batch.x[j] = bounds.center.x();
+            batch.y[j] = bounds.center.y();
+            batch.z[j] = bounds.center.z();
+            batch.radius[j] = bounds.radius;
+            for ( unsigned int k = 0; k < 3; k++ ) {
+                node.boundsMinimum[k] = std::min(node.boundsMinimum[k], bounds.boundsMinimum[k]);
+                node.boundsMaximum[k] = std::max(node.boundsMaximum[k], bounds.boundsMaximum[k]);
+            }
+        }
+    }
+}
+
+std::size_t SceneIndex::cull(const Frustum& frustum, std::vector<std::size_t>& visible) const {
+    visible.clear();
+
+    //--------------------------------------------------------------------------
+    // A balanced tree of any practical size is far shallower than the stack.
+    //--------------------------------------------------------------------------
+    SceneIndex_Entry stack[SCENE_INDEX_STACK_SIZE];
+    std::size_t stackSize = 0;
+    if ( this->nodes.size() != 0 ) {
+        stack[0].node = 0u;
+        stack[0].planeMask = FRUSTUM_ALL_PLANES;
+        stackSize = 1;
+    }
+
+    while ( stackSize > 0 ) {
+        SceneIndex_Entry entry = stack[--stackSize];
+        const SceneIndexNode& node = this->nodes[entry.node];
+
+        //----------------------------------------------------------------------
+        // Once a box is inside every plane its whole subtree is visible and
+        // no more tests are needed.
+        //----------------------------------------------------------------------
+        unsigned int planeMask = entry.planeMask;
+        if ( planeMask != 0 ) {
+            Vector3f boundsMinimum(node.boundsMinimum[0], node.boundsMinimum[1], node.boundsMinimum[2]);
+            Vector3f boundsMaximum(node.boundsMaximum[0], node.boundsMaximum[1], node.boundsMaximum[2]);
+            if ( !frustum.intersectsBox(boundsMinimum, boundsMaximum, planeMask) ) continue;
+        }
+
+        if ( node.count == 0 ) {
+            stack[stackSize].node = node.offset + 1;
+            stack[stackSize++].planeMask = planeMask;
+            stack[stackSize].node = node.offset;
+            stack[stackSize++].planeMask = planeMask;
+            continue;
+        }
+
+        const SceneIndexBatch& batch = this->batches[node.offset];
+        unsigned int lanes = (1u << node.count) - 1u;
+        if ( planeMask != 0 ) lanes &= frustum.intersectSpheres(batch.x, batch.y, batch.z, batch.radius, planeMask);
+        for ( std::size_t j = 0; j < node.count; j++ )
+            if ( (lanes & (1u << j)) != 0 ) visible.push_back(batch.meshes[j]);
+    }
+
+    visible.insert(visible.end(), this->unbounded.begin(), this->unbounded.end());
+    return visible.size();
+}
+
+void SceneIndex::clear() {
+    this->meshes.clear();
+    this->nodes.clear();
+    this->batches.clear();
+    this->unbounded.clear();
+}
+
+bool SceneIndex::isEmpty() const {
+    return this->meshes.size() == 0;
+}
+
+std::size_t SceneIndex::getMeshCount() const {
+    return this->meshes.size();
+}
+
+std::size_t SceneIndex::getNodeCount() const {
+    return this->nodes.size();
+}
+
+const std::vector<SceneIndexNode>& SceneIndex::getNodes() const {
+    return this->nodes;
+}
+
+}
@@ -24,20 +24,15 @@
 #define VERTEX_H
 
 #include <Vector3.h>
-#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include "Color3.h"
 
 namespace sgpu {
 
 struct Vertex {
-    float operator () (const Vertex& v) const {
-        float ret = v.position.x() + v.position.y() + v.position.z();
-        ret += v.normal.x() + v.normal.y() + v.normal.z();
-        ret += v.tangent.x() + v.tangent.y() + v.tangent.z() + v.tangent.w();
-        ret += v.textureCoord.x() + v.textureCoord.y();
-        return ret;
-    }
-
     bool operator () (const Vertex& u, const Vertex& v) const {
         if ( u.position == v.position &&
              u.normal == v.normal &&
@@ -53,7 +48,110 @@ struct Vertex {
     Color3f color;
 };
 
-typedef std::unordered_map<Vertex, unsigned int, Vertex, Vertex> VertexSet;
+/*
+ * Hash of the bit patterns of the vertex attributes compared by Vertex. Zero
+ * is hashed as +0 since -0 compares equal to it.
+ */
+inline std::uint32_t HashVertex(const Vertex& vertex) {
+    const float values[13] = {
+        vertex.position.x(), vertex.position.y(), vertex.position.z(),
+        vertex.normal.x(), vertex.normal.y(), vertex.normal.z(),
+        vertex.tangent.x(), vertex.tangent.y(), vertex.tangent.z(), vertex.tangent.w(),
+        vertex.textureCoord.x(), vertex.textureCoord.y(), vertex.textureCoord.z()
+    };
+
+    std::uint64_t hash = 0x9E3779B97F4A7C15ull;
+    for ( unsigned int i = 0; i < 13; i++ ) {
+        std::uint32_t bits = 0u;
+        if ( values[i] != 0.0f ) std::memcpy(&bits, &values[i], sizeof(bits));
+        hash = (hash ^ bits) * 0xBF58476D1CE4E5B9ull;
+        hash ^= hash >> 31;
+    }
+
+    hash = (hash ^ (hash >> 30)) * 0x94D049BB133111EBull;
+    return static_cast<std::uint32_t>(hash ^ (hash >> 32));
+}
+
+/* Index of an empty VertexSet slot, and the smallest VertexSet table. */
+const std::uint32_t VERTEX_SET_EMPTY = 0xFFFFFFFFu;
+const std::size_t VERTEX_SET_MIN_CAPACITY = 64u;
+
+/*
+ * Set of the unique vertices of a vertex array that maps each vertex to its
+ * index in the array. The set is an open addressing (linear probing) table of
+ * vertex indices and hashes; the vertices are only stored in the array.
+ */
+class VertexSet {
+public:
+    VertexSet() {
+        this->count = 0u;
+    }
+
+    /* Reserves room for the provided number of unique vertices. */
+    void reserve(std::size_t vertexCount) {
+        std::size_t capacity = VERTEX_SET_MIN_CAPACITY;
+        while ( capacity < vertexCount * 2u ) capacity *= 2u;
+        if ( capacity > this->slots.size() ) this->rehash(capacity);
+    }
+
+    /*
+     * Returns the index of the vertex in the provided array that is equal to
+     * the provided vertex. If there is none the vertex is appended first. The
+     * same array must be passed to every call.
+     */
+    unsigned int insert(const Vertex& vertex, std::vector<Vertex>& vertices) {
+        if ( (this->count + 1u) * 2u > this->slots.size() ) this->rehash(std::max(this->slots.size() * 2u, VERTEX_SET_MIN_CAPACITY));
+
+        std::uint32_t hash = HashVertex(vertex);
+        std::size_t mask = this->slots.size() - 1u;
+        for ( std::size_t i = hash & mask; ; i = (i + 1u) & mask ) {
+            Slot& slot = this->slots[i];
+            if ( slot.index == VERTEX_SET_EMPTY ) {
+                slot.hash = hash;
+                slot.index = static_cast<std::uint32_t>(vertices.size());
+                vertices.push_back(vertex);
+                this->count++;
+                return slot.index;
+            }
+
+            if ( slot.hash == hash && Vertex()(vertices[slot.index], vertex) ) return slot.index;
+        }
+    }
+
+    std::size_t size() const {
+        return this->count;
+    }
+
+    void clear() {
+        this->slots.clear();
+        this->count = 0u;
+    }
+
+protected:
+    struct Slot {
+        std::uint32_t hash;
+        std::uint32_t index;
+    };
+
+    void rehash(std::size_t capacity) {
+        std::vector<Slot> slots(capacity);
+        for ( std::size_t i = 0; i < capacity; i++ ) slots[i].index = VERTEX_SET_EMPTY;
+
+        std::size_t mask = capacity - 1u;
+        for ( std::size_t i = 0; i < this->slots.size(); i++ ) {
+            if ( this->slots[i].index == VERTEX_SET_EMPTY ) continue;
+            std::size_t j = this->slots[i].hash & mask;
+            while ( slots[j].index != VERTEX_SET_EMPTY ) j = (j + 1u) & mask;
+            slots[j] = this->slots[i];
+        }
+
+        this->slots.swap(slots);
+    }
+
+protected:
+    std::vector<Slot> slots;
+    std::size_t count;
+};
 
 }
 
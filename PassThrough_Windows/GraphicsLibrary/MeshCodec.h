@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MESH_CODEC_H
+#define MESH_CODEC_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <Mathematics.h>
+#include "Vertex.h"
+#include "Face.h"
+#include "MappedFile.h"
+
+namespace sgpu {
+
+/* Format version of compressed (*.sgmz) mesh files. */
+const std::uint32_t MESH_CODEC_VERSION = 1u;
+
+/*
+ * Quantization of the vertex attributes of a compressed mesh. Positions,
+ * texture coordinates, and colors are quantized per axis over their bounding
+ * box; normals and tangents are quantized in octahedral form. Indices are
+ * always stored losslessly.
+ */
+struct MeshCodecOptions {
+    MeshCodecOptions();
+
+    unsigned int positionBits;      /* [1, 24], default 16 */
+    unsigned int normalBits;        /* [2, 16], default 12 */
+    unsigned int tangentBits;       /* [2, 16], default 10 */
+    unsigned int textureCoordBits;  /* [1, 24], default 16 */
+    unsigned int colorBits;         /* [1, 24], default 8 */
+};
+
+/* Entropy coded streams of a compressed mesh, stored in this order. */
+enum MeshCodecStream {
+    MESH_CODEC_INDICES,
+    MESH_CODEC_POSITIONS,
+    MESH_CODEC_NORMALS,
+    MESH_CODEC_TANGENTS,
+    MESH_CODEC_TEXTURE_COORDS,
+    MESH_CODEC_COLORS,
+    MESH_CODEC_STREAM_COUNT
+};
+
+/*
+ * Header of a *.sgmz file. The header is followed by the mesh name, the
+ * sub-mesh records, their names and materials, the null terminated material
+ * library names, and the MESH_CODEC_STREAM_COUNT streams. Each stream is a
+ * MeshCodecStreamHeader followed by its frequency table and rANS data. The
+ * sub-mesh records and the streams start on 4 byte boundaries.
+ */
+struct MeshCodecHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t vertexCount;
+    std::uint32_t faceCount;
+    std::uint32_t subMeshCount;
+    std::uint32_t nameLength;
+    std::uint32_t materialLibraryCount;
+    std::uint32_t materialLibrarySize;
+
+    std::uint32_t positionBits;
+    std::uint32_t normalBits;
+    std::uint32_t tangentBits;
+    std::uint32_t textureCoordBits;
+    std::uint32_t colorBits;
+
+    /* Dequantization: value = minimum + quantized * step (per axis). */
+    float positionMinimum[3];
+    float positionStep[3];
+    float textureCoordMinimum[3];
+    float textureCoordStep[3];
+    float colorMinimum[3];
+    float colorStep[3];
+};
+
+/* Sub-mesh record of a *.sgmz file (see SubMesh). */
+struct MeshCodecSubMesh {
+    std::uint32_t faceOffset;
+    std::uint32_t faceCount;
+    std::uint32_t minIndex;
+    std::uint32_t maxIndex;
+    std::uint32_t nameLength;
+    std::uint32_t materialLength;
+};
+
+/*
+ * Stream record of a *.sgmz file. A stream holds rawSize bytes of variable
+ * length (LEB128) integers, rANS coded into encodedSize bytes. A stream that
+ * does not compress is stored as is (encodedSize == rawSize).
+ */
+struct MeshCodecStreamHeader {
+    std::uint32_t rawSize;
+    std::uint32_t encodedSize;
+};
+
+/*
+ * Compact binary form of the vertices and faces of a Mesh, intended for
+ * assets that are stored in a repository or read over the network.
+ *
+ * Indices are coded as the distance to the next unreferenced vertex, which
+ * is zero for a vertex used for the first time and small for recently used
+ * vertices. Vertex attributes are quantized (see MeshCodecOptions) and
+ * predicted from the previous vertex. The residuals of both are written as
+ * variable length integers and entropy coded with a static order-0 rANS
+ * coder, one stream per attribute.
+ *
+ * An open file is mapped into memory; decode writes the final vertices and
+ * faces straight into the provided (ex. mapped GPU) buffers.
+ */
+class CompressedMesh {
+public:
+    CompressedMesh();
+    ~CompressedMesh();
+
+    /*
+     * Opens and validates the provided compressed mesh file.
+     *
+     * @param filename - The name of the compressed (*.sgmz) file.
+     *
+     * @return If the file is a complete compressed mesh of this version then
+     * this function will return true; otherwise it will return false.
+     */
+    bool open(const std::string& filename);
+
+    /* Releases the mapping of the compressed file. */
+    void close();
+
+    /* Returns true if a compressed mesh is currently open. */
+    bool isOpen() const;
+
+    /* Returns the name of the compressed mesh. */
+    std::string getName() const;
+
+    std::size_t getVertexCount() const;
+    std::size_t getFaceCount() const;
+
+    /* Copies the sub-meshes of the compressed mesh. */
+    void getSubMeshes(std::vector<SubMesh>& subMeshes) const;
+
+    /* Copies the material libraries referenced by the compressed mesh. */
+    void getMaterialLibraries(std::vector<std::string>& materialLibraries) const;
+
+    /* Returns the bounds of the quantized positions (read from the header). */
+    void getBounds(Vector3f& minimum, Vector3f& maximum) const;
+
+    /*
+     * Decodes the open mesh. The vertices are written once and in order, so
+     * the destination may be write-combined memory.
+     *
+     * @param vertices - Destination of getVertexCount() vertices.
+     * @param faces - Destination of getFaceCount() faces.
+     * @param bSimd - Assemble the vertices with SSE2 where available; if
+     * false, the scalar path of every other platform is used.
+     *
+     * @return If every stream decodes and every index references a vertex
+     * then this function will return true; otherwise it will return false.
+     */
+    bool decode(Vertex* vertices, TriangleFace* faces, bool bSimd = true) const;
+
+protected:
+    CompressedMesh(const CompressedMesh&) = delete;
+    CompressedMesh& operator = (const CompressedMesh&) = delete;
+
+protected:
+    MappedFile file;
+    const MeshCodecHeader* header;
+    const MeshCodecSubMesh* subMeshes;
+    const char* materialLibraries;
+    const MeshCodecStreamHeader* streams[MESH_CODEC_STREAM_COUNT];
+};
+
+/*
+ * Writes the compressed form of a mesh.
+ *
+ * @param filename - The name of the compressed (*.sgmz) file to be written.
+ * @param name - The name of the mesh.
+ * @param vertices - The final vertices of the mesh.
+ * @param faces - The final faces of the mesh.
+ * @param subMeshes - The sub-meshes of the mesh.
+ * @param materialLibraries - The material libraries referenced by the mesh.
+ * @param options - The quantization of the vertex attributes.
+ *
+ * @return If the file is written successfully then this function will
+ * return true; otherwise it will return false.
+ */
+bool SaveCompressedMesh(const std::string& filename, const std::string& name, const std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces, const std::vector<SubMesh>& subMeshes, const std::vector<std::string>& materialLibraries, const MeshCodecOptions& options = MeshCodecOptions());
+
+}
+
+#endif
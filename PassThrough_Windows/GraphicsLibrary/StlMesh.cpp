@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "StlMesh.h"
+#include "MappedFile.h"
+#include "ParallelFor.h"
+#include "Face.h"
+#include <iostream>
+#include <unordered_map>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+namespace sgpu {
+
+static const std::size_t STL_HEADER_SIZE = 80u;
+static const std::size_t STL_TRIANGLE_SIZE = 50u;
+static const std::size_t STL_TRIANGLE_POSITIONS_OFFSET = 12u;
+
+/* Smallest number of positions worth decoding or welding on several threads. */
+static const std::size_t STL_MIN_PARALLEL_POSITIONS = 1u << 16;
+
+/* Grid cell of a welded position. */
+struct Stl_Cell {
+    bool operator == (const Stl_Cell& cell) const {
+        return this->x == cell.x && this->y == cell.y && this->z == cell.z;
+    }
+
+    std::int64_t x, y, z;
+};
+
+/* Mixes the coordinates of a cell into a 64-bit hash (splitmix64 finalizer). */
+inline std::uint64_t Stl_HashCell(const Stl_Cell& cell) {
+    std::uint64_t hash = static_cast<std::uint64_t>(cell.x) * 0x9E3779B97F4A7C15ull;
+    hash ^= static_cast<std::uint64_t>(cell.y) + 0x7F4A7C159E3779B9ull + (hash << 6) + (hash >> 2);
+    hash ^= static_cast<std::uint64_t>(cell.z) + 0x94D049BB133111EBull + (hash << 6) + (hash >> 2);
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+    return hash ^ (hash >> 31);
+}
+
+struct Stl_CellHash {
+    std::size_t operator () (const Stl_Cell& cell) const {
+        return static_cast<std::size_t>(Stl_HashCell(cell));
+    }
+};
+
+/* Returns the grid cell of a position (its bit pattern if cellSize is 0). */
+inline Stl_Cell Stl_ToCell(const Vector3f& position, float cellSize) {
+    Stl_Cell cell;
+    if ( cellSize > 0.0f ) {
+        cell.x = static_cast<std::int64_t>(std::floor(static_cast<double>(position.x()) / cellSize));
+        cell.y = static_cast<std::int64_t>(std::floor(static_cast<double>(position.y()) / cellSize));
+        cell.z = static_cast<std::int64_t>(std::floor(static_cast<double>(position.z()) / cellSize));
+        return cell;
+    }
+
+    //--------------------------------------------------------------------------
+    // Adding 0 maps -0 to +0, so both signs of zero are welded.
+    //--------------------------------------------------------------------------
+    std::uint32_t bits[3];
+    float coordinates[3] = { position.x() + 0.0f, position.y() + 0.0f, position.z() + 0.0f };
+    std::memcpy(bits, coordinates, sizeof(bits));
+    cell.x = bits[0];
+    cell.y = bits[1];
+    cell.z = bits[2];
+    return cell;
+}
+
+bool LoadStlMesh(const std::string& filename, std::vector<Vector3f>& positions) {
+    MappedFile file;
+    if ( !file.open(filename) ) {
+        std::cerr << "[Stl:load] Error: The file: " << filename << " could not be opened." << std::endl;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // A binary Stl file is an 80 byte header, the number of triangles, and 50
+    // bytes per triangle (normal, three corners, attribute byte count).
+    //--------------------------------------------------------------------------
+    std::uint32_t triangleCount = 0u;
+    if ( file.size() >= STL_HEADER_SIZE + sizeof(triangleCount) )
+        std::memcpy(&triangleCount, file.data() + STL_HEADER_SIZE, sizeof(triangleCount));
+
+    const std::size_t bodySize = file.size() - std::min(file.size(), STL_HEADER_SIZE + sizeof(triangleCount));
+    if ( file.size() < STL_HEADER_SIZE + sizeof(triangleCount) || triangleCount > bodySize / STL_TRIANGLE_SIZE ) {
+        std::cerr << "[Stl:load] Error: The file: " << filename << " is not a valid binary Stl file (ASCII Stl files are not supported)." << std::endl;
+        return false;
+    }
+
+    const char* triangles = file.data() + STL_HEADER_SIZE + sizeof(triangleCount);
+    positions.resize(static_cast<std::size_t>(triangleCount) * TRIANGLE_EDGE_COUNT);
+
+    std::size_t threadCount = (positions.size() >= STL_MIN_PARALLEL_POSITIONS) ? GetThreadCount() : 1u;
+    ParallelFor(threadCount, [&](std::size_t t) {
+        std::size_t begin = triangleCount * t / threadCount;
+        std::size_t end = triangleCount * (t + 1) / threadCount;
+        for ( std::size_t i = begin; i < end; i++ ) {
+            float corners[9];
+            std::memcpy(corners, triangles + i * STL_TRIANGLE_SIZE + STL_TRIANGLE_POSITIONS_OFFSET, sizeof(corners));
+            for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ )
+                positions[i * TRIANGLE_EDGE_COUNT + j] = Vector3f(corners[j * 3], corners[j * 3 + 1], corners[j * 3 + 2]);
+        }
+    });
+
+    return true;
+}
+
+void WeldVertices(const std::vector<Vector3f>& positions, float cellSize, std::vector<Vector3f>& vertices, std::vector<unsigned int>& indices) {
+    std::size_t positionCount = positions.size();
+    std::size_t threadCount = (positionCount >= STL_MIN_PARALLEL_POSITIONS) ? GetThreadCount() : 1u;
+
+    //--------------------------------------------------------------------------
+    // Compute the cell and hash of every position. Each position is then
+    // assigned to the partition (thread) selected by the upper hash bits.
+    //--------------------------------------------------------------------------
+    std::vector<Stl_Cell> cells(positionCount);
+    std::vector<std::uint32_t> partitions(positionCount);
+    ParallelFor(threadCount, [&](std::size_t t) {
+        for ( std::size_t i = positionCount * t / threadCount; i < positionCount * (t + 1) / threadCount; i++ ) {
+            cells[i] = Stl_ToCell(positions[i], cellSize);
+            partitions[i] = static_cast<std::uint32_t>((Stl_HashCell(cells[i]) >> 32) % threadCount);
+        }
+    });
+
+    //--------------------------------------------------------------------------
+    // Every thread maps the cells of its partition to the first position in
+    // them, visiting only the positions of its partition in order. A cell
+    // belongs to exactly one partition, so no locking is needed.
+    //--------------------------------------------------------------------------
+    std::vector<std::uint32_t> partitionPositions;
+    std::vector<std::size_t> offsets;
+    ParallelPartition(positionCount, threadCount, threadCount, [&](std::size_t i) { return partitions[i]; }, partitionPositions, offsets);
+
+    std::vector<unsigned int> first(positionCount);
+    ParallelFor(threadCount, [&](std::size_t t) {
+        std::unordered_map<Stl_Cell, unsigned int, Stl_CellHash> cellMap;
+        cellMap.reserve(offsets[t + 1u] - offsets[t]);
+        for ( std::size_t k = offsets[t]; k < offsets[t + 1u]; k++ ) {
+            std::size_t i = partitionPositions[k];
+            first[i] = cellMap.emplace(cells[i], static_cast<unsigned int>(i)).first->second;
+        }
+    });
+
+    //--------------------------------------------------------------------------
+    // Number the welded vertices in order of their first use.
+    //--------------------------------------------------------------------------
+    vertices.clear();
+    indices.resize(positionCount);
+    for ( std::size_t i = 0; i < positionCount; i++ ) {
+        if ( first[i] != i ) {
+            indices[i] = indices[first[i]];
+            continue;
+        }
+
+        indices[i] = static_cast<unsigned int>(vertices.size());
+        vertices.push_back(positions[i]);
+    }
+}
+
+}
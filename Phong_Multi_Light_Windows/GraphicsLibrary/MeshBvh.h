@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MESH_BVH_H
+#define MESH_BVH_H
+
+#include <vector>
+#include <cstdint>
+#include <Mathematics.h>
+#include "Vertex.h"
+#include "Face.h"
+
+namespace sgpu {
+
+/* Face index of a MeshRayHit that did not hit any face. */
+const std::uint32_t MESH_RAY_NO_HIT = 0xFFFFFFFFu;
+
+/* Number of rays traced together by MeshBvh::intersect (see MeshRayPacket). */
+const std::size_t MESH_RAY_PACKET_SIZE = 4u;
+
+/*
+ * Ray of a MeshBvh query: the points origin + t * direction for t in
+ * [0, maxDistance]. The direction does not need to be normalized; distances
+ * are measured in multiples of it.
+ */
+struct MeshRay {
+    Vector3f origin;
+    Vector3f direction;
+    float maxDistance;
+};
+
+/*
+ * Closest face hit by a ray, at the point origin + distance * direction. The
+ * point is p0 + u * (p1 - p0) + v * (p2 - p0) on the face.
+ */
+struct MeshRayHit {
+    std::uint32_t face;
+    float distance;
+    float u;
+    float v;
+};
+
+/*
+ * Node of a MeshBvh. An inner node (count 0) has its two children at offset
+ * and offset + 1; a leaf references count triangles starting at offset.
+ * Nodes are 32 bytes, so both children of a node share a cache line.
+ */
+struct MeshBvhNode {
+    float boundsMinimum[3];
+    std::uint32_t offset;
+    float boundsMaximum[3];
+    std::uint32_t count;
+};
+
+/* Triangle of a MeshBvh leaf, stored as its first vertex and edges. */
+struct MeshBvhTriangle {
+    float p0[3];
+    float edge1[3];
+    float edge2[3];
+    std::uint32_t face;
+};
+
+/*
+ * Bounding volume hierarchy over the faces of a mesh for ray queries (picking,
+ * snapping, measurements) in the object space of the mesh. The hierarchy is
+ * built top-down with a binned surface area heuristic; once the top of the
+ * tree provides enough subtrees, these are built on several threads. Nodes
+ * and triangles are stored in depth-first order in flat arrays.
+ */
+class MeshBvh {
+public:
+    MeshBvh();
+
+    /*
+     * Builds the hierarchy over the provided faces, replacing any previous
+     * hierarchy. Degenerate faces are skipped.
+     *
+     * @return If the faces reference valid vertices then this function will
+     * return true; otherwise it will return false and the hierarchy is empty.
+     */
+    bool build(const Vertex* vertices, std::size_t vertexCount, const TriangleFace* faces, std::size_t faceCount);
+
+    /* Releases the hierarchy. */
+    void clear();
+
+    /*
+     * Finds the closest face hit by a ray within its maxDistance.
+     *
+     * @return If a face is hit then this function will return true and fill
+     * hit; otherwise it will return false and hit.face is MESH_RAY_NO_HIT.
+     */
+    bool intersect(const MeshRay& ray, MeshRayHit& hit) const;
+
+    /*
+     * Finds the closest hits of several rays. Consecutive rays are traced as
+     * packets of MESH_RAY_PACKET_SIZE rays (SIMD where available), so rays
+     * that are close to each other (ex. neighboring pixels) should be
+     * consecutive. Large batches are split among several threads.
+     *
+     * @return Returns the number of rays that hit a face.
+     */
+    std::size_t intersect(const MeshRay* rays, std::size_t rayCount, MeshRayHit* hits) const;
+
+    bool isEmpty() const;
+    std::size_t getNodeCount() const;
+    std::size_t getDepth() const;
+    const std::vector<MeshBvhNode>& getNodes() const;
+    const std::vector<MeshBvhTriangle>& getTriangles() const;
+
+protected:
+    void intersectPacket(const MeshRay* rays, std::size_t rayCount, MeshRayHit* hits) const;
+
+protected:
+    std::vector<MeshBvhNode> nodes;
+    std::vector<MeshBvhTriangle> triangles;
+    std::size_t depth;
+};
+
+}
+
+#endif
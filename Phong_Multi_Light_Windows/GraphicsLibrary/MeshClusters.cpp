@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "MeshClusters.h"
+#include "MeshOptimizer.h"
+#include "Frustum.h"
+#include <algorithm>
+#include <cmath>
+
+namespace sgpu {
+
+static const std::uint32_t CLUSTER_NONE = 0xFFFFFFFFu;
+
+/* Weight of the normal spread of a face added to a cluster (see BuildMeshClusters). */
+static const float CLUSTER_CONE_WEIGHT = 4.0f;
+
+/* Weight of the distance of a face from the center of a cluster, in mean edge lengths. */
+static const float CLUSTER_DISTANCE_WEIGHT = 0.1f;
+
+/* Returns the unit normal of a face, or false if the face has no area. */
+inline bool Clusters_FaceNormal(const Vertex* vertices, const TriangleFace& face, Vector3f& normal) {
+    const Vector3f& a = vertices[face[0]].position;
+    normal = Vector3f::Cross(vertices[face[1]].position - a, vertices[face[2]].position - a);
+    float length = static_cast<float>(normal.length());
+    if ( !(length > 0.0f) ) return false;
+
+    normal = normal / length;
+    return true;
+}
+
+/* Computes the index range, bounding sphere, and normal cone of a cluster. */
+void Clusters_Finish(const Vertex* vertices, const TriangleFace* faces, MeshCluster& cluster) {
+    Vector3f minimum = vertices[faces[cluster.faceOffset][0]].position;
+    Vector3f maximum = minimum;
+    Vector3f normalSum(0.0f, 0.0f, 0.0f);
+    cluster.minIndex = CLUSTER_NONE;
+    cluster.maxIndex = 0u;
+    for ( std::size_t f = cluster.faceOffset; f < cluster.faceOffset + cluster.faceCount; f++ ) {
+        for ( unsigned int k = 0; k < TRIANGLE_EDGE_COUNT; k++ ) {
+            std::uint32_t index = faces[f][k];
+            const Vector3f& position = vertices[index].position;
+            cluster.minIndex = std::min(cluster.minIndex, index);
+            cluster.maxIndex = std::max(cluster.maxIndex, index);
+            minimum.set(std::min(minimum.x(), position.x()), std::min(minimum.y(), position.y()), std::min(minimum.z(), position.z()));
+            maximum.set(std::max(maximum.x(), position.x()), std::max(maximum.y(), position.y()), std::max(maximum.z(), position.z()));
+        }
+
+        Vector3f normal;
+        if ( Clusters_FaceNormal(vertices, faces[f], normal) ) normalSum = normalSum + normal;
+    }
+
+    //--------------------------------------------------------------------------
+    // The sphere is centered on the bounding box of the vertices.
+    //--------------------------------------------------------------------------
+    cluster.center = (minimum + maximum) * 0.5f;
+    cluster.radius = 0.0f;
+    for ( std::size_t f = cluster.faceOffset; f < cluster.faceOffset + cluster.faceCount; f++ ) {
+        for ( unsigned int k = 0; k < TRIANGLE_EDGE_COUNT; k++ )
+            cluster.radius = std::max(cluster.radius, static_cast<float>(vertices[faces[f][k]].position.distance(cluster.center)));
+    }
+
+    //--------------------------------------------------------------------------
+    // The cone axis is the mean face normal. Its cutoff is the sine of the
+    // largest angle between the axis and a face normal; a cone wider than a
+    // hemisphere is never culled.
+    //--------------------------------------------------------------------------
+    cluster.coneAxis = Vector3f(0.0f, 0.0f, 0.0f);
+    cluster.coneCutoff = 1.0f;
+    float length = static_cast<float>(normalSum.length());
+    if ( !(length > 0.0f) ) return;
+
+    cluster.coneAxis = normalSum / length;
+    float minimumDot = 1.0f;
+    for ( std::size_t f = cluster.faceOffset; f < cluster.faceOffset + cluster.faceCount; f++ ) {
+        Vector3f normal;
+        if ( Clusters_FaceNormal(vertices, faces[f], normal) ) minimumDot = std::min(minimumDot, static_cast<float>(normal.dot(cluster.coneAxis)));
+    }
+
+    if ( minimumDot > 0.0f ) cluster.coneCutoff = std::sqrt(1.0f - minimumDot * minimumDot);
+}
+
+/*
+ * Orders the faces of a cluster for the vertex cache. The cluster is remapped
+ * to its own vertices so OptimizeVertexCache only allocates for those.
+ */
+void Clusters_OptimizeVertexCache(std::vector<TriangleFace>& faces, std::size_t faceOffset, std::vector<std::uint32_t>& localIndices, std::vector<std::uint32_t>& clusterVertices, std::vector<TriangleFace>& clusterFaces) {
+    clusterVertices.clear();
+    clusterFaces.assign(faces.begin() + faceOffset, faces.end());
+    for ( std::size_t f = 0; f < clusterFaces.size(); f++ ) {
+        for ( unsigned int k = 0; k < TRIANGLE_EDGE_COUNT; k++ ) {
+            unsigned int& index = clusterFaces[f].indices[k];
+            if ( localIndices[index] == CLUSTER_NONE ) {
+                localIndices[index] = static_cast<std::uint32_t>(clusterVertices.size());
+                clusterVertices.push_back(index);
+            }
+            index = localIndices[index];
+        }
+    }
+
+    OptimizeVertexCache(clusterFaces, 0u, clusterFaces.size(), clusterVertices.size());
+    for ( std::size_t f = 0; f < clusterFaces.size(); f++ ) {
+        for ( unsigned int k = 0; k < TRIANGLE_EDGE_COUNT; k++ ) faces[faceOffset + f].indices[k] = clusterVertices[clusterFaces[f][k]];
+    }
+
+    for ( std::size_t v = 0; v < clusterVertices.size(); v++ ) localIndices[clusterVertices[v]] = CLUSTER_NONE;
+}
+
+void BuildMeshClusters(const std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces, const std::vector<SubMesh>& subMeshes, std::vector<MeshCluster>& clusters) {
+    clusters.clear();
+
+    //--------------------------------------------------------------------------
+    // Faces around each vertex, and the unit normal and centroid of each face.
+    //--------------------------------------------------------------------------
+    std::vector<std::uint32_t> adjacencyOffsets(vertices.size() + 1u, 0u), adjacency;
+    for ( std::size_t s = 0; s < subMeshes.size(); s++ ) {
+        for ( std::size_t f = subMeshes[s].faceOffset; f < subMeshes[s].faceOffset + subMeshes[s].faceCount; f++ )
+            for ( unsigned int k = 0; k < TRIANGLE_EDGE_COUNT; k++ ) adjacencyOffsets[faces[f][k] + 1u]++;
+    }
+
+    for ( std::size_t v = 0; v < vertices.size(); v++ ) adjacencyOffsets[v + 1u] += adjacencyOffsets[v];
+    adjacency.resize(adjacencyOffsets.back());
+    std::vector<std::uint32_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+
+    std::vector<Vector3f> normals(faces.size()), centroids(faces.size());
+    for ( std::size_t s = 0; s < subMeshes.size(); s++ ) {
+        for ( std::size_t f = subMeshes[s].faceOffset; f < subMeshes[s].faceOffset + subMeshes[s].faceCount; f++ ) {
+            for ( unsigned int k = 0; k < TRIANGLE_EDGE_COUNT; k++ ) adjacency[cursors[faces[f][k]]++] = static_cast<std::uint32_t>(f);
+            if ( !Clusters_FaceNormal(vertices.data(), faces[f], normals[f]) ) normals[f] = Vector3f(0.0f, 0.0f, 0.0f);
+            centroids[f] = (vertices[faces[f][0]].position + vertices[faces[f][1]].position + vertices[faces[f][2]].position) / 3.0f;
+        }
+    }
+
+    std::vector<unsigned char> emitted(faces.size(), 0u);
+    std::vector<std::uint32_t> stamps(vertices.size(), CLUSTER_NONE);
+    std::vector<std::uint32_t> candidates, localIndices(vertices.size(), CLUSTER_NONE), clusterVertices;
+    std::vector<TriangleFace> ordered, clusterFaces;
+    for ( std::size_t s = 0; s < subMeshes.size(); s++ ) {
+        const SubMesh& subMesh = subMeshes[s];
+        std::size_t faceEnd = subMesh.faceOffset + subMesh.faceCount;
+        std::size_t seed = subMesh.faceOffset;
+        ordered.clear();
+
+        while ( ordered.size() < subMesh.faceCount ) {
+            while ( emitted[seed] ) seed++;
+
+            MeshCluster cluster = MeshCluster();
+            cluster.faceOffset = static_cast<std::uint32_t>(subMesh.faceOffset + ordered.size());
+            cluster.faceCount = 0u;
+            cluster.subMesh = static_cast<std::uint32_t>(s);
+
+            std::uint32_t stamp = static_cast<std::uint32_t>(clusters.size());
+            std::size_t clusterVertexCount = 0u;
+            Vector3f normalSum(0.0f, 0.0f, 0.0f), centroidSum(0.0f, 0.0f, 0.0f);
+            float edgeSum = 0.0f;
+            candidates.clear();
+
+            //------------------------------------------------------------------
+            // Grow the cluster from the first face left in the sub-mesh by the
+            // neighboring face that adds the fewest vertices, then by the one
+            // that keeps the normal cone and the cluster the tightest.
+            //------------------------------------------------------------------
+            std::size_t face = seed;
+            while ( face != CLUSTER_NONE ) {
+                emitted[face] = 1u;
+                ordered.push_back(faces[face]);
+                cluster.faceCount++;
+                normalSum = normalSum + normals[face];
+                centroidSum = centroidSum + centroids[face];
+                edgeSum += static_cast<float>(vertices[faces[face][0]].position.distance(vertices[faces[face][1]].position));
+
+                for ( unsigned int k = 0; k < TRIANGLE_EDGE_COUNT; k++ ) {
+                    std::uint32_t vertex = faces[face][k];
+                    if ( stamps[vertex] == stamp ) continue;
+                    stamps[vertex] = stamp;
+                    clusterVertexCount++;
+                    for ( std::uint32_t a = adjacencyOffsets[vertex]; a < adjacencyOffsets[vertex + 1u]; a++ ) {
+                        std::uint32_t neighbor = adjacency[a];
+                        if ( !emitted[neighbor] && neighbor >= subMesh.faceOffset && neighbor < faceEnd ) candidates.push_back(neighbor);
+                    }
+                }
+
+                face = CLUSTER_NONE;
+                if ( cluster.faceCount == MESH_CLUSTER_MAX_FACES ) break;
+
+                float normalLength = static_cast<float>(normalSum.length());
+                Vector3f axis = (normalLength > 0.0f) ? normalSum / normalLength : normalSum;
+                Vector3f center = centroidSum / static_cast<float>(cluster.faceCount);
+                float edgeLength = std::max(edgeSum / static_cast<float>(cluster.faceCount), 1e-20f);
+
+                float bestScore = 0.0f;
+                std::size_t kept = 0u;
+                for ( std::size_t c = 0; c < candidates.size(); c++ ) {
+                    std::uint32_t candidate = candidates[c];
+                    if ( emitted[candidate] ) continue;
+                    candidates[kept++] = candidate;
+
+                    std::size_t newVertexCount = 0u;
+                    for ( unsigned int k = 0; k < TRIANGLE_EDGE_COUNT; k++ )
+                        if ( stamps[faces[candidate][k]] != stamp ) newVertexCount++;
+                    if ( clusterVertexCount + newVertexCount > MESH_CLUSTER_MAX_VERTICES ) continue;
+
+                    float spread = 1.0f - static_cast<float>(normals[candidate].dot(axis));
+                    float distance = static_cast<float>(centroids[candidate].distance(center)) / edgeLength;
+                    float score = static_cast<float>(newVertexCount) + CLUSTER_CONE_WEIGHT * spread + CLUSTER_DISTANCE_WEIGHT * distance;
+                    if ( face != CLUSTER_NONE && score >= bestScore ) continue;
+                    face = candidate;
+                    bestScore = score;
+                }
+
+                candidates.resize(kept);
+            }
+
+            Clusters_OptimizeVertexCache(ordered, ordered.size() - cluster.faceCount, localIndices, clusterVertices, clusterFaces);
+            clusters.push_back(cluster);
+        }
+
+        //----------------------------------------------------------------------
+        // The faces of the sub-mesh are replaced by the faces of its clusters.
+        //----------------------------------------------------------------------
+        std::copy(ordered.begin(), ordered.end(), faces.begin() + subMesh.faceOffset);
+    }
+
+    for ( std::size_t c = 0; c < clusters.size(); c++ ) Clusters_Finish(vertices.data(), faces.data(), clusters[c]);
+}
+
+std::size_t CullMeshClusters(const std::vector<MeshCluster>& clusters, const std::vector<SubMesh>& subMeshes, const Matrix4f& modelView, const Matrix4f& projection, bool bConeCulling, std::vector<SubMesh>& visibleSubMeshes) {
+    visibleSubMeshes.clear();
+
+    //--------------------------------------------------------------------------
+    // The frustum of the model-view-projection matrix is in object space like
+    // the clusters.
+    //--------------------------------------------------------------------------
+    Frustum frustum(Matrix4f::Multiply(modelView, projection));
+
+    //--------------------------------------------------------------------------
+    // The eye in object space is the translation of the inverse model-view.
+    //--------------------------------------------------------------------------
+    Matrix4f inverseModelView = Matrix4f::Inverse(modelView);
+    const float* inverse = inverseModelView.constData();
+    Vector3f eye(inverse[12] / inverse[15], inverse[13] / inverse[15], inverse[14] / inverse[15]);
+
+    std::size_t visibleFaceCount = 0u;
+    for ( std::size_t c = 0; c < clusters.size(); c++ ) {
+        const MeshCluster& cluster = clusters[c];
+        const Vector3f& center = cluster.center;
+
+        bool bVisible = frustum.intersectsSphere(center, cluster.radius);
+
+        //----------------------------------------------------------------------
+        // Every face of a cluster faces away if the direction from the eye to
+        // any point of its sphere is within the complement of its cone.
+        //----------------------------------------------------------------------
+        if ( bVisible && bConeCulling && cluster.coneCutoff < 1.0f ) {
+            Vector3f direction = center - eye;
+            bVisible = static_cast<float>(direction.dot(cluster.coneAxis)) < cluster.coneCutoff * static_cast<float>(direction.length()) + cluster.radius;
+        }
+
+        if ( !bVisible ) continue;
+
+        //----------------------------------------------------------------------
+        // Consecutive clusters of a sub-mesh are drawn as one range.
+        //----------------------------------------------------------------------
+        if ( visibleSubMeshes.size() != 0 && c > 0 && visibleSubMeshes.back().faceOffset + visibleSubMeshes.back().faceCount == cluster.faceOffset && clusters[c - 1].subMesh == cluster.subMesh ) {
+            SubMesh& range = visibleSubMeshes.back();
+            range.faceCount += cluster.faceCount;
+            range.minIndex = std::min(range.minIndex, cluster.minIndex);
+            range.maxIndex = std::max(range.maxIndex, cluster.maxIndex);
+        }
+        else {
+            SubMesh range = subMeshes[cluster.subMesh];
+            range.faceOffset = cluster.faceOffset;
+            range.faceCount = cluster.faceCount;
+            range.minIndex = cluster.minIndex;
+            range.maxIndex = cluster.maxIndex;
+            visibleSubMeshes.push_back(range);
+        }
+
+        visibleFaceCount += cluster.faceCount;
+    }
+
+    return visibleFaceCount;
+}
+
+}
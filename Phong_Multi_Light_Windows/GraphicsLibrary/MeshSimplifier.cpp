@@ -0,0 +1,558 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+namespace sgpu {
+
+/* Weight of the planes that hold borders and seams in place (per squared edge length). */
+static const double SIMPLIFIER_EDGE_WEIGHT = 10.0;
+
+/* Smallest cosine between the normals of a face before and after a collapse. */
+static const double SIMPLIFIER_MIN_NORMAL_COSINE = 0.25;
+
+/* Largest face count of a level relative to the previous level it is kept for. */
+static const float SIMPLIFIER_MIN_LEVEL_REDUCTION = 0.9f;
+
+static const std::uint32_t SIMPLIFIER_NONE = 0xFFFFFFFFu;
+
+/* How the vertices of a position may collapse. */
+enum Simplifier_Kind {
+    SIMPLIFIER_MANIFOLD,    /* Interior position with one vertex: collapses onto any neighbor. */
+    SIMPLIFIER_BORDER,      /* Position on one open border: collapses along the border. */
+    SIMPLIFIER_SEAM,        /* Interior position with two vertices on one seam: collapses along the seam. */
+    SIMPLIFIER_LOCKED       /* Anything else: never collapses. */
+};
+
+/* Sum of weighted squared distances to a set of planes. */
+struct Simplifier_Quadric {
+    double a00, a11, a22, a01, a02, a12;
+    double b0, b1, b2;
+    double c;
+    double weight;
+};
+
+inline void Simplifier_AddPlane(Simplifier_Quadric& quadric, const double* normal, double distance, double weight) {
+    quadric.a00 += weight * normal[0] * normal[0];
+    quadric.a11 += weight * normal[1] * normal[1];
+    quadric.a22 += weight * normal[2] * normal[2];
+    quadric.a01 += weight * normal[0] * normal[1];
+    quadric.a02 += weight * normal[0] * normal[2];
+    quadric.a12 += weight * normal[1] * normal[2];
+    quadric.b0 += weight * normal[0] * distance;
+    quadric.b1 += weight * normal[1] * distance;
+    quadric.b2 += weight * normal[2] * distance;
+    quadric.c += weight * distance * distance;
+    quadric.weight += weight;
+}
+
+inline void Simplifier_Add(Simplifier_Quadric& quadric, const Simplifier_Quadric& other) {
+    quadric.a00 += other.a00;
+    quadric.a11 += other.a11;
+    quadric.a22 += other.a22;
+    quadric.a01 += other.a01;
+    quadric.a02 += other.a02;
+    quadric.a12 += other.a12;
+    quadric.b0 += other.b0;
+    quadric.b1 += other.b1;
+    quadric.b2 += other.b2;
+    quadric.c += other.c;
+    quadric.weight += other.weight;
+}
+
+/* Mean squared distance of a point from the planes of two quadrics. */
+inline double Simplifier_Error(const Simplifier_Quadric& q, const Simplifier_Quadric& r, const double* p) {
+    double weight = q.weight + r.weight;
+    if ( !(weight > 0.0) ) return 0.0;
+
+    double x = p[0], y = p[1], z = p[2];
+    double error = (q.a00 + r.a00) * x * x + (q.a11 + r.a11) * y * y + (q.a22 + r.a22) * z * z +
+        2.0 * ((q.a01 + r.a01) * x * y + (q.a02 + r.a02) * x * z + (q.a12 + r.a12) * y * z) +
+        2.0 * ((q.b0 + r.b0) * x + (q.b1 + r.b1) * y + (q.b2 + r.b2) * z) + (q.c + r.c);
+    return std::fabs(error) / weight;
+}
+
+inline void Simplifier_Cross(const double* a, const double* b, const double* c, double* normal) {
+    double u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+    double v[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+    normal[0] = u[1] * v[2] - u[2] * v[1];
+    normal[1] = u[2] * v[0] - u[0] * v[2];
+    normal[2] = u[0] * v[1] - u[1] * v[0];
+}
+
+inline std::uint64_t Simplifier_EdgeKey(std::uint32_t a, std::uint32_t b) {
+    return (static_cast<std::uint64_t>(a) << 32) | b;
+}
+
+inline bool Simplifier_HasEdge(const std::vector<std::uint64_t>& edges, std::uint32_t a, std::uint32_t b) {
+    return std::binary_search(edges.begin(), edges.end(), Simplifier_EdgeKey(a, b));
+}
+
+/* Edge collapse of vertex v0 onto vertex v1 (local vertex indices). */
+struct Simplifier_Collapse {
+    std::uint32_t v0;
+    std::uint32_t v1;
+    double error;
+};
+
+/*
+ * Maps every vertex to the first vertex of the same position, and marks the
+ * positions used by more than one sub-mesh.
+ */
+static void Simplifier_MapPositions(const std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces, const std::vector<SubMesh>& subMeshes, std::vector<std::uint32_t>& positionIds, std::vector<unsigned char>& shared) {
+    std::vector<std::uint32_t> order(vertices.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&vertices](std::uint32_t a, std::uint32_t b) {
+        const Vector3f& u = vertices[a].position;
+        const Vector3f& v = vertices[b].position;
+        if ( u.x() != v.x() ) return u.x() < v.x();
+        if ( u.y() != v.y() ) return u.y() < v.y();
+        if ( u.z() != v.z() ) return u.z() < v.z();
+        return a < b;
+    });
+
+    positionIds.resize(vertices.size());
+    for ( std::size_t i = 0; i < order.size(); i++ ) {
+        bool bSame = (i > 0 && vertices[order[i]].position == vertices[order[i - 1]].position);
+        positionIds[order[i]] = bSame ? positionIds[order[i - 1]] : order[i];
+    }
+
+    std::vector<std::uint32_t> owners(vertices.size(), SIMPLIFIER_NONE);
+    shared.assign(vertices.size(), 0u);
+    for ( std::size_t s = 0; s < subMeshes.size(); s++ ) {
+        for ( std::size_t f = subMeshes[s].faceOffset; f < subMeshes[s].faceOffset + subMeshes[s].faceCount; f++ ) {
+            for ( unsigned int k = 0; k < TRIANGLE_EDGE_COUNT; k++ ) {
+                std::uint32_t position = positionIds[faces[f][k]];
+                if ( owners[position] == SIMPLIFIER_NONE ) owners[position] = static_cast<std::uint32_t>(s);
+                else if ( owners[position] != s ) shared[position] = 1u;
+            }
+        }
+    }
+}
+
+/*
+ * Simplifies the faces of one sub-mesh. The vertices of the sub-mesh are
+ * numbered locally; localVertices and localPositions map the mesh vertices
+ * and positions to them and are restored to SIMPLIFIER_NONE before returning.
+ * Returns the largest mean squared error of a collapse.
+ */
+static double Simplifier_SimplifySubMesh(const std::vector<Vertex>& vertices, const std::vector<std::uint32_t>& positionIds, const std::vector<unsigned char>& shared, const TriangleFace* faces, std::size_t faceCount, std::size_t targetFaceCount,
+                                         std::vector<std::uint32_t>& localVertices, std::vector<std::uint32_t>& localPositions, std::vector<TriangleFace>& result) {
+    //--------------------------------------------------------------------------
+    // Number the vertices and positions of the sub-mesh. The vertices of a
+    // position (its wedges) are linked in a circular list.
+    //--------------------------------------------------------------------------
+    std::vector<std::uint32_t> vertexIds, positionVertices;
+    std::vector<std::uint32_t> indices(faceCount * TRIANGLE_EDGE_COUNT);
+    std::vector<std::uint32_t> positions, wedges, firstWedges;
+    for ( std::size_t i = 0; i < indices.size(); i++ ) {
+        std::uint32_t vertex = faces[i / TRIANGLE_EDGE_COUNT][i % TRIANGLE_EDGE_COUNT];
+        if ( localVertices[vertex] == SIMPLIFIER_NONE ) {
+            std::uint32_t position = positionIds[vertex];
+            std::uint32_t local = static_cast<std::uint32_t>(vertexIds.size());
+            localVertices[vertex] = local;
+            vertexIds.push_back(vertex);
+            wedges.push_back(local);
+
+            if ( localPositions[position] == SIMPLIFIER_NONE ) {
+                localPositions[position] = static_cast<std::uint32_t>(positionVertices.size());
+                positionVertices.push_back(position);
+                firstWedges.push_back(local);
+            }
+            else {
+                std::uint32_t first = firstWedges[localPositions[position]];
+                wedges[local] = wedges[first];
+                wedges[first] = local;
+            }
+
+            positions.push_back(localPositions[position]);
+        }
+
+        indices[i] = localVertices[vertex];
+    }
+
+    std::size_t vertexCount = vertexIds.size();
+    std::size_t positionCount = positionVertices.size();
+    std::vector<double> coordinates(positionCount * 3u);
+    std::vector<unsigned char> locked(positionCount);
+    for ( std::size_t p = 0; p < positionCount; p++ ) {
+        const Vector3f& position = vertices[positionVertices[p]].position;
+        for ( unsigned int k = 0; k < 3; k++ ) coordinates[3 * p + k] = position[k];
+        locked[p] = shared[positionVertices[p]];
+    }
+
+    for ( std::size_t v = 0; v < vertexCount; v++ ) localVertices[vertexIds[v]] = SIMPLIFIER_NONE;
+    for ( std::size_t p = 0; p < positionCount; p++ ) localPositions[positionVertices[p]] = SIMPLIFIER_NONE;
+
+    //--------------------------------------------------------------------------
+    // Every position starts with the planes of its faces, weighted by area.
+    //--------------------------------------------------------------------------
+    std::vector<Simplifier_Quadric> quadrics(positionCount, Simplifier_Quadric());
+    for ( std::size_t f = 0; f < faceCount; f++ ) {
+        const double* corners[3];
+        for ( unsigned int k = 0; k < 3; k++ ) corners[k] = &coordinates[3 * positions[indices[3 * f + k]]];
+
+        double normal[3];
+        Simplifier_Cross(corners[0], corners[1], corners[2], normal);
+        double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if ( !(length > 0.0) ) continue;
+
+        for ( unsigned int k = 0; k < 3; k++ ) normal[k] /= length;
+        double distance = -(normal[0] * corners[0][0] + normal[1] * corners[0][1] + normal[2] * corners[0][2]);
+        for ( unsigned int k = 0; k < 3; k++ ) Simplifier_AddPlane(quadrics[positions[indices[3 * f + k]]], normal, distance, 0.5 * length);
+    }
+
+    std::vector<std::uint64_t> vertexEdges, positionEdges;
+    std::vector<unsigned char> edgeFlags, used(vertexCount), kinds(positionCount), ringLocked(positionCount);
+    std::vector<std::uint32_t> openOut(vertexCount), openIn(vertexCount), borderOut(positionCount), borderIn(positionCount);
+    std::vector<std::uint32_t> adjacencyOffsets(positionCount + 1), adjacency, remap(vertexCount);
+    std::vector<Simplifier_Collapse> collapses;
+    double maxError = 0.0;
+    bool bEdgePlanes = false;
+
+    std::size_t currentFaceCount = faceCount;
+    while ( currentFaceCount > targetFaceCount ) {
+        //----------------------------------------------------------------------
+        // Half-edges of the current faces by vertex and by position. A half-
+        // edge without its opposite is open (bit 0): a border if it is also
+        // open by position (bit 1), otherwise a seam.
+        //----------------------------------------------------------------------
+        vertexEdges.resize(indices.size());
+        positionEdges.resize(indices.size());
+        for ( std::size_t i = 0; i < indices.size(); i++ ) {
+            std::uint32_t a = indices[i];
+            std::uint32_t b = indices[i - i % 3 + (i + 1) % 3];
+            vertexEdges[i] = Simplifier_EdgeKey(a, b);
+            positionEdges[i] = Simplifier_EdgeKey(positions[a], positions[b]);
+        }
+
+        std::sort(vertexEdges.begin(), vertexEdges.end());
+        std::sort(positionEdges.begin(), positionEdges.end());
+
+        std::fill(used.begin(), used.end(), 0u);
+        std::fill(openOut.begin(), openOut.end(), 0u);
+        std::fill(openIn.begin(), openIn.end(), 0u);
+        std::fill(borderOut.begin(), borderOut.end(), 0u);
+        std::fill(borderIn.begin(), borderIn.end(), 0u);
+        edgeFlags.resize(indices.size());
+        for ( std::size_t i = 0; i < indices.size(); i++ ) {
+            std::uint32_t a = indices[i];
+            std::uint32_t b = indices[i - i % 3 + (i + 1) % 3];
+            bool bOpen = !Simplifier_HasEdge(vertexEdges, b, a);
+            bool bBorder = !Simplifier_HasEdge(positionEdges, positions[b], positions[a]);
+            edgeFlags[i] = (bOpen ? 1u : 0u) | (bBorder ? 2u : 0u);
+            used[a] = 1u;
+            if ( bOpen ) {
+                openOut[a]++;
+                openIn[b]++;
+            }
+
+            if ( bBorder ) {
+                borderOut[positions[a]]++;
+                borderIn[positions[b]]++;
+            }
+
+            //------------------------------------------------------------------
+            // Open edges of the original faces add a plane through the edge
+            // perpendicular to their face, which holds borders and seams.
+            //------------------------------------------------------------------
+            if ( bOpen && !bEdgePlanes ) {
+                const double* corners[3];
+                for ( unsigned int k = 0; k < 3; k++ ) corners[k] = &coordinates[3 * positions[indices[i - i % 3 + k]]];
+                const double* ca = &coordinates[3 * positions[a]];
+                const double* cb = &coordinates[3 * positions[b]];
+
+                double normal[3], edge[3] = { cb[0] - ca[0], cb[1] - ca[1], cb[2] - ca[2] };
+                Simplifier_Cross(corners[0], corners[1], corners[2], normal);
+                double plane[3] = { edge[1] * normal[2] - edge[2] * normal[1], edge[2] * normal[0] - edge[0] * normal[2], edge[0] * normal[1] - edge[1] * normal[0] };
+                double length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+                if ( length > 0.0 ) {
+                    for ( unsigned int k = 0; k < 3; k++ ) plane[k] /= length;
+                    double distance = -(plane[0] * ca[0] + plane[1] * ca[1] + plane[2] * ca[2]);
+                    double weight = (edge[0] * edge[0] + edge[1] * edge[1] + edge[2] * edge[2]) * SIMPLIFIER_EDGE_WEIGHT;
+                    Simplifier_AddPlane(quadrics[positions[a]], plane, distance, weight);
+                    Simplifier_AddPlane(quadrics[positions[b]], plane, distance, weight);
+                }
+            }
+        }
+
+        bEdgePlanes = true;
+
+        //----------------------------------------------------------------------
+        // Classify the positions by their vertices still in use.
+        //----------------------------------------------------------------------
+        for ( std::size_t p = 0; p < positionCount; p++ ) {
+            std::uint32_t wedgeCount = 0u;
+            bool bSingleSeam = true;
+            std::uint32_t v = firstWedges[p];
+            do {
+                if ( used[v] ) {
+                    wedgeCount++;
+                    if ( openOut[v] != 1u || openIn[v] != 1u ) bSingleSeam = false;
+                }
+
+                v = wedges[v];
+            } while ( v != firstWedges[p] );
+
+            bool bBorder = (borderOut[p] != 0u || borderIn[p] != 0u);
+            bool bSingleBorder = (borderOut[p] == 1u && borderIn[p] == 1u);
+            kinds[p] = SIMPLIFIER_LOCKED;
+            if ( locked[p] || wedgeCount == 0u ) continue;
+
+            if ( wedgeCount == 1u ) {
+                std::uint32_t w = firstWedges[p];
+                while ( !used[w] ) w = wedges[w];
+                if ( !bBorder && openOut[w] == 0u && openIn[w] == 0u ) kinds[p] = SIMPLIFIER_MANIFOLD;
+                else if ( bSingleBorder && bSingleSeam ) kinds[p] = SIMPLIFIER_BORDER;
+            }
+            else if ( wedgeCount == 2u && !bBorder && bSingleSeam ) kinds[p] = SIMPLIFIER_SEAM;
+        }
+
+        //----------------------------------------------------------------------
+        // Faces around each position.
+        //----------------------------------------------------------------------
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0u);
+        for ( std::size_t i = 0; i < indices.size(); i++ ) adjacencyOffsets[positions[indices[i]] + 1]++;
+        for ( std::size_t p = 0; p < positionCount; p++ ) adjacencyOffsets[p + 1] += adjacencyOffsets[p];
+        adjacency.resize(indices.size());
+        for ( std::size_t i = 0; i < indices.size(); i++ ) adjacency[adjacencyOffsets[positions[indices[i]]]++] = static_cast<std::uint32_t>(i / 3);
+        for ( std::size_t p = positionCount; p > 0; p-- ) adjacencyOffsets[p] = adjacencyOffsets[p - 1];
+        adjacencyOffsets[0] = 0u;
+
+        //----------------------------------------------------------------------
+        // Candidate collapses along every edge the vertex kinds allow, cheapest
+        // first. A collapse moves its vertex onto the other end of the edge.
+        // Edges inside the sub-mesh are visited from one of their two faces.
+        //----------------------------------------------------------------------
+        collapses.clear();
+        for ( std::size_t i = 0; i < indices.size(); i++ ) {
+            std::uint32_t a = indices[i];
+            std::uint32_t b = indices[i - i % 3 + (i + 1) % 3];
+            bool bOpen = (edgeFlags[i] & 1u) != 0u;
+            bool bBorder = (edgeFlags[i] & 2u) != 0u;
+            if ( !bBorder && positions[a] > positions[b] ) continue;
+            for ( unsigned int direction = 0; direction < 2; direction++ ) {
+                std::uint32_t v0 = direction ? b : a;
+                std::uint32_t v1 = direction ? a : b;
+                unsigned char kind0 = kinds[positions[v0]];
+                unsigned char kind1 = kinds[positions[v1]];
+
+                bool bAllowed = (kind0 == SIMPLIFIER_MANIFOLD);
+                if ( kind0 == SIMPLIFIER_BORDER ) bAllowed = bBorder && (kind1 == SIMPLIFIER_BORDER || kind1 == SIMPLIFIER_LOCKED);
+                if ( kind0 == SIMPLIFIER_SEAM ) bAllowed = bOpen && !bBorder && (kind1 == SIMPLIFIER_SEAM || kind1 == SIMPLIFIER_LOCKED);
+                if ( !bAllowed ) continue;
+
+                Simplifier_Collapse collapse;
+                collapse.v0 = v0;
+                collapse.v1 = v1;
+                collapse.error = Simplifier_Error(quadrics[positions[v0]], quadrics[positions[v1]], &coordinates[3 * positions[v1]]);
+                collapses.push_back(collapse);
+            }
+        }
+
+        std::sort(collapses.begin(), collapses.end(), [](const Simplifier_Collapse& a, const Simplifier_Collapse& b) { return a.error < b.error; });
+
+        //----------------------------------------------------------------------
+        // Apply the collapses until enough faces are removed. The positions of
+        // the faces around a collapsed position are locked for the rest of
+        // the pass, so no face changes twice.
+        //----------------------------------------------------------------------
+        std::iota(remap.begin(), remap.end(), 0u);
+        std::fill(ringLocked.begin(), ringLocked.end(), 0u);
+        std::size_t excess = currentFaceCount - targetFaceCount;
+        std::size_t removed = 0u, applied = 0u;
+        for ( std::size_t c = 0; c < collapses.size() && removed < excess; c++ ) {
+            const Simplifier_Collapse& collapse = collapses[c];
+            std::uint32_t p0 = positions[collapse.v0];
+            std::uint32_t p1 = positions[collapse.v1];
+            if ( ringLocked[p0] || ringLocked[p1] ) continue;
+
+            bool bValid = true;
+            std::size_t faceRemoved = 0u;
+            for ( std::uint32_t j = adjacencyOffsets[p0]; j < adjacencyOffsets[p0 + 1] && bValid; j++ ) {
+                const std::uint32_t* face = &indices[3 * adjacency[j]];
+                std::uint32_t corners[3] = { positions[face[0]], positions[face[1]], positions[face[2]] };
+                if ( corners[0] == p1 || corners[1] == p1 || corners[2] == p1 ) {
+                    faceRemoved++;
+                    continue;
+                }
+
+                double before[3], after[3];
+                Simplifier_Cross(&coordinates[3 * corners[0]], &coordinates[3 * corners[1]], &coordinates[3 * corners[2]], before);
+                for ( unsigned int k = 0; k < 3; k++ ) if ( corners[k] == p0 ) corners[k] = p1;
+                Simplifier_Cross(&coordinates[3 * corners[0]], &coordinates[3 * corners[1]], &coordinates[3 * corners[2]], after);
+
+                double dot = before[0] * after[0] + before[1] * after[1] + before[2] * after[2];
+                double lengths = std::sqrt((before[0] * before[0] + before[1] * before[1] + before[2] * before[2]) * (after[0] * after[0] + after[1] * after[1] + after[2] * after[2]));
+                if ( dot <= SIMPLIFIER_MIN_NORMAL_COSINE * lengths ) bValid = false;
+            }
+
+            if ( !bValid ) continue;
+
+            //------------------------------------------------------------------
+            // The other vertex of a seam collapses onto the vertex of the
+            // target position it shares a seam edge with.
+            //------------------------------------------------------------------
+            std::uint32_t w0 = SIMPLIFIER_NONE;
+            std::uint32_t w1 = SIMPLIFIER_NONE;
+            if ( kinds[p0] == SIMPLIFIER_SEAM ) {
+                w0 = wedges[collapse.v0];
+                while ( !used[w0] ) w0 = wedges[w0];
+
+                std::uint32_t x = collapse.v1;
+                do {
+                    if ( used[x] && (Simplifier_HasEdge(vertexEdges, w0, x) || Simplifier_HasEdge(vertexEdges, x, w0)) ) w1 = x;
+                    x = wedges[x];
+                } while ( x != collapse.v1 && w1 == SIMPLIFIER_NONE );
+
+                if ( w1 == SIMPLIFIER_NONE ) continue;
+            }
+
+            remap[collapse.v0] = collapse.v1;
+            if ( w0 != SIMPLIFIER_NONE ) remap[w0] = w1;
+            Simplifier_Add(quadrics[p1], quadrics[p0]);
+            for ( std::uint32_t j = adjacencyOffsets[p0]; j < adjacencyOffsets[p0 + 1]; j++ ) {
+                const std::uint32_t* face = &indices[3 * adjacency[j]];
+                for ( unsigned int k = 0; k < 3; k++ ) ringLocked[positions[face[k]]] = 1u;
+            }
+
+            maxError = std::max(maxError, collapse.error);
+            removed += faceRemoved;
+            applied++;
+        }
+
+        if ( applied == 0u ) break;
+
+        //----------------------------------------------------------------------
+        // Remap the faces and drop those that collapsed into an edge.
+        //----------------------------------------------------------------------
+        std::size_t written = 0u;
+        for ( std::size_t f = 0; f < currentFaceCount; f++ ) {
+            std::uint32_t a = remap[indices[3 * f + 0]];
+            std::uint32_t b = remap[indices[3 * f + 1]];
+            std::uint32_t c = remap[indices[3 * f + 2]];
+            if ( positions[a] == positions[b] || positions[b] == positions[c] || positions[a] == positions[c] ) continue;
+            indices[3 * written + 0] = a;
+            indices[3 * written + 1] = b;
+            indices[3 * written + 2] = c;
+            written++;
+        }
+
+        indices.resize(3 * written);
+        currentFaceCount = written;
+    }
+
+    for ( std::size_t f = 0; f < currentFaceCount; f++ ) {
+        TriangleFace face;
+        for ( unsigned int k = 0; k < 3; k++ ) face.indices[k] = vertexIds[indices[3 * f + k]];
+        result.push_back(face);
+    }
+
+    return maxError;
+}
+
+float SimplifyMesh(const std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces, const std::vector<SubMesh>& subMeshes, float ratio, std::vector<TriangleFace>& simplifiedFaces, std::vector<SubMesh>& simplifiedSubMeshes) {
+    simplifiedFaces.clear();
+    simplifiedSubMeshes = subMeshes;
+
+    std::vector<std::uint32_t> positionIds;
+    std::vector<unsigned char> shared;
+    Simplifier_MapPositions(vertices, faces, subMeshes, positionIds, shared);
+
+    std::vector<std::uint32_t> localVertices(vertices.size(), SIMPLIFIER_NONE);
+    std::vector<std::uint32_t> localPositions(vertices.size(), SIMPLIFIER_NONE);
+    double error = 0.0;
+    for ( std::size_t s = 0; s < subMeshes.size(); s++ ) {
+        std::size_t faceOffset = simplifiedFaces.size();
+        std::size_t targetFaceCount = static_cast<std::size_t>(std::ceil(static_cast<double>(subMeshes[s].faceCount) * ratio));
+        double subMeshError = Simplifier_SimplifySubMesh(vertices, positionIds, shared, faces.data() + subMeshes[s].faceOffset, subMeshes[s].faceCount, targetFaceCount, localVertices, localPositions, simplifiedFaces);
+
+        error = std::max(error, subMeshError);
+        simplifiedSubMeshes[s].faceOffset = static_cast<std::uint32_t>(faceOffset);
+        simplifiedSubMeshes[s].faceCount = static_cast<std::uint32_t>(simplifiedFaces.size() - faceOffset);
+    }
+
+    return static_cast<float>(std::sqrt(error));
+}
+
+void BuildMeshLods(const std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces, const std::vector<SubMesh>& subMeshes, MeshLodChain& chain) {
+    chain.levels.clear();
+    for ( unsigned int k = 0; k < 3; k++ ) {
+        chain.boundsMinimum[k] = vertices.size() > 0 ? vertices[0].position[k] : 0.0f;
+        chain.boundsMaximum[k] = chain.boundsMinimum[k];
+    }
+
+    for ( std::size_t i = 1; i < vertices.size(); i++ ) {
+        for ( unsigned int k = 0; k < 3; k++ ) {
+            chain.boundsMinimum[k] = std::min(chain.boundsMinimum[k], vertices[i].position[k]);
+            chain.boundsMaximum[k] = std::max(chain.boundsMaximum[k], vertices[i].position[k]);
+        }
+    }
+
+    std::size_t faceCount = faces.size();
+    std::size_t levelCount = 0u;
+    float ratio = MESH_LOD_REDUCTION;
+    while ( subMeshes.size() != 0 && levelCount < MESH_LOD_MAX_LEVELS && static_cast<float>(faceCount) * ratio >= static_cast<float>(MESH_LOD_MIN_FACES) ) {
+        ratio *= MESH_LOD_REDUCTION;
+        levelCount++;
+    }
+
+    //--------------------------------------------------------------------------
+    // The levels do not depend on each other, so they are simplified from the
+    // mesh in parallel.
+    //--------------------------------------------------------------------------
+    std::vector<std::vector<TriangleFace>> levelFaces(levelCount);
+    std::vector<std::vector<SubMesh>> levelSubMeshes(levelCount);
+    std::vector<float> levelErrors(levelCount);
+    ParallelFor(levelCount, [&](std::size_t level) {
+        float levelRatio = std::pow(MESH_LOD_REDUCTION, static_cast<float>(level + 1));
+        levelErrors[level] = SimplifyMesh(vertices, faces, subMeshes, levelRatio, levelFaces[level], levelSubMeshes[level]);
+    });
+
+    std::size_t previousFaceCount = faceCount;
+    float previousError = 0.0f;
+    for ( std::size_t level = 0; level < levelCount; level++ ) {
+        if ( static_cast<float>(levelFaces[level].size()) > static_cast<float>(previousFaceCount) * SIMPLIFIER_MIN_LEVEL_REDUCTION ) continue;
+
+        MeshLod lod;
+        lod.error = std::max(levelErrors[level], previousError);
+        lod.subMeshes = levelSubMeshes[level];
+
+        std::size_t faceOffset = faces.size();
+        faces.insert(faces.end(), levelFaces[level].begin(), levelFaces[level].end());
+        for ( std::size_t s = 0; s < lod.subMeshes.size(); s++ ) {
+            lod.subMeshes[s].faceOffset += static_cast<std::uint32_t>(faceOffset);
+            OptimizeVertexCache(faces, lod.subMeshes[s].faceOffset, lod.subMeshes[s].faceCount, vertices.size());
+        }
+
+        previousFaceCount = levelFaces[level].size();
+        previousError = lod.error;
+        chain.levels.push_back(lod);
+    }
+}
+
+}
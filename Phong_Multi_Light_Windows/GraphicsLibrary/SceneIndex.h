@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef SCENE_INDEX_H
+#define SCENE_INDEX_H
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "Mesh.h"
+#include "Frustum.h"
+
+namespace sgpu {
+
+/*
+ * Node of a SceneIndex. An inner node (count 0) has its two children at
+ * offset and offset + 1; a leaf holds the count meshes of batch offset. The
+ * box contains the world space boxes of the meshes below the node.
+ */
+struct SceneIndexNode {
+    float boundsMinimum[3];
+    std::uint32_t offset;
+    float boundsMaximum[3];
+    std::uint32_t count;
+};
+
+/*
+ * World space bounding spheres of the meshes of a leaf, stored component by
+ * component so they are tested together (see Frustum::intersectSpheres).
+ * Meshes are indices into the meshes the index was built from.
+ */
+struct SceneIndexBatch {
+    float x[FRUSTUM_BATCH_SIZE];
+    float y[FRUSTUM_BATCH_SIZE];
+    float z[FRUSTUM_BATCH_SIZE];
+    float radius[FRUSTUM_BATCH_SIZE];
+    std::uint32_t meshes[FRUSTUM_BATCH_SIZE];
+};
+
+/*
+ * Bounding volume hierarchy over the world space bounds of the meshes of a
+ * scene (see Mesh::getWorldBounds) for frustum culling. The meshes are split
+ * at the median of their centers along the longest axis until at most
+ * FRUSTUM_BATCH_SIZE meshes remain, which form a leaf. Culling skips every
+ * subtree whose box is outside of the frustum and stops testing the planes
+ * a box is entirely inside of, so the cost grows with the number of visible
+ * meshes rather than with the size of the scene.
+ *
+ * The index shares ownership of its meshes. Meshes whose bounds are not known
+ * when the index is built (ex. lazy meshes without a header) are always
+ * visible.
+ */
+class SceneIndex {
+public:
+    SceneIndex();
+    ~SceneIndex();
+
+    /* Builds the hierarchy over the meshes, replacing any previous one. */
+    void build(const std::vector<std::shared_ptr<Mesh>>& meshes);
+
+    /*
+     * Updates the bounds of every node after meshes have moved, keeping the
+     * hierarchy. Culling becomes less efficient as meshes move away from
+     * their neighbors in the hierarchy; build it again then.
+     */
+    void refit();
+
+    /*
+     * Finds the meshes that may be visible in a world space frustum.
+     *
+     * @param visible - Receives the indices (into the meshes the index was
+     * built from) of the meshes that are not outside of the frustum.
+     *
+     * @return Returns the number of visible meshes.
+     */
+    std::size_t cull(const Frustum& frustum, std::vector<std::size_t>& visible) const;
+
+    /* Releases the hierarchy and the meshes. */
+    void clear();
+
+    bool isEmpty() const;
+    std::size_t getMeshCount() const;
+    std::size_t getNodeCount() const;
+    const std::vector<SceneIndexNode>& getNodes() const;
+
+protected:
+    std::vector<std::shared_ptr<Mesh>> meshes;
+    std::vector<SceneIndexNode> nodes;
+    std::vector<SceneIndexBatch> batches;
+
+    /* Meshes whose bounds were not known when the index was built. */
+    std::vector<std::uint32_t> unbounded;
+};
+
+}
+
+#endif
@@ -0,0 +1,922 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "MeshCodec.h"
+#include "ParallelFor.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MESH_CODEC_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace sgpu {
+
+static const char MESH_CODEC_MAGIC[4] = { 'S', 'G', 'M', 'Z' };
+static const std::size_t MESH_CODEC_ALIGNMENT = 4u;
+
+/* Static rANS coder: 12-bit probabilities, 32-bit states, byte output. */
+static const std::size_t MESH_CODEC_SYMBOL_COUNT = 256u;
+static const std::uint32_t MESH_CODEC_PROBABILITY_BITS = 12u;
+static const std::uint32_t MESH_CODEC_PROBABILITY_SCALE = 1u << MESH_CODEC_PROBABILITY_BITS;
+static const std::uint32_t MESH_CODEC_RANS_LOWER_BOUND = 1u << 23;
+
+/* Number of interleaved rANS states; symbol i is coded by state i % lanes. */
+static const std::size_t MESH_CODEC_RANS_LANES = 4u;
+
+/* Most bytes a group of one symbol per lane renormalizes (2 per symbol). */
+static const std::size_t MESH_CODEC_RANS_GROUP_BYTES = 2 * MESH_CODEC_RANS_LANES;
+
+/* Variable length integers per face (indices) or vertex of each stream. */
+static const std::uint32_t MESH_CODEC_STREAM_INTEGERS[MESH_CODEC_STREAM_COUNT] = { 3u, 3u, 2u, 3u, 3u, 3u };
+
+/*
+ * Zero bytes appended to a decoded stream. A vertex or face reads at most
+ * three variable length integers from a stream before it is bounds checked.
+ */
+static const std::size_t MESH_CODEC_STREAM_PADDING = 32u;
+
+/* Decoding table entry of one rANS slot. */
+struct Codec_Slot {
+    std::uint16_t frequency;
+    std::uint16_t bias;
+    unsigned char symbol;
+};
+
+inline std::size_t Codec_Align(std::size_t offset) {
+    return (offset + MESH_CODEC_ALIGNMENT - 1) / MESH_CODEC_ALIGNMENT * MESH_CODEC_ALIGNMENT;
+}
+
+inline std::uint64_t Codec_ZigZag(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+inline std::int64_t Codec_UnZigZag(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1u);
+}
+
+inline void Codec_WriteVarint(std::vector<unsigned char>& bytes, std::uint64_t value) {
+    while ( value >= 0x80u ) {
+        bytes.push_back(static_cast<unsigned char>(value | 0x80u));
+        value >>= 7;
+    }
+    bytes.push_back(static_cast<unsigned char>(value));
+}
+
+/* Reads a variable length integer of at most 10 bytes (no bounds check). */
+inline std::uint64_t Codec_ReadVarint(const unsigned char*& bytes) {
+    std::uint64_t value = *bytes++;
+    if ( value < 0x80u ) return value;
+
+    value &= 0x7Fu;
+    for ( unsigned int shift = 7u; shift < 64u; shift += 7u ) {
+        std::uint64_t byte = *bytes++;
+        value |= (byte & 0x7Fu) << shift;
+        if ( byte < 0x80u ) break;
+    }
+
+    return value;
+}
+
+/* Reads a variable length integer that must end before the provided end. */
+inline bool Codec_ReadVarint(const unsigned char*& bytes, const unsigned char* end, std::uint64_t& value) {
+    value = 0u;
+    for ( unsigned int shift = 0u; shift < 64u && bytes < end; shift += 7u ) {
+        std::uint64_t byte = *bytes++;
+        value |= (byte & 0x7Fu) << shift;
+        if ( byte < 0x80u ) return true;
+    }
+
+    return false;
+}
+
+/*
+ * Scales the symbol counts of a stream to frequencies that sum up to the
+ * probability scale. Every symbol that occurs keeps a frequency of at least 1.
+ */
+void Codec_NormalizeFrequencies(const std::uint32_t* counts, std::size_t total, std::uint32_t* frequencies) {
+    std::uint32_t sum = 0u;
+    std::size_t largest = 0u;
+    for ( std::size_t s = 0; s < MESH_CODEC_SYMBOL_COUNT; s++ ) {
+        frequencies[s] = 0u;
+        if ( counts[s] == 0u ) continue;
+
+        std::uint64_t scaled = static_cast<std::uint64_t>(counts[s]) * MESH_CODEC_PROBABILITY_SCALE / total;
+        frequencies[s] = std::max(1u, static_cast<std::uint32_t>(scaled));
+        sum += frequencies[s];
+        if ( counts[s] > counts[largest] ) largest = s;
+    }
+
+    if ( sum < MESH_CODEC_PROBABILITY_SCALE ) frequencies[largest] += MESH_CODEC_PROBABILITY_SCALE - sum;
+    while ( sum > MESH_CODEC_PROBABILITY_SCALE ) {
+        std::size_t s = static_cast<std::size_t>(std::max_element(frequencies, frequencies + MESH_CODEC_SYMBOL_COUNT) - frequencies);
+        std::uint32_t reduction = std::min(frequencies[s] - 1u, sum - MESH_CODEC_PROBABILITY_SCALE);
+        frequencies[s] -= reduction;
+        sum -= reduction;
+    }
+}
+
+/*
+ * Entropy codes a stream: a 256 bit mask of the byte values that occur, their
+ * frequencies minus one (variable length integers), and the rANS coded bytes.
+ * The symbols are coded in reverse so the decoder reads the output front to
+ * back. A stream that does not get smaller is stored as is.
+ */
+void Codec_EntropyEncode(const std::vector<unsigned char>& raw, std::vector<unsigned char>& encoded) {
+    encoded.clear();
+    if ( raw.size() == 0 ) return;
+
+    std::uint32_t counts[MESH_CODEC_SYMBOL_COUNT] = { 0u };
+    for ( std::size_t i = 0; i < raw.size(); i++ ) counts[raw[i]]++;
+
+    std::uint32_t frequencies[MESH_CODEC_SYMBOL_COUNT];
+    std::uint32_t starts[MESH_CODEC_SYMBOL_COUNT];
+    Codec_NormalizeFrequencies(counts, raw.size(), frequencies);
+    encoded.resize(MESH_CODEC_SYMBOL_COUNT / 8, 0u);
+    for ( std::size_t s = 0, start = 0u; s < MESH_CODEC_SYMBOL_COUNT; s++ ) {
+        starts[s] = static_cast<std::uint32_t>(start);
+        start += frequencies[s];
+        if ( frequencies[s] == 0u ) continue;
+
+        encoded[s / 8] |= static_cast<unsigned char>(1u << (s % 8));
+        Codec_WriteVarint(encoded, frequencies[s] - 1u);
+    }
+
+    //--------------------------------------------------------------------------
+    // A symbol renormalizes at most 2 bytes out of its state.
+    //--------------------------------------------------------------------------
+    std::vector<unsigned char> buffer(2 * raw.size() + MESH_CODEC_RANS_LANES * sizeof(std::uint32_t));
+    unsigned char* end = buffer.data() + buffer.size();
+    unsigned char* output = end;
+
+    std::uint32_t states[MESH_CODEC_RANS_LANES];
+    for ( std::size_t lane = 0; lane < MESH_CODEC_RANS_LANES; lane++ ) states[lane] = MESH_CODEC_RANS_LOWER_BOUND;
+
+    for ( std::size_t i = raw.size(); i-- > 0; ) {
+        std::uint32_t& state = states[i % MESH_CODEC_RANS_LANES];
+        std::uint32_t frequency = frequencies[raw[i]];
+        std::uint32_t maximum = ((MESH_CODEC_RANS_LOWER_BOUND >> MESH_CODEC_PROBABILITY_BITS) << 8) * frequency;
+        while ( state >= maximum ) {
+            *--output = static_cast<unsigned char>(state & 0xFFu);
+            state >>= 8;
+        }
+
+        state = ((state / frequency) << MESH_CODEC_PROBABILITY_BITS) + (state % frequency) + starts[raw[i]];
+    }
+
+    for ( std::size_t lane = MESH_CODEC_RANS_LANES; lane-- > 0; ) {
+        output -= sizeof(std::uint32_t);
+        for ( std::size_t b = 0; b < sizeof(std::uint32_t); b++ )
+            output[b] = static_cast<unsigned char>(states[lane] >> (8 * b));
+    }
+
+    encoded.insert(encoded.end(), output, end);
+    if ( encoded.size() >= raw.size() ) encoded = raw;
+}
+
+/* Decodes one symbol of a state and renormalizes it (at most 2 bytes). */
+inline unsigned char Codec_DecodeSymbol(std::uint32_t& state, const Codec_Slot* slots, const unsigned char*& bytes) {
+    const Codec_Slot slot = slots[state & (MESH_CODEC_PROBABILITY_SCALE - 1u)];
+    std::uint32_t x = slot.frequency * (state >> MESH_CODEC_PROBABILITY_BITS) + slot.bias;
+    if ( x < MESH_CODEC_RANS_LOWER_BOUND ) {
+        x = (x << 8) | *bytes++;
+        if ( x < MESH_CODEC_RANS_LOWER_BOUND ) x = (x << 8) | *bytes++;
+    }
+
+    state = x;
+    return slot.symbol;
+}
+
+/*
+ * Decodes groups of one symbol per lane, starting at symbol i, while a group
+ * fits into rawSize and the next group starts at or before limit. Returns
+ * the index of the first symbol that was not decoded.
+ */
+inline std::size_t Codec_DecodeGroups(std::uint32_t* states, const Codec_Slot* slots, const unsigned char*& bytes, const unsigned char* limit, unsigned char* raw, std::size_t i, std::size_t rawSize) {
+    static_assert(MESH_CODEC_RANS_LANES == 4u, "[MeshCodec] Error: The decoder unrolls four rANS lanes.");
+    std::uint32_t x0 = states[0], x1 = states[1], x2 = states[2], x3 = states[3];
+    const unsigned char* input = bytes;
+    for ( ; i + MESH_CODEC_RANS_LANES <= rawSize && input <= limit; i += MESH_CODEC_RANS_LANES ) {
+        unsigned char s0 = Codec_DecodeSymbol(x0, slots, input);
+        unsigned char s1 = Codec_DecodeSymbol(x1, slots, input);
+        unsigned char s2 = Codec_DecodeSymbol(x2, slots, input);
+        unsigned char s3 = Codec_DecodeSymbol(x3, slots, input);
+        raw[i + 0] = s0;
+        raw[i + 1] = s1;
+        raw[i + 2] = s2;
+        raw[i + 3] = s3;
+    }
+
+    states[0] = x0;
+    states[1] = x1;
+    states[2] = x2;
+    states[3] = x3;
+    bytes = input;
+    return i;
+}
+
+/* Decodes rawSize bytes of an entropy coded stream (see Codec_EntropyEncode). */
+bool Codec_EntropyDecode(const unsigned char* bytes, std::size_t size, unsigned char* raw, std::size_t rawSize) {
+    if ( size == rawSize ) {
+        if ( rawSize > 0u ) std::memcpy(raw, bytes, rawSize);
+        return true;
+    }
+
+    const unsigned char* end = bytes + size;
+    if ( size < MESH_CODEC_SYMBOL_COUNT / 8 ) return false;
+    const unsigned char* mask = bytes;
+    bytes += MESH_CODEC_SYMBOL_COUNT / 8;
+
+    //--------------------------------------------------------------------------
+    // Frequency table. Each of the 4096 slots maps to its symbol, frequency,
+    // and offset within the symbol.
+    //--------------------------------------------------------------------------
+    Codec_Slot slots[MESH_CODEC_PROBABILITY_SCALE];
+    std::uint32_t start = 0u;
+    for ( std::size_t s = 0; s < MESH_CODEC_SYMBOL_COUNT; s++ ) {
+        if ( (mask[s / 8] & (1u << (s % 8))) == 0u ) continue;
+
+        std::uint64_t frequency = 0u;
+        if ( !Codec_ReadVarint(bytes, end, frequency) ) return false;
+        frequency += 1u;
+        if ( frequency > MESH_CODEC_PROBABILITY_SCALE - start ) return false;
+
+        for ( std::uint32_t slot = 0u; slot < frequency; slot++ ) {
+            slots[start + slot].frequency = static_cast<std::uint16_t>(frequency);
+            slots[start + slot].bias = static_cast<std::uint16_t>(slot);
+            slots[start + slot].symbol = static_cast<unsigned char>(s);
+        }
+
+        start += static_cast<std::uint32_t>(frequency);
+    }
+
+    if ( start != MESH_CODEC_PROBABILITY_SCALE ) return false;
+    if ( static_cast<std::size_t>(end - bytes) < MESH_CODEC_RANS_LANES * sizeof(std::uint32_t) ) return false;
+
+    std::uint32_t states[MESH_CODEC_RANS_LANES];
+    for ( std::size_t lane = 0; lane < MESH_CODEC_RANS_LANES; lane++ ) {
+        states[lane] = 0u;
+        for ( std::size_t b = 0; b < sizeof(std::uint32_t); b++ )
+            states[lane] |= static_cast<std::uint32_t>(*bytes++) << (8 * b);
+    }
+
+    //--------------------------------------------------------------------------
+    // Groups of symbols are decoded while at least a group worth of bytes
+    // (2 per symbol) remains. The last bytes are copied into a zero padded
+    // buffer so the remaining symbols are decoded without bounds checks; a
+    // valid stream consumes exactly those bytes.
+    //--------------------------------------------------------------------------
+    std::size_t i = 0;
+    if ( static_cast<std::size_t>(end - bytes) >= MESH_CODEC_RANS_GROUP_BYTES )
+        i = Codec_DecodeGroups(states, slots, bytes, end - MESH_CODEC_RANS_GROUP_BYTES, raw, 0, rawSize);
+
+    std::size_t remaining = static_cast<std::size_t>(end - bytes);
+    if ( remaining > MESH_CODEC_RANS_GROUP_BYTES ) return false;
+
+    unsigned char tail[3 * MESH_CODEC_RANS_GROUP_BYTES] = { 0u };
+    std::memcpy(tail, bytes, remaining);
+    bytes = tail;
+    i = Codec_DecodeGroups(states, slots, bytes, tail + remaining, raw, i, rawSize);
+    if ( static_cast<std::size_t>(bytes - tail) > remaining ) return false;
+
+    for ( ; i < rawSize; i++ ) raw[i] = Codec_DecodeSymbol(states[i % MESH_CODEC_RANS_LANES], slots, bytes);
+    if ( static_cast<std::size_t>(bytes - tail) != remaining ) return false;
+
+    //--------------------------------------------------------------------------
+    // The states of a valid stream end where the encoder started them.
+    //--------------------------------------------------------------------------
+    for ( std::size_t lane = 0; lane < MESH_CODEC_RANS_LANES; lane++ )
+        if ( states[lane] != MESH_CODEC_RANS_LOWER_BOUND ) return false;
+
+    return true;
+}
+
+/* Smallest number of stream bytes worth coding on several threads. */
+static const std::size_t MESH_CODEC_MIN_PARALLEL_SIZE = 1u << 16;
+
+/* Bounds and step of three components quantized with the provided bits. */
+template <typename Component>
+void Codec_FitQuantization(const std::vector<Vertex>& vertices, Component component, unsigned int bits, float* minimum, float* step) {
+    float maximum[3];
+    for ( std::size_t k = 0; k < 3; k++ ) {
+        minimum[k] = vertices.size() > 0 ? component(vertices[0], k) : 0.0f;
+        maximum[k] = minimum[k];
+    }
+
+    for ( std::size_t i = 0; i < vertices.size(); i++ ) {
+        for ( std::size_t k = 0; k < 3; k++ ) {
+            float value = component(vertices[i], k);
+            if ( value < minimum[k] ) minimum[k] = value;
+            if ( value > maximum[k] ) maximum[k] = value;
+        }
+    }
+
+    float levels = static_cast<float>((1u << bits) - 1u);
+    for ( std::size_t k = 0; k < 3; k++ )
+        step[k] = (maximum[k] > minimum[k]) ? (maximum[k] - minimum[k]) / levels : 0.0f;
+}
+
+inline std::int64_t Codec_Quantize(float value, float minimum, float step, unsigned int bits) {
+    if ( !(step > 0.0f) ) return 0;
+    double quantized = std::floor((static_cast<double>(value) - minimum) / step + 0.5);
+    return static_cast<std::int64_t>(std::min(std::max(quantized, 0.0), static_cast<double>((1u << bits) - 1u)));
+}
+
+/* Octahedral quantization of a direction; zero vectors map to (0, 0, 1). */
+inline void Codec_EncodeOctahedral(float x, float y, float z, unsigned int bits, std::int64_t* quantized) {
+    float sum = std::fabs(x) + std::fabs(y) + std::fabs(z);
+    if ( !(sum > 0.0f) ) {
+        quantized[0] = quantized[1] = 0;
+        return;
+    }
+
+    float u = x / sum;
+    float v = y / sum;
+    if ( z < 0.0f ) {
+        float foldedU = (1.0f - std::fabs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+        float foldedV = (1.0f - std::fabs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+        u = foldedU;
+        v = foldedV;
+    }
+
+    float scale = static_cast<float>((1u << (bits - 1u)) - 1u);
+    quantized[0] = static_cast<std::int64_t>(std::lround(std::min(std::max(u, -1.0f), 1.0f) * scale));
+    quantized[1] = static_cast<std::int64_t>(std::lround(std::min(std::max(v, -1.0f), 1.0f) * scale));
+}
+
+inline void Codec_DecodeOctahedral(std::int32_t qu, std::int32_t qv, float inverseScale, float* direction) {
+    float u = static_cast<float>(qu) * inverseScale;
+    float v = static_cast<float>(qv) * inverseScale;
+    float z = 1.0f - std::fabs(u) - std::fabs(v);
+    if ( z < 0.0f ) {
+        float foldedU = (1.0f - std::fabs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+        float foldedV = (1.0f - std::fabs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+        u = foldedU;
+        v = foldedV;
+    }
+
+    float inverseLength = 1.0f / std::sqrt(u * u + v * v + z * z);
+    direction[0] = u * inverseLength;
+    direction[1] = v * inverseLength;
+    direction[2] = z * inverseLength;
+}
+
+/* Writes the residuals of every vertex to the previous vertex. */
+inline void Codec_WriteResiduals(std::vector<unsigned char>& raw, const std::int64_t* quantized, std::int64_t* previous, std::size_t count) {
+    for ( std::size_t k = 0; k < count; k++ ) {
+        Codec_WriteVarint(raw, Codec_ZigZag(quantized[k] - previous[k]));
+        previous[k] = quantized[k];
+    }
+}
+
+/* Builds the variable length integers of one stream (see MeshCodecStream). */
+void Codec_WriteStream(std::size_t stream, const MeshCodecHeader& header, const std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces, std::vector<unsigned char>& raw) {
+    raw.clear();
+    std::int64_t previous[3] = { 0, 0, 0 };
+    std::int64_t quantized[3] = { 0, 0, 0 };
+
+    if ( stream == MESH_CODEC_INDICES ) {
+        //----------------------------------------------------------------------
+        // Distance of every index to the next vertex that is not referenced
+        // yet: zero for a new vertex, small for recently referenced ones.
+        //----------------------------------------------------------------------
+        raw.reserve(faces.size() * TRIANGLE_EDGE_COUNT);
+        std::int64_t next = 0;
+        for ( std::size_t i = 0; i < faces.size(); i++ ) {
+            for ( std::size_t k = 0; k < TRIANGLE_EDGE_COUNT; k++ ) {
+                std::int64_t index = static_cast<std::int64_t>(faces[i].indices[k]);
+                Codec_WriteVarint(raw, Codec_ZigZag(next - index));
+                next = std::max(next, index + 1);
+            }
+        }
+
+        return;
+    }
+
+    raw.reserve(vertices.size() * 3);
+    for ( std::size_t i = 0; i < vertices.size(); i++ ) {
+        const Vertex& vertex = vertices[i];
+        switch ( stream ) {
+            case MESH_CODEC_POSITIONS:
+                for ( std::size_t k = 0; k < 3; k++ ) quantized[k] = Codec_Quantize(vertex.position[k], header.positionMinimum[k], header.positionStep[k], header.positionBits);
+                Codec_WriteResiduals(raw, quantized, previous, 3);
+                break;
+            case MESH_CODEC_NORMALS:
+                Codec_EncodeOctahedral(vertex.normal.x(), vertex.normal.y(), vertex.normal.z(), header.normalBits, quantized);
+                Codec_WriteResiduals(raw, quantized, previous, 2);
+                break;
+            case MESH_CODEC_TANGENTS:
+                Codec_EncodeOctahedral(vertex.tangent.x(), vertex.tangent.y(), vertex.tangent.z(), header.tangentBits, quantized);
+                Codec_WriteResiduals(raw, quantized, previous, 2);
+                Codec_WriteVarint(raw, vertex.tangent.w() < 0.0f ? 1u : 0u);
+                break;
+            case MESH_CODEC_TEXTURE_COORDS:
+                for ( std::size_t k = 0; k < 3; k++ ) quantized[k] = Codec_Quantize(vertex.textureCoord[k], header.textureCoordMinimum[k], header.textureCoordStep[k], header.textureCoordBits);
+                Codec_WriteResiduals(raw, quantized, previous, 3);
+                break;
+            case MESH_CODEC_COLORS:
+                quantized[0] = Codec_Quantize(vertex.color.r(), header.colorMinimum[0], header.colorStep[0], header.colorBits);
+                quantized[1] = Codec_Quantize(vertex.color.g(), header.colorMinimum[1], header.colorStep[1], header.colorBits);
+                quantized[2] = Codec_Quantize(vertex.color.b(), header.colorMinimum[2], header.colorStep[2], header.colorBits);
+                Codec_WriteResiduals(raw, quantized, previous, 3);
+                break;
+        }
+    }
+}
+
+/* Reads the residual of the next component of a vertex (see Codec_WriteResiduals). */
+inline std::uint32_t Codec_ReadResidual(const unsigned char*& bytes) {
+    return static_cast<std::uint32_t>(Codec_UnZigZag(Codec_ReadVarint(bytes)));
+}
+
+/* Reconstructs the faces from the decoded index stream. */
+bool Codec_DecodeIndices(const std::vector<unsigned char>& raw, std::size_t rawSize, std::size_t vertexCount, TriangleFace* faces, std::size_t faceCount) {
+    const unsigned char* bytes = raw.data();
+    const unsigned char* end = bytes + rawSize;
+
+    std::int64_t next = 0;
+    for ( std::size_t i = 0; i < faceCount; i++ ) {
+        for ( std::size_t k = 0; k < TRIANGLE_EDGE_COUNT; k++ ) {
+            std::int64_t index = next - Codec_UnZigZag(Codec_ReadVarint(bytes));
+            if ( index < 0 || index >= static_cast<std::int64_t>(vertexCount) ) return false;
+            faces[i].indices[k] = static_cast<unsigned int>(index);
+            if ( index >= next ) next = index + 1;
+        }
+
+        if ( bytes > end ) return false;
+    }
+
+    return bytes == end;
+}
+
+/*
+ * Reconstructs the vertices from the decoded attribute streams. With SSE2
+ * (and bSimd set) every vertex is assembled in registers and written with
+ * four 16 byte stores, streaming (non-temporal) if the destination is
+ * aligned; otherwise its attributes are assigned one at a time.
+ */
+bool Codec_DecodeVertices(const MeshCodecHeader& header, const std::vector<unsigned char>* raw, const std::size_t* rawSizes, Vertex* vertices, bool bSimd) {
+    const unsigned char* bytes[MESH_CODEC_STREAM_COUNT];
+    const unsigned char* ends[MESH_CODEC_STREAM_COUNT];
+    for ( std::size_t s = 0; s < MESH_CODEC_STREAM_COUNT; s++ ) {
+        bytes[s] = raw[s].data();
+        ends[s] = bytes[s] + rawSizes[s];
+    }
+
+    std::uint32_t position[3] = { 0u, 0u, 0u };
+    std::uint32_t normal[2] = { 0u, 0u };
+    std::uint32_t tangent[2] = { 0u, 0u };
+    std::uint32_t textureCoord[3] = { 0u, 0u, 0u };
+    std::uint32_t color[3] = { 0u, 0u, 0u };
+    float normalScale = 1.0f / static_cast<float>((1u << (header.normalBits - 1u)) - 1u);
+    float tangentScale = 1.0f / static_cast<float>((1u << (header.tangentBits - 1u)) - 1u);
+
+#ifdef MESH_CODEC_SSE2
+    static_assert(sizeof(Vertex) == 16 * sizeof(float), "[MeshCodec] Error: Vertex must be 16 tightly packed floats.");
+    const __m128 positionMinimum = _mm_setr_ps(header.positionMinimum[0], header.positionMinimum[1], header.positionMinimum[2], 0.0f);
+    const __m128 positionStep = _mm_setr_ps(header.positionStep[0], header.positionStep[1], header.positionStep[2], 0.0f);
+    const __m128 textureCoordMinimum = _mm_setr_ps(header.textureCoordMinimum[0], header.textureCoordMinimum[1], header.textureCoordMinimum[2], 0.0f);
+    const __m128 textureCoordStep = _mm_setr_ps(header.textureCoordStep[0], header.textureCoordStep[1], header.textureCoordStep[2], 0.0f);
+    const __m128 colorMinimum = _mm_setr_ps(0.0f, header.colorMinimum[0], header.colorMinimum[1], header.colorMinimum[2]);
+    const __m128 colorStep = _mm_setr_ps(0.0f, header.colorStep[0], header.colorStep[1], header.colorStep[2]);
+    const bool bStream = bSimd && (reinterpret_cast<std::uintptr_t>(vertices) % 16u) == 0u;
+#else
+    (void)bSimd;
+#endif
+
+    for ( std::size_t i = 0; i < header.vertexCount; i++ ) {
+        for ( std::size_t k = 0; k < 3; k++ ) position[k] += Codec_ReadResidual(bytes[MESH_CODEC_POSITIONS]);
+        for ( std::size_t k = 0; k < 2; k++ ) normal[k] += Codec_ReadResidual(bytes[MESH_CODEC_NORMALS]);
+        for ( std::size_t k = 0; k < 2; k++ ) tangent[k] += Codec_ReadResidual(bytes[MESH_CODEC_TANGENTS]);
+        float handedness = Codec_ReadVarint(bytes[MESH_CODEC_TANGENTS]) != 0u ? -1.0f : 1.0f;
+        for ( std::size_t k = 0; k < 3; k++ ) textureCoord[k] += Codec_ReadResidual(bytes[MESH_CODEC_TEXTURE_COORDS]);
+        for ( std::size_t k = 0; k < 3; k++ ) color[k] += Codec_ReadResidual(bytes[MESH_CODEC_COLORS]);
+
+        for ( std::size_t s = MESH_CODEC_POSITIONS; s < MESH_CODEC_STREAM_COUNT; s++ )
+            if ( bytes[s] > ends[s] ) return false;
+
+        float n[3], t[3];
+        Codec_DecodeOctahedral(static_cast<std::int32_t>(normal[0]), static_cast<std::int32_t>(normal[1]), normalScale, n);
+        Codec_DecodeOctahedral(static_cast<std::int32_t>(tangent[0]), static_cast<std::int32_t>(tangent[1]), tangentScale, t);
+
+#ifdef MESH_CODEC_SSE2
+        if ( bSimd ) {
+            //------------------------------------------------------------------
+            // Dequantize the box quantized attributes four lanes at a time and
+            // assemble the 64 byte vertex: [p p p n] [n n t t] [t t c c] [c r g b].
+            //------------------------------------------------------------------
+            __m128 p = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_setr_epi32(static_cast<int>(position[0]), static_cast<int>(position[1]), static_cast<int>(position[2]), 0)), positionStep), positionMinimum);
+            __m128 c = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_setr_epi32(static_cast<int>(textureCoord[0]), static_cast<int>(textureCoord[1]), static_cast<int>(textureCoord[2]), 0)), textureCoordStep), textureCoordMinimum);
+            __m128 k = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_setr_epi32(0, static_cast<int>(color[0]), static_cast<int>(color[1]), static_cast<int>(color[2]))), colorStep), colorMinimum);
+
+            __m128 r0 = _mm_shuffle_ps(p, _mm_unpackhi_ps(p, _mm_set1_ps(n[0])), _MM_SHUFFLE(1, 0, 1, 0));
+            __m128 r1 = _mm_setr_ps(n[1], n[2], t[0], t[1]);
+            __m128 r2 = _mm_movelh_ps(_mm_setr_ps(t[2], handedness, 0.0f, 0.0f), c);
+            __m128 r3 = _mm_move_ss(k, _mm_shuffle_ps(c, c, _MM_SHUFFLE(2, 2, 2, 2)));
+
+            float* destination = reinterpret_cast<float*>(vertices + i);
+            if ( bStream ) {
+                _mm_stream_ps(destination + 0, r0);
+                _mm_stream_ps(destination + 4, r1);
+                _mm_stream_ps(destination + 8, r2);
+                _mm_stream_ps(destination + 12, r3);
+            }
+            else {
+                _mm_storeu_ps(destination + 0, r0);
+                _mm_storeu_ps(destination + 4, r1);
+                _mm_storeu_ps(destination + 8, r2);
+                _mm_storeu_ps(destination + 12, r3);
+            }
+            continue;
+        }
+#endif
+
+        Vertex& vertex = vertices[i];
+        vertex.position = Vector3f(header.positionMinimum[0] + static_cast<float>(static_cast<std::int32_t>(position[0])) * header.positionStep[0],
+                                   header.positionMinimum[1] + static_cast<float>(static_cast<std::int32_t>(position[1])) * header.positionStep[1],
+                                   header.positionMinimum[2] + static_cast<float>(static_cast<std::int32_t>(position[2])) * header.positionStep[2]);
+        vertex.normal = Vector3f(n[0], n[1], n[2]);
+        vertex.tangent = Vector4f(Vector3f(t[0], t[1], t[2]), handedness);
+        vertex.textureCoord = Vector3f(header.textureCoordMinimum[0] + static_cast<float>(static_cast<std::int32_t>(textureCoord[0])) * header.textureCoordStep[0],
+                                       header.textureCoordMinimum[1] + static_cast<float>(static_cast<std::int32_t>(textureCoord[1])) * header.textureCoordStep[1],
+                                       header.textureCoordMinimum[2] + static_cast<float>(static_cast<std::int32_t>(textureCoord[2])) * header.textureCoordStep[2]);
+        vertex.color = Color3f(header.colorMinimum[0] + static_cast<float>(static_cast<std::int32_t>(color[0])) * header.colorStep[0],
+                               header.colorMinimum[1] + static_cast<float>(static_cast<std::int32_t>(color[1])) * header.colorStep[1],
+                               header.colorMinimum[2] + static_cast<float>(static_cast<std::int32_t>(color[2])) * header.colorStep[2]);
+    }
+
+#ifdef MESH_CODEC_SSE2
+    if ( bStream ) _mm_sfence();
+#endif
+
+    for ( std::size_t s = MESH_CODEC_POSITIONS; s < MESH_CODEC_STREAM_COUNT; s++ )
+        if ( bytes[s] != ends[s] ) return false;
+    return true;
+}
+
+/* Returns true if the quantization bits are within their supported ranges. */
+inline bool Codec_ValidBits(std::uint32_t positionBits, std::uint32_t normalBits, std::uint32_t tangentBits, std::uint32_t textureCoordBits, std::uint32_t colorBits) {
+    if ( positionBits < 1u || positionBits > 24u ) return false;
+    if ( normalBits < 2u || normalBits > 16u ) return false;
+    if ( tangentBits < 2u || tangentBits > 16u ) return false;
+    if ( textureCoordBits < 1u || textureCoordBits > 24u ) return false;
+    if ( colorBits < 1u || colorBits > 24u ) return false;
+    return true;
+}
+
+MeshCodecOptions::MeshCodecOptions() {
+    this->positionBits = 16u;
+    this->normalBits = 12u;
+    this->tangentBits = 10u;
+    this->textureCoordBits = 16u;
+    this->colorBits = 8u;
+}
+
+CompressedMesh::CompressedMesh() {
+    this->header = nullptr;
+    this->subMeshes = nullptr;
+    this->materialLibraries = nullptr;
+    for ( std::size_t s = 0; s < MESH_CODEC_STREAM_COUNT; s++ ) this->streams[s] = nullptr;
+}
+
+CompressedMesh::~CompressedMesh() {
+    this->close();
+}
+
+bool CompressedMesh::open(const std::string& filename) {
+    this->close();
+    if ( !this->file.open(filename) ) {
+        std::cerr << "[CompressedMesh:open] Error: Could not open file: " << filename << std::endl;
+        return false;
+    }
+
+    const char* data = this->file.data();
+    std::size_t size = this->file.size();
+    const MeshCodecHeader* header = reinterpret_cast<const MeshCodecHeader*>(data);
+    if ( size < sizeof(MeshCodecHeader) || std::memcmp(header->magic, MESH_CODEC_MAGIC, sizeof(MESH_CODEC_MAGIC)) != 0 || header->version != MESH_CODEC_VERSION ) {
+        std::cerr << "[CompressedMesh:open] Error: Not a compressed mesh of version " << MESH_CODEC_VERSION << ": " << filename << std::endl;
+        this->close();
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // Walk the name, sub-meshes, material libraries, and streams, checking
+    // that each lies within the file and that nothing follows the last one.
+    //--------------------------------------------------------------------------
+    bool bValid = Codec_ValidBits(header->positionBits, header->normalBits, header->tangentBits, header->textureCoordBits, header->colorBits);
+    std::size_t offset = Codec_Align(sizeof(MeshCodecHeader) + static_cast<std::size_t>(header->nameLength));
+    bValid = bValid && offset <= size && header->subMeshCount <= (size - offset) / sizeof(MeshCodecSubMesh);
+
+    const MeshCodecSubMesh* subMeshes = reinterpret_cast<const MeshCodecSubMesh*>(data + offset);
+    if ( bValid ) offset += header->subMeshCount * sizeof(MeshCodecSubMesh);
+    for ( std::size_t i = 0; bValid && i < header->subMeshCount; i++ ) {
+        std::size_t length = static_cast<std::size_t>(subMeshes[i].nameLength) + subMeshes[i].materialLength;
+        bValid = length <= size - offset && subMeshes[i].faceOffset <= header->faceCount && subMeshes[i].faceCount <= header->faceCount - subMeshes[i].faceOffset;
+        if ( bValid ) offset += length;
+    }
+
+    const char* materialLibraries = data + offset;
+    bValid = bValid && header->materialLibrarySize <= size - offset;
+    bValid = bValid && std::count(materialLibraries, materialLibraries + header->materialLibrarySize, '\0') == static_cast<std::ptrdiff_t>(header->materialLibraryCount);
+    if ( bValid ) offset += header->materialLibrarySize;
+
+    for ( std::size_t s = 0; bValid && s < MESH_CODEC_STREAM_COUNT; s++ ) {
+        offset = Codec_Align(offset);
+        bValid = offset <= size && sizeof(MeshCodecStreamHeader) <= size - offset;
+        if ( !bValid ) break;
+
+        this->streams[s] = reinterpret_cast<const MeshCodecStreamHeader*>(data + offset);
+        offset += sizeof(MeshCodecStreamHeader);
+        bValid = this->streams[s]->encodedSize <= size - offset;
+        offset += this->streams[s]->encodedSize;
+
+        //----------------------------------------------------------------------
+        // Every vertex or face writes a fixed number of 1 to 10 byte integers
+        // to a stream, which bounds the memory a decode allocates.
+        //----------------------------------------------------------------------
+        std::uint64_t integerCount = static_cast<std::uint64_t>((s == MESH_CODEC_INDICES) ? header->faceCount : header->vertexCount) * MESH_CODEC_STREAM_INTEGERS[s];
+        bValid = bValid && this->streams[s]->rawSize >= integerCount && this->streams[s]->rawSize <= integerCount * 10u;
+    }
+
+    if ( !bValid || offset != size ) {
+        std::cerr << "[CompressedMesh:open] Error: Truncated or corrupt compressed mesh: " << filename << std::endl;
+        this->close();
+        return false;
+    }
+
+    this->header = header;
+    this->subMeshes = subMeshes;
+    this->materialLibraries = materialLibraries;
+    return true;
+}
+
+void CompressedMesh::close() {
+    this->file.close();
+    this->header = nullptr;
+    this->subMeshes = nullptr;
+    this->materialLibraries = nullptr;
+    for ( std::size_t s = 0; s < MESH_CODEC_STREAM_COUNT; s++ ) this->streams[s] = nullptr;
+}
+
+bool CompressedMesh::isOpen() const {
+    return this->header != nullptr;
+}
+
+std::string CompressedMesh::getName() const {
+    if ( this->header == nullptr ) return std::string();
+    return std::string(this->file.data() + sizeof(MeshCodecHeader), this->header->nameLength);
+}
+
+std::size_t CompressedMesh::getVertexCount() const {
+    if ( this->header == nullptr ) return 0u;
+    return static_cast<std::size_t>(this->header->vertexCount);
+}
+
+std::size_t CompressedMesh::getFaceCount() const {
+    if ( this->header == nullptr ) return 0u;
+    return static_cast<std::size_t>(this->header->faceCount);
+}
+
+void CompressedMesh::getSubMeshes(std::vector<SubMesh>& subMeshes) const {
+    subMeshes.clear();
+    if ( this->header == nullptr ) return;
+
+    const char* names = reinterpret_cast<const char*>(this->subMeshes + this->header->subMeshCount);
+    subMeshes.resize(static_cast<std::size_t>(this->header->subMeshCount));
+    for ( std::size_t i = 0; i < subMeshes.size(); i++ ) {
+        const MeshCodecSubMesh& record = this->subMeshes[i];
+        subMeshes[i].name = std::string(names, record.nameLength);
+        names += record.nameLength;
+        subMeshes[i].material = std::string(names, record.materialLength);
+        names += record.materialLength;
+        subMeshes[i].faceOffset = record.faceOffset;
+        subMeshes[i].faceCount = record.faceCount;
+        subMeshes[i].minIndex = record.minIndex;
+        subMeshes[i].maxIndex = record.maxIndex;
+        subMeshes[i].materialIndex = SUBMESH_NO_MATERIAL;
+    }
+}
+
+void CompressedMesh::getMaterialLibraries(std::vector<std::string>& materialLibraries) const {
+    materialLibraries.clear();
+    if ( this->header == nullptr ) return;
+
+    const char* name = this->materialLibraries;
+    for ( std::size_t i = 0; i < this->header->materialLibraryCount; i++ ) {
+        materialLibraries.push_back(std::string(name));
+        name += materialLibraries.back().length() + 1;
+    }
+}
+
+void CompressedMesh::getBounds(Vector3f& minimum, Vector3f& maximum) const {
+    if ( this->header == nullptr ) return;
+
+    float levels = static_cast<float>((1u << this->header->positionBits) - 1u);
+    for ( unsigned int k = 0; k < 3; k++ ) {
+        minimum[k] = this->header->positionMinimum[k];
+        maximum[k] = this->header->positionMinimum[k] + levels * this->header->positionStep[k];
+    }
+}
+
+bool CompressedMesh::decode(Vertex* vertices, TriangleFace* faces, bool bSimd) const {
+    if ( this->header == nullptr ) return false;
+
+    //--------------------------------------------------------------------------
+    // Entropy decode the streams (one thread per stream for large meshes)
+    // into zero padded buffers of variable length integers.
+    //--------------------------------------------------------------------------
+    std::vector<unsigned char> raw[MESH_CODEC_STREAM_COUNT];
+    std::size_t rawSizes[MESH_CODEC_STREAM_COUNT];
+    bool decoded[MESH_CODEC_STREAM_COUNT];
+    std::size_t totalSize = 0u;
+    for ( std::size_t s = 0; s < MESH_CODEC_STREAM_COUNT; s++ ) {
+        rawSizes[s] = this->streams[s]->rawSize;
+        totalSize += rawSizes[s];
+    }
+
+    auto decodeStream = [&](std::size_t s) {
+        raw[s].resize(rawSizes[s] + MESH_CODEC_STREAM_PADDING, 0u);
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(this->streams[s] + 1);
+        decoded[s] = Codec_EntropyDecode(bytes, this->streams[s]->encodedSize, raw[s].data(), rawSizes[s]);
+    };
+
+    bool bParallel = totalSize >= MESH_CODEC_MIN_PARALLEL_SIZE;
+    if ( bParallel ) ParallelFor(MESH_CODEC_STREAM_COUNT, decodeStream);
+    else for ( std::size_t s = 0; s < MESH_CODEC_STREAM_COUNT; s++ ) decodeStream(s);
+
+    for ( std::size_t s = 0; s < MESH_CODEC_STREAM_COUNT; s++ ) {
+        if ( !decoded[s] ) {
+            std::cerr << "[CompressedMesh:decode] Error: Corrupt stream " << s << "." << std::endl;
+            return false;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    // The faces and vertices are reconstructed independently.
+    //--------------------------------------------------------------------------
+    bool reconstructed[2] = { false, false };
+    auto reconstruct = [&](std::size_t part) {
+        if ( part == 0 ) reconstructed[0] = Codec_DecodeIndices(raw[MESH_CODEC_INDICES], rawSizes[MESH_CODEC_INDICES], this->header->vertexCount, faces, this->header->faceCount);
+        else reconstructed[1] = Codec_DecodeVertices(*this->header, raw, rawSizes, vertices, bSimd);
+    };
+
+    if ( bParallel ) ParallelFor(2, reconstruct);
+    else for ( std::size_t part = 0; part < 2; part++ ) reconstruct(part);
+
+    if ( !reconstructed[0] ) std::cerr << "[CompressedMesh:decode] Error: Corrupt or out of range indices." << std::endl;
+    if ( !reconstructed[1] ) std::cerr << "[CompressedMesh:decode] Error: Corrupt vertex attributes." << std::endl;
+    return reconstructed[0] && reconstructed[1];
+}
+
+bool SaveCompressedMesh(const std::string& filename, const std::string& name, const std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces, const std::vector<SubMesh>& subMeshes, const std::vector<std::string>& materialLibraries, const MeshCodecOptions& options) {
+    if ( !Codec_ValidBits(options.positionBits, options.normalBits, options.tangentBits, options.textureCoordBits, options.colorBits) ) {
+        std::cerr << "[CompressedMesh:save] Error: Unsupported quantization bits." << std::endl;
+        return false;
+    }
+
+    if ( vertices.size() > 0xFFFFFFFFu || faces.size() > 0xFFFFFFFFu ) {
+        std::cerr << "[CompressedMesh:save] Error: Mesh is too large to be compressed." << std::endl;
+        return false;
+    }
+
+    for ( std::size_t i = 0; i < faces.size(); i++ ) {
+        for ( std::size_t k = 0; k < TRIANGLE_EDGE_COUNT; k++ ) {
+            if ( faces[i].indices[k] >= vertices.size() ) {
+                std::cerr << "[CompressedMesh:save] Error: Face " << i << " references a vertex out of range." << std::endl;
+                return false;
+            }
+        }
+    }
+
+    MeshCodecHeader header;
+    std::memset(&header, 0, sizeof(MeshCodecHeader));
+    std::memcpy(header.magic, MESH_CODEC_MAGIC, sizeof(MESH_CODEC_MAGIC));
+    header.version = MESH_CODEC_VERSION;
+    header.vertexCount = static_cast<std::uint32_t>(vertices.size());
+    header.faceCount = static_cast<std::uint32_t>(faces.size());
+    header.subMeshCount = static_cast<std::uint32_t>(subMeshes.size());
+    header.nameLength = static_cast<std::uint32_t>(name.length());
+    header.materialLibraryCount = static_cast<std::uint32_t>(materialLibraries.size());
+    for ( std::size_t i = 0; i < materialLibraries.size(); i++ )
+        header.materialLibrarySize += static_cast<std::uint32_t>(materialLibraries[i].length() + 1);
+
+    header.positionBits = options.positionBits;
+    header.normalBits = options.normalBits;
+    header.tangentBits = options.tangentBits;
+    header.textureCoordBits = options.textureCoordBits;
+    header.colorBits = options.colorBits;
+    Codec_FitQuantization(vertices, [](const Vertex& vertex, std::size_t k) { return vertex.position[k]; }, header.positionBits, header.positionMinimum, header.positionStep);
+    Codec_FitQuantization(vertices, [](const Vertex& vertex, std::size_t k) { return vertex.textureCoord[k]; }, header.textureCoordBits, header.textureCoordMinimum, header.textureCoordStep);
+    Codec_FitQuantization(vertices, [](const Vertex& vertex, std::size_t k) { return k == 0 ? vertex.color.r() : (k == 1 ? vertex.color.g() : vertex.color.b()); }, header.colorBits, header.colorMinimum, header.colorStep);
+
+    //--------------------------------------------------------------------------
+    // Build and entropy code the streams (one thread per stream for large
+    // meshes).
+    //--------------------------------------------------------------------------
+    std::vector<unsigned char> encoded[MESH_CODEC_STREAM_COUNT];
+    std::size_t rawSizes[MESH_CODEC_STREAM_COUNT];
+    auto encodeStream = [&](std::size_t s) {
+        std::vector<unsigned char> raw;
+        Codec_WriteStream(s, header, vertices, faces, raw);
+        rawSizes[s] = raw.size();
+        Codec_EntropyEncode(raw, encoded[s]);
+    };
+
+    if ( vertices.size() * sizeof(Vertex) >= MESH_CODEC_MIN_PARALLEL_SIZE ) ParallelFor(MESH_CODEC_STREAM_COUNT, encodeStream);
+    else for ( std::size_t s = 0; s < MESH_CODEC_STREAM_COUNT; s++ ) encodeStream(s);
+
+    for ( std::size_t s = 0; s < MESH_CODEC_STREAM_COUNT; s++ ) {
+        if ( rawSizes[s] > 0xFFFFFFFFu || encoded[s].size() > 0xFFFFFFFFu ) {
+            std::cerr << "[CompressedMesh:save] Error: Mesh is too large to be compressed." << std::endl;
+            return false;
+        }
+    }
+
+    std::ofstream out(filename.c_str(), std::ios::binary | std::ios::trunc);
+    if ( out.is_open() == false ) {
+        std::cerr << "[CompressedMesh:save] Error: Could not open file: " << filename << std::endl;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // Header, name, sub-mesh records, sub-mesh names and materials, material
+    // libraries, streams. The records are padded to 4 byte boundaries.
+    //--------------------------------------------------------------------------
+    static const char padding[MESH_CODEC_ALIGNMENT] = { 0 };
+    std::size_t offset = sizeof(MeshCodecHeader) + name.length();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(MeshCodecHeader));
+    out.write(name.data(), static_cast<std::streamsize>(name.length()));
+    out.write(padding, static_cast<std::streamsize>(Codec_Align(offset) - offset));
+    offset = Codec_Align(offset);
+
+    for ( std::size_t i = 0; i < subMeshes.size(); i++ ) {
+        MeshCodecSubMesh record;
+        record.faceOffset = subMeshes[i].faceOffset;
+        record.faceCount = subMeshes[i].faceCount;
+        record.minIndex = subMeshes[i].minIndex;
+        record.maxIndex = subMeshes[i].maxIndex;
+        record.nameLength = static_cast<std::uint32_t>(subMeshes[i].name.length());
+        record.materialLength = static_cast<std::uint32_t>(subMeshes[i].material.length());
+        out.write(reinterpret_cast<const char*>(&record), sizeof(MeshCodecSubMesh));
+        offset += sizeof(MeshCodecSubMesh);
+    }
+
+    for ( std::size_t i = 0; i < subMeshes.size(); i++ ) {
+        out.write(subMeshes[i].name.data(), static_cast<std::streamsize>(subMeshes[i].name.length()));
+        out.write(subMeshes[i].material.data(), static_cast<std::streamsize>(subMeshes[i].material.length()));
+        offset += subMeshes[i].name.length() + subMeshes[i].material.length();
+    }
+
+    for ( std::size_t i = 0; i < materialLibraries.size(); i++ )
+        out.write(materialLibraries[i].c_str(), static_cast<std::streamsize>(materialLibraries[i].length() + 1));
+    offset += header.materialLibrarySize;
+
+    for ( std::size_t s = 0; s < MESH_CODEC_STREAM_COUNT; s++ ) {
+        out.write(padding, static_cast<std::streamsize>(Codec_Align(offset) - offset));
+        offset = Codec_Align(offset);
+
+        MeshCodecStreamHeader stream;
+        stream.rawSize = static_cast<std::uint32_t>(rawSizes[s]);
+        stream.encodedSize = static_cast<std::uint32_t>(encoded[s].size());
+        out.write(reinterpret_cast<const char*>(&stream), sizeof(MeshCodecStreamHeader));
+        out.write(reinterpret_cast<const char*>(encoded[s].data()), static_cast<std::streamsize>(encoded[s].size()));
+        offset += sizeof(MeshCodecStreamHeader) + encoded[s].size();
+    }
+
+    if ( !out.good() ) {
+        std::cerr << "[CompressedMesh:save] Error: Could not write file: " << filename << std::endl;
+        out.close();
+        std::error_code error;
+        std::filesystem::remove(filename, error);
+        return false;
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,404 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "PlyMesh.h"
+#include "MappedFile.h"
+#include "ParallelFor.h"
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+namespace sgpu {
+
+static const std::string PLY_MAGIC = "ply";
+static const std::string PLY_FORMAT = "format";
+static const std::string PLY_ELEMENT = "element";
+static const std::string PLY_PROPERTY = "property";
+static const std::string PLY_LIST = "list";
+static const std::string PLY_END_HEADER = "end_header";
+static const std::string PLY_BINARY_LITTLE_ENDIAN = "binary_little_endian";
+static const std::string PLY_BINARY_BIG_ENDIAN = "binary_big_endian";
+static const std::string PLY_VERTEX = "vertex";
+static const std::string PLY_FACE = "face";
+
+/* Smallest number of vertices worth decoding on several threads. */
+static const std::size_t PLY_MIN_PARALLEL_VERTICES = 1u << 16;
+
+enum Ply_Type { PLY_INT8, PLY_UINT8, PLY_INT16, PLY_UINT16, PLY_INT32, PLY_UINT32, PLY_FLOAT32, PLY_FLOAT64, PLY_INVALID };
+
+/* Vertex properties read by LoadPlyMesh (in the order of Ply_VertexNames). */
+enum Ply_VertexProperty { PLY_X, PLY_Y, PLY_Z, PLY_NX, PLY_NY, PLY_NZ, PLY_U, PLY_V, PLY_RED, PLY_GREEN, PLY_BLUE, PLY_VERTEX_PROPERTY_COUNT };
+
+static const char* const Ply_VertexNames[] = { "x", "y", "z", "nx", "ny", "nz", "u", "v", "red", "green", "blue" };
+
+struct Ply_Property {
+    std::string name;
+    Ply_Type type;
+    Ply_Type countType;
+    bool bList;
+    std::size_t offset;
+};
+
+struct Ply_Element {
+    std::string name;
+    std::size_t count;
+    std::vector<Ply_Property> properties;
+
+    /* Size of one record in bytes, 0 if the element has list properties. */
+    std::size_t stride;
+};
+
+Ply_Type Ply_ParseType(const std::string& type) {
+    if ( type == "char" || type == "int8" ) return PLY_INT8;
+    if ( type == "uchar" || type == "uint8" ) return PLY_UINT8;
+    if ( type == "short" || type == "int16" ) return PLY_INT16;
+    if ( type == "ushort" || type == "uint16" ) return PLY_UINT16;
+    if ( type == "int" || type == "int32" ) return PLY_INT32;
+    if ( type == "uint" || type == "uint32" ) return PLY_UINT32;
+    if ( type == "float" || type == "float32" ) return PLY_FLOAT32;
+    if ( type == "double" || type == "float64" ) return PLY_FLOAT64;
+    return PLY_INVALID;
+}
+
+std::size_t Ply_TypeSize(Ply_Type type) {
+    switch ( type ) {
+        case PLY_INT8:
+        case PLY_UINT8: return 1u;
+        case PLY_INT16:
+        case PLY_UINT16: return 2u;
+        case PLY_INT32:
+        case PLY_UINT32:
+        case PLY_FLOAT32: return 4u;
+        case PLY_FLOAT64: return 8u;
+        default: return 0u;
+    }
+}
+
+/* Reads a value of type T, reversing its bytes if the file endianness differs. */
+template <typename T>
+inline T Ply_Load(const unsigned char* data, bool bSwap) {
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, data, sizeof(T));
+    if ( bSwap ) std::reverse(bytes, bytes + sizeof(T));
+
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+double Ply_ReadValue(const unsigned char* data, Ply_Type type, bool bSwap) {
+    switch ( type ) {
+        case PLY_INT8: return static_cast<std::int8_t>(data[0]);
+        case PLY_UINT8: return data[0];
+        case PLY_INT16: return Ply_Load<std::int16_t>(data, bSwap);
+        case PLY_UINT16: return Ply_Load<std::uint16_t>(data, bSwap);
+        case PLY_INT32: return Ply_Load<std::int32_t>(data, bSwap);
+        case PLY_UINT32: return Ply_Load<std::uint32_t>(data, bSwap);
+        case PLY_FLOAT32: return Ply_Load<float>(data, bSwap);
+        case PLY_FLOAT64: return Ply_Load<double>(data, bSwap);
+        default: return 0.0;
+    }
+}
+
+/* Color channels stored as integers are mapped to [0, 1]. */
+float Ply_ReadColor(const unsigned char* data, Ply_Type type, bool bSwap) {
+    double value = Ply_ReadValue(data, type, bSwap);
+    if ( type == PLY_UINT8 ) return static_cast<float>(value / 255.0);
+    if ( type == PLY_UINT16 ) return static_cast<float>(value / 65535.0);
+    return static_cast<float>(value);
+}
+
+/* Returns the vertex property a Ply property name refers to (or the count). */
+unsigned int Ply_FindVertexProperty(const std::string& name) {
+    if ( name == "s" || name == "texture_u" ) return PLY_U;
+    if ( name == "t" || name == "texture_v" ) return PLY_V;
+    if ( name == "r" ) return PLY_RED;
+    if ( name == "g" ) return PLY_GREEN;
+    if ( name == "b" ) return PLY_BLUE;
+    for ( unsigned int i = 0; i < PLY_VERTEX_PROPERTY_COUNT; i++ )
+        if ( name == Ply_VertexNames[i] ) return i;
+    return PLY_VERTEX_PROPERTY_COUNT;
+}
+
+/* 
+ * Parses the header of a Ply file. On success, data points at the first byte
+ * of the binary body.
+ */
+bool Parse_Ply_Header(const char*& data, const char* end, std::vector<Ply_Element>& elements, bool& bBigEndian) {
+    bool bFormat = false;
+    bool bMagic = false;
+
+    while ( data < end ) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(data, '\n', static_cast<std::size_t>(end - data)));
+        if ( lineEnd == nullptr ) return false;
+
+        std::string line(data, lineEnd);
+        data = lineEnd + 1;
+        if ( line.length() > 0 && line.back() == '\r' ) line.pop_back();
+
+        std::istringstream stream(line);
+        std::string keyword;
+        stream >> keyword;
+
+        if ( !bMagic ) {
+            if ( keyword != PLY_MAGIC ) return false;
+            bMagic = true;
+        }
+        else if ( keyword == PLY_END_HEADER ) return bFormat;
+        else if ( keyword == PLY_FORMAT ) {
+            std::string format;
+            stream >> format;
+            if ( format == PLY_BINARY_LITTLE_ENDIAN ) bBigEndian = false;
+            else if ( format == PLY_BINARY_BIG_ENDIAN ) bBigEndian = true;
+            else {
+                std::cerr << "[Ply:load] Error: Unsupported Ply format: " << format << std::endl;
+                return false;
+            }
+            bFormat = true;
+        }
+        else if ( keyword == PLY_ELEMENT ) {
+            Ply_Element element;
+            if ( !(stream >> element.name >> element.count) ) return false;
+            element.stride = 0u;
+            elements.push_back(element);
+        }
+        else if ( keyword == PLY_PROPERTY ) {
+            if ( elements.size() == 0 ) return false;
+
+            Ply_Property property;
+            std::string type;
+            stream >> type;
+            property.bList = (type == PLY_LIST);
+            property.countType = PLY_INVALID;
+            if ( property.bList ) {
+                std::string countType;
+                stream >> countType >> type;
+                property.countType = Ply_ParseType(countType);
+                if ( property.countType == PLY_INVALID || property.countType == PLY_FLOAT32 || property.countType == PLY_FLOAT64 ) return false;
+            }
+
+            property.type = Ply_ParseType(type);
+            if ( property.type == PLY_INVALID || !(stream >> property.name) ) return false;
+
+            Ply_Element& element = elements.back();
+            property.offset = element.stride;
+            element.properties.push_back(property);
+            element.stride += Ply_TypeSize(property.type);
+        }
+    }
+
+    return false;
+}
+
+/* 
+ * Returns the size in bytes of the record starting at data (0 if the record
+ * exceeds the file). Only needed for elements with list properties.
+ */
+std::size_t Ply_RecordSize(const unsigned char* data, const unsigned char* end, const Ply_Element& element, bool bSwap) {
+    const unsigned char* cur = data;
+    for ( std::size_t i = 0; i < element.properties.size(); i++ ) {
+        const Ply_Property& property = element.properties[i];
+        if ( !property.bList ) {
+            cur += Ply_TypeSize(property.type);
+            continue;
+        }
+
+        std::size_t countSize = Ply_TypeSize(property.countType);
+        if ( static_cast<std::size_t>(end - cur) < countSize ) return 0u;
+        double count = Ply_ReadValue(cur, property.countType, bSwap);
+        cur += countSize;
+        if ( count < 0.0 || count * Ply_TypeSize(property.type) > static_cast<double>(end - cur) ) return 0u;
+        cur += static_cast<std::size_t>(count) * Ply_TypeSize(property.type);
+    }
+
+    return (cur <= end) ? static_cast<std::size_t>(cur - data) : 0u;
+}
+
+/* Decodes the vertices [begin, end) of a fixed-size vertex element. */
+void Decode_Ply_Vertices(const unsigned char* data, const Ply_Element& element, const int* properties, bool bSwap, std::size_t begin, std::size_t end, std::vector<Vertex>& vertices) {
+    for ( std::size_t i = begin; i < end; i++ ) {
+        const unsigned char* record = data + i * element.stride;
+        float values[PLY_VERTEX_PROPERTY_COUNT] = { 0.0f };
+
+        for ( unsigned int p = 0; p < PLY_VERTEX_PROPERTY_COUNT; p++ ) {
+            if ( properties[p] < 0 ) continue;
+            const Ply_Property& property = element.properties[properties[p]];
+            if ( p >= PLY_RED ) values[p] = Ply_ReadColor(record + property.offset, property.type, bSwap);
+            else values[p] = static_cast<float>(Ply_ReadValue(record + property.offset, property.type, bSwap));
+        }
+
+        Vertex& vertex = vertices[i];
+        vertex.position = Vector3f(values[PLY_X], values[PLY_Y], values[PLY_Z]);
+        vertex.normal = Vector3f(values[PLY_NX], values[PLY_NY], values[PLY_NZ]);
+        vertex.tangent = Vector4f(0.0f, 0.0f, 0.0f, 0.0f);
+        vertex.textureCoord = Vector3f(values[PLY_U], values[PLY_V], 0.0f);
+        vertex.color = Color3f(values[PLY_RED], values[PLY_GREEN], values[PLY_BLUE]);
+    }
+}
+
+bool LoadPlyMesh(const std::string& filename, std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces, unsigned int& attributes) {
+    MappedFile file;
+    if ( !file.open(filename) ) {
+        std::cerr << "[Ply:load] Error: The file: " << filename << " could not be opened." << std::endl;
+        return false;
+    }
+
+    std::vector<Ply_Element> elements;
+    bool bBigEndian = false;
+    const char* body = file.data();
+    if ( body == nullptr || !Parse_Ply_Header(body, file.data() + file.size(), elements, bBigEndian) ) {
+        std::cerr << "[Ply:load] Error: The file: " << filename << " has no valid binary Ply header." << std::endl;
+        return false;
+    }
+
+    const std::uint16_t endianTest = 1u;
+    bool bLittleEndianHost = *reinterpret_cast<const unsigned char*>(&endianTest) == 1u;
+    bool bSwap = (bBigEndian == bLittleEndianHost);
+
+    vertices.clear();
+    faces.clear();
+    attributes = 0u;
+
+    const unsigned char* cur = reinterpret_cast<const unsigned char*>(body);
+    const unsigned char* end = reinterpret_cast<const unsigned char*>(file.data() + file.size());
+    std::size_t vertexCount = 0u;
+    for ( std::size_t e = 0; e < elements.size(); e++ ) {
+        if ( elements[e].name == PLY_VERTEX ) vertexCount = elements[e].count;
+        for ( std::size_t p = 0; p < elements[e].properties.size(); p++ )
+            if ( elements[e].properties[p].bList ) elements[e].stride = 0u;
+    }
+
+    for ( std::size_t e = 0; e < elements.size(); e++ ) {
+        const Ply_Element& element = elements[e];
+
+        //----------------------------------------------------------------------
+        // Vertex records have a fixed size, so they are decoded in parallel
+        // directly from the mapped file.
+        //----------------------------------------------------------------------
+        if ( element.name == PLY_VERTEX ) {
+            if ( element.stride == 0u ) {
+                std::cerr << "[Ply:load] Error: List properties of vertices are not supported: " << filename << std::endl;
+                return false;
+            }
+
+            if ( element.count > static_cast<std::size_t>(end - cur) / element.stride ) {
+                std::cerr << "[Ply:load] Error: The file: " << filename << " is truncated." << std::endl;
+                return false;
+            }
+
+            int properties[PLY_VERTEX_PROPERTY_COUNT];
+            for ( unsigned int p = 0; p < PLY_VERTEX_PROPERTY_COUNT; p++ ) properties[p] = -1;
+            for ( std::size_t p = 0; p < element.properties.size(); p++ ) {
+                unsigned int index = Ply_FindVertexProperty(element.properties[p].name);
+                if ( index < PLY_VERTEX_PROPERTY_COUNT ) properties[index] = static_cast<int>(p);
+            }
+
+            if ( properties[PLY_X] < 0 || properties[PLY_Y] < 0 || properties[PLY_Z] < 0 ) {
+                std::cerr << "[Ply:load] Error: Vertices without positions in: " << filename << std::endl;
+                return false;
+            }
+
+            if ( properties[PLY_NX] >= 0 && properties[PLY_NY] >= 0 && properties[PLY_NZ] >= 0 ) attributes |= PLY_NORMALS;
+            if ( properties[PLY_U] >= 0 && properties[PLY_V] >= 0 ) attributes |= PLY_TEXTURE_COORDS;
+            if ( properties[PLY_RED] >= 0 && properties[PLY_GREEN] >= 0 && properties[PLY_BLUE] >= 0 ) attributes |= PLY_COLORS;
+
+            vertices.resize(element.count);
+            std::size_t threadCount = (element.count >= PLY_MIN_PARALLEL_VERTICES) ? GetThreadCount() : 1u;
+            ParallelFor(threadCount, [&](std::size_t t) {
+                Decode_Ply_Vertices(cur, element, properties, bSwap, element.count * t / threadCount, element.count * (t + 1) / threadCount, vertices);
+            });
+
+            cur += element.count * element.stride;
+            continue;
+        }
+
+        //----------------------------------------------------------------------
+        // Every other element is skipped, except for the vertex indices of the
+        // faces. Polygons are split into triangle fans.
+        //----------------------------------------------------------------------
+        int indexProperty = -1;
+        for ( std::size_t p = 0; element.name == PLY_FACE && p < element.properties.size(); p++ ) {
+            const Ply_Property& property = element.properties[p];
+            if ( property.bList && (property.name == "vertex_indices" || property.name == "vertex_index") ) indexProperty = static_cast<int>(p);
+        }
+
+        if ( element.stride > 0u && indexProperty < 0 ) {
+            if ( element.count > static_cast<std::size_t>(end - cur) / element.stride ) {
+                std::cerr << "[Ply:load] Error: The file: " << filename << " is truncated." << std::endl;
+                return false;
+            }
+            cur += element.count * element.stride;
+            continue;
+        }
+
+        if ( indexProperty >= 0 ) faces.reserve(faces.size() + element.count);
+        for ( std::size_t i = 0; i < element.count; i++ ) {
+            std::size_t recordSize = Ply_RecordSize(cur, end, element, bSwap);
+            if ( recordSize == 0u && element.properties.size() > 0 ) {
+                std::cerr << "[Ply:load] Error: The file: " << filename << " is truncated." << std::endl;
+                return false;
+            }
+
+            if ( indexProperty >= 0 ) {
+                const unsigned char* record = cur;
+                for ( int p = 0; p < indexProperty; p++ ) {
+                    const Ply_Property& property = element.properties[p];
+                    std::size_t count = property.bList ? static_cast<std::size_t>(Ply_ReadValue(record, property.countType, bSwap)) : 1u;
+                    if ( property.bList ) record += Ply_TypeSize(property.countType);
+                    record += count * Ply_TypeSize(property.type);
+                }
+
+                const Ply_Property& property = element.properties[indexProperty];
+                std::size_t count = static_cast<std::size_t>(Ply_ReadValue(record, property.countType, bSwap));
+                std::size_t indexSize = Ply_TypeSize(property.type);
+                record += Ply_TypeSize(property.countType);
+
+                TriangleFace face;
+                for ( std::size_t j = 0; j < count; j++ ) {
+                    double index = Ply_ReadValue(record + j * indexSize, property.type, bSwap);
+                    if ( index < 0.0 || index >= static_cast<double>(vertexCount) ) {
+                        std::cerr << "[Ply:load] Error: Face references an undefined vertex in: " << filename << std::endl;
+                        vertices.clear();
+                        faces.clear();
+                        return false;
+                    }
+
+                    if ( j == 0 ) face.indices[A] = static_cast<unsigned int>(index);
+                    else if ( j == 1 ) face.indices[C] = static_cast<unsigned int>(index);
+                    else {
+                        face.indices[B] = face.indices[C];
+                        face.indices[C] = static_cast<unsigned int>(index);
+                        faces.push_back(face);
+                    }
+                }
+            }
+
+            cur += recordSize;
+        }
+    }
+
+    return true;
+}
+
+}
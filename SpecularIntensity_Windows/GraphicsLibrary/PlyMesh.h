@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef PLY_MESH_H
+#define PLY_MESH_H
+
+#include <string>
+#include <vector>
+#include <Mathematics.h>
+#include "Vertex.h"
+#include "Face.h"
+
+namespace sgpu {
+
+/* Vertex attributes (besides the position) provided by a Ply file. */
+enum PlyAttribute {
+    PLY_NORMALS = 0x1,
+    PLY_TEXTURE_COORDS = 0x2,
+    PLY_COLORS = 0x4
+};
+
+/*
+ * Loads a binary (little or big endian) Ply file. The header may declare any
+ * elements and scalar or list properties; only the vertex element (x, y, z,
+ * nx, ny, nz, u/s/texture_u, v/t/texture_v, red, green, blue) and the vertex
+ * index list of the face element are read, everything else is skipped.
+ * Polygons are triangulated as fans. Vertex colors and normals that are not
+ * provided are set to zero.
+ *
+ * @param filename - The name of the Ply file to be read (include .ply).
+ * @param vertices - Receives the vertices of the file.
+ * @param faces - Receives the triangle faces of the file.
+ * @param attributes - Receives the PlyAttribute flags of the vertex element.
+ *
+ * @return If the file is successfully loaded then this function will return
+ * true; otherwise it will return false.
+ */
+bool LoadPlyMesh(const std::string& filename, std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces, unsigned int& attributes);
+
+}
+
+#endif
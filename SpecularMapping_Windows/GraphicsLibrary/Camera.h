@@ -62,6 +62,13 @@ public:
     Vector3<Real> getUpDirection() const;
     Vector3<Real> getRightDirection() const;
 
+    /*
+     * Returns the world space ray from the eye through the center of the pixel
+     * (x, y) of a viewport of the provided size, with y pointing down as in
+     * window coordinates. The direction is normalized.
+     */
+    void pick(Real x, Real y, Real viewportWidth, Real viewportHeight, Vector3<Real>& origin, Vector3<Real>& direction) const;
+
     Matrix4<Real>& getViewMatrix();
     Matrix4<Real>& getProjectionMatrix();
     Real& getRadius();
@@ -80,18 +87,23 @@ public:
     const Vector3<Real>& getRight() const;
 
 protected:
-    void compile();
+    /*
+     * Recomputes the eye, basis, and view matrix from the spherical
+     * coordinates and look at point. These are cached state, so the const
+     * getters recompile them as well.
+     */
+    void compile() const;
 
 protected:
-    Matrix4<Real> view;
+    mutable Matrix4<Real> view;
     Matrix4<Real> projection;
 
-    Vector3<Real> eye;
+    mutable Vector3<Real> eye;
     Vector3<Real> lookAt;
 
-    Vector3<Real> up;
-    Vector3<Real> right;
-    Vector3<Real> dir;
+    mutable Vector3<Real> up;
+    mutable Vector3<Real> right;
+    mutable Vector3<Real> dir;
 
     Real r, theta, phi;
 };
@@ -245,6 +257,25 @@ Vector3<Real> Camera<Real>::getRightDirection() const {
     return this->right;
 }
 
+template <typename Real>
+void Camera<Real>::pick(Real x, Real y, Real viewportWidth, Real viewportHeight, Vector3<Real>& origin, Vector3<Real>& direction) const {
+    //--------------------------------------------------------------------------
+    // The pixel is moved to normalized device coordinates and unprojected onto
+    // the view space plane z = -1, then rotated into world space by the
+    // inverse of the view matrix (column-major).
+    //--------------------------------------------------------------------------
+    Real ndcX = Real(2) * (x + Real(0.5)) / viewportWidth - Real(1);
+    Real ndcY = Real(1) - Real(2) * (y + Real(0.5)) / viewportHeight;
+    Real viewX = (ndcX - this->projection[8]) / this->projection[0];
+    Real viewY = (ndcY - this->projection[9]) / this->projection[5];
+
+    Matrix4<Real> inverseView = Matrix4<Real>::Inverse(this->view);
+    const Real* m = inverseView.constData();
+    origin.set(m[12], m[13], m[14]);
+    direction.set(m[0] * viewX + m[4] * viewY - m[8], m[1] * viewX + m[5] * viewY - m[9], m[2] * viewX + m[6] * viewY - m[10]);
+    direction.normalize();
+}
+
 template <typename Real>
 Matrix4<Real>& Camera<Real>::getViewMatrix() {
     return this->view;
@@ -321,7 +352,7 @@ const Vector3<Real>& Camera<Real>::getRight() const {
 }
 
 template <typename Real>
-void Camera<Real>::compile() {
+void Camera<Real>::compile() const {
     this->eye = SphereicalToCartesian<Real>(this->r, this->theta, this->phi);
     this->up = -SphereicalToCartesian_dPhi<Real>(this->r, this->theta, this->phi);
     this->right = SphereicalToCartesian_dTheta<Real>(this->r, this->theta, this->phi);
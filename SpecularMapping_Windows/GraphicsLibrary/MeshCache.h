@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <Mathematics.h>
+#include "MappedFile.h"
+#include "Vertex.h"
+#include "Face.h"
+#include "MeshNormals.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "MeshClusters.h"
+
+namespace sgpu {
+
+/*
+ * Format version of *.sgmesh files. This must be incremented whenever the
+ * layout of the file, the Vertex or TriangleFace structures, or the processing
+ * applied by Mesh::load changes so that stale caches are rebuilt.
+ */
+const std::uint32_t MESH_CACHE_VERSION = 9u;
+
+/*
+ * Header of a *.sgmesh file. The header is followed by the mesh name, the
+ * vertices (16 byte aligned), and the faces of the mesh exactly as they are
+ * uploaded to the GPU (including the faces of the levels of detail). The faces
+ * are followed by the sub-mesh records, the errors of the levels of detail and
+ * their sub-mesh ranges, the cluster records, the sub-mesh names and
+ * materials, and the null terminated material library names.
+ */
+struct MeshCacheHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t vertexSize;
+    std::uint32_t faceSize;
+
+    /* Identity of the source (*.obj) file the cache was built from. */
+    std::uint64_t sourceHash;
+    std::int64_t sourceModifiedTime;
+    std::uint64_t sourceSize;
+
+    /* 0, or 1 plus the MeshNormalWeighting of computed normals. */
+    std::uint32_t computeNormals;
+    std::uint32_t nameLength;
+    std::uint64_t vertexCount;
+    std::uint64_t faceCount;
+    std::uint64_t subMeshCount;
+    std::uint32_t materialLibraryCount;
+    std::uint32_t materialLibrarySize;
+
+    /* Bounds of the vertex positions (zero for a mesh without vertices). */
+    float boundsMinimum[3];
+    float boundsMaximum[3];
+
+    /* 1 if the faces and vertices were reordered by OptimizeMesh. */
+    std::uint32_t optimizeFaceOrder;
+
+    /* Vertex cache efficiency of the mesh before and after OptimizeMesh. */
+    MeshOptimizationStatistics statistics;
+
+    /* 1 if levels of detail were generated, and the number of them. */
+    std::uint32_t generateLods;
+    std::uint32_t lodCount;
+
+    /* 1 if the faces were split into clusters, and the number of them. */
+    std::uint32_t generateClusters;
+    std::uint32_t clusterCount;
+};
+
+/* Sub-mesh record of a *.sgmesh file (see SubMesh). */
+struct MeshCacheSubMesh {
+    std::uint32_t faceOffset;
+    std::uint32_t faceCount;
+    std::uint32_t minIndex;
+    std::uint32_t maxIndex;
+    std::uint32_t nameLength;
+    std::uint32_t materialLength;
+};
+
+/* Sub-mesh range of a level of detail in a *.sgmesh file (see MeshLod). */
+struct MeshCacheLodRange {
+    std::uint32_t faceOffset;
+    std::uint32_t faceCount;
+    std::uint32_t minIndex;
+    std::uint32_t maxIndex;
+};
+
+/* Cluster record of a *.sgmesh file (see MeshCluster). */
+struct MeshCacheCluster {
+    std::uint32_t faceOffset;
+    std::uint32_t faceCount;
+    std::uint32_t minIndex;
+    std::uint32_t maxIndex;
+    std::uint32_t subMesh;
+    float center[3];
+    float radius;
+    float coneAxis[3];
+    float coneCutoff;
+};
+
+/*
+ * Binary cache of the final (decompressed) vertices and faces of a Mesh that
+ * is stored next to its source file (model.obj -> model.obj.sgmesh). An open
+ * cache maps the file into memory so its vertices and faces can be uploaded
+ * without being parsed or copied.
+ *
+ * A cache is valid if it was built from a source of the same size and
+ * modification time. If only the modification time differs (ex. the source
+ * was checked out again) the contents of the source are hashed and compared
+ * against the hash stored in the cache.
+ */
+class MeshCache {
+public:
+    MeshCache();
+    ~MeshCache();
+
+    /*
+     * Opens the cache of the provided source file.
+     *
+     * @param sourceFilename - The name of the source (*.obj) file.
+     * @param bComputeNormals - The normal option the mesh is loaded with.
+     * @param normalWeighting - The weighting of computed normals.
+     * @param bOptimizeFaceOrder - The face order option the mesh is loaded with.
+     * @param bGenerateLods - The level of detail option the mesh is loaded with.
+     * @param bGenerateClusters - The cluster option the mesh is loaded with.
+     *
+     * @return If a valid cache built from the current source with the same
+     * options exists then this function will return true; otherwise it will
+     * return false.
+     */
+    bool open(const std::string& sourceFilename, bool bComputeNormals, MeshNormalWeighting normalWeighting, bool bOptimizeFaceOrder, bool bGenerateLods, bool bGenerateClusters);
+
+    /* Releases the mapping of the cache file. */
+    void close();
+
+    /* Returns true if a valid cache is currently open. */
+    bool isOpen() const;
+
+    /* Returns the name of the cached mesh. */
+    std::string getName() const;
+
+    /* Returns the vertices of the cached mesh (mapped, not copied). */
+    const Vertex* getVertices() const;
+    std::size_t getVertexCount() const;
+
+    /* Returns the faces of the cached mesh (mapped, not copied). */
+    const TriangleFace* getFaces() const;
+    std::size_t getFaceCount() const;
+
+    /* Copies the sub-meshes of the cached mesh. */
+    void getSubMeshes(std::vector<SubMesh>& subMeshes) const;
+
+    /* Copies the levels of detail of the cached mesh. */
+    void getLods(MeshLodChain& chain) const;
+
+    /* Copies the clusters of the cached mesh. */
+    void getClusters(std::vector<MeshCluster>& clusters) const;
+
+    /* Copies the material libraries referenced by the cached mesh. */
+    void getMaterialLibraries(std::vector<std::string>& materialLibraries) const;
+
+    /* Returns the bounds of the vertex positions of the cached mesh. */
+    void getBounds(Vector3f& minimum, Vector3f& maximum) const;
+
+    /* Returns the vertex cache efficiency of the cached mesh. */
+    void getStatistics(MeshOptimizationStatistics& statistics) const;
+
+protected:
+    MeshCache(const MeshCache&) = delete;
+    MeshCache& operator = (const MeshCache&) = delete;
+
+protected:
+    MappedFile file;
+    const MeshCacheHeader* header;
+    const Vertex* vertices;
+    const TriangleFace* faces;
+    const MeshCacheSubMesh* subMeshes;
+    const float* lodErrors;
+    const MeshCacheLodRange* lodRanges;
+    const MeshCacheCluster* clusters;
+    const char* materialLibraries;
+};
+
+/* Returns the name of the cache file of the provided source file. */
+std::string GetMeshCacheFilename(const std::string& sourceFilename);
+
+/*
+ * Writes the cache of a mesh loaded from the provided source file.
+ *
+ * @param sourceFilename - The name of the source (*.obj) file.
+ * @param bComputeNormals - The normal option the mesh was loaded with.
+ * @param normalWeighting - The weighting of computed normals.
+ * @param bOptimizeFaceOrder - The face order option the mesh was loaded with.
+ * @param statistics - The vertex cache efficiency of the mesh.
+ * @param bGenerateLods - The level of detail option the mesh was loaded with.
+ * @param lodChain - The levels of detail of the mesh.
+ * @param bGenerateClusters - The cluster option the mesh was loaded with.
+ * @param clusters - The clusters of the mesh.
+ * @param name - The name of the mesh.
+ * @param vertices - The final vertices of the mesh.
+ * @param faces - The final faces of the mesh (including its levels of detail).
+ * @param subMeshes - The sub-meshes of the mesh.
+ * @param materialLibraries - The material libraries referenced by the mesh.
+ *
+ * @return If the cache is written successfully then this function will
+ * return true; otherwise it will return false.
+ */
+bool SaveMeshCache(const std::string& sourceFilename, bool bComputeNormals, MeshNormalWeighting normalWeighting, bool bOptimizeFaceOrder, const MeshOptimizationStatistics& statistics, bool bGenerateLods, const MeshLodChain& lodChain, bool bGenerateClusters, const std::vector<MeshCluster>& clusters, const std::string& name, const std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces, const std::vector<SubMesh>& subMeshes, const std::vector<std::string>& materialLibraries);
+
+}
+
+#endif
@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "MeshResidency.h"
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+
+namespace sgpu {
+
+MeshResidencyManager::MeshResidencyManager(std::size_t memoryBudget, std::size_t loaderCount) {
+    this->memoryBudget = memoryBudget;
+    this->uploadBudget = MESH_DEFAULT_UPLOAD_BUDGET;
+    this->residentSize = 0u;
+    this->frame = 0u;
+    this->nextGeneration = 1u;
+    this->bStopping = false;
+
+    for ( std::size_t i = 0; i < std::max<std::size_t>(loaderCount, 1u); i++ )
+        this->loaders.emplace_back(&MeshResidencyManager::runLoader, this);
+}
+
+MeshResidencyManager::~MeshResidencyManager() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->bStopping = true;
+    }
+
+    this->condition.notify_all();
+    for ( std::size_t i = 0; i < this->loaders.size(); i++ ) this->loaders[i].join();
+
+    std::map<const Mesh*, Record>::iterator it;
+    for ( it = this->records.begin(); it != this->records.end(); it++ )
+        it->second.mesh->residencyManager = nullptr;
+}
+
+void MeshResidencyManager::update() {
+    std::vector<Job> finished;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        finished.swap(this->results);
+    }
+
+    //--------------------------------------------------------------------------
+    // Upload the loaded meshes until the upload budget of this frame is spent.
+    // Loads of meshes that were removed or made resident since are dropped.
+    //--------------------------------------------------------------------------
+    std::size_t uploaded = 0u;
+    std::size_t i = 0;
+    for ( ; i < finished.size(); i++ ) {
+        if ( uploaded > 0 && uploaded >= this->uploadBudget ) break;
+
+        std::map<const Mesh*, Record>::iterator it = this->records.find(finished[i].mesh);
+        if ( it == this->records.end() || it->second.generation != finished[i].generation ) continue;
+
+        Record& record = it->second;
+        if ( !finished[i].bLoaded ) {
+            record.residency = MESH_FAILED;
+            continue;
+        }
+
+        this->adopt(record, *finished[i].staging);
+        uploaded += record.size;
+    }
+
+    if ( i < finished.size() ) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->results.insert(this->results.begin(), std::make_move_iterator(finished.begin() + i), std::make_move_iterator(finished.end()));
+    }
+
+    //--------------------------------------------------------------------------
+    // Evict the least recently drawn meshes. Meshes drawn in this or the
+    // previous frame are kept even if the budget is exceeded, so update may
+    // be called at either end of a frame.
+    //--------------------------------------------------------------------------
+    while ( this->residentSize > this->memoryBudget ) {
+        Record* victim = nullptr;
+        std::map<const Mesh*, Record>::iterator it;
+        for ( it = this->records.begin(); it != this->records.end(); it++ ) {
+            Record& record = it->second;
+            if ( record.residency != MESH_RESIDENT || record.lastUsedFrame + 1u >= this->frame ) continue;
+            if ( victim == nullptr || record.lastUsedFrame < victim->lastUsedFrame ) victim = &record;
+        }
+
+        if ( victim == nullptr ) break;
+        this->evict(*victim);
+    }
+
+    this->frame++;
+}
+
+void MeshResidencyManager::setMemoryBudget(std::size_t memoryBudget) {
+    this->memoryBudget = memoryBudget;
+}
+
+void MeshResidencyManager::setUploadBudget(std::size_t uploadBudget) {
+    this->uploadBudget = uploadBudget;
+}
+
+std::size_t MeshResidencyManager::getMemoryBudget() const {
+    return this->memoryBudget;
+}
+
+std::size_t MeshResidencyManager::getUploadBudget() const {
+    return this->uploadBudget;
+}
+
+std::size_t MeshResidencyManager::getResidentSize() const {
+    return this->residentSize;
+}
+
+std::size_t MeshResidencyManager::getMeshCount() const {
+    return this->records.size();
+}
+
+std::size_t MeshResidencyManager::getResidentCount() const {
+    std::size_t count = 0u;
+    std::map<const Mesh*, Record>::const_iterator it;
+    for ( it = this->records.begin(); it != this->records.end(); it++ )
+        if ( it->second.residency == MESH_RESIDENT ) count++;
+    return count;
+}
+
+MeshResidency MeshResidencyManager::getResidency(const Mesh& mesh) const {
+    std::map<const Mesh*, Record>::const_iterator it = this->records.find(&mesh);
+    if ( it == this->records.end() ) return MESH_FAILED;
+    return it->second.residency;
+}
+
+void MeshResidencyManager::add(Mesh* mesh) {
+    Record record;
+    record.mesh = mesh;
+    record.residency = MESH_REGISTERED;
+    record.generation = this->nextGeneration++;
+    record.lastUsedFrame = 0u;
+    record.size = 0u;
+
+    this->records[mesh] = record;
+    mesh->residencyManager = this;
+}
+
+void MeshResidencyManager::remove(Mesh* mesh) {
+    std::map<const Mesh*, Record>::iterator it = this->records.find(mesh);
+    if ( it == this->records.end() ) return;
+
+    this->residentSize -= it->second.size;
+    this->records.erase(it);
+    mesh->residencyManager = nullptr;
+
+    //--------------------------------------------------------------------------
+    // Queued loads of the mesh are cancelled; a load in progress finishes and
+    // is dropped by update.
+    //--------------------------------------------------------------------------
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->jobs.erase(std::remove_if(this->jobs.begin(), this->jobs.end(), [mesh](const Job& job) { return job.mesh == mesh; }), this->jobs.end());
+}
+
+void MeshResidencyManager::request(const Mesh* mesh) {
+    std::map<const Mesh*, Record>::iterator it = this->records.find(mesh);
+    if ( it == this->records.end() ) return;
+
+    Record& record = it->second;
+    record.lastUsedFrame = this->frame;
+    if ( record.residency != MESH_REGISTERED ) return;
+
+    Job job;
+    job.mesh = mesh;
+    job.generation = record.generation;
+    job.filename = mesh->sourceFilename;
+    job.staging = mesh->createStaging();
+    job.bLoaded = false;
+    record.residency = MESH_LOADING;
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->jobs.push_back(std::move(job));
+    }
+
+    this->condition.notify_all();
+}
+
+bool MeshResidencyManager::makeResident(const Mesh* mesh) {
+    std::map<const Mesh*, Record>::iterator it = this->records.find(mesh);
+    if ( it == this->records.end() ) return false;
+
+    Record& record = it->second;
+    record.lastUsedFrame = this->frame;
+    if ( record.residency == MESH_RESIDENT ) return true;
+    if ( record.residency == MESH_FAILED ) return false;
+
+    //--------------------------------------------------------------------------
+    // A queued or running load of the mesh is superseded by loading it on
+    // this thread, after any load of the same file has finished.
+    //--------------------------------------------------------------------------
+    record.generation = this->nextGeneration++;
+    std::shared_ptr<Mesh> staging = mesh->createStaging();
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->jobs.erase(std::remove_if(this->jobs.begin(), this->jobs.end(), [mesh](const Job& job) { return job.mesh == mesh; }), this->jobs.end());
+        this->condition.wait(lock, [this, mesh]() { return this->loadingFiles.count(mesh->sourceFilename) == 0; });
+        this->loadingFiles.insert(mesh->sourceFilename);
+    }
+
+    bool bLoaded = staging->loadStaging();
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->loadingFiles.erase(mesh->sourceFilename);
+    }
+
+    this->condition.notify_all();
+    if ( !bLoaded ) {
+        record.residency = MESH_FAILED;
+        return false;
+    }
+
+    this->adopt(record, *staging);
+    return true;
+}
+
+void MeshResidencyManager::adopt(Record& record, Mesh& staging) {
+    record.size = record.mesh->adopt(staging);
+    record.residency = MESH_RESIDENT;
+    record.lastUsedFrame = std::max(record.lastUsedFrame, this->frame);
+    this->residentSize += record.size;
+}
+
+void MeshResidencyManager::evict(Record& record) {
+    record.mesh->release();
+    record.residency = MESH_REGISTERED;
+    this->residentSize -= record.size;
+    record.size = 0u;
+}
+
+void MeshResidencyManager::runLoader() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while ( true ) {
+        //----------------------------------------------------------------------
+        // Take the oldest job whose file is not being loaded by another thread.
+        //----------------------------------------------------------------------
+        std::deque<Job>::iterator it = this->jobs.end();
+        while ( !this->bStopping ) {
+            it = std::find_if(this->jobs.begin(), this->jobs.end(), [this](const Job& job) { return this->loadingFiles.count(job.filename) == 0; });
+            if ( it != this->jobs.end() ) break;
+            this->condition.wait(lock);
+        }
+
+        if ( this->bStopping ) return;
+
+        Job job = std::move(*it);
+        this->jobs.erase(it);
+        this->loadingFiles.insert(job.filename);
+        lock.unlock();
+
+        job.bLoaded = job.staging->loadStaging();
+        if ( !job.bLoaded ) std::cerr << "[MeshResidencyManager:load] Error: Could not load mesh: " << job.filename << std::endl;
+
+        lock.lock();
+        this->loadingFiles.erase(job.filename);
+        this->results.push_back(std::move(job));
+        this->condition.notify_all();
+    }
+}
+
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "MappedFile.h"
+#include <iostream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace sgpu {
+
+MappedFile::MappedFile() {
+    this->view = nullptr;
+    this->length = 0;
+    this->opened = false;
+#ifdef _WIN32
+    this->fileHandle = INVALID_HANDLE_VALUE;
+    this->mappingHandle = nullptr;
+#else
+    this->fileDescriptor = -1;
+#endif
+}
+
+MappedFile::~MappedFile() {
+    this->close();
+}
+
+#ifdef _WIN32
+bool MappedFile::open(const std::string& filename) {
+    this->close();
+
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if ( file == INVALID_HANDLE_VALUE ) {
+        std::cerr << "[MappedFile:open] Error: The file: " << filename << " could not be opened." << std::endl;
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if ( !GetFileSizeEx(file, &fileSize) ) {
+        std::cerr << "[MappedFile:open] Error: Could not determine the size of: " << filename << std::endl;
+        CloseHandle(file);
+        return false;
+    }
+
+    this->fileHandle = file;
+    this->length = static_cast<std::size_t>(fileSize.QuadPart);
+    this->opened = true;
+
+    //--------------------------------------------------------------------------
+    // Zero length files cannot be mapped; they are still considered open so
+    // that readers simply see an empty range.
+    //--------------------------------------------------------------------------
+    if ( this->length == 0 ) return true;
+
+    this->mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if ( this->mappingHandle == nullptr ) {
+        std::cerr << "[MappedFile:open] Error: Could not create a file mapping for: " << filename << std::endl;
+        this->close();
+        return false;
+    }
+
+    this->view = static_cast<const char*>(MapViewOfFile(this->mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if ( this->view == nullptr ) {
+        std::cerr << "[MappedFile:open] Error: Could not map a view of: " << filename << std::endl;
+        this->close();
+        return false;
+    }
+
+    return true;
+}
+
+void MappedFile::close() {
+    if ( this->view != nullptr ) UnmapViewOfFile(this->view);
+    if ( this->mappingHandle != nullptr ) CloseHandle(this->mappingHandle);
+    if ( this->fileHandle != INVALID_HANDLE_VALUE ) CloseHandle(this->fileHandle);
+
+    this->view = nullptr;
+    this->mappingHandle = nullptr;
+    this->fileHandle = INVALID_HANDLE_VALUE;
+    this->length = 0;
+    this->opened = false;
+}
+#else
+bool MappedFile::open(const std::string& filename) {
+    this->close();
+
+    int file = ::open(filename.c_str(), O_RDONLY);
+    if ( file < 0 ) {
+        std::cerr << "[MappedFile:open] Error: The file: " << filename << " could not be opened." << std::endl;
+        return false;
+    }
+
+    struct stat fileInfo;
+    if ( fstat(file, &fileInfo) != 0 ) {
+        std::cerr << "[MappedFile:open] Error: Could not determine the size of: " << filename << std::endl;
+        ::close(file);
+        return false;
+    }
+
+    this->fileDescriptor = file;
+    this->length = static_cast<std::size_t>(fileInfo.st_size);
+    this->opened = true;
+
+    //--------------------------------------------------------------------------
+    // Zero length files cannot be mapped; they are still considered open so
+    // that readers simply see an empty range.
+    //--------------------------------------------------------------------------
+    if ( this->length == 0 ) return true;
+
+    void* mapping = mmap(nullptr, this->length, PROT_READ, MAP_PRIVATE, file, 0);
+    if ( mapping == MAP_FAILED ) {
+        std::cerr << "[MappedFile:open] Error: Could not map: " << filename << std::endl;
+        this->close();
+        return false;
+    }
+
+    madvise(mapping, this->length, MADV_SEQUENTIAL);
+    this->view = static_cast<const char*>(mapping);
+    return true;
+}
+
+void MappedFile::close() {
+    if ( this->view != nullptr ) munmap(const_cast<char*>(this->view), this->length);
+    if ( this->fileDescriptor >= 0 ) ::close(this->fileDescriptor);
+
+    this->view = nullptr;
+    this->fileDescriptor = -1;
+    this->length = 0;
+    this->opened = false;
+}
+#endif
+
+bool MappedFile::isOpen() const {
+    return this->opened;
+}
+
+const char* MappedFile::data() const {
+    return this->view;
+}
+
+std::size_t MappedFile::size() const {
+    return this->length;
+}
+
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MESH_RESIDENCY_H
+#define MESH_RESIDENCY_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <set>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "Mesh.h"
+
+namespace sgpu {
+
+/* Default GPU memory budget of the resident meshes of a manager (512 MB). */
+const std::size_t MESH_DEFAULT_RESIDENCY_BUDGET = 512u << 20;
+
+/* Default number of bytes uploaded by MeshResidencyManager::update (32 MB). */
+const std::size_t MESH_DEFAULT_UPLOAD_BUDGET = 32u << 20;
+
+/*
+ * Default number of loader threads. The Obj parser already splits a file
+ * across every core, so a few loaders are enough to keep them busy.
+ */
+const std::size_t MESH_DEFAULT_LOADER_COUNT = 2u;
+
+enum MeshResidency {
+    MESH_REGISTERED,    /* Only the header of the mesh has been read. */
+    MESH_LOADING,       /* The mesh is queued or loading on a loader thread. */
+    MESH_RESIDENT,      /* The mesh is uploaded to the GPU and can be drawn. */
+    MESH_FAILED         /* The mesh could not be loaded; it is not retried. */
+};
+
+/*
+ * Loads the meshes registered with Mesh::loadLazy when they are first drawn
+ * or prefetched, and evicts the least recently drawn meshes when the resident
+ * meshes exceed the memory budget. Meshes are parsed (or decoded) on loader
+ * threads and uploaded by update, so the loader threads never use OpenGL.
+ *
+ * Every function must be called from the thread that owns the OpenGL context.
+ * Meshes may outlive their manager; they keep the buffers they are resident
+ * with but are no longer loaded or evicted.
+ */
+class MeshResidencyManager {
+public:
+    MeshResidencyManager(std::size_t memoryBudget = MESH_DEFAULT_RESIDENCY_BUDGET, std::size_t loaderCount = MESH_DEFAULT_LOADER_COUNT);
+    ~MeshResidencyManager();
+
+    /*
+     * Uploads the meshes loaded since the last update (at least one, then up
+     * to the upload budget) and evicts meshes that were not drawn in this or
+     * the previous frame while the resident meshes exceed the memory budget.
+     * This function must be called once per frame.
+     */
+    void update();
+
+    void setMemoryBudget(std::size_t memoryBudget);
+    void setUploadBudget(std::size_t uploadBudget);
+
+    std::size_t getMemoryBudget() const;
+    std::size_t getUploadBudget() const;
+
+    /* Returns the GPU memory used by the resident meshes (in bytes). */
+    std::size_t getResidentSize() const;
+
+    std::size_t getMeshCount() const;
+    std::size_t getResidentCount() const;
+
+    /* Returns the residency of a mesh (MESH_FAILED if it is not registered). */
+    MeshResidency getResidency(const Mesh& mesh) const;
+
+protected:
+    friend class Mesh;
+
+    /* Load of a mesh into a staging mesh on a loader thread. */
+    struct Job {
+        const Mesh* mesh;
+        std::uint64_t generation;
+        std::string filename;
+        std::shared_ptr<Mesh> staging;
+        bool bLoaded;
+    };
+
+    struct Record {
+        Mesh* mesh;
+        MeshResidency residency;
+        std::uint64_t generation;
+        std::uint64_t lastUsedFrame;
+        std::size_t size;
+    };
+
+    void add(Mesh* mesh);
+    void remove(Mesh* mesh);
+    void request(const Mesh* mesh);
+    bool makeResident(const Mesh* mesh);
+    void adopt(Record& record, Mesh& staging);
+    void evict(Record& record);
+    void runLoader();
+
+    MeshResidencyManager(const MeshResidencyManager&) = delete;
+    MeshResidencyManager& operator = (const MeshResidencyManager&) = delete;
+
+protected:
+    std::map<const Mesh*, Record> records;
+    std::size_t memoryBudget;
+    std::size_t uploadBudget;
+    std::size_t residentSize;
+    std::uint64_t frame;
+
+    /* Identifies a registration so stale loads of a mesh are discarded. */
+    std::uint64_t nextGeneration;
+
+    /*
+     * State shared with the loader threads. Loads of the same file are never
+     * run at the same time since an Obj load may rewrite its cache.
+     */
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<Job> jobs;
+    std::vector<Job> results;
+    std::set<std::string> loadingFiles;
+    std::vector<std::thread> loaders;
+    bool bStopping;
+};
+
+}
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MESH_CLUSTERS_H
+#define MESH_CLUSTERS_H
+
+#include <vector>
+#include <cstdint>
+#include <Mathematics.h>
+#include <Matrix4.h>
+#include "Vertex.h"
+#include "Face.h"
+
+namespace sgpu {
+
+/* Most vertices referenced by the faces of a cluster. */
+const std::size_t MESH_CLUSTER_MAX_VERTICES = 64u;
+
+/* Most faces of a cluster. */
+const std::size_t MESH_CLUSTER_MAX_FACES = 124u;
+
+/*
+ * Range of faces of one sub-mesh that is culled as a whole (see
+ * CullMeshClusters). The bounds and normal cone are in object space.
+ */
+struct MeshCluster {
+    std::uint32_t faceOffset;
+    std::uint32_t faceCount;
+    std::uint32_t minIndex;
+    std::uint32_t maxIndex;
+    std::uint32_t subMesh;
+
+    /* Bounding sphere of the vertices of the cluster. */
+    Vector3f center;
+    float radius;
+
+    /*
+     * Normal cone of the faces of the cluster: every face normal is within
+     * the cone around coneAxis whose sine of its half angle is coneCutoff.
+     * A cutoff of 1 means the faces of the cluster never all face away.
+     */
+    Vector3f coneAxis;
+    float coneCutoff;
+};
+
+/*
+ * Splits the faces of each sub-mesh into clusters of at most
+ * MESH_CLUSTER_MAX_VERTICES vertices and MESH_CLUSTER_MAX_FACES faces. A
+ * cluster grows from a seed face by the neighboring face that adds the fewest
+ * vertices and keeps its normal cone and extent small. The faces of each
+ * sub-mesh are reordered cluster by cluster, so every cluster is a range of
+ * the index buffer, and the faces of a cluster are ordered for the vertex
+ * cache (see OptimizeVertexCache).
+ */
+void BuildMeshClusters(const std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces, const std::vector<SubMesh>& subMeshes, std::vector<MeshCluster>& clusters);
+
+/*
+ * Culls the clusters that are outside the view frustum or whose faces all
+ * face away from the eye, and returns the face ranges of the remaining
+ * clusters as sub-meshes (adjacent ranges are merged).
+ *
+ * @param modelView - The model-view matrix of the mesh.
+ * @param projection - The projection matrix of the camera.
+ * @param bConeCulling - Whether back-facing clusters are culled. The normal
+ * cones are only valid if the model-view matrix does not scale non-uniformly.
+ * @param visibleSubMeshes - Receives the ranges of the remaining clusters.
+ *
+ * @return Returns the number of faces of the remaining clusters.
+ */
+std::size_t CullMeshClusters(const std::vector<MeshCluster>& clusters, const std::vector<SubMesh>& subMeshes, const Matrix4f& modelView, const Matrix4f& projection, bool bConeCulling, std::vector<SubMesh>& visibleSubMeshes);
+
+}
+
+#endif
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef VERTEX_LAYOUT_H
+#define VERTEX_LAYOUT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <Mathematics.h>
+#include "Vertex.h"
+#include "Face.h"
+
+namespace sgpu {
+
+/* Largest vertex count of a mesh that can be drawn with 16-bit indices. */
+const std::size_t VERTEX_LAYOUT_SHORT_INDEX_LIMIT = 65536u;
+
+/* Vertex attributes in the order they are stored within a vertex. */
+enum VertexAttribute {
+    VERTEX_POSITION,
+    VERTEX_NORMAL,
+    VERTEX_TANGENT,
+    VERTEX_TEXTURE_COORD,
+    VERTEX_COLOR,
+    VERTEX_ATTRIBUTE_COUNT
+};
+
+/* Storage of the normals and tangents of a vertex layout. */
+enum VertexDirectionFormat {
+    VERTEX_DIRECTION_FLOAT,             /* 3 floats (normal), 4 floats (tangent). */
+    VERTEX_DIRECTION_INT_2_10_10_10,    /* Signed normalized 10_10_10_2, read as vec4. */
+    VERTEX_DIRECTION_OCTAHEDRAL         /* 2 (normal) or 4 (tangent) signed normalized shorts. */
+};
+
+/* Storage of the texture-coords of a vertex layout. */
+enum VertexTextureCoordFormat {
+    VERTEX_TEXTURE_COORD_FLOAT,         /* 3 floats. */
+    VERTEX_TEXTURE_COORD_HALF           /* 2 half floats (z reads as 0). */
+};
+
+/* Storage of the colors of a vertex layout. */
+enum VertexColorFormat {
+    VERTEX_COLOR_NONE,                  /* Not stored; the color reads as black. */
+    VERTEX_COLOR_FLOAT,                 /* 3 floats. */
+    VERTEX_COLOR_UNORM8                 /* 4 unsigned normalized bytes (alpha is 1). */
+};
+
+/*
+ * Layout of the vertex and index buffers of a Mesh. Positions are always
+ * stored as 3 floats and every attribute is 4 byte aligned. The default
+ * layout stores Vertex structures (64 bytes) and 32-bit indices.
+ *
+ * Packed attributes are read by the attribute declarations of the default
+ * layout, except for octahedral directions. Those are read as vec2 (normal)
+ * and vec4 (tangent: xy octahedral, z handedness) and decoded by the shader:
+ *
+ *     vec3 octahedralDecode(vec2 e) {
+ *         vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+ *         if ( v.z < 0.0 ) v.xy = (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+ *         return normalize(v);
+ *     }
+ */
+struct VertexLayout {
+    VertexLayout();
+
+    /*
+     * Returns the 24 byte layout: 10_10_10_2 normals and tangents, half float
+     * texture-coords, no colors, and 16-bit indices.
+     */
+    static VertexLayout Compact();
+
+    VertexDirectionFormat directionFormat;      /* default VERTEX_DIRECTION_FLOAT */
+    VertexTextureCoordFormat textureCoordFormat;/* default VERTEX_TEXTURE_COORD_FLOAT */
+    VertexColorFormat colorFormat;              /* default VERTEX_COLOR_FLOAT */
+
+    /* Use 16-bit indices for meshes of at most 65536 vertices (default false). */
+    bool bShortIndices;
+};
+
+/* Returns the size in bytes of an attribute of a vertex of the layout (0 if not stored). */
+std::size_t GetVertexAttributeSize(const VertexLayout& layout, VertexAttribute attribute);
+
+/* Returns the byte offset of an attribute within a vertex of the layout. */
+std::size_t GetVertexAttributeOffset(const VertexLayout& layout, VertexAttribute attribute);
+
+/* Returns the size in bytes of a vertex of the layout. */
+std::size_t GetVertexSize(const VertexLayout& layout);
+
+/* Returns true if the vertices of the layout are stored as Vertex structures. */
+bool IsUnpackedVertexLayout(const VertexLayout& layout);
+
+/*
+ * Converts vertices into the layout.
+ *
+ * @param layout - The layout of the packed vertices.
+ * @param vertices - The vertices to convert.
+ * @param vertexCount - The number of vertices.
+ * @param packed - Receives vertexCount * GetVertexSize(layout) bytes.
+ */
+void PackVertices(const VertexLayout& layout, const Vertex* vertices, std::size_t vertexCount, void* packed);
+
+/* Converts the indices of faces whose vertices are all < 65536 to 16 bits. */
+void PackShortIndices(const TriangleFace* faces, std::size_t faceCount, std::uint16_t* indices);
+
+}
+
+#endif
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "Benchmarks.h"
+#include <ObjMesh.h>
+#include <MeshPrimitives.h>
+#include <iostream>
+#include <cstdlib>
+
+namespace sgpu {
+
+/* Prefix of a generated grid input (see Benchmark_LoadCorners). */
+const static std::string BENCHMARK_GRID_PREFIX = "grid:";
+
+/* Returns the vertex of a node of an Obj face (attributes it lacks are zero). */
+Vertex Benchmark_ObjCorner(const ObjMesh& mesh, std::size_t node) {
+    Vertex corner;
+    std::uint32_t textureIndex = mesh.textureIndices[node];
+    std::uint32_t normalIndex = mesh.normalIndices[node];
+
+    corner.position = mesh.vertices[mesh.vertexIndices[node]];
+    corner.normal = (normalIndex < mesh.normals.size()) ? mesh.normals[normalIndex] : Vector3f(0.0f, 0.0f, 0.0f);
+    corner.tangent = Vector4f(0.0f, 0.0f, 0.0f, 0.0f);
+    corner.textureCoord = (textureIndex < mesh.textureCoordinates.size()) ? mesh.textureCoordinates[textureIndex] : Vector3f(0.0f, 0.0f, 0.0f);
+    corner.color = Color3f(0.0f, 0.0f, 0.0f);
+    return corner;
+}
+
+bool Benchmark_LoadCorners(const std::string& input, std::vector<Vertex>& corners) {
+    corners.clear();
+
+    if ( input.compare(0, BENCHMARK_GRID_PREFIX.size(), BENCHMARK_GRID_PREFIX) == 0 ) {
+        long quads = std::strtol(input.c_str() + BENCHMARK_GRID_PREFIX.size(), nullptr, 10);
+        std::vector<Vertex> vertices;
+        std::vector<TriangleFace> faces;
+        if ( quads <= 0 || !GeneratePlane(2.0f, 2.0f, static_cast<unsigned int>(quads), static_cast<unsigned int>(quads), vertices, faces) ) {
+            std::cerr << "[MeshBenchmarks] Error: Invalid grid: " << input << std::endl;
+            return false;
+        }
+
+        corners.reserve(faces.size() * TRIANGLE_EDGE_COUNT);
+        for ( const TriangleFace& face : faces ) {
+            for ( std::size_t j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) corners.push_back(vertices[face.indices[j]]);
+        }
+        return true;
+    }
+
+    ObjFile file;
+    if ( !file.load(input) ) {
+        std::cerr << "[MeshBenchmarks] Error: Could not load Obj file: " << input << std::endl;
+        return false;
+    }
+
+    for ( std::size_t i = 0; i < file.size(); i++ ) {
+        const ObjMesh& mesh = *file.getMesh(i);
+        for ( const Obj_Face& face : mesh.faces ) {
+            for ( std::uint32_t k = 1; k + 1 < face.count; k++ ) {
+                corners.push_back(Benchmark_ObjCorner(mesh, face.offset));
+                corners.push_back(Benchmark_ObjCorner(mesh, face.offset + k));
+                corners.push_back(Benchmark_ObjCorner(mesh, face.offset + k + 1));
+            }
+        }
+    }
+
+    return true;
+}
+
+void Benchmark_IndexCorners(const std::vector<Vertex>& corners, std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces) {
+    VertexSet set;
+    vertices.clear();
+    faces.resize(corners.size() / TRIANGLE_EDGE_COUNT);
+
+    for ( std::size_t i = 0; i < faces.size(); i++ ) {
+        for ( std::size_t j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) faces[i].indices[j] = set.insert(corners[i * TRIANGLE_EDGE_COUNT + j], vertices);
+    }
+}
+
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include <Mathematics.h>
+#include <Face.h>
+
+namespace sgpu {
+
+/* Minimum time each measurement of a benchmark is repeated for (in seconds). */
+const double BENCHMARK_MIN_SECONDS = 1.0;
+
+/* Returns the time of a steady clock in seconds. */
+inline double Benchmark_Seconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+ * Runs function repeatedly for at least BENCHMARK_MIN_SECONDS and returns
+ * the time of the fastest run in seconds.
+ */
+template <typename Function>
+double Benchmark_BestTime(Function function) {
+    double best = 0.0;
+    double start = Benchmark_Seconds();
+    std::size_t runs = 0u;
+    do {
+        double begin = Benchmark_Seconds();
+        function();
+        double time = Benchmark_Seconds() - begin;
+        if ( runs == 0u || time < best ) best = time;
+        runs++;
+    } while ( Benchmark_Seconds() - start < BENCHMARK_MIN_SECONDS );
+    return best;
+}
+
+/* Returns the file name of a path without its directories. */
+std::string Benchmark_FileName(const std::string& filename);
+
+/*
+ * Reads the triangle corners of a benchmark input, three vertices per
+ * triangle in face order. An input is either an Obj file, whose polygons are
+ * split into triangle fans, or "grid:<n>", a plane of n x n quads generated
+ * by GeneratePlane (2n^2 triangles).
+ */
+bool Benchmark_LoadCorners(const std::string& input, std::vector<Vertex>& corners);
+
+/* Merges the equal corners of Benchmark_LoadCorners into indexed triangles. */
+void Benchmark_IndexCorners(const std::vector<Vertex>& corners, std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces);
+
+/*
+ * Measures the throughput of ObjFile::load in every ObjLoadMode on Obj files
+ * and verifies that the mapped and parallel readers produce the meshes of
+ * the stream reader. Returns the exit code of the tool.
+ */
+int RunObjLoadBenchmark(int argc, char** argv);
+
+/*
+ * Measures the compression ratio and the encode and decode times of the
+ * compressed mesh format (see CompressedMesh) and verifies the round trip
+ * of both the SSE2 and the scalar vertex decoder. Returns the exit code of
+ * the tool.
+ */
+int RunCodecBenchmark(int argc, char** argv);
+
+/*
+ * Opens and decodes corrupted copies of a compressed mesh: truncated files
+ * and files with flipped bits or random bytes. Fails if a corrupted file
+ * crashes the decoder or decodes to an index outside of its vertices.
+ * Returns the exit code of the tool.
+ */
+int RunCodecFuzz(int argc, char** argv);
+
+/*
+ * Measures the merging of equal triangle corners by VertexSet against the
+ * float sum hash map it replaced, and verifies that both produce the same
+ * indices. Returns the exit code of the tool.
+ */
+int RunVertexSetBenchmark(int argc, char** argv);
+
+}
+
+#endif
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "Benchmarks.h"
+#include <MeshCodec.h>
+#include <MeshNormals.h>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <iterator>
+#include <filesystem>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+
+namespace sgpu {
+
+/* Number of corrupted files decoded by the fuzz benchmark by default. */
+const int CODEC_FUZZ_DEFAULT_ITERATIONS = 3000;
+
+/*
+ * Largest vertex or face count of a corrupted file that is decoded. A
+ * corrupted header can claim more elements than fit into memory; such files
+ * are only opened.
+ */
+const std::size_t CODEC_FUZZ_MAX_ELEMENTS = 1u << 24;
+
+/*
+ * Largest distance of a decoded unit normal or tangent from its original
+ * (the default 10 bit octahedral tangents are within about 0.005).
+ */
+const float CODEC_MAX_DIRECTION_ERROR = 0.02f;
+
+/* Returns the path of a temporary compressed mesh of the benchmarks. */
+std::string Codec_TemporaryPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+/*
+ * Writes the compressed form of a benchmark input (see Benchmark_LoadCorners)
+ * as one sub-mesh without material.
+ */
+bool Codec_SaveInput(const std::string& filename, const std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces) {
+    std::vector<SubMesh> subMeshes(1u);
+    subMeshes[0].faceOffset = 0u;
+    subMeshes[0].faceCount = static_cast<std::uint32_t>(faces.size());
+    subMeshes[0].minIndex = 0u;
+    subMeshes[0].maxIndex = vertices.size() > 0u ? static_cast<std::uint32_t>(vertices.size() - 1u) : 0u;
+    subMeshes[0].materialIndex = SUBMESH_NO_MATERIAL;
+    return SaveCompressedMesh(filename, "benchmark", vertices, faces, subMeshes, std::vector<std::string>());
+}
+
+/* Returns the largest distance of a decoded position from its original. */
+double Codec_MaxPositionError(const std::vector<Vertex>& original, const std::vector<Vertex>& decoded) {
+    double error = 0.0;
+    for ( std::size_t i = 0; i < original.size(); i++ ) error = std::max(error, (decoded[i].position - original[i].position).length());
+    return error;
+}
+
+/*
+ * Returns true if the unit normals and tangents of the decoded vertices are
+ * within CODEC_MAX_DIRECTION_ERROR of the original ones and every tangent
+ * keeps its handedness. Zero (undefined) directions are not compared.
+ */
+bool Codec_DirectionsMatch(const std::vector<Vertex>& original, const std::vector<Vertex>& decoded) {
+    for ( std::size_t i = 0; i < original.size(); i++ ) {
+        const Vector4f& tangent = original[i].tangent;
+        const Vector4f& decodedTangent = decoded[i].tangent;
+        Vector3f direction(tangent.x(), tangent.y(), tangent.z());
+        Vector3f decodedDirection(decodedTangent.x(), decodedTangent.y(), decodedTangent.z());
+
+        if ( original[i].normal.length() > 0.5f && (decoded[i].normal - original[i].normal).length() > CODEC_MAX_DIRECTION_ERROR ) return false;
+        if ( direction.length() <= 0.5f ) continue;
+        if ( (decodedDirection - direction).length() > CODEC_MAX_DIRECTION_ERROR || (decodedTangent.w() < 0.0f) != (tangent.w() < 0.0f) ) return false;
+    }
+
+    return true;
+}
+
+/*
+ * Decodes an open compressed mesh with the SSE2 (bSimd) or the scalar vertex
+ * path and returns true if the faces match the original ones exactly and the
+ * directions within the quantization (see Codec_DirectionsMatch).
+ */
+bool Codec_CheckRoundTrip(const CompressedMesh& mesh, const std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces, bool bSimd, std::vector<Vertex>& decodedVertices, std::vector<TriangleFace>& decodedFaces) {
+    decodedVertices.assign(mesh.getVertexCount(), Vertex());
+    decodedFaces.assign(mesh.getFaceCount(), TriangleFace());
+    if ( decodedVertices.size() != vertices.size() || decodedFaces.size() != faces.size() ) return false;
+    if ( !mesh.decode(decodedVertices.data(), decodedFaces.data(), bSimd) ) return false;
+
+    for ( std::size_t f = 0; f < faces.size(); f++ ) {
+        if ( !std::equal(faces[f].indices, faces[f].indices + TRIANGLE_EDGE_COUNT, decodedFaces[f].indices) ) return false;
+    }
+
+    return Codec_DirectionsMatch(vertices, decodedVertices);
+}
+
+int RunCodecBenchmark(int argc, char** argv) {
+    if ( argc == 0 ) {
+        std::cerr << "[MeshBenchmarks:codec] Error: No inputs provided." << std::endl;
+        return 1;
+    }
+
+    std::string path = Codec_TemporaryPath("MeshBenchmarks.sgmz");
+    std::cout << std::left << std::setw(20) << "input" << std::right << std::setw(10) << "vertices" << std::setw(10) << "faces";
+    std::cout << std::setw(10) << "raw MB" << std::setw(8) << "ratio" << std::setw(12) << "encode ms" << std::setw(12) << "decode ms" << std::setw(10) << "MB/s" << std::setw(12) << "max error" << std::endl;
+
+    int result = 0;
+    for ( int i = 0; i < argc; i++ ) {
+        std::vector<Vertex> corners, vertices;
+        std::vector<TriangleFace> faces;
+        if ( !Benchmark_LoadCorners(argv[i], corners) ) {
+            result = 1;
+            continue;
+        }
+        Benchmark_IndexCorners(corners, vertices, faces);
+        CalculateTangents(vertices, faces);
+
+        //----------------------------------------------------------------------
+        // The decoded faces must match the original faces exactly and the
+        // normals and tangents within their quantization, with both the SSE2
+        // and the scalar vertex paths. Positions are quantized and only
+        // reported by their largest error.
+        //----------------------------------------------------------------------
+        CompressedMesh mesh;
+        double encodeTime = Benchmark_BestTime([&]() { Codec_SaveInput(path, vertices, faces); });
+        if ( !Codec_SaveInput(path, vertices, faces) || !mesh.open(path) ) {
+            std::cerr << "[MeshBenchmarks:codec] Error: Could not compress: " << argv[i] << std::endl;
+            result = 1;
+            continue;
+        }
+
+        std::vector<Vertex> decodedVertices;
+        std::vector<TriangleFace> decodedFaces;
+        bool bScalarDecoded = Codec_CheckRoundTrip(mesh, vertices, faces, false, decodedVertices, decodedFaces);
+        bool bDecoded = Codec_CheckRoundTrip(mesh, vertices, faces, true, decodedVertices, decodedFaces) && bScalarDecoded;
+
+        double rawBytes = static_cast<double>(vertices.size() * sizeof(Vertex) + faces.size() * sizeof(TriangleFace));
+        double fileBytes = static_cast<double>(std::filesystem::file_size(path));
+        std::cout << std::left << std::setw(20) << Benchmark_FileName(argv[i]) << std::right << std::setw(10) << vertices.size() << std::setw(10) << faces.size();
+        std::cout << std::fixed << std::setprecision(2) << std::setw(10) << rawBytes / 1.0e6 << std::setprecision(1) << std::setw(8) << rawBytes / fileBytes;
+        if ( !bDecoded ) {
+            std::cout << std::setw(12) << encodeTime * 1.0e3 << std::setw(12) << "MISMATCH" << std::endl;
+            result = 1;
+            continue;
+        }
+
+        double decodeTime = Benchmark_BestTime([&]() { mesh.decode(decodedVertices.data(), decodedFaces.data()); });
+        std::cout << std::setw(12) << encodeTime * 1.0e3 << std::setw(12) << decodeTime * 1.0e3 << std::setw(10) << std::setprecision(0) << rawBytes / 1.0e6 / decodeTime;
+        std::cout << std::setw(12) << std::scientific << std::setprecision(2) << Codec_MaxPositionError(vertices, decodedVertices) << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+    }
+
+    std::filesystem::remove(path);
+    return result;
+}
+
+int RunCodecFuzz(int argc, char** argv) {
+    if ( argc == 0 ) {
+        std::cerr << "[MeshBenchmarks:fuzz] Error: No input provided." << std::endl;
+        return 1;
+    }
+
+    std::string path = Codec_TemporaryPath("MeshBenchmarks.sgmz");
+    std::string fuzzPath = Codec_TemporaryPath("MeshBenchmarks.fuzz.sgmz");
+    int iterations = (argc > 1) ? std::atoi(argv[1]) : CODEC_FUZZ_DEFAULT_ITERATIONS;
+
+    std::vector<Vertex> corners, vertices;
+    std::vector<TriangleFace> faces;
+    if ( !Benchmark_LoadCorners(argv[0], corners) ) return 1;
+    Benchmark_IndexCorners(corners, vertices, faces);
+    if ( !Codec_SaveInput(path, vertices, faces) ) {
+        std::cerr << "[MeshBenchmarks:fuzz] Error: Could not compress: " << argv[0] << std::endl;
+        return 1;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> original((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    std::filesystem::remove(path);
+
+    //--------------------------------------------------------------------------
+    // Every third file is truncated; the others have up to four bytes with a
+    // flipped bit or a random value, half of them within the headers. The
+    // generator is seeded so that a failing iteration can be reproduced.
+    //--------------------------------------------------------------------------
+    std::mt19937 random(1u);
+    int opened = 0, decoded = 0, failed = 0;
+    std::streambuf* errors = std::cerr.rdbuf(nullptr);
+    for ( int i = 0; i < iterations; i++ ) {
+        std::vector<char> bytes = original;
+        if ( i % 3 == 0 ) bytes.resize(random() % bytes.size());
+        else {
+            unsigned int changes = 1u + random() % 4u;
+            for ( unsigned int c = 0; c < changes; c++ ) {
+                std::size_t offset = (i % 2 == 0) ? random() % std::min<std::size_t>(512u, bytes.size()) : random() % bytes.size();
+                if ( random() % 5u == 0u ) bytes[offset] = static_cast<char>(random());
+                else bytes[offset] ^= static_cast<char>(1u << (random() % 8u));
+            }
+        }
+
+        std::ofstream out(fuzzPath, std::ios::binary);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        out.close();
+
+        CompressedMesh mesh;
+        if ( !mesh.open(fuzzPath) ) continue;
+        opened++;
+
+        std::vector<SubMesh> subMeshes;
+        std::vector<std::string> materialLibraries;
+        mesh.getSubMeshes(subMeshes);
+        mesh.getMaterialLibraries(materialLibraries);
+        if ( mesh.getVertexCount() > CODEC_FUZZ_MAX_ELEMENTS || mesh.getFaceCount() > CODEC_FUZZ_MAX_ELEMENTS ) continue;
+
+        std::vector<Vertex> fuzzVertices(mesh.getVertexCount());
+        std::vector<TriangleFace> fuzzFaces(mesh.getFaceCount());
+        if ( !mesh.decode(fuzzVertices.data(), fuzzFaces.data()) ) continue;
+        decoded++;
+
+        bool bValid = true;
+        for ( const TriangleFace& face : fuzzFaces ) {
+            for ( std::size_t j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) bValid = bValid && face.indices[j] < fuzzVertices.size();
+        }
+
+        if ( !bValid ) {
+            std::cout << "Iteration " << i << " decoded an index outside of its vertices." << std::endl;
+            failed++;
+        }
+    }
+    std::cerr.rdbuf(errors);
+    std::filesystem::remove(fuzzPath);
+
+    std::cout << iterations << " corrupted files, " << opened << " opened, " << decoded << " decoded, " << failed << " failed" << std::endl;
+    return (failed == 0) ? 0 : 1;
+}
+
+}
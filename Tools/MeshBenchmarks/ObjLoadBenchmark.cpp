@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "Benchmarks.h"
+#include <ObjMesh.h>
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <filesystem>
+
+namespace sgpu {
+
+/* Returns true if two Obj vector arrays are bitwise identical. */
+bool ObjLoad_SameVectors(const std::vector<Vector3f>& a, const std::vector<Vector3f>& b) {
+    if ( a.size() != b.size() ) return false;
+    return a.size() == 0 || std::memcmp(a.data(), b.data(), a.size() * sizeof(Vector3f)) == 0;
+}
+
+/* Returns true if two Obj files contain the same meshes, groups, and materials. */
+bool ObjLoad_SameFiles(const ObjFile& a, const ObjFile& b) {
+    if ( a.size() != b.size() ) return false;
+    if ( a.getGroups() != b.getGroups() || a.getMaterials() != b.getMaterials() || a.getMaterialLibraries() != b.getMaterialLibraries() ) return false;
+
+    for ( std::size_t i = 0; i < a.size(); i++ ) {
+        std::shared_ptr<ObjMesh> m = a.getMesh(i);
+        std::shared_ptr<ObjMesh> n = b.getMesh(i);
+        if ( m->name != n->name ) return false;
+        if ( !ObjLoad_SameVectors(m->vertices, n->vertices) || !ObjLoad_SameVectors(m->normals, n->normals) || !ObjLoad_SameVectors(m->textureCoordinates, n->textureCoordinates) ) return false;
+        if ( m->vertexIndices != n->vertexIndices || m->textureIndices != n->textureIndices || m->normalIndices != n->normalIndices ) return false;
+        if ( m->faces.size() != n->faces.size() ) return false;
+
+        for ( std::size_t f = 0; f < m->faces.size(); f++ ) {
+            const Obj_Face& x = m->faces[f];
+            const Obj_Face& y = n->faces[f];
+            if ( x.type != y.type || x.offset != y.offset || x.count != y.count ) return false;
+            if ( x.groupIndex != y.groupIndex || x.smoothingGroupIndex != y.smoothingGroupIndex || x.materialIndex != y.materialIndex ) return false;
+        }
+    }
+
+    return true;
+}
+
+std::string Benchmark_FileName(const std::string& filename) {
+    return std::filesystem::path(filename).filename().string();
+}
+
+int RunObjLoadBenchmark(int argc, char** argv) {
+    if ( argc == 0 ) {
+        std::cerr << "[MeshBenchmarks:obj] Error: No Obj files provided." << std::endl;
+        return 1;
+    }
+
+    const ObjLoadMode modes[] = { OBJ_LOAD_STREAM, OBJ_LOAD_MAPPED, OBJ_LOAD_PARALLEL };
+    const char* modeNames[] = { "stream", "mapped", "parallel" };
+    const std::size_t modeCount = sizeof(modes) / sizeof(modes[0]);
+
+    std::cout << std::left << std::setw(28) << "file" << std::right << std::setw(10) << "MB";
+    for ( std::size_t m = 0; m < modeCount; m++ ) std::cout << std::setw(12) << modeNames[m];
+    std::cout << "   (MB/s, best run)" << std::endl;
+
+    int result = 0;
+    for ( int i = 0; i < argc; i++ ) {
+        //----------------------------------------------------------------------
+        // Every reader must produce the meshes of the stream reader before its
+        // throughput is measured. Files with relative face indices can only be
+        // read by the mapped readers, which are then compared to each other.
+        //----------------------------------------------------------------------
+        std::error_code error;
+        std::uintmax_t size = std::filesystem::file_size(argv[i], error);
+        ObjFile streamed, mapped;
+        bool bStream = !error && streamed.load(argv[i], OBJ_LOAD_STREAM);
+        if ( error || (!bStream && !mapped.load(argv[i], OBJ_LOAD_MAPPED)) ) {
+            std::cerr << "[MeshBenchmarks:obj] Error: Could not load Obj file: " << argv[i] << std::endl;
+            result = 1;
+            continue;
+        }
+
+        const ObjFile& reference = bStream ? streamed : mapped;
+        double megabytes = static_cast<double>(size) / 1.0e6;
+        std::cout << std::left << std::setw(28) << Benchmark_FileName(argv[i]) << std::right << std::setw(10) << std::fixed << std::setprecision(2) << megabytes;
+        for ( std::size_t m = 0; m < modeCount; m++ ) {
+            if ( modes[m] == OBJ_LOAD_STREAM && !bStream ) {
+                std::cout << std::setw(12) << "-";
+                continue;
+            }
+
+            ObjFile file;
+            if ( !file.load(argv[i], modes[m]) || !ObjLoad_SameFiles(reference, file) ) {
+                std::cout << std::setw(12) << "MISMATCH";
+                result = 1;
+                continue;
+            }
+
+            double time = Benchmark_BestTime([&]() { ObjFile file; file.load(argv[i], modes[m]); });
+            std::cout << std::setw(12) << std::setprecision(1) << megabytes / time;
+        }
+        std::cout << std::endl;
+    }
+
+    return result;
+}
+
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "Benchmarks.h"
+#include <unordered_map>
+#include <iostream>
+#include <iomanip>
+
+namespace sgpu {
+
+/*
+ * Time after which the float sum hash map is stopped. Inputs whose corners
+ * sum to few distinct values (ex. grids) take far longer than that.
+ */
+const double VERTEX_SET_MAX_SUM_SECONDS = 60.0;
+
+/*
+ * Hash of the vertex set replaced by VertexSet: the sum of the attributes,
+ * which is equal for every vertex of a plane or mirrored shape.
+ */
+struct VertexSet_SumHash {
+    float operator () (const Vertex& vertex) const {
+        float hash = vertex.position.x() + vertex.position.y() + vertex.position.z();
+        hash += vertex.normal.x() + vertex.normal.y() + vertex.normal.z();
+        hash += vertex.tangent.x() + vertex.tangent.y() + vertex.tangent.z() + vertex.tangent.w();
+        hash += vertex.textureCoord.x() + vertex.textureCoord.y();
+        return hash;
+    }
+};
+
+typedef std::unordered_map<Vertex, unsigned int, VertexSet_SumHash, Vertex> VertexSet_SumMap;
+
+/*
+ * Indexes corners with the float sum hash map. Returns false if it was
+ * stopped after VERTEX_SET_MAX_SUM_SECONDS.
+ */
+bool VertexSet_IndexWithSumHash(const std::vector<Vertex>& corners, std::vector<unsigned int>& indices) {
+    VertexSet_SumMap map;
+    double start = Benchmark_Seconds();
+    indices.resize(corners.size());
+
+    for ( std::size_t i = 0; i < corners.size(); i++ ) {
+        VertexSet_SumMap::const_iterator it = map.find(corners[i]);
+        if ( it == map.end() ) it = map.insert(std::make_pair(corners[i], static_cast<unsigned int>(map.size()))).first;
+        indices[i] = it->second;
+        if ( (i & 4095u) == 0u && Benchmark_Seconds() - start > VERTEX_SET_MAX_SUM_SECONDS ) return false;
+    }
+
+    return true;
+}
+
+int RunVertexSetBenchmark(int argc, char** argv) {
+    if ( argc == 0 ) {
+        std::cerr << "[MeshBenchmarks:vertexset] Error: No inputs provided." << std::endl;
+        return 1;
+    }
+
+    std::cout << std::left << std::setw(20) << "input" << std::right << std::setw(10) << "corners" << std::setw(10) << "unique";
+    std::cout << std::setw(14) << "sum hash ms" << std::setw(14) << "VertexSet ms" << std::setw(10) << "speedup" << std::endl;
+
+    int result = 0;
+    for ( int i = 0; i < argc; i++ ) {
+        std::vector<Vertex> corners;
+        if ( !Benchmark_LoadCorners(argv[i], corners) ) {
+            result = 1;
+            continue;
+        }
+
+        //----------------------------------------------------------------------
+        // Both sets number the unique corners in the order they are first
+        // seen, so a completed sum hash run must produce the same indices.
+        //----------------------------------------------------------------------
+        std::vector<Vertex> unique;
+        std::vector<unsigned int> indices(corners.size()), sumIndices;
+        double time = Benchmark_BestTime([&]() {
+            VertexSet set;
+            unique.clear();
+            for ( std::size_t c = 0; c < corners.size(); c++ ) indices[c] = set.insert(corners[c], unique);
+        });
+
+        double sumTime = Benchmark_Seconds();
+        bool bCompleted = VertexSet_IndexWithSumHash(corners, sumIndices);
+        sumTime = Benchmark_Seconds() - sumTime;
+
+        std::cout << std::left << std::setw(20) << Benchmark_FileName(argv[i]) << std::right << std::setw(10) << corners.size() << std::setw(10) << unique.size();
+        std::cout << std::fixed << std::setprecision(2);
+        if ( !bCompleted ) std::cout << std::setw(14) << "> " + std::to_string(static_cast<int>(VERTEX_SET_MAX_SUM_SECONDS * 1.0e3)) << std::setw(14) << time * 1.0e3 << std::setw(10) << "-" << std::endl;
+        else if ( sumIndices != indices ) {
+            std::cout << std::setw(14) << sumTime * 1.0e3 << std::setw(14) << time * 1.0e3 << std::setw(10) << "MISMATCH" << std::endl;
+            result = 1;
+        }
+        else std::cout << std::setw(14) << sumTime * 1.0e3 << std::setw(14) << time * 1.0e3 << std::setw(9) << std::setprecision(0) << sumTime / time << "x" << std::endl;
+    }
+
+    return result;
+}
+
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2024 University of Colorado [http://graphics.ucdenver.edu]
+ * Computer VR and Graphics Laboratory
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "Benchmarks.h"
+#include <iostream>
+#include <cstring>
+
+using namespace sgpu;
+
+/*
+ * Command line benchmarks of the mesh loaders and codecs of the
+ * GraphicsLibrary. The tool compiles the MaterialDisplay copy of the library
+ * and needs no OpenGL context. Build it in Release; each measurement reports the
+ * fastest of the runs repeated for at least one second.
+ */
+void PrintUsage() {
+    std::cout << "Usage: MeshBenchmarks <benchmark> [arguments]" << std::endl;
+    std::cout << "  obj <file.obj>...    ObjFile::load throughput of each ObjLoadMode" << std::endl;
+    std::cout << "  codec <input>...     Compressed mesh ratio, encode and decode times" << std::endl;
+    std::cout << "  fuzz <input> [n]     Decodes n corrupted compressed meshes (default 3000)" << std::endl;
+    std::cout << "  vertexset <input>... VertexSet against the float sum hash it replaced" << std::endl;
+    std::cout << "An input is an Obj file or grid:<n>, a generated plane of n x n quads." << std::endl;
+}
+
+int main(int argc, char** argv) {
+    if ( argc < 2 ) {
+        PrintUsage();
+        return 1;
+    }
+
+    if ( std::strcmp(argv[1], "obj") == 0 ) return RunObjLoadBenchmark(argc - 2, argv + 2);
+    if ( std::strcmp(argv[1], "codec") == 0 ) return RunCodecBenchmark(argc - 2, argv + 2);
+    if ( std::strcmp(argv[1], "fuzz") == 0 ) return RunCodecFuzz(argc - 2, argv + 2);
+    if ( std::strcmp(argv[1], "vertexset") == 0 ) return RunVertexSetBenchmark(argc - 2, argv + 2);
+
+    PrintUsage();
+    return 1;
+}